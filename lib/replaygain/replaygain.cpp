@@ -268,6 +268,13 @@ bool ReplayGain::process(const float* left_samples, const float* right_samples,
     return true;
 }
 
+void ReplayGain::merge(const ReplayGain& other)
+{
+    for ( size_t i = 0; i < sizeof(A)/sizeof(*A); i++ ) {
+        A[i] += other.A[i];
+    }
+}
+
 float ReplayGain::end()
 {
     float  retval;
@@ -71,6 +71,10 @@ class ReplayGain {
 
     bool initialise(long samplefreq, size_t channels);
     bool process(const float* left_samples, const float* right_samples, size_t blockSize);
+    // Adds the RMS statistics of another analysis with the same sample rate,
+    // e.g. of a different segment of the same track. Samples of an
+    // incomplete RMS window of the other analysis are discarded.
+    void merge(const ReplayGain& other);
     float end();
 
   private:
@@ -186,19 +186,33 @@ Descriptor<JVRev>::setup()
 
 /* //////////////////////////////////////////////////////////////////////// */
 
+/* delay line lengths and output taps of the plate in seconds,
+ * shared by PlateStub and MixxxPlateX2 */
+static const float plate_lengths[] = {
+	0.004771345048889486, 0.0035953092974026408,
+	0.01273478713752898, 0.0093074829474816042,
+	0.022579886428547427, 0.030509727495715868,
+	0.14962534861059779, 0.060481838647894894, 0.12499579987231611,
+	0.14169550754342933, 0.089244313027116023, 0.10628003091293972
+};
+
+static const float plate_taps[] = {
+	0.0089378717113000241, 0.099929437854910791, 0.064278754074123853,
+	0.067067638856221232, 0.066866032727394914, 0.006283391015086859,
+	0.01186116057928161, 0.12187090487550822, 0.041262054366452743,
+	0.089815530392123921, 0.070931756325392295, 0.011256342192802662
+};
+
+/* width of the modulated lattices in seconds, about 12 samples @ 44.1 */
+static const double plate_mod_width = 0.000403221;
+
 void
 PlateStub::init()
 {
 	f_lfo = -1;
 
 #	define L(i) ((int) (l[i] * fs))
-	static float l[] = {
-		0.004771345048889486, 0.0035953092974026408,
-		0.01273478713752898, 0.0093074829474816042,
-		0.022579886428547427, 0.030509727495715868,
-		0.14962534861059779, 0.060481838647894894, 0.12499579987231611,
-		0.14169550754342933, 0.089244313027116023, 0.10628003091293972
-	};
+	const float * l = plate_lengths;
 
 	/* lh */
 	input.lattice[0].init (L(0));
@@ -209,8 +223,8 @@ PlateStub::init()
 	input.lattice[3].init (L(3));
 
 	/* modulated, width about 12 samples @ 44.1 */
-	tank.mlattice[0].init (L(4), (int) (0.000403221 * fs));
-	tank.mlattice[1].init (L(5), (int) (0.000403221 * fs));
+	tank.mlattice[0].init (L(4), (int) (plate_mod_width * fs));
+	tank.mlattice[1].init (L(5), (int) (plate_mod_width * fs));
 
 	/* lh */
 	tank.delay[0].init (L(6));
@@ -224,12 +238,7 @@ PlateStub::init()
 #	undef L
 
 #	define T(i) ((int) (t[i] * fs))
-	static float t[] = {
-		0.0089378717113000241, 0.099929437854910791, 0.064278754074123853,
-		0.067067638856221232, 0.066866032727394914, 0.006283391015086859,
-		0.01186116057928161, 0.12187090487550822, 0.041262054366452743,
-		0.089815530392123921, 0.070931756325392295, 0.011256342192802662
-	};
+	const float * t = plate_taps;
 
 	for (int i = 0; i < 12; ++i)
 		tank.taps[i] = T(i);
@@ -435,6 +444,273 @@ Descriptor<PlateX2>::setup()
 
 
 #include <util/rampingvalue.h>
+
+#include <algorithm>
+
+void MixxxPlateX2::BlockDelay::init(uint length, uint blockFrames) {
+    m_length = length;
+    // Samples that are read while a block is written are at most
+    // `length + blockFrames` samples old
+    const uint size = next_power_of_2(length + blockFrames + 1);
+    // The storage never shrinks, so switching back to a lower sample rate
+    // reuses it
+    if (size > m_data.size()) {
+        m_data.resize(size);
+    }
+    m_mask = size - 1;
+    m_write = 0;
+}
+
+void MixxxPlateX2::BlockDelay::reset() {
+    std::fill_n(m_data.begin(), m_mask + 1, 0);
+    m_write = 0;
+}
+
+void MixxxPlateX2::BlockDelay::read(sample_t* pDest, uint delay, uint frames) const {
+    const uint start = (m_write - delay) & m_mask;
+    const uint firstPart = std::min(frames, m_mask + 1 - start);
+    std::copy_n(m_data.data() + start, firstPart, pDest);
+    std::copy_n(m_data.data(), frames - firstPart, pDest + firstPart);
+}
+
+void MixxxPlateX2::BlockDelay::write(const sample_t* pSrc, uint frames) {
+    const uint firstPart = std::min(frames, m_mask + 1 - m_write);
+    std::copy_n(pSrc, firstPart, m_data.data() + m_write);
+    std::copy_n(pSrc + firstPart, frames - firstPart, m_data.data());
+    m_write = (m_write + frames) & m_mask;
+}
+
+void MixxxPlateX2::allocate(float maxSampleRate) {
+    // All delay lines are longest for the highest sample rate
+    setSampleRate(maxSampleRate);
+}
+
+void MixxxPlateX2::setSampleRate(float sampleRate) {
+    if (sampleRate != m_fs) {
+        m_fs = sampleRate;
+        const float fs = sampleRate;
+#	define L(i) ((uint) (plate_lengths[i] * fs))
+        const uint modWidth = (uint) (plate_mod_width * fs);
+        m_modLattice[0] = {static_cast<float>(L(4)), static_cast<float>(modWidth)};
+        m_modLattice[1] = {static_cast<float>(L(5)), static_cast<float>(modWidth)};
+
+        // Within a block, every stage must only read samples that have been
+        // written by previous blocks
+        m_blockFrames = kMaxBlockFrames;
+        for (int i = 0; i < 12; ++i) {
+            if (i == 4 || i == 5) {
+                m_blockFrames = std::min(m_blockFrames, L(i) - modWidth);
+            } else {
+                m_blockFrames = std::min(m_blockFrames, L(i));
+            }
+        }
+        assert(m_blockFrames > 0);
+
+        /* lh */
+        m_inputLattice[0].init(L(0), m_blockFrames);
+        m_inputLattice[1].init(L(1), m_blockFrames);
+
+        /* rh */
+        m_inputLattice[2].init(L(2), m_blockFrames);
+        m_inputLattice[3].init(L(3), m_blockFrames);
+
+        /* modulated, the interpolation reads one sample beyond the maximum delay */
+        m_tankModLattice[0].init(L(4) + modWidth + 1, m_blockFrames);
+        m_tankModLattice[1].init(L(5) + modWidth + 1, m_blockFrames);
+
+        /* lh */
+        m_tankDelay[0].init(L(6), m_blockFrames);
+        m_tankLattice[0].init(L(7), m_blockFrames);
+        m_tankDelay[1].init(L(8), m_blockFrames);
+
+        /* rh */
+        m_tankDelay[2].init(L(9), m_blockFrames);
+        m_tankLattice[1].init(L(10), m_blockFrames);
+        m_tankDelay[3].init(L(11), m_blockFrames);
+#	undef L
+
+        for (int i = 0; i < 12; ++i) {
+            m_taps[i] = (uint) (plate_taps[i] * fs);
+        }
+
+        /* tuned for soft attack, ambience */
+        m_indiff1 = .742;
+        m_indiff2 = .712;
+
+        m_dediff1 = .723;
+        m_dediff2 = .729;
+    }
+
+    clear();
+}
+
+void MixxxPlateX2::clear() {
+    m_bandwidth.reset();
+    for (int i = 0; i < 4; ++i) {
+        m_inputLattice[i].reset();
+        m_tankDelay[i].reset();
+    }
+    for (int i = 0; i < 2; ++i) {
+        m_tankModLattice[i].reset();
+        m_tankLattice[i].reset();
+        m_tankDamping[i].reset();
+    }
+    m_tankLfo[0].set_f(1.2, m_fs, 0);
+    m_tankLfo[1].set_f(1.2, m_fs, .5 * M_PI);
+}
+
+// static
+void MixxxPlateX2::processLattice(BlockDelay* pDelay,
+        sample_t* pInOut,
+        sample_t* pScratch,
+        sample_t* pDelayed,
+        sample_t d,
+        uint frames) {
+    pDelay->read(pDelayed, pDelay->length(), frames);
+    for (uint j = 0; j < frames; ++j) {
+        const sample_t x = pInOut[j] - d * pDelayed[j];
+        pScratch[j] = x;
+        pInOut[j] = d * x + pDelayed[j];
+    }
+    pDelay->write(pScratch, frames);
+}
+
+// static
+void MixxxPlateX2::processModLattice(BlockDelay* pDelay,
+        DSP::Sine* pLfo,
+        float n0,
+        float width,
+        sample_t* pInOut,
+        sample_t* pScratch,
+        sample_t* pLfoValues,
+        sample_t d,
+        uint frames) {
+    for (uint j = 0; j < frames; ++j) {
+        pLfoValues[j] = static_cast<float>(pLfo->get());
+    }
+    for (uint j = 0; j < frames; ++j) {
+        float f = n0 + width * pLfoValues[j];
+        int n;
+        fistp(f, n); /* read: i = (int) f; relies on FPTruncateMode */
+        f -= n;
+        // The delay relative to the j-th sample of the block
+        const uint age = static_cast<uint>(n) - j;
+        const sample_t y = (1 - f) * pDelay->tap(age) + f * pDelay->tap(age + 1);
+        const sample_t x = pInOut[j] + d * y;
+        pScratch[j] = x;
+        pInOut[j] = y - d * x; /* note sign */
+    }
+    pDelay->write(pScratch, frames);
+}
+
+void MixxxPlateX2::processBlock(const sample_t* pMonoIn,
+        sample_t* pOut,
+        sample_t decay,
+        uint frames) {
+    sample_t x[kMaxBlockFrames];
+    sample_t xl[kMaxBlockFrames];
+    sample_t xr[kMaxBlockFrames];
+    sample_t scratch[kMaxBlockFrames];
+    sample_t delayed[kMaxBlockFrames];
+
+    for (uint j = 0; j < frames; ++j) {
+        x[j] = m_bandwidth.process(pMonoIn[j]);
+    }
+
+    /* lh */
+    processLattice(&m_inputLattice[0], x, scratch, delayed, m_indiff1, frames);
+    processLattice(&m_inputLattice[1], x, scratch, delayed, m_indiff1, frames);
+
+    /* rh */
+    processLattice(&m_inputLattice[2], x, scratch, delayed, m_indiff2, frames);
+    processLattice(&m_inputLattice[3], x, scratch, delayed, m_indiff2, frames);
+
+    /* summation point */
+    m_tankDelay[3].read(xl, m_tankDelay[3].length(), frames);
+    m_tankDelay[1].read(xr, m_tankDelay[1].length(), frames);
+    for (uint j = 0; j < frames; ++j) {
+        xl[j] = x[j] + decay * xl[j];
+        xr[j] = x[j] + decay * xr[j];
+    }
+
+    /* lh */
+    processModLattice(&m_tankModLattice[0],
+            &m_tankLfo[0],
+            m_modLattice[0].n0,
+            m_modLattice[0].width,
+            xl,
+            scratch,
+            delayed,
+            m_dediff1,
+            frames);
+    m_tankDelay[0].read(delayed, m_tankDelay[0].length(), frames);
+    m_tankDelay[0].write(xl, frames);
+    for (uint j = 0; j < frames; ++j) {
+        xl[j] = m_tankDamping[0].process(delayed[j]);
+    }
+    for (uint j = 0; j < frames; ++j) {
+        xl[j] *= decay;
+    }
+    processLattice(&m_tankLattice[0], xl, scratch, delayed, m_dediff2, frames);
+    m_tankDelay[1].write(xl, frames);
+
+    /* rh */
+    processModLattice(&m_tankModLattice[1],
+            &m_tankLfo[1],
+            m_modLattice[1].n0,
+            m_modLattice[1].width,
+            xr,
+            scratch,
+            delayed,
+            m_dediff1,
+            frames);
+    m_tankDelay[2].read(delayed, m_tankDelay[2].length(), frames);
+    m_tankDelay[2].write(xr, frames);
+    for (uint j = 0; j < frames; ++j) {
+        xr[j] = m_tankDamping[1].process(delayed[j]);
+    }
+    for (uint j = 0; j < frames; ++j) {
+        xr[j] *= decay;
+    }
+    processLattice(&m_tankLattice[1], xr, scratch, delayed, m_dediff2, frames);
+    m_tankDelay[3].write(xr, frames);
+
+    /* gather output */
+    double outL[kMaxBlockFrames];
+    double outR[kMaxBlockFrames];
+    std::fill_n(outL, frames, 0.0);
+    std::fill_n(outR, frames, 0.0);
+    // The taps are relative to the j-th sample of the block that has
+    // been written last
+    const auto accumulateTap = [frames, &scratch](double* pAcc,
+                                       const BlockDelay& delay,
+                                       uint tap,
+                                       double gain) {
+        delay.read(scratch, tap + frames - 1, frames);
+        for (uint j = 0; j < frames; ++j) {
+            pAcc[j] += gain * scratch[j];
+        }
+    };
+    accumulateTap(outL, m_tankDelay[2], m_taps[0], .6);
+    accumulateTap(outL, m_tankDelay[2], m_taps[1], .6);
+    accumulateTap(outL, m_tankLattice[1], m_taps[2], -.6);
+    accumulateTap(outL, m_tankDelay[3], m_taps[3], .6);
+    accumulateTap(outL, m_tankDelay[0], m_taps[4], -.6);
+    accumulateTap(outL, m_tankLattice[0], m_taps[5], .6);
+
+    accumulateTap(outR, m_tankDelay[0], m_taps[6], .6);
+    accumulateTap(outR, m_tankDelay[0], m_taps[7], .6);
+    accumulateTap(outR, m_tankLattice[0], m_taps[8], -.6);
+    accumulateTap(outR, m_tankDelay[1], m_taps[9], .6);
+    accumulateTap(outR, m_tankDelay[2], m_taps[10], -.6);
+    accumulateTap(outR, m_tankLattice[1], m_taps[11], .6);
+
+    for (uint j = 0; j < frames; ++j) {
+        pOut[2 * j] = static_cast<sample_t>(outL[j]);
+        pOut[2 * j + 1] = static_cast<sample_t>(outR[j]);
+    }
+}
+
 // (timrae) we have our left / right samples interleaved in the same array, so use slightly modified version of PlateX2::cycle
 void MixxxPlateX2::processBuffer(const sample_t* in, sample_t* out, const uint frames,
                                  const sample_t bandwidthParam,
@@ -443,22 +719,28 @@ void MixxxPlateX2::processBuffer(const sample_t* in, sample_t* out, const uint f
                                  const sample_t currentSend,
                                  const sample_t previousSend) {
     // set bandwidth
-    input.bandwidth.set(exp(-M_PI * (1. - (.005 + .994*bandwidthParam))));
+    m_bandwidth.set(exp(-M_PI * (1. - (.005 + .994*bandwidthParam))));
     // set decay
     sample_t decay = .890*decayParam;
     // set damping
     double damp = exp(-M_PI * (.0005+.9995*dampingParam));
-    tank.damping[0].set(damp);
-    tank.damping[1].set(damp);
+    m_tankDamping[0].set(damp);
+    m_tankDamping[1].set(damp);
     RampingValue<sample_t> send(pow(currentSend, 1.53), previousSend, frames);
 
     // the modulated lattices interpolate, which needs truncated float
     DSP::FPTruncateMode _truncate;
 
-    // loop through the buffer, processing each sample
-    for (uint i = 0; i + 1 < frames; i += 2) {
-        sample_t mono_sample = send.getNth(i / 2) * (in[i] + in[i + 1]) / 2;
-        PlateStub::process(mono_sample, decay, &out[i], &out[i+1]);
+    // `frames` is actually the number of interleaved samples
+    const uint stereoFrames = frames / 2;
+    sample_t monoIn[kMaxBlockFrames];
+    for (uint frame = 0; frame < stereoFrames; frame += m_blockFrames) {
+        const uint blockFrames = std::min(m_blockFrames, stereoFrames - frame);
+        const sample_t* pIn = in + 2 * frame;
+        for (uint j = 0; j < blockFrames; ++j) {
+            monoIn[j] = send.getNth(static_cast<int>(frame + j)) *
+                    (pIn[2 * j] + pIn[2 * j + 1]) / 2;
+        }
+        processBlock(monoIn, out + 2 * frame, decay, blockFrames);
     }
- }
-
+}
@@ -49,6 +49,7 @@
 
 #include <stdio.h>
 #include <cmath> // for M_PI
+#include <vector>
 
 #include "basics.h"
 #include "dsp/Delay.h"
@@ -222,20 +223,110 @@ class PlateX2
 #endif
 
 /// (timrae) Define our own interface instead of using the original LADSPA plugin interface
- class MixxxPlateX2 : public PlateStub {
-    public:
-        void processBuffer(const sample_t* in, sample_t* out, const uint frames,
-                           const sample_t bandwidthParam,
-                           const sample_t decayParam,
-                           const sample_t dampingParam,
-                           const sample_t currentSend,
-                           const sample_t previousSend);
-
-        void init(float sampleRate) {
-            fs = sampleRate;
-            PlateStub::init();
-            PlateStub::activate();
+///
+/// MixxxPlateX2 implements the same network as PlateStub, but processes the
+/// audio in blocks instead of sample by sample. Every delay line and allpass
+/// in the plate is longer than a block, so within a block each stage only
+/// reads samples that have been written by previous blocks. This allows to
+/// run the network stage by stage over a whole block, with loops that have
+/// no dependencies between iterations and can be vectorized by the compiler.
+/// Only the one-pole filters, the LFOs and the interpolated taps of the
+/// modulated allpasses remain scalar loops.
+class MixxxPlateX2 {
+  public:
+    void processBuffer(const sample_t* in, sample_t* out, const uint frames,
+                       const sample_t bandwidthParam,
+                       const sample_t decayParam,
+                       const sample_t dampingParam,
+                       const sample_t currentSend,
+                       const sample_t previousSend);
+
+    /// Allocates the delay lines for sample rates up to maxSampleRate and
+    /// initializes the reverb for maxSampleRate. Not real-time safe.
+    void allocate(float maxSampleRate);
+
+    /// Adapts the delay lines to the sample rate and clears the state of
+    /// the reverb. Only allocates memory if the sample rate exceeds the
+    /// one passed to allocate().
+    void setSampleRate(float sampleRate);
+
+    /// Clears the state of the reverb.
+    void clear();
+
+  private:
+    /// Upper bound for the block size, the actual block size is limited
+    /// by the shortest delay line and depends on the sample rate.
+    static constexpr uint kMaxBlockFrames = 64;
+
+    /// A delay line that is read and written in blocks. The storage is
+    /// large enough that writing a block never overwrites samples that are
+    /// still read during the same block.
+    class BlockDelay {
+      public:
+        void init(uint length, uint blockFrames);
+        void reset();
+
+        /// Copies the samples that have been written `delay` samples before
+        /// the next `frames` samples that will be written.
+        void read(sample_t* pDest, uint delay, uint frames) const;
+        /// Appends `frames` samples.
+        void write(const sample_t* pSrc, uint frames);
+        /// Returns the sample that has been written `age` samples ago,
+        /// where 1 is the most recently written sample.
+        sample_t tap(uint age) const {
+            return m_data[(m_write - age) & m_mask];
         }
- };
+
+        uint length() const {
+            return m_length;
+        }
+
+      private:
+        std::vector<sample_t> m_data;
+        uint m_mask = 0;
+        uint m_write = 0;
+        uint m_length = 0;
+    };
+
+    /// Allpass lattice of the input diffusers and the tank.
+    static void processLattice(BlockDelay* pDelay,
+            sample_t* pInOut,
+            sample_t* pScratch,
+            sample_t* pDelayed,
+            sample_t d,
+            uint frames);
+    /// Allpass lattice with a delay modulated by a sine LFO.
+    static void processModLattice(BlockDelay* pDelay,
+            DSP::Sine* pLfo,
+            float n0,
+            float width,
+            sample_t* pInOut,
+            sample_t* pScratch,
+            sample_t* pLfoValues,
+            sample_t d,
+            uint frames);
+    void processBlock(const sample_t* pMonoIn,
+            sample_t* pOut,
+            sample_t decay,
+            uint frames);
+
+    float m_fs = 0;
+    uint m_blockFrames = 1;
+    sample_t m_indiff1, m_indiff2, m_dediff1, m_dediff2;
+
+    DSP::LP1<sample_t> m_bandwidth;
+    BlockDelay m_inputLattice[4];
+
+    struct ModLatticeParams {
+        float n0;
+        float width;
+    } m_modLattice[2];
+    BlockDelay m_tankModLattice[2];
+    DSP::Sine m_tankLfo[2];
+    BlockDelay m_tankLattice[2];
+    BlockDelay m_tankDelay[4];
+    DSP::LP1<sample_t> m_tankDamping[2];
+    uint m_taps[12];
+};
 
 #endif /* REVERB_H */
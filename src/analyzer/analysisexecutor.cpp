@@ -0,0 +1,117 @@
+#include "analyzer/analysisexecutor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "util/assert.h"
+
+namespace {
+
+// Lower priorities are paused while the 99th percentile of the audio
+// callback duration exceeds this fraction of the callback period. The
+// remaining headroom is too small to absorb any additional contention
+// for caches and memory bandwidth caused by the analysis.
+constexpr double kPauseAtEngineLoadPeak = 0.8;
+
+// How often acquire() checks if waiting has been cancelled
+constexpr std::chrono::milliseconds kAcquireCancelledPollInterval(100);
+
+} // anonymous namespace
+
+AnalysisExecutor::AnalysisExecutor(
+        int maxConcurrency,
+        std::function<double()> engineLoad,
+        std::function<double()> engineLoadPeak)
+        : m_maxConcurrency(std::max(1, maxConcurrency)),
+          m_engineLoad(std::move(engineLoad)),
+          m_engineLoadPeak(std::move(engineLoadPeak)),
+          m_running{},
+          m_waiting{} {
+    DEBUG_ASSERT(maxConcurrency > 0);
+    m_threadPool.setMaxThreadCount(m_maxConcurrency);
+}
+
+int AnalysisExecutor::concurrencyLimit(Priority priority) const {
+    if (priority == Priority::Deck) {
+        return m_maxConcurrency;
+    }
+    if (m_engineLoadPeak && m_engineLoadPeak() > kPauseAtEngineLoadPeak) {
+        return 0;
+    }
+    if (!m_engineLoad) {
+        return m_maxConcurrency;
+    }
+    // Leave the share of the cores that is occupied by the audio engine
+    // to the engine, but allow at least one analysis to proceed while
+    // not paused.
+    const double engineLoad = std::clamp(m_engineLoad(), 0.0, 1.0);
+    const auto limit = static_cast<int>(
+            std::floor(m_maxConcurrency * (1.0 - engineLoad)));
+    return std::max(1, limit);
+}
+
+int AnalysisExecutor::runningCountLocked() const {
+    return std::accumulate(m_running.begin(), m_running.end(), 0);
+}
+
+bool AnalysisExecutor::higherPriorityWaitingLocked(Priority priority) const {
+    return std::any_of(m_waiting.begin() + index(priority) + 1,
+            m_waiting.end(),
+            [](int waiting) {
+                return waiting > 0;
+            });
+}
+
+bool AnalysisExecutor::canAcquireLocked(Priority priority) const {
+    return !higherPriorityWaitingLocked(priority) &&
+            runningCountLocked() < concurrencyLimit(priority);
+}
+
+bool AnalysisExecutor::tryAcquire(Priority priority, std::chrono::milliseconds timeout) {
+    std::unique_lock locked(m_mutex);
+    ++m_waiting[index(priority)];
+    const bool acquired = m_condition.wait_for(locked, timeout, [this, priority] {
+        return canAcquireLocked(priority);
+    });
+    --m_waiting[index(priority)];
+    if (acquired) {
+        ++m_running[index(priority)];
+    }
+    // Waiting for a higher priority might have blocked others
+    // that are able to proceed now
+    m_condition.notify_all();
+    return acquired;
+}
+
+bool AnalysisExecutor::acquire(
+        Priority priority, const std::function<bool()>& isCancelled) {
+    while (!tryAcquire(priority, kAcquireCancelledPollInterval)) {
+        if (isCancelled && isCancelled()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AnalysisExecutor::release(Priority priority) {
+    {
+        std::lock_guard locked(m_mutex);
+        VERIFY_OR_DEBUG_ASSERT(m_running[index(priority)] > 0) {
+            return;
+        }
+        --m_running[index(priority)];
+    }
+    m_condition.notify_all();
+}
+
+bool AnalysisExecutor::shouldYield(Priority priority) const {
+    std::lock_guard locked(m_mutex);
+    return higherPriorityWaitingLocked(priority) ||
+            runningCountLocked() > concurrencyLimit(priority);
+}
+
+void AnalysisExecutor::start(std::function<void()> task) {
+    DEBUG_ASSERT(task);
+    m_threadPool.start(std::move(task));
+}
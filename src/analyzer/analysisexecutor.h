@@ -0,0 +1,105 @@
+#pragma once
+
+#include <QThreadPool>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
+#include "analyzer/analyzertrack.h"
+
+/// Process-wide admission control for the analyzer threads of all
+/// TrackAnalysisScheduler instances.
+///
+/// Each analyzer thread needs to acquire a slot before it starts to analyze
+/// a track and releases it when done. A slot is only granted if no analysis
+/// with a higher priority is waiting and the number of running analyses is
+/// below the limit for the requested priority. Deck analysis may use all
+/// slots, while the limit for all other priorities shrinks with the load
+/// of the audio engine. They are paused entirely while the peak load of
+/// the audio engine indicates that buffer underruns are imminent.
+///
+/// Running analyses are not interrupted by the executor. Instead they
+/// are expected to check shouldYield() at chunk boundaries and release
+/// their slot, which allows a higher priority analysis to start without
+/// waiting for a long batch analysis to finish.
+///
+/// Tasks that belong to an analysis, e.g. the segments of a long track,
+/// are started on the thread pool of the executor and compete for slots
+/// like the analyzer threads.
+///
+/// All functions are thread-safe.
+class AnalysisExecutor final {
+  public:
+    using Priority = AnalyzerTrack::Priority;
+
+    /// The engine load is the fraction of the audio callback period
+    /// that is currently needed for processing on average, the peak
+    /// engine load a high percentile of it. Both are polled from the
+    /// analyzer threads and must be thread-safe.
+    explicit AnalysisExecutor(
+            int maxConcurrency,
+            std::function<double()> engineLoad = std::function<double()>(),
+            std::function<double()> engineLoadPeak = std::function<double()>());
+    AnalysisExecutor(const AnalysisExecutor&) = delete;
+    AnalysisExecutor& operator=(const AnalysisExecutor&) = delete;
+
+    int maxConcurrency() const {
+        return m_maxConcurrency;
+    }
+
+    /// The maximum number of analyses that may run concurrently while
+    /// an analysis with the given priority is running. Might be 0 for
+    /// lower priorities while the audio engine is overloaded.
+    int concurrencyLimit(Priority priority) const;
+
+    /// Blocks until a slot has been granted or the timeout expired.
+    /// Returns false in case of a timeout. Callers that need to react
+    /// on other events while waiting should invoke this function in
+    /// a loop with a short timeout.
+    bool tryAcquire(Priority priority, std::chrono::milliseconds timeout);
+
+    /// Blocks until a slot has been granted. Returns false without a
+    /// slot if isCancelled() returns true while waiting.
+    bool acquire(Priority priority, const std::function<bool()>& isCancelled);
+
+    /// Releases a slot that has been acquired with the same priority.
+    void release(Priority priority);
+
+    /// Non-blocking check if an analysis with the given priority should
+    /// release its slot, because a more important analysis is waiting
+    /// or the concurrency limit has been lowered in the meantime.
+    bool shouldYield(Priority priority) const;
+
+    /// Runs the task on the thread pool of the executor. The task must
+    /// acquire a slot before doing any work and release it when done.
+    /// Tasks that are waiting for a slot occupy a thread of the pool,
+    /// which is limited to the maximum concurrency.
+    void start(std::function<void()> task);
+
+  private:
+    static constexpr std::size_t kPriorityCount =
+            static_cast<std::size_t>(Priority::Deck) + 1;
+
+    static std::size_t index(Priority priority) {
+        return static_cast<std::size_t>(priority);
+    }
+
+    // Must be called with m_mutex locked
+    int runningCountLocked() const;
+    bool higherPriorityWaitingLocked(Priority priority) const;
+    bool canAcquireLocked(Priority priority) const;
+
+    const int m_maxConcurrency;
+    const std::function<double()> m_engineLoad;
+    const std::function<double()> m_engineLoadPeak;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::array<int, kPriorityCount> m_running;
+    std::array<int, kPriorityCount> m_waiting;
+
+    // Declared last to wait for the remaining tasks first when destroyed
+    QThreadPool m_threadPool;
+};
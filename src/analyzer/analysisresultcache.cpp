@@ -0,0 +1,182 @@
+#include "analyzer/analysisresultcache.h"
+
+#include <QCryptographicHash>
+
+#include "analyzer/analyzersilence.h"
+#include "track/beats.h"
+#include "track/keyfactory.h"
+#include "track/track.h"
+#include "util/logger.h"
+#include "util/math.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+const mixxx::Logger kLogger("AnalysisResultCache");
+
+// Decoding a few short excerpts is sufficient for distinguishing different
+// recordings with the same duration, e.g. different masterings, but much
+// cheaper than decoding the whole file. The excerpts are not placed at the
+// beginning or end, which are often silent.
+constexpr int kFingerprintExcerptCount = 3;
+constexpr SINT kFingerprintExcerptFrames = 4096;
+
+} // anonymous namespace
+
+AnalysisResultCache::AnalysisResultCache(UserSettingsPointer pConfig)
+        : m_pConfig(pConfig),
+          m_analysisDao(pConfig) {
+}
+
+void AnalysisResultCache::initialize(const QSqlDatabase& database) {
+    m_analysisCacheDao.initialize(database);
+    m_analysisDao.initialize(database);
+}
+
+// static
+QString AnalysisResultCache::fingerprint(
+        const mixxx::AudioSourcePointer& pAudioSource) {
+    const mixxx::IndexRange frameIndexRange = pAudioSource->frameIndexRange();
+    if (frameIndexRange.empty()) {
+        return QString();
+    }
+    const auto signalInfo = pAudioSource->getSignalInfo();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    // Files with the same audio data but a different container or codec
+    // may report a different length, e.g. due to encoder delay. They will
+    // be decoded differently anyway.
+    hash.addData(QStringLiteral("%1:%2:%3")
+                         .arg(QString::number(signalInfo.getSampleRate()),
+                                 QString::number(signalInfo.getChannelCount()),
+                                 QString::number(frameIndexRange.length()))
+                         .toUtf8());
+
+    const SINT excerptFrames = math_min(
+            kFingerprintExcerptFrames, frameIndexRange.length());
+    mixxx::SampleBuffer sampleBuffer(signalInfo.frames2samples(excerptFrames));
+    for (int i = 1; i <= kFingerprintExcerptCount; ++i) {
+        const SINT excerptStart = frameIndexRange.start() +
+                (frameIndexRange.length() - excerptFrames) * i /
+                        (kFingerprintExcerptCount + 1);
+        const auto readableSampleFrames = pAudioSource->readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        mixxx::IndexRange::forward(excerptStart, excerptFrames),
+                        mixxx::SampleBuffer::WritableSlice(sampleBuffer)));
+        if (readableSampleFrames.frameIndexRange().empty()) {
+            return QString();
+        }
+        hash.addData(QByteArray::fromRawData(
+                reinterpret_cast<const char*>(readableSampleFrames.readableData()),
+                static_cast<int>(readableSampleFrames.readableLength() *
+                        sizeof(CSAMPLE))));
+    }
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+bool AnalysisResultCache::restoreResults(const QString& fingerprint, Track* pTrack) {
+    DEBUG_ASSERT(pTrack);
+    const auto entry = m_analysisCacheDao.findEntry(fingerprint);
+    if (!entry || entry->trackId == pTrack->getId()) {
+        return false;
+    }
+
+    bool restored = false;
+    if (!pTrack->getBeats() && !entry->beatsVersion.isEmpty()) {
+        const mixxx::BeatsPointer pBeats = mixxx::Beats::fromByteArray(
+                pTrack->getSampleRate(),
+                entry->beatsVersion,
+                entry->beatsSubVersion,
+                entry->beats);
+        if (pBeats && pTrack->trySetBeats(pBeats)) {
+            restored = true;
+        }
+    }
+    if (pTrack->getKeys().getGlobalKey() == mixxx::track::io::key::INVALID &&
+            !entry->keysVersion.isEmpty()) {
+        QByteArray keysSerialized = entry->keys;
+        const Keys keys = KeyFactory::loadKeysFromByteArray(
+                entry->keysVersion, entry->keysSubVersion, &keysSerialized);
+        if (keys.getGlobalKey() != mixxx::track::io::key::INVALID) {
+            pTrack->setKeys(keys);
+            restored = true;
+        }
+    }
+    if (!pTrack->getReplayGain().hasRatio() &&
+            mixxx::ReplayGain::isValidRatio(entry->replayGainRatio)) {
+        mixxx::ReplayGain replayGain(entry->replayGainRatio,
+                static_cast<CSAMPLE>(entry->replayGainPeak));
+        pTrack->setReplayGain(replayGain);
+        restored = true;
+    }
+    if (!AnalyzerSilence::hasSoundPositions(*pTrack) &&
+            entry->firstSoundFrame >= 0 &&
+            entry->lastSoundFrame > entry->firstSoundFrame) {
+        AnalyzerSilence::storeSoundPositions(pTrack,
+                mixxx::audio::FramePos(entry->firstSoundFrame),
+                mixxx::audio::FramePos(entry->lastSoundFrame),
+                m_pConfig.data());
+        restored = true;
+    }
+
+    // The waveforms are only stored in the analysis table of the track
+    // the cached results have been obtained from. The analyzer will load
+    // the copies and skip the analysis if they are still up to date.
+    if (entry->trackId.isValid() &&
+            m_analysisDao.getAnalysesForTrack(pTrack->getId()).isEmpty()) {
+        const auto analyses = m_analysisDao.getAnalysesForTrack(entry->trackId);
+        for (auto analysis : analyses) {
+            analysis.analysisId = -1;
+            analysis.trackId = pTrack->getId();
+            if (m_analysisDao.saveAnalysis(&analysis)) {
+                restored = true;
+            }
+        }
+    }
+
+    if (restored) {
+        kLogger.debug()
+                << "Restored cached analysis results of track"
+                << entry->trackId
+                << "for track"
+                << pTrack->getId();
+    }
+    return restored;
+}
+
+void AnalysisResultCache::storeResults(const QString& fingerprint, const Track& track) {
+    AnalysisCacheDao::Entry entry;
+    entry.fingerprint = fingerprint;
+    entry.trackId = track.getId();
+    bool hasResults = false;
+
+    if (const mixxx::BeatsPointer pBeats = track.getBeats()) {
+        entry.beatsVersion = pBeats->getVersion();
+        entry.beatsSubVersion = pBeats->getSubVersion();
+        entry.beats = pBeats->toByteArray();
+        hasResults = true;
+    }
+    const Keys keys = track.getKeys();
+    if (keys.getGlobalKey() != mixxx::track::io::key::INVALID) {
+        entry.keysVersion = keys.getVersion();
+        entry.keysSubVersion = keys.getSubVersion();
+        entry.keys = keys.toByteArray();
+        hasResults = true;
+    }
+    const mixxx::ReplayGain replayGain = track.getReplayGain();
+    if (replayGain.hasRatio()) {
+        entry.replayGainRatio = replayGain.getRatio();
+        entry.replayGainPeak = replayGain.hasPeak() ? replayGain.getPeak() : -1.0;
+        hasResults = true;
+    }
+    const CuePointer pN60dBSound = track.findCueByType(mixxx::CueType::N60dBSound);
+    if (pN60dBSound && pN60dBSound->getLengthFrames() > 0) {
+        entry.firstSoundFrame = pN60dBSound->getPosition().value();
+        entry.lastSoundFrame = pN60dBSound->getEndPosition().value();
+        hasResults = true;
+    }
+
+    if (hasResults) {
+        m_analysisCacheDao.saveEntry(entry);
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QSqlDatabase>
+#include <QString>
+
+#include "library/dao/analysiscachedao.h"
+#include "library/dao/analysisdao.h"
+#include "preferences/usersettings.h"
+#include "sources/audiosource.h"
+#include "track/track_decl.h"
+
+/// Shares analysis results between tracks with the same audio content,
+/// e.g. copies of a file in different folders or files that have been
+/// re-tagged or moved and imported as new tracks.
+///
+/// The results are looked up by a fingerprint of the decoded audio data.
+/// Only results that are missing are restored, so the analyzers still
+/// process everything else. Restored results are indistinguishable from
+/// results of a regular analysis.
+///
+/// Only used by a single analyzer thread.
+class AnalysisResultCache final {
+  public:
+    explicit AnalysisResultCache(UserSettingsPointer pConfig);
+
+    void initialize(const QSqlDatabase& database);
+
+    /// Calculates the fingerprint from a few short excerpts that are
+    /// spread over the whole audio stream. Returns an empty string if
+    /// the audio source could not be read.
+    static QString fingerprint(const mixxx::AudioSourcePointer& pAudioSource);
+
+    /// Restores the cached results that the track is missing. Returns
+    /// true if any results have been restored.
+    bool restoreResults(const QString& fingerprint, Track* pTrack);
+
+    /// Stores the current results of the track after the analysis.
+    void storeResults(const QString& fingerprint, const Track& track);
+
+  private:
+    const UserSettingsPointer m_pConfig;
+
+    AnalysisCacheDao m_analysisCacheDao;
+    AnalysisDao m_analysisDao;
+};
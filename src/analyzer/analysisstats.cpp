@@ -0,0 +1,70 @@
+#include "analyzer/analysisstats.h"
+
+#if defined(__WINDOWS__)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+// static
+mixxx::Duration AnalysisStats::currentThreadCpuTime() {
+#if defined(__WINDOWS__)
+    FILETIME creationTime;
+    FILETIME exitTime;
+    FILETIME kernelTime;
+    FILETIME userTime;
+    if (!GetThreadTimes(GetCurrentThread(),
+                &creationTime,
+                &exitTime,
+                &kernelTime,
+                &userTime)) {
+        return mixxx::Duration::empty();
+    }
+    // FILETIME counts in units of 100 ns
+    const auto toNanos = [](const FILETIME& fileTime) {
+        return ((static_cast<qint64>(fileTime.dwHighDateTime) << 32) |
+                       fileTime.dwLowDateTime) *
+                100;
+    };
+    return mixxx::Duration::fromNanos(toNanos(kernelTime) + toNanos(userTime));
+#else
+    timespec cpuTime;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuTime) != 0) {
+        return mixxx::Duration::empty();
+    }
+    return mixxx::Duration::fromNanos(
+            static_cast<qint64>(cpuTime.tv_sec) * 1000000000 + cpuTime.tv_nsec);
+#endif
+}
+
+void AnalysisStats::addDecodeCpuTime(mixxx::Duration cpuTime) {
+    std::lock_guard locked(m_mutex);
+    m_snapshot.decodeCpuTime += cpuTime;
+}
+
+void AnalysisStats::addAnalyzerCpuTime(
+        const QString& analyzerName, mixxx::Duration cpuTime) {
+    std::lock_guard locked(m_mutex);
+    m_snapshot.analyzerCpuTimes[analyzerName] += cpuTime;
+}
+
+void AnalysisStats::addFinishedTrack(mixxx::Duration audioDuration) {
+    std::lock_guard locked(m_mutex);
+    ++m_snapshot.finishedTracks;
+    m_snapshot.audioDuration += audioDuration;
+}
+
+void AnalysisStats::addSkippedTrack() {
+    std::lock_guard locked(m_mutex);
+    ++m_snapshot.skippedTracks;
+}
+
+void AnalysisStats::addFailedTrack() {
+    std::lock_guard locked(m_mutex);
+    ++m_snapshot.failedTracks;
+}
+
+AnalysisStats::Snapshot AnalysisStats::snapshot() const {
+    std::lock_guard locked(m_mutex);
+    return m_snapshot;
+}
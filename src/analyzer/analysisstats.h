@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QMap>
+#include <QString>
+#include <mutex>
+
+#include "util/duration.h"
+
+/// Collects where the time of the analysis is spent, i.e. the CPU time
+/// for decoding and for each analyzer, for benchmarking the analysis.
+///
+/// Shared by all analyzer threads of a TrackAnalysisScheduler and
+/// thread-safe. The analyzer threads only report their accumulated
+/// times once per track.
+class AnalysisStats final {
+  public:
+    struct Snapshot {
+        int finishedTracks = 0;
+        /// Tracks with up-to-date results that didn't need to be analyzed
+        int skippedTracks = 0;
+        int failedTracks = 0;
+        /// The total duration of the audio streams of the finished tracks
+        mixxx::Duration audioDuration;
+        mixxx::Duration decodeCpuTime;
+        /// Indexed by the name of the analyzer
+        QMap<QString, mixxx::Duration> analyzerCpuTimes;
+    };
+
+    AnalysisStats() = default;
+    AnalysisStats(const AnalysisStats&) = delete;
+    AnalysisStats& operator=(const AnalysisStats&) = delete;
+
+    /// Returns the CPU time that has been consumed by the calling thread.
+    /// The difference of two consecutive calls is the time that has been
+    /// spent in between, excluding the time while the thread has been
+    /// waiting or preempted. Returns a zero duration if not supported.
+    static mixxx::Duration currentThreadCpuTime();
+
+    void addDecodeCpuTime(mixxx::Duration cpuTime);
+    void addAnalyzerCpuTime(const QString& analyzerName, mixxx::Duration cpuTime);
+    void addFinishedTrack(mixxx::Duration audioDuration);
+    void addSkippedTrack();
+    void addFailedTrack();
+
+    Snapshot snapshot() const;
+
+  private:
+    mutable std::mutex m_mutex;
+    Snapshot m_snapshot;
+};
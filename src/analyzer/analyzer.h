@@ -1,5 +1,9 @@
 #pragma once
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 #include "analyzer/analyzertrack.h"
 #include "audio/signalinfo.h"
 #include "audio/types.h"
@@ -16,6 +20,20 @@
 
 #include "track/track_decl.h"
 
+// The partial results of an analyzer for a segment of a track, see
+// Analyzer::createSegment().
+class AnalyzerSegment {
+  public:
+    virtual ~AnalyzerSegment() = default;
+
+    // Analyze the next chunk of audio samples of the segment and return
+    // true if successful. Segments are processed concurrently on different
+    // threads.
+    virtual bool processSamples(const CSAMPLE* pIn, SINT count) = 0;
+};
+
+typedef std::vector<std::unique_ptr<AnalyzerSegment>> AnalyzerSegments;
+
 class Analyzer {
   public:
     virtual ~Analyzer() = default;
@@ -34,6 +52,46 @@ class Analyzer {
     // but not finalize()!
     virtual bool processSamples(const CSAMPLE* pIn, SINT count) = 0;
 
+    // Same as processSamples(), but with a mono downmix of the chunk that
+    // has count / 2 samples. The downmix is calculated only once for all
+    // analyzers. Analyzers of a mono signal should override this method
+    // instead of downmixing the samples again.
+    virtual bool processSamplesWithDownmix(
+            const CSAMPLE* pIn, const CSAMPLE* pMonoIn, SINT count) {
+        Q_UNUSED(pMonoIn);
+        return processSamples(pIn, count);
+    }
+
+    // Analyzers whose results can be merged from independently analyzed
+    // segments of the track return a new segment that starts at the given
+    // frame, counted from the first frame of the track. Segments must not
+    // access the analyzer while they are processed. Analyzers that need
+    // to process the whole track in order return nullptr.
+    virtual std::unique_ptr<AnalyzerSegment> createSegment(SINT startFrame) {
+        Q_UNUSED(startFrame);
+        return nullptr;
+    }
+
+    // Merge the results of all segments in the order of the track
+    // before storeResults() is invoked.
+    virtual bool mergeSegments(AnalyzerSegments segments) {
+        Q_UNUSED(segments);
+        DEBUG_ASSERT(!"not implemented");
+        return false;
+    }
+
+    // Analyzers that don't need the full bandwidth of the signal return
+    // true. They may then be initialized with a lower sample rate than
+    // the sample rate of the track. This only happens if all active
+    // analyzers of a track support it, e.g. when only beats and keys
+    // are missing, and if the decoder natively decodes at a reduced
+    // sample rate, see AudioSource::canDecodeAtReducedSampleRate().
+    // All positions of the results must still be stored in frames at
+    // the sample rate of the track.
+    virtual bool supportsReducedSampleRate() const {
+        return false;
+    }
+
     // Update the track object with the analysis results after
     // processing finished successfully, i.e. all available audio
     // samples have been processed.
@@ -66,6 +124,10 @@ class AnalyzerWithState final {
         return m_active;
     }
 
+    bool supportsReducedSampleRate() const {
+        return m_analyzer->supportsReducedSampleRate();
+    }
+
     bool initialize(const AnalyzerTrack& track,
             mixxx::audio::SampleRate sampleRate,
             SINT frameLength) {
@@ -74,8 +136,14 @@ class AnalyzerWithState final {
     }
 
     void processSamples(const CSAMPLE* pIn, const int count) {
-        if (m_active) {
-            m_active = m_analyzer->processSamples(pIn, count);
+        processSamples(pIn, nullptr, count);
+    }
+
+    void processSamples(const CSAMPLE* pIn, const CSAMPLE* pMonoIn, const int count) {
+        if (m_active && !isSplit()) {
+            m_active = pMonoIn
+                    ? m_analyzer->processSamplesWithDownmix(pIn, pMonoIn, count)
+                    : m_analyzer->processSamples(pIn, count);
             if (!m_active) {
                 // Ensure that cleanup() is invoked after processing
                 // failed and the analyzer became inactive!
@@ -84,7 +152,55 @@ class AnalyzerWithState final {
         }
     }
 
+    // Splits the analysis into segments that start at the given frames.
+    // Returns false if the analyzer needs to process the whole track in
+    // order. The samples of a split analyzer are only passed to its
+    // segments.
+    bool splitIntoSegments(const std::vector<SINT>& segmentStartFrames) {
+        DEBUG_ASSERT(!isSplit());
+        if (!m_active || segmentStartFrames.empty()) {
+            return false;
+        }
+        AnalyzerSegments segments;
+        segments.reserve(segmentStartFrames.size());
+        for (const auto startFrame : segmentStartFrames) {
+            auto pSegment = m_analyzer->createSegment(startFrame);
+            if (!pSegment) {
+                return false;
+            }
+            segments.push_back(std::move(pSegment));
+        }
+        m_segments = std::move(segments);
+        m_segmentFailed.assign(m_segments.size(), false);
+        return true;
+    }
+
+    bool isSplit() const {
+        return !m_segments.empty();
+    }
+
+    // Each segment must only be processed by a single thread at a time.
+    void processSegmentSamples(std::size_t segmentIndex, const CSAMPLE* pIn, SINT count) {
+        DEBUG_ASSERT(segmentIndex < m_segments.size());
+        if (!m_segmentFailed[segmentIndex]) {
+            m_segmentFailed[segmentIndex] =
+                    !m_segments[segmentIndex]->processSamples(pIn, count);
+        }
+    }
+
     void finish(const AnalyzerTrack& track) {
+        if (m_active && isSplit()) {
+            const bool failed = std::any_of(m_segmentFailed.begin(),
+                    m_segmentFailed.end(),
+                    [](char segmentFailed) {
+                        return segmentFailed;
+                    });
+            if (failed || !m_analyzer->mergeSegments(std::move(m_segments))) {
+                cancel();
+                return;
+            }
+            m_segments.clear();
+        }
         if (m_active) {
             m_analyzer->storeResults(track.getTrack());
             m_analyzer->cleanup();
@@ -93,6 +209,7 @@ class AnalyzerWithState final {
     }
 
     void cancel() {
+        m_segments.clear();
         if (m_active) {
             m_analyzer->cleanup();
             m_active = false;
@@ -102,4 +219,8 @@ class AnalyzerWithState final {
   private:
     AnalyzerPtr m_analyzer;
     bool m_active;
+    AnalyzerSegments m_segments;
+    // Not std::vector<bool>, because the elements are written
+    // concurrently by different threads
+    std::vector<char> m_segmentFailed;
 };
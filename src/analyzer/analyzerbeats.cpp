@@ -4,15 +4,26 @@
 #include <QString>
 #include <QVector>
 #include <QtDebug>
+#include <limits>
 
 #include "analyzer/analyzertrack.h"
 #include "analyzer/constants.h"
 #include "analyzer/plugins/analyzerqueenmarybeats.h"
 #include "analyzer/plugins/analyzersoundtouchbeats.h"
+#include "analyzer/provisionalresults.h"
 #include "library/rekordbox/rekordboxconstants.h"
 #include "track/beatfactory.h"
 #include "track/track.h"
 
+namespace {
+
+// Provisional beats are calculated after analyzing the first 30 seconds
+// and then refined each time the analyzed duration has doubled. This
+// bounds the additional effort by the effort of the final calculation.
+constexpr double kFirstProvisionalBeatsSeconds = 30;
+
+} // anonymous namespace
+
 // static
 QList<mixxx::AnalyzerPluginInfo> AnalyzerBeats::availablePlugins() {
     QList<mixxx::AnalyzerPluginInfo> plugins;
@@ -37,7 +48,8 @@ AnalyzerBeats::AnalyzerBeats(UserSettingsPointer pConfig, bool enforceBpmDetecti
           m_bPreferencesFixedTempo(true),
           m_bPreferencesFastAnalysis(false),
           m_maxFramesToProcess(0),
-          m_currentFrame(0) {
+          m_currentFrame(0),
+          m_nextProvisionalFrame(0) {
 }
 
 bool AnalyzerBeats::initialize(const AnalyzerTrack& track,
@@ -86,6 +98,10 @@ bool AnalyzerBeats::initialize(const AnalyzerTrack& track,
              << "\nFast analysis:" << m_bPreferencesFastAnalysis;
 
     m_sampleRate = sampleRate;
+    m_trackSampleRate = track.getTrack()->getSampleRate();
+    if (!m_trackSampleRate.isValid()) {
+        m_trackSampleRate = sampleRate;
+    }
     // In fast analysis mode, skip processing after
     // kFastAnalysisSecondsToAnalyze seconds are analyzed.
     if (m_bPreferencesFastAnalysis) {
@@ -123,6 +139,14 @@ bool AnalyzerBeats::initialize(const AnalyzerTrack& track,
             bShouldAnalyze = false;
         }
     }
+
+    DEBUG_ASSERT(!m_pProvisionalTrack);
+    if (bShouldAnalyze && track.getOptions().provisionalResults) {
+        m_pProvisionalTrack = track.getTrack();
+        m_nextProvisionalFrame = static_cast<SINT>(
+                kFirstProvisionalBeatsSeconds * m_sampleRate.toDouble());
+        m_pReplaceableBeats = m_pProvisionalTrack->getBeats();
+    }
     return bShouldAnalyze;
 }
 
@@ -157,6 +181,11 @@ bool AnalyzerBeats::shouldAnalyze(TrackPointer pTrack) const {
         return true;
     }
 
+    if (mixxx::provisionalresults::isProvisional(pBeats->getSubVersion())) {
+        qDebug() << "Re-analyzing track with provisional beats of an unfinished analysis.";
+        return true;
+    }
+
     QString subVersion = pBeats->getSubVersion();
     if (subVersion == mixxx::rekordboxconstants::beatsSubversion) {
         return m_bPreferencesReanalyzeImported;
@@ -195,6 +224,11 @@ bool AnalyzerBeats::shouldAnalyze(TrackPointer pTrack) const {
 }
 
 bool AnalyzerBeats::processSamples(const CSAMPLE* pIn, SINT count) {
+    return processSamplesWithDownmix(pIn, nullptr, count);
+}
+
+bool AnalyzerBeats::processSamplesWithDownmix(
+        const CSAMPLE* pIn, const CSAMPLE* pMonoIn, SINT count) {
     VERIFY_OR_DEBUG_ASSERT(m_pPlugin) {
         return false;
     }
@@ -204,11 +238,51 @@ bool AnalyzerBeats::processSamples(const CSAMPLE* pIn, SINT count) {
         return true; // silently ignore all remaining samples
     }
 
-    return m_pPlugin->processSamples(pIn, count);
+    const bool result = pMonoIn
+            ? m_pPlugin->processSamplesWithDownmix(pIn, pMonoIn, count)
+            : m_pPlugin->processSamples(pIn, count);
+    if (result && m_pProvisionalTrack && m_currentFrame >= m_nextProvisionalFrame) {
+        m_nextProvisionalFrame *= 2;
+        storeProvisionalResults();
+    }
+    return result;
+}
+
+void AnalyzerBeats::storeProvisionalResults() {
+    DEBUG_ASSERT(m_pPlugin);
+    DEBUG_ASSERT(m_pProvisionalTrack);
+    if (m_pProvisionalTrack->getBeats() != m_pReplaceableBeats) {
+        // The beats have been edited or imported in the meantime
+        qDebug() << "Beats have been modified during the analysis."
+                 << "No longer publishing provisional beats.";
+        m_nextProvisionalFrame = std::numeric_limits<SINT>::max();
+        return;
+    }
+
+    const QVector<mixxx::audio::FramePos> beats =
+            toTrackFramePositions(m_pPlugin->calculateProvisionalBeats());
+    if (beats.size() < 2) {
+        return;
+    }
+    QHash<QString, QString> extraVersionInfo = getExtraVersionInfo(
+            m_pluginId, m_bPreferencesFastAnalysis);
+    mixxx::provisionalresults::markProvisional(&extraVersionInfo);
+    const mixxx::BeatsPointer pBeats = BeatFactory::makePreferredBeats(
+            beats,
+            extraVersionInfo,
+            m_bPreferencesFixedTempo,
+            m_trackSampleRate);
+    if (pBeats && m_pProvisionalTrack->trySetBeats(pBeats)) {
+        qDebug() << "AnalyzerBeats published provisional beats after"
+                 << m_currentFrame / m_sampleRate.toDouble() << "seconds";
+        m_pReplaceableBeats = pBeats;
+    }
 }
 
 void AnalyzerBeats::cleanup() {
     m_pPlugin.reset();
+    m_pProvisionalTrack.reset();
+    m_pReplaceableBeats.reset();
 }
 
 void AnalyzerBeats::storeResults(TrackPointer pTrack) {
@@ -223,14 +297,15 @@ void AnalyzerBeats::storeResults(TrackPointer pTrack) {
 
     mixxx::BeatsPointer pBeats;
     if (m_pPlugin->supportsBeatTracking()) {
-        QVector<mixxx::audio::FramePos> beats = m_pPlugin->getBeats();
+        QVector<mixxx::audio::FramePos> beats =
+                toTrackFramePositions(m_pPlugin->getBeats());
         QHash<QString, QString> extraVersionInfo = getExtraVersionInfo(
                 m_pluginId, m_bPreferencesFastAnalysis);
         pBeats = BeatFactory::makePreferredBeats(
                 beats,
                 extraVersionInfo,
                 m_bPreferencesFixedTempo,
-                m_sampleRate);
+                m_trackSampleRate);
         qDebug() << "AnalyzerBeats plugin detected" << beats.size()
                  << "beats. Predominant BPM:"
                  << (pBeats ? pBeats->getBpmInRange(
@@ -242,12 +317,29 @@ void AnalyzerBeats::storeResults(TrackPointer pTrack) {
     } else {
         mixxx::Bpm bpm = m_pPlugin->getBpm();
         qDebug() << "AnalyzerBeats plugin detected constant BPM: " << bpm;
-        pBeats = mixxx::Beats::fromConstTempo(m_sampleRate, mixxx::audio::kStartFramePos, bpm);
+        pBeats = mixxx::Beats::fromConstTempo(
+                m_trackSampleRate, mixxx::audio::kStartFramePos, bpm);
     }
 
+    if (m_pProvisionalTrack && pTrack->getBeats() != m_pReplaceableBeats) {
+        qDebug() << "Not replacing beats that have been modified during the analysis";
+        return;
+    }
     pTrack->trySetBeats(pBeats);
 }
 
+QVector<mixxx::audio::FramePos> AnalyzerBeats::toTrackFramePositions(
+        QVector<mixxx::audio::FramePos> beats) const {
+    if (m_sampleRate == m_trackSampleRate) {
+        return beats;
+    }
+    const double ratio = m_trackSampleRate.toDouble() / m_sampleRate.toDouble();
+    for (auto& beat : beats) {
+        beat *= ratio;
+    }
+    return beats;
+}
+
 // static
 QHash<QString, QString> AnalyzerBeats::getExtraVersionInfo(
         const QString& pluginId, bool bPreferencesFastAnalysis) {
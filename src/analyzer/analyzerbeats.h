@@ -23,14 +23,25 @@ class AnalyzerBeats : public Analyzer {
             mixxx::audio::SampleRate sampleRate,
             SINT frameLength) override;
     bool processSamples(const CSAMPLE* pIn, SINT count) override;
+    bool processSamplesWithDownmix(
+            const CSAMPLE* pIn, const CSAMPLE* pMonoIn, SINT count) override;
+    bool supportsReducedSampleRate() const override {
+        return true;
+    }
     void storeResults(TrackPointer tio) override;
     void cleanup() override;
 
   private:
     bool shouldAnalyze(TrackPointer pTrack) const;
+    /// Converts the beat positions of the plugin from the analyzed
+    /// sample rate to the sample rate of the track.
+    QVector<mixxx::audio::FramePos> toTrackFramePositions(
+            QVector<mixxx::audio::FramePos> beats) const;
     static QHash<QString, QString> getExtraVersionInfo(
             const QString& pluginId, bool bPreferencesFastAnalysis);
 
+    void storeProvisionalResults();
+
     BeatDetectionSettings m_bpmSettings;
     std::unique_ptr<mixxx::AnalyzerBeatsPlugin> m_pPlugin;
     const bool m_enforceBpmDetection;
@@ -41,6 +52,14 @@ class AnalyzerBeats : public Analyzer {
     bool m_bPreferencesFastAnalysis;
 
     mixxx::audio::SampleRate m_sampleRate;
+    mixxx::audio::SampleRate m_trackSampleRate;
     SINT m_maxFramesToProcess;
     SINT m_currentFrame;
+
+    // Only set while publishing provisional results
+    TrackPointer m_pProvisionalTrack;
+    SINT m_nextProvisionalFrame;
+    // The beats of the track that may be replaced, i.e. the initial
+    // beats or the provisional beats that have been published
+    mixxx::BeatsPointer m_pReplaceableBeats;
 };
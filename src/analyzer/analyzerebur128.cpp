@@ -1,6 +1,7 @@
 #include "analyzer/analyzerebur128.h"
 
 #include <QtDebug>
+#include <vector>
 
 #include "analyzer/analyzertrack.h"
 #include "analyzer/constants.h"
@@ -10,6 +11,29 @@
 
 namespace {
 constexpr double kReplayGain2ReferenceLUFS = -18;
+
+class Ebur128Segment final : public AnalyzerSegment {
+  public:
+    explicit Ebur128Segment(ebur128_state* pState)
+            : m_pState(pState) {
+    }
+    ~Ebur128Segment() override {
+        ebur128_destroy(&m_pState);
+    }
+
+    bool processSamples(const CSAMPLE* pIn, SINT count) override {
+        const size_t frames = count / mixxx::kAnalysisChannels;
+        return ebur128_add_frames_float(m_pState, pIn, frames) == EBUR128_SUCCESS;
+    }
+
+    ebur128_state* state() const {
+        return m_pState;
+    }
+
+  private:
+    ebur128_state* m_pState;
+};
+
 } // anonymous namespace
 
 AnalyzerEbur128::AnalyzerEbur128(UserSettingsPointer pConfig)
@@ -30,6 +54,7 @@ bool AnalyzerEbur128::initialize(
         return false;
     }
     DEBUG_ASSERT(m_pState == nullptr);
+    m_sampleRate = sampleRate;
     m_pState = ebur128_init(
             mixxx::kAnalysisChannels,
             sampleRate,
@@ -38,6 +63,7 @@ bool AnalyzerEbur128::initialize(
 }
 
 void AnalyzerEbur128::cleanup() {
+    m_segments.clear();
     if (m_pState) {
         ebur128_destroy(&m_pState);
         // ebur128_destroy clears the pointer but let's not rely on that.
@@ -59,12 +85,43 @@ bool AnalyzerEbur128::processSamples(const CSAMPLE* pIn, SINT count) {
     return true;
 }
 
+std::unique_ptr<AnalyzerSegment> AnalyzerEbur128::createSegment(SINT startFrame) {
+    Q_UNUSED(startFrame);
+    // The blocks of the gating are not aligned across the segments,
+    // i.e. a few blocks at their boundaries are missing. This is
+    // negligible for the long tracks that are split into segments.
+    ebur128_state* pState = ebur128_init(
+            mixxx::kAnalysisChannels,
+            m_sampleRate,
+            EBUR128_MODE_I);
+    if (!pState) {
+        return nullptr;
+    }
+    return std::make_unique<Ebur128Segment>(pState);
+}
+
+bool AnalyzerEbur128::mergeSegments(AnalyzerSegments segments) {
+    DEBUG_ASSERT(m_segments.empty());
+    m_segments = std::move(segments);
+    return true;
+}
+
 void AnalyzerEbur128::storeResults(TrackPointer pTrack) {
     VERIFY_OR_DEBUG_ASSERT(m_pState) {
         return;
     }
     double averageLufs;
-    int e = ebur128_loudness_global(m_pState, &averageLufs);
+    int e;
+    if (m_segments.empty()) {
+        e = ebur128_loudness_global(m_pState, &averageLufs);
+    } else {
+        std::vector<ebur128_state*> states;
+        states.reserve(m_segments.size());
+        for (const auto& pSegment : m_segments) {
+            states.push_back(static_cast<const Ebur128Segment&>(*pSegment).state());
+        }
+        e = ebur128_loudness_global_multiple(states.data(), states.size(), &averageLufs);
+    }
     VERIFY_OR_DEBUG_ASSERT(e == EBUR128_SUCCESS) {
         qWarning() << "AnalyzerEbur128::storeResults() failed with" << e;
         return;
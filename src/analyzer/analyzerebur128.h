@@ -18,10 +18,15 @@ class AnalyzerEbur128 : public Analyzer {
             mixxx::audio::SampleRate sampleRate,
             SINT frameLength) override;
     bool processSamples(const CSAMPLE* pIn, SINT count) override;
+    std::unique_ptr<AnalyzerSegment> createSegment(SINT startFrame) override;
+    bool mergeSegments(AnalyzerSegments segments) override;
     void storeResults(TrackPointer pTrack) override;
     void cleanup() override;
 
   private:
     ReplayGainSettings m_rgSettings;
+    mixxx::audio::SampleRate m_sampleRate;
     ebur128_state* m_pState;
+    // The segments are merged when calculating the loudness
+    AnalyzerSegments m_segments;
 };
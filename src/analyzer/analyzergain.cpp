@@ -11,6 +11,55 @@
 #include "util/sample.h"
 #include "util/timer.h"
 
+namespace {
+
+bool processReplayGain(ReplayGain* pReplayGain,
+        std::vector<CSAMPLE>* pLeftTempBuffer,
+        std::vector<CSAMPLE>* pRightTempBuffer,
+        const CSAMPLE* pIn,
+        SINT count) {
+    SINT numFrames = count / mixxx::kAnalysisChannels;
+    if (numFrames > static_cast<SINT>(pLeftTempBuffer->size())) {
+        pLeftTempBuffer->resize(numFrames);
+        pRightTempBuffer->resize(numFrames);
+    }
+    SampleUtil::deinterleaveBuffer(pLeftTempBuffer->data(),
+            pRightTempBuffer->data(),
+            pIn,
+            numFrames);
+    SampleUtil::applyGain(pLeftTempBuffer->data(), 32767, numFrames);
+    SampleUtil::applyGain(pRightTempBuffer->data(), 32767, numFrames);
+    return pReplayGain->process(pLeftTempBuffer->data(), pRightTempBuffer->data(), numFrames);
+}
+
+class ReplayGainSegment final : public AnalyzerSegment {
+  public:
+    ReplayGainSegment() = default;
+
+    bool initialize(mixxx::audio::SampleRate sampleRate) {
+        return m_replayGain.initialise(sampleRate, mixxx::kAnalysisChannels);
+    }
+
+    bool processSamples(const CSAMPLE* pIn, SINT count) override {
+        return processReplayGain(&m_replayGain,
+                &m_leftTempBuffer,
+                &m_rightTempBuffer,
+                pIn,
+                count);
+    }
+
+    const ReplayGain& replayGain() const {
+        return m_replayGain;
+    }
+
+  private:
+    ReplayGain m_replayGain;
+    std::vector<CSAMPLE> m_leftTempBuffer;
+    std::vector<CSAMPLE> m_rightTempBuffer;
+};
+
+} // anonymous namespace
+
 AnalyzerGain::AnalyzerGain(UserSettingsPointer pConfig)
         : m_rgSettings(pConfig) {
     m_pReplayGain = new ReplayGain();
@@ -28,6 +77,7 @@ bool AnalyzerGain::initialize(const AnalyzerTrack& track,
         return false;
     }
 
+    m_sampleRate = sampleRate;
     return m_pReplayGain->initialise(
             sampleRate,
             mixxx::kAnalysisChannels);
@@ -39,18 +89,31 @@ void AnalyzerGain::cleanup() {
 bool AnalyzerGain::processSamples(const CSAMPLE* pIn, SINT count) {
     ScopedTimer t(u"AnalyzerGain::process()");
 
-    SINT numFrames = count / mixxx::kAnalysisChannels;
-    if (numFrames > static_cast<SINT>(m_pLeftTempBuffer.size())) {
-        m_pLeftTempBuffer.resize(numFrames);
-        m_pRightTempBuffer.resize(numFrames);
-    }
-    SampleUtil::deinterleaveBuffer(m_pLeftTempBuffer.data(),
-            m_pRightTempBuffer.data(),
+    return processReplayGain(m_pReplayGain,
+            &m_pLeftTempBuffer,
+            &m_pRightTempBuffer,
             pIn,
-            numFrames);
-    SampleUtil::applyGain(m_pLeftTempBuffer.data(), 32767, numFrames);
-    SampleUtil::applyGain(m_pRightTempBuffer.data(), 32767, numFrames);
-    return m_pReplayGain->process(m_pLeftTempBuffer.data(), m_pRightTempBuffer.data(), numFrames);
+            count);
+}
+
+std::unique_ptr<AnalyzerSegment> AnalyzerGain::createSegment(SINT startFrame) {
+    Q_UNUSED(startFrame);
+    // The filters of each segment start settled at silence and the
+    // last incomplete RMS window of each segment is discarded. This
+    // is negligible for the long tracks that are split into segments.
+    auto pSegment = std::make_unique<ReplayGainSegment>();
+    if (!pSegment->initialize(m_sampleRate)) {
+        return nullptr;
+    }
+    return pSegment;
+}
+
+bool AnalyzerGain::mergeSegments(AnalyzerSegments segments) {
+    for (const auto& pSegment : segments) {
+        m_pReplayGain->merge(
+                static_cast<const ReplayGainSegment&>(*pSegment).replayGain());
+    }
+    return true;
 }
 
 void AnalyzerGain::storeResults(TrackPointer pTrack) {
@@ -27,11 +27,14 @@ class AnalyzerGain : public Analyzer {
             mixxx::audio::SampleRate sampleRate,
             SINT frameLength) override;
     bool processSamples(const CSAMPLE* pIn, SINT count) override;
+    std::unique_ptr<AnalyzerSegment> createSegment(SINT startFrame) override;
+    bool mergeSegments(AnalyzerSegments segments) override;
     void storeResults(TrackPointer tio) override;
     void cleanup() override;
 
   private:
     ReplayGainSettings m_rgSettings;
+    mixxx::audio::SampleRate m_sampleRate;
     std::vector<CSAMPLE> m_pLeftTempBuffer;
     std::vector<CSAMPLE> m_pRightTempBuffer;
     ReplayGain* m_pReplayGain;
@@ -1,6 +1,7 @@
 #include "analyzer/analyzerkey.h"
 
 #include <QtDebug>
+#include <limits>
 
 #include "analyzer/analyzertrack.h"
 #include "analyzer/constants.h"
@@ -8,10 +9,20 @@
 #include "analyzer/plugins/analyzerkeyfinder.h"
 #endif
 #include "analyzer/plugins/analyzerqueenmarykey.h"
+#include "analyzer/provisionalresults.h"
 #include "proto/keys.pb.h"
 #include "track/keyfactory.h"
 #include "track/track.h"
 
+namespace {
+
+// A key needs more context than the tempo. Provisional keys are
+// calculated after analyzing the first minute and then each time the
+// analyzed duration has doubled.
+constexpr double kFirstProvisionalKeysSeconds = 60;
+
+} // anonymous namespace
+
 // static
 QList<mixxx::AnalyzerPluginInfo> AnalyzerKey::availablePlugins() {
     QList<mixxx::AnalyzerPluginInfo> analyzers;
@@ -33,9 +44,11 @@ mixxx::AnalyzerPluginInfo AnalyzerKey::defaultPlugin() {
 AnalyzerKey::AnalyzerKey(const KeyDetectionSettings& keySettings)
         : m_keySettings(keySettings),
           m_sampleRate(0),
+          m_trackSampleRate(0),
           m_totalFrames(0),
           m_maxFramesToProcess(0),
           m_currentFrame(0),
+          m_nextProvisionalFrame(0),
           m_bPreferencesKeyDetectionEnabled(true),
           m_bPreferencesFastAnalysisEnabled(false),
           m_bPreferencesReanalyzeEnabled(false) {
@@ -75,6 +88,10 @@ bool AnalyzerKey::initialize(const AnalyzerTrack& track,
              << "\nFast analysis:" << m_bPreferencesFastAnalysisEnabled;
 
     m_sampleRate = sampleRate;
+    m_trackSampleRate = track.getTrack()->getSampleRate();
+    if (!m_trackSampleRate.isValid()) {
+        m_trackSampleRate = sampleRate;
+    }
     m_totalFrames = frameLength;
     // In fast analysis mode, skip processing after
     // kFastAnalysisSecondsToAnalyze seconds are analyzed.
@@ -114,6 +131,14 @@ bool AnalyzerKey::initialize(const AnalyzerTrack& track,
             bShouldAnalyze = false;
         }
     }
+
+    DEBUG_ASSERT(!m_pProvisionalTrack);
+    if (bShouldAnalyze && track.getOptions().provisionalResults) {
+        m_pProvisionalTrack = track.getTrack();
+        m_nextProvisionalFrame = static_cast<SINT>(
+                kFirstProvisionalKeysSeconds * m_sampleRate.toDouble());
+        m_replaceableKeys = m_pProvisionalTrack->getKeys();
+    }
     return bShouldAnalyze;
 }
 
@@ -126,6 +151,10 @@ bool AnalyzerKey::shouldAnalyze(TrackPointer pTrack) const {
 
     const Keys keys = pTrack->getKeys();
     if (keys.getGlobalKey() != mixxx::track::io::key::INVALID) {
+        if (mixxx::provisionalresults::isProvisional(keys.getSubVersion())) {
+            qDebug() << "Re-analyzing track with provisional keys of an unfinished analysis.";
+            return true;
+        }
         QString version = keys.getVersion();
         QString subVersion = keys.getSubVersion();
 
@@ -151,6 +180,11 @@ bool AnalyzerKey::shouldAnalyze(TrackPointer pTrack) const {
 }
 
 bool AnalyzerKey::processSamples(const CSAMPLE* pIn, SINT count) {
+    return processSamplesWithDownmix(pIn, nullptr, count);
+}
+
+bool AnalyzerKey::processSamplesWithDownmix(
+        const CSAMPLE* pIn, const CSAMPLE* pMonoIn, SINT count) {
     VERIFY_OR_DEBUG_ASSERT(m_pPlugin) {
         return false;
     }
@@ -160,11 +194,48 @@ bool AnalyzerKey::processSamples(const CSAMPLE* pIn, SINT count) {
         return true; // silently ignore remaining samples
     }
 
-    return m_pPlugin->processSamples(pIn, count);
+    const bool result = pMonoIn
+            ? m_pPlugin->processSamplesWithDownmix(pIn, pMonoIn, count)
+            : m_pPlugin->processSamples(pIn, count);
+    if (result && m_pProvisionalTrack && m_currentFrame >= m_nextProvisionalFrame) {
+        m_nextProvisionalFrame *= 2;
+        storeProvisionalResults();
+    }
+    return result;
+}
+
+void AnalyzerKey::storeProvisionalResults() {
+    DEBUG_ASSERT(m_pPlugin);
+    DEBUG_ASSERT(m_pProvisionalTrack);
+    if (m_pProvisionalTrack->getKeys() != m_replaceableKeys) {
+        // The key has been edited or imported in the meantime
+        qDebug() << "Keys have been modified during the analysis."
+                 << "No longer publishing provisional keys.";
+        m_nextProvisionalFrame = std::numeric_limits<SINT>::max();
+        return;
+    }
+
+    const KeyChangeList keyChanges = m_pPlugin->getProvisionalKeyChanges();
+    if (keyChanges.isEmpty()) {
+        return;
+    }
+    QHash<QString, QString> extraVersionInfo = getExtraVersionInfo(
+            m_pluginId, m_bPreferencesFastAnalysisEnabled);
+    mixxx::provisionalresults::markProvisional(&extraVersionInfo);
+    const Keys keys = makeKeys(keyChanges, extraVersionInfo, m_currentFrame);
+    if (keys.getGlobalKey() == mixxx::track::io::key::INVALID) {
+        return;
+    }
+    qDebug() << "AnalyzerKey published provisional keys after"
+             << m_currentFrame / m_sampleRate.toDouble() << "seconds";
+    m_pProvisionalTrack->setKeys(keys);
+    m_replaceableKeys = keys;
 }
 
 void AnalyzerKey::cleanup() {
     m_pPlugin.reset();
+    m_pProvisionalTrack.reset();
+    m_replaceableKeys = Keys();
 }
 
 void AnalyzerKey::storeResults(TrackPointer tio) {
@@ -180,11 +251,28 @@ void AnalyzerKey::storeResults(TrackPointer tio) {
     KeyChangeList key_changes = m_pPlugin->getKeyChanges();
     QHash<QString, QString> extraVersionInfo = getExtraVersionInfo(
             m_pluginId, m_bPreferencesFastAnalysisEnabled);
-    Keys track_keys = KeyFactory::makePreferredKeys(
-            key_changes, extraVersionInfo, m_sampleRate, m_totalFrames);
+    Keys track_keys = makeKeys(key_changes, extraVersionInfo, m_totalFrames);
+    if (m_pProvisionalTrack && tio->getKeys() != m_replaceableKeys) {
+        qDebug() << "Not replacing keys that have been modified during the analysis";
+        return;
+    }
     tio->setKeys(track_keys);
 }
 
+Keys AnalyzerKey::makeKeys(KeyChangeList keyChanges,
+        const QHash<QString, QString>& extraVersionInfo,
+        SINT frames) const {
+    if (m_sampleRate != m_trackSampleRate) {
+        const double ratio = m_trackSampleRate.toDouble() / m_sampleRate.toDouble();
+        for (auto& keyChange : keyChanges) {
+            keyChange.second *= ratio;
+        }
+        frames = static_cast<SINT>(frames * ratio);
+    }
+    return KeyFactory::makePreferredKeys(
+            keyChanges, extraVersionInfo, m_trackSampleRate, frames);
+}
+
 // static
 QHash<QString, QString> AnalyzerKey::getExtraVersionInfo(
         const QString& pluginId, bool bPreferencesFastAnalysis) {
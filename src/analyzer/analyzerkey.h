@@ -7,6 +7,7 @@
 #include "analyzer/analyzer.h"
 #include "analyzer/plugins/analyzerplugin.h"
 #include "preferences/keydetectionsettings.h"
+#include "track/keys.h"
 #include "track/track_decl.h"
 #include "util/memory.h"
 
@@ -22,23 +23,44 @@ class AnalyzerKey : public Analyzer {
             mixxx::audio::SampleRate sampleRate,
             SINT frameLength) override;
     bool processSamples(const CSAMPLE* pIn, SINT count) override;
+    bool processSamplesWithDownmix(
+            const CSAMPLE* pIn, const CSAMPLE* pMonoIn, SINT count) override;
+    bool supportsReducedSampleRate() const override {
+        return true;
+    }
     void storeResults(TrackPointer tio) override;
     void cleanup() override;
 
   private:
+    /// Creates the keys with the positions converted from the analyzed
+    /// sample rate to the sample rate of the track.
+    Keys makeKeys(KeyChangeList keyChanges,
+            const QHash<QString, QString>& extraVersionInfo,
+            SINT frames) const;
+
     static QHash<QString, QString> getExtraVersionInfo(
             const QString& pluginId, bool bPreferencesFastAnalysis);
 
     bool shouldAnalyze(TrackPointer tio) const;
 
+    void storeProvisionalResults();
+
     KeyDetectionSettings m_keySettings;
     std::unique_ptr<mixxx::AnalyzerKeyPlugin> m_pPlugin;
     QString m_pluginId;
     mixxx::audio::SampleRate m_sampleRate;
+    mixxx::audio::SampleRate m_trackSampleRate;
     SINT m_totalFrames;
     SINT m_maxFramesToProcess;
     SINT m_currentFrame;
 
+    // Only set while publishing provisional results
+    TrackPointer m_pProvisionalTrack;
+    SINT m_nextProvisionalFrame;
+    // The keys of the track that may be replaced, i.e. the initial
+    // keys or the provisional keys that have been published
+    Keys m_replaceableKeys;
+
     bool m_bPreferencesKeyDetectionEnabled;
     bool m_bPreferencesFastAnalysisEnabled;
     bool m_bPreferencesReanalyzeEnabled;
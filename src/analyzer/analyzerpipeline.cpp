@@ -0,0 +1,139 @@
+#include "analyzer/analyzerpipeline.h"
+
+#include <algorithm>
+
+#include "analyzer/constants.h"
+#include "util/assert.h"
+#include "util/sample.h"
+
+namespace {
+
+// The number of chunks the fastest analyzer may be ahead of the slowest
+// one. A larger ring only increases the memory usage if the analyzers
+// have a different throughput, because the decoding is usually faster.
+constexpr std::size_t kChunkCount = 8;
+
+} // anonymous namespace
+
+AnalyzerPipeline::AnalyzerPipeline(
+        std::vector<AnalyzerWithState>* pAnalyzers,
+        QThreadPool* pThreadPool)
+        : m_pAnalyzers(pAnalyzers),
+          m_pThreadPool(pThreadPool),
+          m_chunks(kChunkCount),
+          m_consumers(pAnalyzers->size()),
+          m_publishedChunks(0),
+          m_cancelled(false) {
+    DEBUG_ASSERT(m_pAnalyzers);
+    DEBUG_ASSERT(m_pThreadPool);
+    for (auto& chunk : m_chunks) {
+        chunk.buffer = mixxx::SampleBuffer(mixxx::kAnalysisSamplesPerChunk);
+        chunk.monoBuffer = mixxx::SampleBuffer(mixxx::kAnalysisFramesPerChunk);
+    }
+}
+
+AnalyzerPipeline::~AnalyzerPipeline() {
+    cancel();
+}
+
+std::size_t AnalyzerPipeline::minConsumedChunks() const {
+    std::size_t minConsumed = m_publishedChunks;
+    for (const auto& consumer : m_consumers) {
+        minConsumed = std::min(minConsumed, consumer.consumedChunks);
+    }
+    return minConsumed;
+}
+
+bool AnalyzerPipeline::isIdle() const {
+    return std::none_of(m_consumers.begin(),
+            m_consumers.end(),
+            [](const Consumer& consumer) {
+                return consumer.running;
+            });
+}
+
+mixxx::SampleBuffer::WritableSlice AnalyzerPipeline::nextChunk() {
+    std::unique_lock locked(m_mutex);
+    m_condition.wait(locked, [this] {
+        return m_publishedChunks - minConsumedChunks() < kChunkCount;
+    });
+    return mixxx::SampleBuffer::WritableSlice(
+            m_chunks[m_publishedChunks % kChunkCount].buffer);
+}
+
+void AnalyzerPipeline::publishChunk(const CSAMPLE* pSamples, SINT sampleCount) {
+    // The chunk buffer is not accessed by any consumer until it
+    // has been published.
+    Chunk& chunk = m_chunks[m_publishedChunks % kChunkCount];
+    DEBUG_ASSERT(sampleCount <= chunk.buffer.size());
+    if (pSamples != chunk.buffer.data()) {
+        // The source may overlap with the chunk buffer, but only with
+        // an offset into the buffer
+        std::copy(pSamples, pSamples + sampleCount, chunk.buffer.data());
+    }
+    SampleUtil::mixMultichannelToMono(
+            chunk.monoBuffer.data(), chunk.buffer.data(), sampleCount);
+    chunk.sampleCount = sampleCount;
+
+    std::lock_guard locked(m_mutex);
+    ++m_publishedChunks;
+    for (std::size_t i = 0; i < m_consumers.size(); ++i) {
+        if (!m_consumers[i].running) {
+            startConsumerLocked(i);
+        }
+    }
+}
+
+void AnalyzerPipeline::startConsumerLocked(std::size_t index) {
+    Consumer& consumer = m_consumers[index];
+    DEBUG_ASSERT(!consumer.running);
+    // Reading the state of an analyzer is safe while no task is running.
+    // Split analyzers only process their segments.
+    if (m_cancelled || !(*m_pAnalyzers)[index].isActive() ||
+            (*m_pAnalyzers)[index].isSplit()) {
+        consumer.consumedChunks = m_publishedChunks;
+        return;
+    }
+    consumer.running = true;
+    m_pThreadPool->start([this, index] {
+        consume(index);
+    });
+}
+
+void AnalyzerPipeline::consume(std::size_t index) {
+    AnalyzerWithState& analyzer = (*m_pAnalyzers)[index];
+    std::unique_lock locked(m_mutex);
+    Consumer& consumer = m_consumers[index];
+    DEBUG_ASSERT(consumer.running);
+    while (consumer.consumedChunks < m_publishedChunks) {
+        if (m_cancelled || !analyzer.isActive()) {
+            consumer.consumedChunks = m_publishedChunks;
+            break;
+        }
+        const Chunk& chunk = m_chunks[consumer.consumedChunks % kChunkCount];
+        locked.unlock();
+        analyzer.processSamples(
+                chunk.buffer.data(), chunk.monoBuffer.data(), chunk.sampleCount);
+        locked.lock();
+        ++consumer.consumedChunks;
+        // Wake up the decoding thread that might be waiting for this chunk
+        m_condition.notify_all();
+    }
+    consumer.running = false;
+    m_condition.notify_all();
+}
+
+void AnalyzerPipeline::wait() {
+    std::unique_lock locked(m_mutex);
+    m_condition.wait(locked, [this] {
+        return isIdle() && minConsumedChunks() == m_publishedChunks;
+    });
+}
+
+void AnalyzerPipeline::cancel() {
+    std::unique_lock locked(m_mutex);
+    m_cancelled = true;
+    m_condition.wait(locked, [this] {
+        return isIdle();
+    });
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <QThreadPool>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include "analyzer/analyzer.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+/// Fans out the decoded chunks of a single track to multiple analyzers
+/// that run concurrently.
+///
+/// The decoding thread publishes each chunk once into a bounded ring of
+/// chunk buffers. Every analyzer consumes the chunks in order on a task of
+/// the thread pool. A chunk buffer is reused after all analyzers have
+/// processed it, i.e. the decoding thread blocks while the slowest analyzer
+/// lags behind by the capacity of the ring.
+///
+/// Tasks never block while waiting for chunks. An analyzer without pending
+/// chunks finishes its task and a new task is started when the next chunk
+/// is published. This prevents deadlocks when the pool is shared with other
+/// pipelines.
+class AnalyzerPipeline final {
+  public:
+    /// The analyzers must outlive the pipeline. They must not be accessed
+    /// by the caller before wait() or cancel() have returned.
+    explicit AnalyzerPipeline(
+            std::vector<AnalyzerWithState>* pAnalyzers,
+            QThreadPool* pThreadPool = QThreadPool::globalInstance());
+    AnalyzerPipeline(const AnalyzerPipeline&) = delete;
+    AnalyzerPipeline& operator=(const AnalyzerPipeline&) = delete;
+    ~AnalyzerPipeline();
+
+    /// Returns the buffer for the next chunk with a capacity of
+    /// mixxx::kAnalysisSamplesPerChunk samples. Blocks until the buffer
+    /// has been released by all analyzers.
+    mixxx::SampleBuffer::WritableSlice nextChunk();
+
+    /// Publishes the samples of the chunk returned by nextChunk(). The
+    /// samples are copied into the chunk buffer if they are not already
+    /// stored at its beginning.
+    void publishChunk(const CSAMPLE* pSamples, SINT sampleCount);
+
+    /// Blocks until all analyzers have processed all published chunks.
+    void wait();
+
+    /// Skips all published chunks that have not been processed yet and
+    /// blocks until all running tasks have finished.
+    void cancel();
+
+  private:
+    struct Chunk {
+        mixxx::SampleBuffer buffer;
+        // The mono downmix of buffer that is shared by all analyzers
+        mixxx::SampleBuffer monoBuffer;
+        SINT sampleCount = 0;
+    };
+
+    struct Consumer {
+        /// The number of chunks that have been processed
+        std::size_t consumedChunks = 0;
+        bool running = false;
+    };
+
+    // Must be called with m_mutex locked
+    std::size_t minConsumedChunks() const;
+    bool isIdle() const;
+
+    void startConsumerLocked(std::size_t index);
+    void consume(std::size_t index);
+
+    std::vector<AnalyzerWithState>* const m_pAnalyzers;
+    QThreadPool* const m_pThreadPool;
+
+    std::vector<Chunk> m_chunks;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::vector<Consumer> m_consumers;
+    std::size_t m_publishedChunks;
+    bool m_cancelled;
+};
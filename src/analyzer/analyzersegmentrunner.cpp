@@ -0,0 +1,202 @@
+#include "analyzer/analyzersegmentrunner.h"
+
+#include "analyzer/constants.h"
+#include "sources/audiosourcestereoproxy.h"
+#include "util/assert.h"
+#include "util/logger.h"
+#include "util/math.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+const mixxx::Logger kLogger("AnalyzerSegmentRunner");
+
+// Splitting is only worth the additional audio sources and the small
+// deviations of some merged results for long tracks, e.g. DJ mixes,
+// radio shows and recordings.
+constexpr double kSegmentDurationSeconds = 10 * 60;
+
+} // anonymous namespace
+
+// static
+std::vector<SINT> AnalyzerSegmentRunner::segmentStartFrames(
+        SINT frameLength,
+        mixxx::audio::SampleRate sampleRate) {
+    if (!sampleRate.isValid()) {
+        return {};
+    }
+    // Round down to whole chunks
+    const SINT segmentFrames = static_cast<SINT>(
+                                       kSegmentDurationSeconds * sampleRate.value()) /
+            mixxx::kAnalysisFramesPerChunk * mixxx::kAnalysisFramesPerChunk;
+    DEBUG_ASSERT(segmentFrames > 0);
+    const SINT segmentCount = frameLength / segmentFrames;
+    if (segmentCount < 2) {
+        return {};
+    }
+    std::vector<SINT> startFrames;
+    startFrames.reserve(segmentCount);
+    for (SINT i = 0; i < segmentCount; ++i) {
+        // The last segment includes the remaining frames
+        startFrames.push_back(i * segmentFrames);
+    }
+    return startFrames;
+}
+
+AnalyzerSegmentRunner::AnalyzerSegmentRunner(
+        std::vector<AnalyzerWithState>* pAnalyzers,
+        AnalysisExecutor* pExecutor,
+        AnalysisExecutor::Priority priority)
+        : m_pAnalyzers(pAnalyzers),
+          m_pExecutor(pExecutor),
+          m_priority(priority),
+          m_frameLength(0),
+          m_framesAnalyzed(0),
+          m_cancelled(false),
+          m_runningTasks(0) {
+    DEBUG_ASSERT(m_pAnalyzers);
+    DEBUG_ASSERT(m_pExecutor);
+}
+
+AnalyzerSegmentRunner::~AnalyzerSegmentRunner() {
+    cancel();
+}
+
+bool AnalyzerSegmentRunner::start(
+        mixxx::IndexRange frameIndexRange,
+        mixxx::audio::SampleRate sampleRate,
+        const OpenAudioSource& openAudioSource) {
+    DEBUG_ASSERT(m_runningTasks == 0);
+    const auto startFrames = segmentStartFrames(frameIndexRange.length(), sampleRate);
+    if (startFrames.empty()) {
+        return false;
+    }
+
+    // Decoders are not thread-safe and each segment needs its own
+    // audio source. The sources are opened before splitting the
+    // analyzers, which could not be undone.
+    std::vector<mixxx::AudioSourcePointer> audioSources;
+    audioSources.reserve(startFrames.size());
+    for (std::size_t i = 0; i < startFrames.size(); ++i) {
+        auto audioSource = openAudioSource();
+        if (!audioSource || audioSource->frameIndexRange() != frameIndexRange) {
+            kLogger.warning()
+                    << "Failed to open audio source for segment"
+                    << i;
+            return false;
+        }
+        audioSources.push_back(std::move(audioSource));
+    }
+
+    bool split = false;
+    for (auto&& analyzer : *m_pAnalyzers) {
+        if (analyzer.splitIntoSegments(startFrames)) {
+            split = true;
+        }
+    }
+    if (!split) {
+        return false;
+    }
+    kLogger.debug()
+            << "Analyzing"
+            << startFrames.size()
+            << "segments concurrently";
+
+    m_frameLength = frameIndexRange.length();
+    m_framesAnalyzed = 0;
+    m_cancelled = false;
+    std::lock_guard locked(m_mutex);
+    for (std::size_t i = 0; i < startFrames.size(); ++i) {
+        const SINT endFrame = i + 1 < startFrames.size()
+                ? startFrames[i + 1]
+                : frameIndexRange.length();
+        const auto frameRange = mixxx::IndexRange::between(
+                frameIndexRange.start() + startFrames[i],
+                frameIndexRange.start() + endFrame);
+        ++m_runningTasks;
+        m_pExecutor->start(
+                [this, i, audioSource = std::move(audioSources[i]), frameRange]() mutable {
+                    analyzeSegment(i, std::move(audioSource), frameRange);
+                });
+    }
+    return true;
+}
+
+void AnalyzerSegmentRunner::analyzeSegment(
+        std::size_t segmentIndex,
+        mixxx::AudioSourcePointer audioSource,
+        mixxx::IndexRange frameRange) {
+    const auto isCancelled = [this] {
+        return m_cancelled.load();
+    };
+    if (m_pExecutor->acquire(m_priority, isCancelled)) {
+        mixxx::AudioSourceStereoProxy audioSourceProxy(
+                audioSource,
+                mixxx::kAnalysisFramesPerChunk);
+        mixxx::SampleBuffer sampleBuffer(mixxx::kAnalysisSamplesPerChunk);
+        mixxx::IndexRange remainingFrameRange = frameRange;
+        bool slotAcquired = true;
+        while (!remainingFrameRange.empty() && !m_cancelled.load()) {
+            if (m_pExecutor->shouldYield(m_priority)) {
+                m_pExecutor->release(m_priority);
+                slotAcquired = m_pExecutor->acquire(m_priority, isCancelled);
+                if (!slotAcquired) {
+                    break;
+                }
+            }
+            const auto chunkFrameRange = remainingFrameRange.splitAndShrinkFront(
+                    math_min(mixxx::kAnalysisFramesPerChunk, remainingFrameRange.length()));
+            const auto readableSampleFrames =
+                    audioSourceProxy.readSampleFrames(
+                            mixxx::WritableSampleFrames(
+                                    chunkFrameRange,
+                                    mixxx::SampleBuffer::WritableSlice(sampleBuffer)));
+            // The duration of the audio source might be adjusted while
+            // reading, see AnalyzerThread::analyzeAudioSource()
+            remainingFrameRange = intersect(
+                    remainingFrameRange, audioSourceProxy.frameIndexRange());
+            if (!readableSampleFrames.frameIndexRange().empty()) {
+                for (auto&& analyzer : *m_pAnalyzers) {
+                    if (analyzer.isSplit()) {
+                        analyzer.processSegmentSamples(segmentIndex,
+                                readableSampleFrames.readableData(),
+                                readableSampleFrames.readableLength());
+                    }
+                }
+            }
+            m_framesAnalyzed += chunkFrameRange.length();
+        }
+        if (slotAcquired) {
+            m_pExecutor->release(m_priority);
+        }
+    }
+    // Close the audio source before signaling the end of the task
+    audioSource.reset();
+
+    std::lock_guard locked(m_mutex);
+    DEBUG_ASSERT(m_runningTasks > 0);
+    --m_runningTasks;
+    m_condition.notify_all();
+}
+
+bool AnalyzerSegmentRunner::waitFor(std::chrono::milliseconds timeout) {
+    std::unique_lock locked(m_mutex);
+    return m_condition.wait_for(locked, timeout, [this] {
+        return m_runningTasks == 0;
+    });
+}
+
+void AnalyzerSegmentRunner::cancel() {
+    m_cancelled = true;
+    std::unique_lock locked(m_mutex);
+    m_condition.wait(locked, [this] {
+        return m_runningTasks == 0;
+    });
+}
+
+double AnalyzerSegmentRunner::progress() const {
+    if (m_frameLength <= 0) {
+        return 0.0;
+    }
+    return math_min(1.0, static_cast<double>(m_framesAnalyzed.load()) / m_frameLength);
+}
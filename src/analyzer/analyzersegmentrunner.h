@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "analyzer/analysisexecutor.h"
+#include "analyzer/analyzer.h"
+#include "audio/types.h"
+#include "sources/audiosource.h"
+#include "util/indexrange.h"
+
+/// Analyzes the segments of a long track concurrently for all analyzers
+/// that can merge the results of independently analyzed segments, see
+/// Analyzer::createSegment().
+///
+/// Each segment is decoded from its own audio source on a task of the
+/// AnalysisExecutor. The tasks acquire a slot with the priority of the
+/// track before decoding and yield it at chunk boundaries like the
+/// analyzer threads. The remaining analyzers still need to process the
+/// whole track in order and are not affected.
+class AnalyzerSegmentRunner final {
+  public:
+    /// Returns the first frames of the segments, counted from the first
+    /// frame of the track, or nothing if the track is too short. The
+    /// segments are aligned to the chunks of the analysis and only depend
+    /// on the length of the track, i.e. the merged results are
+    /// reproducible.
+    static std::vector<SINT> segmentStartFrames(
+            SINT frameLength,
+            mixxx::audio::SampleRate sampleRate);
+
+    /// The analyzers and the executor must outlive the runner. The
+    /// segments of the analyzers must not be accessed by the caller
+    /// before wait() or cancel() have returned.
+    AnalyzerSegmentRunner(
+            std::vector<AnalyzerWithState>* pAnalyzers,
+            AnalysisExecutor* pExecutor,
+            AnalysisExecutor::Priority priority);
+    AnalyzerSegmentRunner(const AnalyzerSegmentRunner&) = delete;
+    AnalyzerSegmentRunner& operator=(const AnalyzerSegmentRunner&) = delete;
+    ~AnalyzerSegmentRunner();
+
+    typedef std::function<mixxx::AudioSourcePointer()> OpenAudioSource;
+
+    /// Splits the active analyzers into segments and starts a task for
+    /// each segment. Returns false if the track is too short, if none of
+    /// the analyzers could be split or if the audio sources for the
+    /// segments could not be opened.
+    bool start(mixxx::IndexRange frameIndexRange,
+            mixxx::audio::SampleRate sampleRate,
+            const OpenAudioSource& openAudioSource);
+
+    /// Returns true if all segments have been analyzed or false if the
+    /// timeout expired. The caller should not hold a slot of the executor
+    /// while waiting, otherwise the segments might never be started.
+    bool waitFor(std::chrono::milliseconds timeout);
+
+    /// Stops the analysis of all segments as soon as possible and blocks
+    /// until all tasks have finished.
+    void cancel();
+
+    /// The fraction of the frames that have been analyzed.
+    double progress() const;
+
+  private:
+    void analyzeSegment(
+            std::size_t segmentIndex,
+            mixxx::AudioSourcePointer audioSource,
+            mixxx::IndexRange frameRange);
+
+    std::vector<AnalyzerWithState>* const m_pAnalyzers;
+    AnalysisExecutor* const m_pExecutor;
+    const AnalysisExecutor::Priority m_priority;
+
+    SINT m_frameLength;
+    std::atomic<SINT> m_framesAnalyzed;
+    std::atomic<bool> m_cancelled;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::size_t m_runningTasks;
+};
@@ -12,7 +12,7 @@ constexpr CSAMPLE kSilenceThreshold = 0.001f; // -60 dB
 // TODO: Change the above line to:
 //constexpr CSAMPLE kSilenceThreshold = db2ratio(-60.0f);
 
-bool shouldAnalyze(TrackPointer pTrack) {
+bool shouldAnalyze(const Track* pTrack) {
     CuePointer pIntroCue = pTrack->findCueByType(mixxx::CueType::Intro);
     CuePointer pOutroCue = pTrack->findCueByType(mixxx::CueType::Outro);
     CuePointer pN60dBSound = pTrack->findCueByType(mixxx::CueType::N60dBSound);
@@ -33,8 +33,11 @@ Iterator first_sound(Iterator begin, Iterator end) {
 } // anonymous namespace
 
 AnalyzerSilence::AnalyzerSilence(UserSettingsPointer pConfig)
-        : m_pConfig(pConfig),
-          m_framesProcessed(0),
+        : m_pConfig(pConfig) {
+}
+
+AnalyzerSilence::Segment::Segment(SINT startFrame)
+        : m_framesProcessed(startFrame),
           m_signalStart(-1),
           m_signalEnd(-1) {
 }
@@ -45,17 +48,20 @@ bool AnalyzerSilence::initialize(const AnalyzerTrack& track,
     Q_UNUSED(sampleRate);
     Q_UNUSED(frameLength);
 
-    if (!shouldAnalyze(track.getTrack())) {
+    if (!shouldAnalyze(track.getTrack().get())) {
         return false;
     }
 
-    m_framesProcessed = 0;
-    m_signalStart = -1;
-    m_signalEnd = -1;
+    m_result = Segment();
 
     return true;
 }
 
+// static
+bool AnalyzerSilence::hasSoundPositions(const Track& track) {
+    return !shouldAnalyze(&track);
+}
+
 // static
 SINT AnalyzerSilence::findFirstSoundInChunk(std::span<const CSAMPLE> samples) {
     return std::distance(samples.begin(), first_sound(samples.begin(), samples.end()));
@@ -85,6 +91,32 @@ bool AnalyzerSilence::verifyFirstSound(
 }
 
 bool AnalyzerSilence::processSamples(const CSAMPLE* pIn, SINT count) {
+    return m_result.processSamples(pIn, count);
+}
+
+std::unique_ptr<AnalyzerSegment> AnalyzerSilence::createSegment(SINT startFrame) {
+    // The segments start at a chunk boundary and the results only
+    // depend on the chunks, i.e. they are the same as if the whole
+    // track is analyzed in order.
+    return std::make_unique<Segment>(startFrame);
+}
+
+bool AnalyzerSilence::mergeSegments(AnalyzerSegments segments) {
+    m_result = Segment();
+    for (const auto& pSegment : segments) {
+        const auto& segment = static_cast<const Segment&>(*pSegment);
+        if (m_result.m_signalStart < 0) {
+            m_result.m_signalStart = segment.m_signalStart;
+        }
+        if (segment.m_signalEnd >= 0) {
+            m_result.m_signalEnd = segment.m_signalEnd;
+        }
+        m_result.m_framesProcessed = segment.m_framesProcessed;
+    }
+    return true;
+}
+
+bool AnalyzerSilence::Segment::processSamples(const CSAMPLE* pIn, SINT count) {
     std::span<const CSAMPLE> samples = mixxx::spanutil::spanFromPtrLen(pIn, count);
     if (m_signalStart < 0) {
         const SINT firstSoundSample = findFirstSoundInChunk(samples);
@@ -107,16 +139,24 @@ void AnalyzerSilence::cleanup() {
 }
 
 void AnalyzerSilence::storeResults(TrackPointer pTrack) {
-    if (m_signalStart < 0) {
-        m_signalStart = 0;
+    if (m_result.m_signalStart < 0) {
+        m_result.m_signalStart = 0;
     }
-    if (m_signalEnd < 0) {
-        m_signalEnd = m_framesProcessed;
+    if (m_result.m_signalEnd < 0) {
+        m_result.m_signalEnd = m_result.m_framesProcessed;
     }
 
-    const auto firstSoundPosition = mixxx::audio::FramePos(m_signalStart);
-    const auto lastSoundPosition = mixxx::audio::FramePos(m_signalEnd);
+    storeSoundPositions(pTrack.get(),
+            mixxx::audio::FramePos(m_result.m_signalStart),
+            mixxx::audio::FramePos(m_result.m_signalEnd),
+            m_pConfig.data());
+}
 
+// static
+void AnalyzerSilence::storeSoundPositions(Track* pTrack,
+        mixxx::audio::FramePos firstSoundPosition,
+        mixxx::audio::FramePos lastSoundPosition,
+        UserSettings* pConfig) {
     CuePointer pN60dBSound = pTrack->findCueByType(mixxx::CueType::N60dBSound);
     if (pN60dBSound == nullptr) {
         pN60dBSound = pTrack->createAndAddCue(
@@ -133,8 +173,8 @@ void AnalyzerSilence::storeResults(TrackPointer pTrack) {
         pN60dBSound->setStartAndEndPosition(firstSoundPosition, lastSoundPosition);
     }
 
-    setupMainAndIntroCue(pTrack.get(), firstSoundPosition, m_pConfig.data());
-    setupOutroCue(pTrack.get(), lastSoundPosition);
+    setupMainAndIntroCue(pTrack, firstSoundPosition, pConfig);
+    setupOutroCue(pTrack, lastSoundPosition);
 }
 
 // static
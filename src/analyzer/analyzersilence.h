@@ -25,6 +25,8 @@ class AnalyzerSilence : public Analyzer {
             mixxx::audio::SampleRate sampleRate,
             SINT frameLength) override;
     bool processSamples(const CSAMPLE* pIn, SINT count) override;
+    std::unique_ptr<AnalyzerSegment> createSegment(SINT startFrame) override;
+    bool mergeSegments(AnalyzerSegments segments) override;
     void storeResults(TrackPointer pTrack) override;
     void cleanup() override;
 
@@ -33,6 +35,16 @@ class AnalyzerSilence : public Analyzer {
             UserSettings* pConfig);
     static void setupOutroCue(Track* pTrack, mixxx::audio::FramePos lastSoundPosition);
 
+    /// Returns true if the results of this analyzer are already present,
+    /// i.e. the N60dBSound, intro and outro cues.
+    static bool hasSoundPositions(const Track& track);
+    /// Stores the results of this analyzer, the positions of the first
+    /// and last sound above -60 dB, in the cues of the track.
+    static void storeSoundPositions(Track* pTrack,
+            mixxx::audio::FramePos firstSoundPosition,
+            mixxx::audio::FramePos lastSoundPosition,
+            UserSettings* pConfig);
+
     /// returns the index of the first sample in the buffer that is above -60 dB
     /// or samples.size() if no sample is found
     static SINT findFirstSoundInChunk(std::span<const CSAMPLE> samples);
@@ -50,8 +62,18 @@ class AnalyzerSilence : public Analyzer {
             mixxx::audio::ChannelCount channelCount);
 
   private:
+    /// The first and last sound in the samples that have been processed
+    class Segment : public AnalyzerSegment {
+      public:
+        explicit Segment(SINT startFrame = 0);
+
+        bool processSamples(const CSAMPLE* pIn, SINT count) override;
+
+        SINT m_framesProcessed;
+        SINT m_signalStart;
+        SINT m_signalEnd;
+    };
+
     UserSettingsPointer m_pConfig;
-    SINT m_framesProcessed;
-    SINT m_signalStart;
-    SINT m_signalEnd;
+    Segment m_result;
 };
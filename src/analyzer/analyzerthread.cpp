@@ -1,22 +1,27 @@
 #include "analyzer/analyzerthread.h"
 
+#include <algorithm>
 #include <mutex>
+#include <optional>
 
+#include "analyzer/analysisresultcache.h"
 #include "analyzer/analyzerbeats.h"
 #include "analyzer/analyzerebur128.h"
 #include "analyzer/analyzergain.h"
 #include "analyzer/analyzerkey.h"
+#include "analyzer/analyzerpipeline.h"
 #include "analyzer/analyzersilence.h"
 #include "analyzer/analyzerwaveform.h"
 #include "analyzer/constants.h"
-#include "library/dao/analysisdao.h"
 #include "moc_analyzerthread.cpp"
 #include "sources/audiosourcestereoproxy.h"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
+#include "util/backgroundthread.h"
 #include "util/db/dbconnectionpooled.h"
 #include "util/db/dbconnectionpooler.h"
 #include "util/logger.h"
+#include "util/sample.h"
 
 namespace {
 
@@ -34,6 +39,10 @@ mixxx::Logger kLogger("AnalyzerThread");
 // continuous feedback.
 const mixxx::Duration kBusyProgressInhibitDuration = mixxx::Duration::fromMillis(60);
 
+// Maximum time between progress updates and checking the stop flag
+// while waiting for the segments of a long track
+constexpr std::chrono::milliseconds kSegmentProgressInterval(100);
+
 void deleteAnalyzerThread(AnalyzerThread* plainPtr) {
     if (plainPtr) {
         plainPtr->deleteAfterFinished();
@@ -60,12 +69,16 @@ AnalyzerThread::Pointer AnalyzerThread::createInstance(
         int id,
         mixxx::DbConnectionPoolPtr dbConnectionPool,
         UserSettingsPointer pConfig,
-        AnalyzerModeFlags modeFlags) {
+        AnalyzerModeFlags modeFlags,
+        std::shared_ptr<AnalysisExecutor> pExecutor,
+        std::shared_ptr<AnalysisStats> pStats) {
     return Pointer(new AnalyzerThread(
                            id,
                            dbConnectionPool,
                            pConfig,
-                           modeFlags),
+                           modeFlags,
+                           std::move(pExecutor),
+                           std::move(pStats)),
             deleteAnalyzerThread);
 }
 
@@ -73,7 +86,9 @@ AnalyzerThread::AnalyzerThread(
         int id,
         mixxx::DbConnectionPoolPtr dbConnectionPool,
         UserSettingsPointer pConfig,
-        AnalyzerModeFlags modeFlags)
+        AnalyzerModeFlags modeFlags,
+        std::shared_ptr<AnalysisExecutor> pExecutor,
+        std::shared_ptr<AnalysisStats> pStats)
         : WorkerThread(
             QString("AnalyzerThread %1").arg(id),
             (modeFlags & AnalyzerModeFlags::LowPriority ? QThread::LowPriority : QThread::InheritPriority)),
@@ -81,40 +96,61 @@ AnalyzerThread::AnalyzerThread(
           m_dbConnectionPool(std::move(dbConnectionPool)),
           m_pConfig(pConfig),
           m_modeFlags(modeFlags),
+          m_pExecutor(std::move(pExecutor)),
+          m_pStats(std::move(pStats)),
           m_nextTrack(2), // minimum capacity
           m_sampleBuffer(mixxx::kAnalysisSamplesPerChunk),
+          m_monoSampleBuffer(mixxx::kAnalysisFramesPerChunk),
+          m_executorSlotAcquired(false),
           m_emittedState(AnalyzerThreadState::Void) {
     std::call_once(registerMetaTypesOnceFlag, registerMetaTypesOnce);
 }
 
 void AnalyzerThread::doRun() {
-    std::unique_ptr<AnalysisDao> pAnalysisDao;
+    if (m_modeFlags & AnalyzerModeFlags::LowPriority) {
+        // QThread::LowPriority has no effect for the default scheduling
+        // policy on Linux
+        mixxx::setCurrentThreadBackgroundScheduling();
+    }
+
     // The thread-local database connection  must not be closed
     // before returning from this function.
-    mixxx::DbConnectionPooler dbConnectionPooler;
+    mixxx::DbConnectionPooler dbConnectionPooler(m_dbConnectionPool);
+    // Cached results of tracks with the same audio content are
+    // optional, but the waveforms are stored in the database.
+    std::optional<AnalysisResultCache> analysisResultCache;
+    if (dbConnectionPooler.isPooling()) {
+        analysisResultCache.emplace(m_pConfig);
+        analysisResultCache->initialize(mixxx::DbConnectionPooled(m_dbConnectionPool));
+    }
 
     if (m_modeFlags & AnalyzerModeFlags::WithWaveform) {
-        dbConnectionPooler = mixxx::DbConnectionPooler(m_dbConnectionPool); // move assignment
         if (!dbConnectionPooler.isPooling()) {
             kLogger.warning()
                     << "Failed to obtain database connection for analyzer thread";
             return;
         }
         QSqlDatabase dbConnection = mixxx::DbConnectionPooled(m_dbConnectionPool);
-        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerWaveform>(m_pConfig, dbConnection)));
+        addAnalyzer(std::make_unique<AnalyzerWaveform>(m_pConfig, dbConnection),
+                QStringLiteral("Waveform"));
     }
     if (AnalyzerGain::isEnabled(ReplayGainSettings(m_pConfig))) {
-        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerGain>(m_pConfig)));
+        addAnalyzer(std::make_unique<AnalyzerGain>(m_pConfig),
+                QStringLiteral("ReplayGain"));
     }
     if (AnalyzerEbur128::isEnabled(ReplayGainSettings(m_pConfig))) {
-        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerEbur128>(m_pConfig)));
+        addAnalyzer(std::make_unique<AnalyzerEbur128>(m_pConfig),
+                QStringLiteral("EBU R128"));
     }
     // BPM detection might be disabled in the config, but can be overridden
     // and enabled by explicitly setting the mode flag.
     const bool enforceBpmDetection = (m_modeFlags & AnalyzerModeFlags::WithBeats) != 0;
-    m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerBeats>(m_pConfig, enforceBpmDetection)));
-    m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerKey>(m_pConfig)));
-    m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerSilence>(m_pConfig)));
+    addAnalyzer(std::make_unique<AnalyzerBeats>(m_pConfig, enforceBpmDetection),
+            QStringLiteral("Beats"));
+    addAnalyzer(std::make_unique<AnalyzerKey>(m_pConfig),
+            QStringLiteral("Key"));
+    addAnalyzer(std::make_unique<AnalyzerSilence>(m_pConfig),
+            QStringLiteral("Silence"));
     DEBUG_ASSERT(!m_analyzers.empty());
     kLogger.debug() << "Activated" << m_analyzers.size() << "analyzers";
 
@@ -127,16 +163,39 @@ void AnalyzerThread::doRun() {
         DEBUG_ASSERT(m_currentTrack.has_value());
         kLogger.debug() << "Analyzing" << m_currentTrack->getTrack()->getLocation();
 
+        // The audio thread might have migrated since the last track
+        mixxx::avoidAudioCallbackCpu();
+
+        // The analysis of a recording that is still written would only
+        // cover the part that has been written so far. The partial
+        // results would never be replaced. The track is analyzed when
+        // the recording has been finished, see RecordingManager.
+        if (SoundSourceProxy::isFileGrowing(m_currentTrack->getTrack()->getLocation())) {
+            kLogger.info()
+                    << "Deferring analysis of growing file"
+                    << m_currentTrack->getTrack()->getLocation();
+            if (m_pStats) {
+                m_pStats->addSkippedTrack();
+            }
+            emitDoneProgress(kAnalyzerProgressUnknown);
+            continue;
+        }
+
         // Get the audio
-        const mixxx::AudioSourcePointer audioSource =
+        mixxx::AudioSourcePointer audioSource =
                 SoundSourceProxy(m_currentTrack->getTrack()).openAudioSource(openParams);
         if (!audioSource) {
             kLogger.warning()
                     << "Failed to open file for analyzing:"
                     << m_currentTrack->getTrack()->getLocation();
+            if (m_pStats) {
+                m_pStats->addFailedTrack();
+            }
             emitDoneProgress(kAnalyzerProgressUnknown);
             continue;
         }
+        m_decodeCpuTime = mixxx::Duration::empty();
+        m_analyzerCpuTimes.assign(m_analyzers.size(), mixxx::Duration::empty());
 
         bool processTrack = false;
         for (auto&& analyzer : m_analyzers) {
@@ -149,8 +208,111 @@ void AnalyzerThread::doRun() {
             }
         }
 
+        // Decoding the excerpts for the fingerprint is only worth it if
+        // the results will be restored or stored afterwards, i.e. if
+        // at least one analyzer needs to process the track.
+        QString fingerprint;
+        if (processTrack && analysisResultCache) {
+            fingerprint = AnalysisResultCache::fingerprint(audioSource);
+            if (!fingerprint.isEmpty() &&
+                    m_currentTrack->getOptions().reuseCachedResults &&
+                    analysisResultCache->restoreResults(
+                            fingerprint, m_currentTrack->getTrack().get())) {
+                // Only the analyzers for results that could not be
+                // restored need to process the track
+                processTrack = false;
+                for (auto&& analyzer : m_analyzers) {
+                    if (!analyzer.isActive()) {
+                        continue;
+                    }
+                    analyzer.cancel();
+                    if (analyzer.initialize(
+                                *m_currentTrack,
+                                audioSource->getSignalInfo().getSampleRate(),
+                                audioSource->frameLength())) {
+                        processTrack = true;
+                    }
+                }
+            }
+        }
+
+        // Beat and key detection don't need the full bandwidth. The track
+        // is reopened at half of its sample rate only if these are the
+        // only active analyzers, i.e. if the waveforms, ReplayGain and
+        // silence have already been analyzed or are disabled, and only
+        // for decoders that natively decode at a reduced rate. Reopening
+        // is not worth it for all other decoders. The sound positions are
+        // always detected at the full rate, because CachingReaderWorker
+        // verifies the first sound sample-accurately when loading.
+        mixxx::AudioSource::OpenParams analysisOpenParams = openParams;
+        if (processTrack &&
+                audioSource->canDecodeAtReducedSampleRate() &&
+                std::all_of(m_analyzers.begin(),
+                        m_analyzers.end(),
+                        [](const AnalyzerWithState& analyzer) {
+                            return !analyzer.isActive() ||
+                                    analyzer.supportsReducedSampleRate();
+                        })) {
+            analysisOpenParams.setSampleRate(mixxx::audio::SampleRate(
+                    audioSource->getSignalInfo().getSampleRate() / 2));
+            auto reducedAudioSource =
+                    SoundSourceProxy(m_currentTrack->getTrack())
+                            .openAudioSource(analysisOpenParams);
+            if (reducedAudioSource &&
+                    reducedAudioSource->getSignalInfo().getSampleRate() <
+                            audioSource->getSignalInfo().getSampleRate()) {
+                kLogger.debug()
+                        << "Analyzing at a reduced sample rate of"
+                        << reducedAudioSource->getSignalInfo().getSampleRate();
+                audioSource = std::move(reducedAudioSource);
+                processTrack = false;
+                for (auto&& analyzer : m_analyzers) {
+                    if (!analyzer.isActive()) {
+                        continue;
+                    }
+                    analyzer.cancel();
+                    if (analyzer.initialize(
+                                *m_currentTrack,
+                                audioSource->getSignalInfo().getSampleRate(),
+                                audioSource->frameLength())) {
+                        processTrack = true;
+                    }
+                }
+            } else {
+                analysisOpenParams = openParams;
+            }
+        }
+
+        if (processTrack && !acquireExecutorSlot()) {
+            for (auto&& analyzer : m_analyzers) {
+                analyzer.cancel();
+            }
+            emitDoneProgress(kAnalyzerProgressUnknown);
+            continue;
+        }
+
         if (processTrack) {
-            const auto analysisResult = analyzeAudioSource(audioSource);
+            // The segments are started as tasks of the executor
+            std::optional<AnalyzerSegmentRunner> segmentRunner;
+            if ((m_modeFlags & AnalyzerModeFlags::Segmented) && m_pExecutor) {
+                segmentRunner.emplace(&m_analyzers,
+                        m_pExecutor.get(),
+                        m_currentTrack->getOptions().priority);
+                segmentRunner->start(audioSource->frameIndexRange(),
+                        audioSource->getSignalInfo().getSampleRate(),
+                        [this, &analysisOpenParams] {
+                            return SoundSourceProxy(m_currentTrack->getTrack())
+                                    .openAudioSource(analysisOpenParams);
+                        });
+            }
+            auto analysisResult = analyzeAudioSource(audioSource);
+            if (segmentRunner) {
+                if (analysisResult == AnalysisResult::Finished) {
+                    analysisResult = awaitSegments(&*segmentRunner);
+                }
+                // The segments must not be accessed while they are analyzed
+                segmentRunner->cancel();
+            }
             DEBUG_ASSERT(analysisResult != AnalysisResult::Pending);
             if (analysisResult == AnalysisResult::Finished) {
                 // The analysis has been finished, and is either complete without
@@ -161,8 +323,24 @@ void AnalyzerThread::doRun() {
                 // suddenly.
                 emitBusyProgress(kAnalyzerProgressFinalizing);
                 // This takes around 3 sec on a Atom Netbook
-                for (auto&& analyzer : m_analyzers) {
-                    analyzer.finish(*m_currentTrack);
+                for (std::size_t i = 0; i < m_analyzers.size(); ++i) {
+                    const auto cpuTime = m_pStats
+                            ? AnalysisStats::currentThreadCpuTime()
+                            : mixxx::Duration::empty();
+                    m_analyzers[i].finish(*m_currentTrack);
+                    if (m_pStats) {
+                        m_analyzerCpuTimes[i] +=
+                                AnalysisStats::currentThreadCpuTime() - cpuTime;
+                    }
+                }
+                if (analysisResultCache && !fingerprint.isEmpty()) {
+                    analysisResultCache->storeResults(
+                            fingerprint, *m_currentTrack->getTrack());
+                }
+                if (m_pStats) {
+                    reportStats(mixxx::Duration::fromSeconds(
+                            audioSource->frameLength() /
+                            audioSource->getSignalInfo().getSampleRate().toDouble()));
                 }
                 emitDoneProgress(kAnalyzerProgressDone);
             } else {
@@ -173,6 +351,9 @@ void AnalyzerThread::doRun() {
             }
         } else {
             kLogger.debug() << "Skipping track analysis because no analyzer initialized.";
+            if (m_pStats) {
+                m_pStats->addSkippedTrack();
+            }
             emitDoneProgress(kAnalyzerProgressDone);
         }
     }
@@ -227,13 +408,40 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
             audioSourceProxy.getSignalInfo().getChannelCount() ==
             mixxx::kAnalysisChannels);
 
+    if (std::none_of(m_analyzers.begin(),
+                m_analyzers.end(),
+                [](const AnalyzerWithState& analyzer) {
+                    return analyzer.isActive() && !analyzer.isSplit();
+                })) {
+        // All analyzers have been split into segments that are
+        // decoded separately
+        return AnalysisResult::Finished;
+    }
+
+    // In pipelined mode the analyzers process the decoded chunks
+    // concurrently while the next chunk is decoded
+    std::unique_ptr<AnalyzerPipeline> pPipeline;
+    if (m_modeFlags & AnalyzerModeFlags::Pipelined) {
+        pPipeline = std::make_unique<AnalyzerPipeline>(&m_analyzers);
+    }
+
     // Analysis starts now
     emitBusyProgress(kAnalyzerProgressNone);
 
+    // Adds the CPU time of this thread since the previous invocation
+    mixxx::Duration cpuTime;
+    const auto addCpuTime = [this, &cpuTime](mixxx::Duration* pCpuTime) {
+        if (m_pStats) {
+            const auto currentCpuTime = AnalysisStats::currentThreadCpuTime();
+            *pCpuTime += currentCpuTime - cpuTime;
+            cpuTime = currentCpuTime;
+        }
+    };
+
     mixxx::IndexRange remainingFrameRange = audioSource->frameIndexRange();
     while (!remainingFrameRange.empty()) {
         sleepWhileSuspended();
-        if (isStopping()) {
+        if (isStopping() || !yieldExecutorSlot()) {
             return AnalysisResult::Cancelled;
         }
 
@@ -246,13 +454,19 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
         DEBUG_ASSERT(!chunkFrameRange.empty());
 
         // Request the next chunk of audio data
+        if (m_pStats) {
+            cpuTime = AnalysisStats::currentThreadCpuTime();
+        }
         const auto readableSampleFrames =
                 audioSourceProxy.readSampleFrames(
                         mixxx::WritableSampleFrames(
                                 chunkFrameRange,
-                                mixxx::SampleBuffer::WritableSlice(m_sampleBuffer)));
+                                pPipeline ? pPipeline->nextChunk()
+                                          : mixxx::SampleBuffer::WritableSlice(
+                                                    m_sampleBuffer)));
         // The returned range fits into the requested range
         DEBUG_ASSERT(readableSampleFrames.frameIndexRange().isSubrangeOf(chunkFrameRange));
+        addCpuTime(&m_decodeCpuTime);
 
         // Sometimes the duration of the audio source is inaccurate and adjusted
         // while reading. We need to adjust all frame ranges to reflect this new
@@ -295,10 +509,24 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
 
         // 2nd: step: Analyze chunk of decoded audio data
         if (!readableSampleFrames.frameIndexRange().empty()) {
-            for (auto&& analyzer : m_analyzers) {
-                analyzer.processSamples(
+            if (pPipeline) {
+                pPipeline->publishChunk(
                         readableSampleFrames.readableData(),
                         readableSampleFrames.readableLength());
+            } else {
+                SampleUtil::mixMultichannelToMono(
+                        m_monoSampleBuffer.data(),
+                        readableSampleFrames.readableData(),
+                        readableSampleFrames.readableLength());
+                // The shared downmix is accounted to the decoding
+                addCpuTime(&m_decodeCpuTime);
+                for (std::size_t i = 0; i < m_analyzers.size(); ++i) {
+                    m_analyzers[i].processSamples(
+                            readableSampleFrames.readableData(),
+                            m_monoSampleBuffer.data(),
+                            readableSampleFrames.readableLength());
+                    addCpuTime(&m_analyzerCpuTimes[i]);
+                }
             }
         }
 
@@ -324,9 +552,84 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
         }
     }
 
+    if (pPipeline) {
+        pPipeline->wait();
+    }
+
     return AnalysisResult::Finished;
 }
 
+void AnalyzerThread::addAnalyzer(AnalyzerPtr analyzer, const QString& name) {
+    m_analyzers.push_back(AnalyzerWithState(std::move(analyzer)));
+    m_analyzerNames.push_back(name);
+}
+
+void AnalyzerThread::reportStats(mixxx::Duration audioDuration) {
+    DEBUG_ASSERT(m_pStats);
+    DEBUG_ASSERT(m_analyzerCpuTimes.size() == m_analyzerNames.size());
+    m_pStats->addDecodeCpuTime(m_decodeCpuTime);
+    for (std::size_t i = 0; i < m_analyzerNames.size(); ++i) {
+        m_pStats->addAnalyzerCpuTime(m_analyzerNames[i], m_analyzerCpuTimes[i]);
+    }
+    m_pStats->addFinishedTrack(audioDuration);
+}
+
+AnalyzerThread::AnalysisResult AnalyzerThread::awaitSegments(
+        AnalyzerSegmentRunner* pSegmentRunner) {
+    // Nothing is decoded on this thread while waiting. The slot would
+    // otherwise block the remaining segments if the executor is limited
+    // to a single analysis.
+    releaseExecutorSlot();
+    while (!pSegmentRunner->waitFor(kSegmentProgressInterval)) {
+        if (isStopping()) {
+            return AnalysisResult::Cancelled;
+        }
+        emitBusyProgress(math_min(kAnalyzerProgressFinalizing,
+                pSegmentRunner->progress() *
+                        (kAnalyzerProgressFinalizing - kAnalyzerProgressNone)));
+    }
+    return AnalysisResult::Finished;
+}
+
+bool AnalyzerThread::acquireExecutorSlot() {
+    DEBUG_ASSERT(m_currentTrack.has_value());
+    DEBUG_ASSERT(!m_executorSlotAcquired);
+    if (!m_pExecutor) {
+        return true;
+    }
+    if (!m_pExecutor->acquire(m_currentTrack->getOptions().priority,
+                [this] {
+                    return isStopping();
+                })) {
+        return false;
+    }
+    m_executorSlotAcquired = true;
+    return true;
+}
+
+void AnalyzerThread::releaseExecutorSlot() {
+    if (!m_executorSlotAcquired) {
+        return;
+    }
+    DEBUG_ASSERT(m_pExecutor);
+    DEBUG_ASSERT(m_currentTrack.has_value());
+    m_pExecutor->release(m_currentTrack->getOptions().priority);
+    m_executorSlotAcquired = false;
+}
+
+bool AnalyzerThread::yieldExecutorSlot() {
+    if (!m_executorSlotAcquired ||
+            !m_pExecutor->shouldYield(m_currentTrack->getOptions().priority)) {
+        return true;
+    }
+    kLogger.debug()
+            << "Pausing analysis of track"
+            << m_currentTrack->getTrack()->getId()
+            << "in favor of more important tracks";
+    releaseExecutorSlot();
+    return acquireExecutorSlot();
+}
+
 void AnalyzerThread::emitBusyProgress(AnalyzerProgress busyProgress) {
     DEBUG_ASSERT(m_currentTrack.has_value());
     if ((m_emittedState == AnalyzerThreadState::Busy) &&
@@ -344,6 +647,8 @@ void AnalyzerThread::emitBusyProgress(AnalyzerProgress busyProgress) {
 
 void AnalyzerThread::emitDoneProgress(AnalyzerProgress doneProgress) {
     DEBUG_ASSERT(m_currentTrack.has_value());
+    // Every analysis ends here, regardless of the result
+    releaseExecutorSlot();
     // Release all references of the track before emitting the signal
     // to ensure that the last reference is not dropped in this worker
     // thread that might trigger database actions! The TrackAnalysisScheduler
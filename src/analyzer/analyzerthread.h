@@ -1,10 +1,14 @@
 #pragma once
 
+#include <memory>
 #include <optional>
 #include <vector>
 
+#include "analyzer/analysisexecutor.h"
+#include "analyzer/analysisstats.h"
 #include "analyzer/analyzer.h"
 #include "analyzer/analyzerprogress.h"
+#include "analyzer/analyzersegmentrunner.h"
 #include "analyzer/analyzertrack.h"
 #include "preferences/usersettings.h"
 #include "rigtorp/SPSCQueue.h"
@@ -22,6 +26,13 @@ enum AnalyzerModeFlags {
     WithBeats = 0x01,
     WithWaveform = 0x02,
     LowPriority = 0x04,
+    // Decode once and run the analyzers concurrently on the global
+    // thread pool, see AnalyzerPipeline
+    Pipelined = 0x08,
+    // Split long tracks into segments that are analyzed concurrently
+    // by all analyzers that support it, see AnalyzerSegmentRunner.
+    // Requires an AnalysisExecutor that runs the segments.
+    Segmented = 0x10,
     All = WithBeats | WithWaveform,
 };
 
@@ -59,13 +70,17 @@ class AnalyzerThread : public WorkerThread {
             int id,
             mixxx::DbConnectionPoolPtr dbConnectionPool,
             UserSettingsPointer pConfig,
-            AnalyzerModeFlags modeFlags);
+            AnalyzerModeFlags modeFlags,
+            std::shared_ptr<AnalysisExecutor> pExecutor = nullptr,
+            std::shared_ptr<AnalysisStats> pStats = nullptr);
 
     /*private*/ AnalyzerThread(
             int id,
             mixxx::DbConnectionPoolPtr dbConnectionPool,
             UserSettingsPointer pConfig,
-            AnalyzerModeFlags modeFlags);
+            AnalyzerModeFlags modeFlags,
+            std::shared_ptr<AnalysisExecutor> pExecutor,
+            std::shared_ptr<AnalysisStats> pStats);
     ~AnalyzerThread() override = default;
 
     int id() const {
@@ -100,6 +115,10 @@ class AnalyzerThread : public WorkerThread {
     const mixxx::DbConnectionPoolPtr m_dbConnectionPool;
     const UserSettingsPointer m_pConfig;
     const AnalyzerModeFlags m_modeFlags;
+    // Optional, shared by all analyzer threads of the process
+    const std::shared_ptr<AnalysisExecutor> m_pExecutor;
+    // Optional, only needed for benchmarking
+    const std::shared_ptr<AnalysisStats> m_pStats;
 
     /////////////////////////////////////////////////////////////////////////
     // Thread-safe atomic values
@@ -117,11 +136,24 @@ class AnalyzerThread : public WorkerThread {
     // run() by the worker thread.
 
     std::vector<AnalyzerWithState> m_analyzers;
+    // The names of m_analyzers for the stats
+    std::vector<QString> m_analyzerNames;
+
+    // The CPU times of the current track, only measured if m_pStats
+    // is set. The analyzers are not measured in pipelined mode,
+    // because they are not running on this thread.
+    mixxx::Duration m_decodeCpuTime;
+    std::vector<mixxx::Duration> m_analyzerCpuTimes;
 
     mixxx::SampleBuffer m_sampleBuffer;
+    // The mono downmix of m_sampleBuffer that is shared by all analyzers
+    mixxx::SampleBuffer m_monoSampleBuffer;
 
     std::optional<AnalyzerTrack> m_currentTrack;
 
+    // Set while a slot of the executor is held for the current track
+    bool m_executorSlotAcquired;
+
     AnalyzerThreadState m_emittedState;
 
     PerformanceTimer m_lastBusyProgressEmittedTimer;
@@ -133,6 +165,20 @@ class AnalyzerThread : public WorkerThread {
     };
     AnalysisResult analyzeAudioSource(
             const mixxx::AudioSourcePointer& audioSource);
+    AnalysisResult awaitSegments(AnalyzerSegmentRunner* pSegmentRunner);
+
+    void addAnalyzer(AnalyzerPtr analyzer, const QString& name);
+    // Reports the CPU times of the finished current track to m_pStats
+    void reportStats(mixxx::Duration audioDuration);
+
+    // Blocks until the executor grants a slot for the current track.
+    // Returns false if the thread has been stopped while waiting.
+    bool acquireExecutorSlot();
+    // Releases the slot if one is held
+    void releaseExecutorSlot();
+    // Temporarily releases the slot while more important analyses are
+    // waiting. Returns false if the thread has been stopped meanwhile.
+    bool yieldExecutorSlot();
 
     // Blocks the worker thread until a next track becomes available
     TrackPointer receiveNextTrack();
@@ -7,9 +7,29 @@
 /// A scheduled not-null track with additional options for analysis.
 class AnalyzerTrack {
   public:
+    /// Determines the order in which tracks are analyzed and which
+    /// analysis yields to another, see AnalysisExecutor.
+    enum class Priority {
+        /// Batch analysis of the library
+        Batch = 0,
+        /// Tracks that have been prepared for playback, e.g. in a
+        /// playlist or crate
+        Prepared = 1,
+        /// A track that has just been loaded into a deck
+        Deck = 2,
+    };
+
     struct Options {
         /// If set, overrides whether the analysis should assume constant BPM.
         std::optional<bool> useFixedTempo;
+        Priority priority = Priority::Batch;
+        /// Restore missing results from tracks with the same audio
+        /// content instead of analyzing them, see AnalysisResultCache.
+        bool reuseCachedResults = true;
+        /// Publish provisional results, e.g. the beats and key of the
+        /// beginning of the track, while the analysis continues. Only
+        /// needed for tracks that are about to be played.
+        bool provisionalResults = false;
     };
 
     explicit AnalyzerTrack(TrackPointer track, Options options = Options());
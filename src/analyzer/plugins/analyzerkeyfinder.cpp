@@ -81,29 +81,53 @@ AnalyzerPluginInfo AnalyzerKeyFinder::pluginInfo() {
 
 bool AnalyzerKeyFinder::initialize(mixxx::audio::SampleRate sampleRate) {
     m_audioData.setFrameRate(sampleRate);
-    m_audioData.setChannels(kAnalysisChannels);
+    // KeyFinder analyzes a mono downmix. Downmixing the samples before
+    // passing them halves the size of the audio data that is copied for
+    // each chunk.
+    m_audioData.setChannels(1);
     return true;
 }
 
 bool AnalyzerKeyFinder::processSamples(const CSAMPLE* pIn, SINT iLen) {
     DEBUG_ASSERT(iLen % kAnalysisChannels == 0);
+    const SINT numInputFrames = iLen / kAnalysisChannels;
     if (m_audioData.getSampleCount() == 0) {
-        m_audioData.addToSampleCount(iLen);
+        m_audioData.addToSampleCount(numInputFrames);
+    }
+
+    for (SINT frame = 0; frame < numInputFrames; frame++) {
+        // Same as the shared downmix of the analyzer thread
+        m_audioData.setSampleByFrame(frame,
+                0,
+                (pIn[frame * kAnalysisChannels] +
+                        pIn[frame * kAnalysisChannels + 1]) *
+                        0.5f);
     }
+    processAudioData(numInputFrames);
+    return true;
+}
 
+bool AnalyzerKeyFinder::processSamplesWithDownmix(
+        const CSAMPLE* pIn, const CSAMPLE* pMonoIn, SINT iLen) {
+    Q_UNUSED(pIn);
+    DEBUG_ASSERT(iLen % kAnalysisChannels == 0);
     const SINT numInputFrames = iLen / kAnalysisChannels;
-    m_currentFrame += numInputFrames;
+    if (m_audioData.getSampleCount() == 0) {
+        m_audioData.addToSampleCount(numInputFrames);
+    }
 
     for (SINT frame = 0; frame < numInputFrames; frame++) {
-        for (SINT channel = 0; channel < kAnalysisChannels; channel++) {
-            m_audioData.setSampleByFrame(
-                    frame, channel, pIn[frame * kAnalysisChannels + channel]);
-        }
+        m_audioData.setSampleByFrame(frame, 0, pMonoIn[frame]);
     }
-    m_keyFinder.progressiveChromagram(m_audioData, m_workspace);
+    processAudioData(numInputFrames);
     return true;
 }
 
+void AnalyzerKeyFinder::processAudioData(SINT numInputFrames) {
+    m_currentFrame += numInputFrames;
+    m_keyFinder.progressiveChromagram(m_audioData, m_workspace);
+}
+
 bool AnalyzerKeyFinder::finalize() {
     m_keyFinder.finalChromagram(m_workspace);
     ChromaticKey finalKey = chromaticKeyFromKeyFinderKeyT(
@@ -19,6 +19,8 @@ class AnalyzerKeyFinder : public AnalyzerKeyPlugin {
 
     bool initialize(mixxx::audio::SampleRate sampleRate) override;
     bool processSamples(const CSAMPLE* pIn, SINT iLen) override;
+    bool processSamplesWithDownmix(
+            const CSAMPLE* pIn, const CSAMPLE* pMonoIn, SINT iLen) override;
     bool finalize() override;
 
     KeyChangeList getKeyChanges() const override {
@@ -26,6 +28,8 @@ class AnalyzerKeyFinder : public AnalyzerKeyPlugin {
     }
 
   private:
+    void processAudioData(SINT numInputFrames);
+
     KeyFinder::KeyFinder m_keyFinder;
     KeyFinder::Workspace m_workspace;
     KeyFinder::AudioData m_audioData;
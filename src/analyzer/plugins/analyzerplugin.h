@@ -62,6 +62,13 @@ class AnalyzerPlugin {
 
     virtual bool initialize(mixxx::audio::SampleRate sampleRate) = 0;
     virtual bool processSamples(const CSAMPLE* pIn, SINT iLen) = 0;
+    /// Receives the mono downmix of the analyzer thread that is shared
+    /// by all plugins, see Analyzer::processSamplesWithDownmix().
+    virtual bool processSamplesWithDownmix(
+            const CSAMPLE* pIn, const CSAMPLE* pMonoIn, SINT iLen) {
+        Q_UNUSED(pMonoIn);
+        return processSamples(pIn, iLen);
+    }
     virtual bool finalize() = 0;
 };
 
@@ -76,6 +83,13 @@ class AnalyzerBeatsPlugin : public AnalyzerPlugin {
     virtual QVector<mixxx::audio::FramePos> getBeats() const {
         return {};
     }
+    /// Calculates the beats of the samples that have been processed so
+    /// far while the analysis continues. Returns nothing if the beats are
+    /// only available after finalize(). This might be expensive and
+    /// should only be invoked occasionally.
+    virtual QVector<mixxx::audio::FramePos> calculateProvisionalBeats() const {
+        return {};
+    }
 };
 
 class AnalyzerKeyPlugin : public AnalyzerPlugin {
@@ -83,6 +97,12 @@ class AnalyzerKeyPlugin : public AnalyzerPlugin {
     ~AnalyzerKeyPlugin() override = default;
 
     virtual KeyChangeList getKeyChanges() const = 0;
+    /// Returns the key changes of the samples that have been processed
+    /// so far while the analysis continues. Returns nothing if the keys
+    /// are only available after finalize().
+    virtual KeyChangeList getProvisionalKeyChanges() const {
+        return {};
+    }
 };
 
 } // namespace mixxx
@@ -36,6 +36,46 @@ DFConfig makeDetectionFunctionConfig(int stepSizeFrames, int windowSize) {
     return config;
 }
 
+QVector<mixxx::audio::FramePos> calculateBeats(
+        const std::vector<double>& detectionResults,
+        mixxx::audio::SampleRate sampleRate,
+        int stepSizeFrames) {
+    int nonZeroCount = static_cast<int>(detectionResults.size());
+    while (nonZeroCount > 0 && detectionResults.at(nonZeroCount - 1) <= 0.0) {
+        --nonZeroCount;
+    }
+
+    std::vector<double> df;
+    std::vector<double> beatPeriod;
+    std::vector<double> tempi;
+    const auto required_size = std::max(0, nonZeroCount - 2);
+    df.reserve(required_size);
+    beatPeriod.reserve(required_size);
+
+    // skip first 2 results as it might have detect noise as onset
+    // that's how vamp does and seems works best this way
+    for (int i = 2; i < nonZeroCount; ++i) {
+        df.push_back(detectionResults.at(i));
+        beatPeriod.push_back(0.0);
+    }
+
+    TempoTrackV2 tt(sampleRate, stepSizeFrames);
+    tt.calculateBeatPeriod(df, beatPeriod, tempi);
+
+    std::vector<double> beats;
+    tt.calculateBeats(df, beatPeriod, beats);
+
+    QVector<mixxx::audio::FramePos> result;
+    result.reserve(static_cast<int>(beats.size()));
+    for (size_t i = 0; i < beats.size(); ++i) {
+        // we add the halve stepSizeFrames here, because the beat
+        // is detected between the two samples.
+        result.push_back(mixxx::audio::FramePos(
+                (beats.at(i) * stepSizeFrames) + stepSizeFrames / 2));
+    }
+    return result;
+}
+
 } // namespace
 
 AnalyzerQueenMaryBeats::AnalyzerQueenMaryBeats()
@@ -74,45 +114,28 @@ bool AnalyzerQueenMaryBeats::processSamples(const CSAMPLE* pIn, SINT iLen) {
     return m_helper.processStereoSamples(pIn, iLen);
 }
 
-bool AnalyzerQueenMaryBeats::finalize() {
-    m_helper.finalize();
-
-    int nonZeroCount = static_cast<int>(m_detectionResults.size());
-    while (nonZeroCount > 0 && m_detectionResults.at(nonZeroCount - 1) <= 0.0) {
-        --nonZeroCount;
-    }
-
-    std::vector<double> df;
-    std::vector<double> beatPeriod;
-    std::vector<double> tempi;
-    const auto required_size = std::max(0, nonZeroCount - 2);
-    df.reserve(required_size);
-    beatPeriod.reserve(required_size);
-
-    // skip first 2 results as it might have detect noise as onset
-    // that's how vamp does and seems works best this way
-    for (int i = 2; i < nonZeroCount; ++i) {
-        df.push_back(m_detectionResults.at(i));
-        beatPeriod.push_back(0.0);
+bool AnalyzerQueenMaryBeats::processSamplesWithDownmix(
+        const CSAMPLE* pIn, const CSAMPLE* pMonoIn, SINT iLen) {
+    Q_UNUSED(pIn);
+    DEBUG_ASSERT(iLen % kAnalysisChannels == 0);
+    if (!m_pDetectionFunction) {
+        return false;
     }
 
-    TempoTrackV2 tt(m_sampleRate, m_stepSizeFrames);
-    tt.calculateBeatPeriod(df, beatPeriod, tempi);
-
-    std::vector<double> beats;
-    tt.calculateBeats(df, beatPeriod, beats);
-
-    m_resultBeats.reserve(static_cast<int>(beats.size()));
-    for (size_t i = 0; i < beats.size(); ++i) {
-        // we add the halve m_stepSizeFrames here, because the beat
-        // is detected between the two samples.
-        const auto result = mixxx::audio::FramePos(
-                (beats.at(i) * m_stepSizeFrames) + m_stepSizeFrames / 2);
-        m_resultBeats.push_back(result);
-    }
+    return m_helper.processMonoSamples(pMonoIn, iLen / kAnalysisChannels);
+}
 
+bool AnalyzerQueenMaryBeats::finalize() {
+    m_helper.finalize();
+    m_resultBeats = calculateBeats(m_detectionResults, m_sampleRate, m_stepSizeFrames);
     m_pDetectionFunction.reset();
     return true;
 }
 
+QVector<mixxx::audio::FramePos> AnalyzerQueenMaryBeats::calculateProvisionalBeats() const {
+    // The samples that are still buffered by the helper are
+    // missing, which is negligible.
+    return calculateBeats(m_detectionResults, m_sampleRate, m_stepSizeFrames);
+}
+
 } // namespace mixxx
@@ -16,6 +16,11 @@ namespace {
 // Tuning frequency of concert A in Hertz. Default value from VAMP plugin.
 constexpr int kTuningFrequencyHertz = 440;
 
+// The chromagram covers pitches up to C7 (~2093 Hz) that must stay below
+// the Nyquist frequency of the decimated signal. The default decimation
+// factor only fits the common sample rates of 32 kHz and above.
+constexpr double kMinDecimatedSampleRate = 4000;
+
 } // namespace
 
 AnalyzerQueenMaryKey::AnalyzerQueenMaryKey()
@@ -52,6 +57,10 @@ bool AnalyzerQueenMaryKey::initialize(mixxx::audio::SampleRate sampleRate) {
     };
 
     GetKeyMode::Config config(sampleRate, kTuningFrequencyHertz);
+    while (config.decimationFactor > 2 &&
+            sampleRate.toDouble() / config.decimationFactor < kMinDecimatedSampleRate) {
+        config.decimationFactor /= 2;
+    }
     m_pKeyMode = std::make_unique<GetKeyMode>(config);
     size_t windowSize = m_pKeyMode->getBlockSize();
     size_t stepSize = m_pKeyMode->getHopSize();
@@ -87,6 +96,19 @@ bool AnalyzerQueenMaryKey::processSamples(const CSAMPLE* pIn, SINT iLen) {
     return m_helper.processStereoSamples(pIn, iLen);
 }
 
+bool AnalyzerQueenMaryKey::processSamplesWithDownmix(
+        const CSAMPLE* pIn, const CSAMPLE* pMonoIn, SINT iLen) {
+    Q_UNUSED(pIn);
+    DEBUG_ASSERT(iLen % kAnalysisChannels == 0);
+    if (!m_pKeyMode) {
+        return false;
+    }
+
+    const size_t numInputFrames = iLen / kAnalysisChannels;
+    m_currentFrame += numInputFrames;
+    return m_helper.processMonoSamples(pMonoIn, numInputFrames);
+}
+
 bool AnalyzerQueenMaryKey::finalize() {
     m_helper.finalize();
     m_pKeyMode.reset();
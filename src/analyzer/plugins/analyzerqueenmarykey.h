@@ -32,12 +32,18 @@ class AnalyzerQueenMaryKey : public AnalyzerKeyPlugin {
 
     bool initialize(mixxx::audio::SampleRate sampleRate) override;
     bool processSamples(const CSAMPLE* pIn, SINT iLen) override;
+    bool processSamplesWithDownmix(
+            const CSAMPLE* pIn, const CSAMPLE* pMonoIn, SINT iLen) override;
     bool finalize() override;
 
     KeyChangeList getKeyChanges() const override {
         return m_resultKeys;
     }
 
+    KeyChangeList getProvisionalKeyChanges() const override {
+        return m_resultKeys;
+    }
+
   private:
     std::unique_ptr<GetKeyMode> m_pKeyMode;
     DownmixAndOverlapHelper m_helper;
@@ -0,0 +1,29 @@
+#include "analyzer/provisionalresults.h"
+
+#include "util/assert.h"
+
+namespace {
+
+// The extra version info is appended to the sub-version as key=value
+// pairs separated by '|', see BeatFactory and KeyFactory
+const QString kProvisionalVersionInfoKey = QStringLiteral("provisional");
+const QString kProvisionalSubVersionFragment = QStringLiteral("provisional=1");
+
+} // anonymous namespace
+
+namespace mixxx {
+
+namespace provisionalresults {
+
+void markProvisional(QHash<QString, QString>* pExtraVersionInfo) {
+    DEBUG_ASSERT(pExtraVersionInfo);
+    pExtraVersionInfo->insert(kProvisionalVersionInfoKey, QStringLiteral("1"));
+}
+
+bool isProvisional(const QString& subVersion) {
+    return subVersion.split(QChar('|')).contains(kProvisionalSubVersionFragment);
+}
+
+} // namespace provisionalresults
+
+} // namespace mixxx
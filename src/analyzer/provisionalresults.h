@@ -0,0 +1,22 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+
+namespace mixxx {
+
+/// Provisional beats and keys are published while the analysis of a
+/// track that is about to be played continues, see
+/// AnalyzerTrack::Options::provisionalResults. They are marked by their
+/// sub-version and will be reanalyzed if the analysis didn't finish.
+namespace provisionalresults {
+
+/// Adds the marker to the extra version info of a provisional result
+void markProvisional(QHash<QString, QString>* pExtraVersionInfo);
+
+/// Checks if the sub-version of beats or keys contains the marker
+bool isProvisional(const QString& subVersion);
+
+} // namespace provisionalresults
+
+} // namespace mixxx
@@ -1,5 +1,7 @@
 #include "analyzer/trackanalysisscheduler.h"
 
+#include <iterator>
+
 #include "analyzer/analyzerscheduledtrack.h"
 #include "analyzer/analyzertrack.h"
 #include "moc_trackanalysisscheduler.cpp"
@@ -36,13 +38,17 @@ TrackAnalysisScheduler::Pointer TrackAnalysisScheduler::createInstance(
         int numWorkerThreads,
         const mixxx::DbConnectionPoolPtr& pDbConnectionPool,
         const UserSettingsPointer& pConfig,
-        AnalyzerModeFlags modeFlags) {
+        AnalyzerModeFlags modeFlags,
+        const std::shared_ptr<AnalysisExecutor>& pExecutor,
+        const std::shared_ptr<AnalysisStats>& pStats) {
     return Pointer(new TrackAnalysisScheduler(
                            std::move(pEnvironment),
                            numWorkerThreads,
                            pDbConnectionPool,
                            pConfig,
-                           modeFlags),
+                           modeFlags,
+                           pExecutor,
+                           pStats),
             deleteTrackAnalysisScheduler);
 }
 
@@ -51,7 +57,9 @@ TrackAnalysisScheduler::TrackAnalysisScheduler(
         int numWorkerThreads,
         const mixxx::DbConnectionPoolPtr& pDbConnectionPool,
         const UserSettingsPointer& pConfig,
-        AnalyzerModeFlags modeFlags)
+        AnalyzerModeFlags modeFlags,
+        const std::shared_ptr<AnalysisExecutor>& pExecutor,
+        const std::shared_ptr<AnalysisStats>& pStats)
         : m_pEnvironment(std::move(pEnvironment)),
           m_currentTrackProgress(kAnalyzerProgressUnknown),
           m_currentTrackNumber(0),
@@ -77,7 +85,9 @@ TrackAnalysisScheduler::TrackAnalysisScheduler(
                 threadId,
                 pDbConnectionPool,
                 pConfig,
-                modeFlags));
+                modeFlags,
+                pExecutor,
+                pStats));
         connect(m_workers.back().thread(),
                 &AnalyzerThread::progress,
                 this,
@@ -243,7 +253,15 @@ bool TrackAnalysisScheduler::scheduleTrack(AnalyzerScheduledTrack track) {
                 << track.getTrackId();
         return false;
     }
-    m_queuedTracks.push_back(track);
+    // Insert behind all tracks with the same or a higher priority. New
+    // tracks usually have the lowest priority and are simply appended.
+    const auto priority = track.getOptions().priority;
+    auto insertPos = m_queuedTracks.end();
+    while (insertPos != m_queuedTracks.begin() &&
+            std::prev(insertPos)->getOptions().priority < priority) {
+        --insertPos;
+    }
+    m_queuedTracks.insert(insertPos, std::move(track));
     // Don't wake up the suspended thread now to avoid race conditions
     // if multiple threads are added in a row by calling this function
     // multiple times. The caller is responsible to finish the scheduling
@@ -38,18 +38,23 @@ class TrackAnalysisScheduler : public QObject {
             int numWorkerThreads,
             const mixxx::DbConnectionPoolPtr& pDbConnectionPool,
             const UserSettingsPointer& pConfig,
-            AnalyzerModeFlags modeFlags);
+            AnalyzerModeFlags modeFlags,
+            const std::shared_ptr<AnalysisExecutor>& pExecutor = nullptr,
+            const std::shared_ptr<AnalysisStats>& pStats = nullptr);
 
     /*private*/ TrackAnalysisScheduler(
             std::unique_ptr<const TrackAnalysisSchedulerEnvironment> pEnvironment,
             int numWorkerThreads,
             const mixxx::DbConnectionPoolPtr& pDbConnectionPool,
             const UserSettingsPointer& pUserSettings,
-            AnalyzerModeFlags modeFlags);
+            AnalyzerModeFlags modeFlags,
+            const std::shared_ptr<AnalysisExecutor>& pExecutor,
+            const std::shared_ptr<AnalysisStats>& pStats);
     ~TrackAnalysisScheduler() override;
 
     // Schedule single or multiple tracks. After all tracks have been scheduled
-    // the caller must invoke resume() once.
+    // the caller must invoke resume() once. Tracks are dequeued by priority
+    // and in the order they have been scheduled.
     bool scheduleTrack(AnalyzerScheduledTrack track);
     int scheduleTracks(const QList<AnalyzerScheduledTrack>& tracks);
 
@@ -0,0 +1,430 @@
+#include "batchanalysis.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QSet>
+#include <QSqlQuery>
+#include <QTextStream>
+#include <QThread>
+#include <QTimer>
+
+#include "analyzer/analyzerebur128.h"
+#include "analyzer/analyzergain.h"
+#include "analyzer/analyzerscheduledtrack.h"
+#include "database/mixxxdb.h"
+#include "library/dao/analysisdao.h"
+#include "library/dao/trackschema.h"
+#include "library/queryutil.h"
+#include "library/trackcollection.h"
+#include "library/trackcollectionmanager.h"
+#include "library/trackset/crate/crate.h"
+#include "moc_batchanalysis.cpp"
+#include "preferences/beatdetectionsettings.h"
+#include "preferences/keydetectionsettings.h"
+#include "preferences/replaygainsettings.h"
+#include "preferences/settingsmanager.h"
+#include "sources/seekindexcache.h"
+#include "sources/soundsourceproxy.h"
+#include "track/track.h"
+#include "util/cmdlineargs.h"
+#include "util/db/dbconnectionpooled.h"
+#include "util/fileinfo.h"
+#include "util/logger.h"
+#include "util/logging.h"
+#include "util/math.h"
+
+namespace {
+
+const mixxx::Logger kLogger("BatchAnalysis");
+
+constexpr int kExitCodeSuccess = 0;
+constexpr int kExitCodeFailure = 1;
+
+const QString kTargetAll = QStringLiteral("all");
+const QString kTargetCratePrefix = QStringLiteral("crate:");
+
+const QString kAnalyzerBeats = QStringLiteral("beats");
+const QString kAnalyzerKey = QStringLiteral("key");
+const QString kAnalyzerReplayGain = QStringLiteral("replaygain");
+const QString kAnalyzerWaveform = QStringLiteral("waveform");
+
+// Progress is printed for overnight runs, but not too often
+constexpr qint64 kProgressIntervalMillis = 10000;
+
+class TrackAnalysisSchedulerEnvironmentImpl final : public TrackAnalysisSchedulerEnvironment {
+  public:
+    explicit TrackAnalysisSchedulerEnvironmentImpl(
+            const TrackCollectionManager* pTrackCollectionManager)
+            : m_pTrackCollectionManager(pTrackCollectionManager) {
+        DEBUG_ASSERT(m_pTrackCollectionManager);
+    }
+    ~TrackAnalysisSchedulerEnvironmentImpl() final = default;
+
+    TrackPointer loadTrackById(TrackId trackId) const final {
+        return m_pTrackCollectionManager->getTrackById(trackId);
+    }
+
+  private:
+    const TrackCollectionManager* const m_pTrackCollectionManager;
+};
+
+QString formatSeconds(mixxx::Duration duration) {
+    return QString::number(duration.toDoubleSeconds(), 'f', 1) + QStringLiteral(" s");
+}
+
+QString formatPercent(mixxx::Duration part, mixxx::Duration total) {
+    if (total.toDoubleSeconds() <= 0) {
+        return QStringLiteral("-");
+    }
+    return QString::number(100 * part.toDoubleSeconds() / total.toDoubleSeconds(), 'f', 1) +
+            QStringLiteral(" %");
+}
+
+} // anonymous namespace
+
+namespace mixxx {
+
+BatchAnalysis::BatchAnalysis(const CmdlineArgs& args)
+        : m_args(args),
+          m_pStats(std::make_shared<AnalysisStats>()),
+          m_pTrackAnalysisScheduler(TrackAnalysisScheduler::NullPointer()),
+          m_numWorkerThreads(0),
+          m_scheduledTracks(0) {
+}
+
+BatchAnalysis::~BatchAnalysis() {
+    finalize();
+}
+
+int BatchAnalysis::exec(QCoreApplication* pApp) {
+    if (!initialize()) {
+        return kExitCodeFailure;
+    }
+
+    AnalyzerModeFlags modeFlags = AnalyzerModeFlags::None;
+    if (!applyAnalyzers(&modeFlags)) {
+        return kExitCodeFailure;
+    }
+
+    QList<TrackId> trackIds;
+    if (!resolveTargets(&trackIds)) {
+        return kExitCodeFailure;
+    }
+    if (trackIds.isEmpty()) {
+        QTextStream(stdout) << "No tracks to analyze\n";
+        return kExitCodeSuccess;
+    }
+
+    AnalyzerTrack::Options options;
+    if (m_args.getReanalyze()) {
+        // Same as reanalyzing tracks in the GUI, see WTrackMenu
+        resetResults(trackIds, modeFlags);
+        options.reuseCachedResults = false;
+    }
+
+    m_numWorkerThreads = m_args.getAnalyzeThreads() > 0
+            ? m_args.getAnalyzeThreads()
+            : math_max(1, QThread::idealThreadCount());
+    // Neither LowPriority nor Pipelined: Nothing else is running and
+    // the decoding and the analyzers of a track should run on the same
+    // thread for measuring their CPU times. Multiple tracks are analyzed
+    // concurrently instead.
+    m_pTrackAnalysisScheduler = TrackAnalysisScheduler::createInstance(
+            std::make_unique<const TrackAnalysisSchedulerEnvironmentImpl>(
+                    m_pTrackCollectionManager.get()),
+            m_numWorkerThreads,
+            m_pDbConnectionPool,
+            m_pSettingsManager->settings(),
+            modeFlags,
+            nullptr,
+            m_pStats);
+    connect(m_pTrackAnalysisScheduler.get(),
+            &TrackAnalysisScheduler::progress,
+            this,
+            &BatchAnalysis::slotProgress);
+    connect(m_pTrackAnalysisScheduler.get(),
+            &TrackAnalysisScheduler::finished,
+            this,
+            &BatchAnalysis::slotFinished);
+
+    QList<AnalyzerScheduledTrack> tracks;
+    tracks.reserve(trackIds.size());
+    for (const auto& trackId : std::as_const(trackIds)) {
+        tracks.append(AnalyzerScheduledTrack(trackId, options));
+    }
+    m_scheduledTracks = m_pTrackAnalysisScheduler->scheduleTracks(tracks);
+    QTextStream(stdout)
+            << "Analyzing " << m_scheduledTracks << " tracks with "
+            << m_numWorkerThreads << " threads\n";
+
+    m_elapsedTimer.start();
+    m_progressTimer.start();
+    m_pTrackAnalysisScheduler->resume();
+    const int exitCode = pApp->exec();
+
+    printReport();
+    return exitCode;
+}
+
+bool BatchAnalysis::initialize() {
+    m_pSettingsManager = std::make_unique<SettingsManager>(m_args.getSettingsPath());
+    const UserSettingsPointer pConfig = m_pSettingsManager->settings();
+    Logging::initialize(
+            pConfig->getSettingsPath(),
+            m_args.getLogLevel(),
+            m_args.getLogFlushLevel(),
+            LogFlag::LogToFile);
+
+    if (!SoundSourceProxy::registerProviders()) {
+        kLogger.critical() << "Failed to register any SoundSource providers";
+        return false;
+    }
+    mixxx::SeekIndexCache::setDirectory(
+            QDir(pConfig->getSettingsPath()).filePath(QStringLiteral("seekindex")));
+
+    m_pDbConnectionPool = MixxxDb(pConfig).connectionPool();
+    if (!m_pDbConnectionPool) {
+        return false;
+    }
+    // Create a connection for the main thread
+    m_pDbConnectionPool->createThreadLocalConnection();
+    const QSqlDatabase dbConnection = DbConnectionPooled(m_pDbConnectionPool);
+    if (!dbConnection.isOpen()) {
+        kLogger.critical() << "Unable to establish a database connection";
+        return false;
+    }
+    if (!MixxxDb::initDatabaseSchema(dbConnection)) {
+        return false;
+    }
+
+    m_pTrackCollectionManager = std::make_unique<TrackCollectionManager>(
+            nullptr,
+            pConfig,
+            m_pDbConnectionPool);
+    return true;
+}
+
+bool BatchAnalysis::applyAnalyzers(AnalyzerModeFlags* pModeFlags) const {
+    const UserSettingsPointer pConfig = m_pSettingsManager->settings();
+    const QStringList& analyzers = m_args.getAnalyzers();
+    int modeFlags = AnalyzerModeFlags::None;
+    if (analyzers.isEmpty()) {
+        // Same as the batch analysis in the GUI, see AnalysisFeature
+        modeFlags |= AnalyzerModeFlags::WithBeats;
+        if (pConfig->getValue<bool>(
+                    ConfigKey("[Library]", "EnableWaveformGenerationWithAnalysis"),
+                    true)) {
+            modeFlags |= AnalyzerModeFlags::WithWaveform;
+        }
+        *pModeFlags = static_cast<AnalyzerModeFlags>(modeFlags);
+        return true;
+    }
+
+    for (const auto& analyzer : analyzers) {
+        const QString name = analyzer.trimmed().toLower();
+        if (name != kAnalyzerBeats && name != kAnalyzerKey &&
+                name != kAnalyzerReplayGain && name != kAnalyzerWaveform) {
+            QTextStream(stderr) << "Unknown analyzer: " << analyzer << "\n";
+            return false;
+        }
+    }
+    const auto contains = [&analyzers](const QString& name) {
+        for (const auto& analyzer : analyzers) {
+            if (analyzer.trimmed().toLower() == name) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // The settings are only modified in memory and never saved
+    BeatDetectionSettings(pConfig).setBpmDetectionEnabled(contains(kAnalyzerBeats));
+    if (contains(kAnalyzerBeats)) {
+        modeFlags |= AnalyzerModeFlags::WithBeats;
+    }
+    KeyDetectionSettings(pConfig).setKeyDetectionEnabled(contains(kAnalyzerKey));
+    ReplayGainSettings(pConfig).setReplayGainAnalyzerEnabled(contains(kAnalyzerReplayGain));
+    if (contains(kAnalyzerWaveform)) {
+        modeFlags |= AnalyzerModeFlags::WithWaveform;
+    }
+    *pModeFlags = static_cast<AnalyzerModeFlags>(modeFlags);
+    return true;
+}
+
+bool BatchAnalysis::resolveTargets(QList<TrackId>* pTrackIds) const {
+    TrackCollection* pTrackCollection = m_pTrackCollectionManager->internalCollection();
+    QSet<TrackId> resolvedTrackIds;
+    const auto addTrackIds = [pTrackIds, &resolvedTrackIds](const QList<TrackId>& trackIds) {
+        for (const auto& trackId : trackIds) {
+            if (trackId.isValid() && !resolvedTrackIds.contains(trackId)) {
+                resolvedTrackIds.insert(trackId);
+                pTrackIds->append(trackId);
+            }
+        }
+    };
+
+    for (const auto& target : m_args.getAnalyzeTargets()) {
+        if (target == kTargetAll) {
+            QSqlQuery query(pTrackCollection->database());
+            query.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE %3=0 ORDER BY %1")
+                                  .arg(LIBRARYTABLE_ID,
+                                          LIBRARY_TABLE,
+                                          LIBRARYTABLE_MIXXXDELETED));
+            if (!query.exec()) {
+                LOG_FAILED_QUERY(query);
+                return false;
+            }
+            QList<TrackId> trackIds;
+            while (query.next()) {
+                trackIds.append(TrackId(query.value(0)));
+            }
+            addTrackIds(trackIds);
+        } else if (target.startsWith(kTargetCratePrefix)) {
+            const QString crateName = target.mid(kTargetCratePrefix.size());
+            Crate crate;
+            if (!pTrackCollection->crates().readCrateByName(crateName, &crate)) {
+                QTextStream(stderr) << "Crate not found: " << crateName << "\n";
+                return false;
+            }
+            CrateTrackSelectResult crateTracks(
+                    pTrackCollection->crates().selectCrateTracksSorted(crate.getId()));
+            QList<TrackId> trackIds;
+            while (crateTracks.next()) {
+                trackIds.append(crateTracks.trackId());
+            }
+            addTrackIds(trackIds);
+        } else {
+            const QFileInfo fileInfo(target);
+            if (!fileInfo.exists()) {
+                QTextStream(stderr) << "File or directory not found: " << target << "\n";
+                return false;
+            }
+            QList<QString> locations;
+            if (fileInfo.isDir()) {
+                QDirIterator it(fileInfo.absoluteFilePath(),
+                        QDir::Files | QDir::NoDotAndDotDot,
+                        QDirIterator::Subdirectories);
+                while (it.hasNext()) {
+                    const QString location = it.next();
+                    if (SoundSourceProxy::isFileSupported(FileInfo(location))) {
+                        locations.append(location);
+                    }
+                }
+            } else {
+                locations.append(fileInfo.absoluteFilePath());
+            }
+            // Missing tracks are added to the library
+            addTrackIds(m_pTrackCollectionManager->resolveTrackIdsFromLocations(locations));
+        }
+    }
+    return true;
+}
+
+void BatchAnalysis::resetResults(
+        const QList<TrackId>& trackIds, AnalyzerModeFlags modeFlags) const {
+    // Otherwise the analyzers would skip all tracks that have already
+    // been analyzed
+    const UserSettingsPointer pConfig = m_pSettingsManager->settings();
+    const bool resetKeys = KeyDetectionSettings(pConfig).getKeyDetectionEnabled();
+    const ReplayGainSettings replayGainSettings(pConfig);
+    const bool resetReplayGain = AnalyzerGain::isEnabled(replayGainSettings) ||
+            AnalyzerEbur128::isEnabled(replayGainSettings);
+    QTextStream(stdout)
+            << "Resetting the analysis results of " << trackIds.size() << " tracks\n";
+    for (const auto& trackId : trackIds) {
+        const TrackPointer pTrack = m_pTrackCollectionManager->getTrackById(trackId);
+        if (!pTrack) {
+            continue;
+        }
+        if (modeFlags & AnalyzerModeFlags::WithBeats) {
+            // Fails for tracks with locked BPM, which are not analyzed
+            pTrack->trySetBeats(mixxx::BeatsPointer());
+        }
+        if (resetKeys) {
+            pTrack->resetKeys();
+        }
+        if (resetReplayGain) {
+            pTrack->setReplayGain(mixxx::ReplayGain());
+        }
+    }
+    if (modeFlags & AnalyzerModeFlags::WithWaveform) {
+        m_pTrackCollectionManager->internalCollection()->getAnalysisDAO().deleteAnalyses(
+                trackIds);
+    }
+}
+
+void BatchAnalysis::slotProgress(AnalyzerProgress currentTrackProgress,
+        int currentTrackNumber,
+        int totalTracksCount) {
+    Q_UNUSED(currentTrackProgress);
+    if (m_progressTimer.elapsed() < kProgressIntervalMillis) {
+        return;
+    }
+    m_progressTimer.restart();
+    QTextStream(stdout)
+            << "Analyzing track " << currentTrackNumber
+            << " of " << totalTracksCount << "\n";
+}
+
+void BatchAnalysis::slotFinished() {
+    // Let the event loop delete the scheduler before exiting
+    m_pTrackAnalysisScheduler.reset();
+    QTimer::singleShot(0, QCoreApplication::instance(), &QCoreApplication::quit);
+}
+
+void BatchAnalysis::printReport() const {
+    const auto elapsed = Duration::fromMillis(m_elapsedTimer.elapsed());
+    const auto stats = m_pStats->snapshot();
+
+    Duration analyzersCpuTime;
+    for (auto it = stats.analyzerCpuTimes.constBegin();
+            it != stats.analyzerCpuTimes.constEnd();
+            ++it) {
+        analyzersCpuTime += it.value();
+    }
+    const auto totalCpuTime = stats.decodeCpuTime + analyzersCpuTime;
+
+    QTextStream out(stdout);
+    out << "\n";
+    out << "Analyzed tracks:  " << stats.finishedTracks
+        << " (skipped: " << stats.skippedTracks
+        << ", failed: " << stats.failedTracks << ")\n";
+    out << "Worker threads:   " << m_numWorkerThreads << "\n";
+    out << "Elapsed time:     " << formatSeconds(elapsed) << "\n";
+    if (elapsed.toDoubleSeconds() > 0) {
+        out << "Throughput:       "
+            << QString::number(stats.finishedTracks / elapsed.toDoubleSeconds(), 'f', 2)
+            << " tracks/s, "
+            << QString::number(stats.audioDuration.toDoubleSeconds() /
+                               elapsed.toDoubleSeconds(),
+                       'f',
+                       1)
+            << "x realtime\n";
+    }
+    out << "CPU time:         " << formatSeconds(totalCpuTime) << "\n";
+    out << "  Decoding:       " << formatSeconds(stats.decodeCpuTime)
+        << " (" << formatPercent(stats.decodeCpuTime, totalCpuTime) << ")\n";
+    out << "  Analyzing:      " << formatSeconds(analyzersCpuTime)
+        << " (" << formatPercent(analyzersCpuTime, totalCpuTime) << ")\n";
+    for (auto it = stats.analyzerCpuTimes.constBegin();
+            it != stats.analyzerCpuTimes.constEnd();
+            ++it) {
+        out << "    " << it.key().leftJustified(14) << formatSeconds(it.value())
+            << " (" << formatPercent(it.value(), totalCpuTime) << ")\n";
+    }
+}
+
+void BatchAnalysis::finalize() {
+    m_pTrackAnalysisScheduler.reset();
+    // Save and release all analyzed tracks before closing the database
+    m_pTrackCollectionManager.reset();
+    if (m_pDbConnectionPool) {
+        m_pDbConnectionPool->destroyThreadLocalConnection();
+        m_pDbConnectionPool.reset();
+    }
+    m_pSettingsManager.reset();
+}
+
+} // namespace mixxx
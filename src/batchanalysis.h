@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <memory>
+
+#include "analyzer/analysisstats.h"
+#include "analyzer/trackanalysisscheduler.h"
+#include "track/trackid.h"
+#include "util/db/dbconnectionpool.h"
+
+class CmdlineArgs;
+class QCoreApplication;
+class SettingsManager;
+class TrackCollectionManager;
+
+namespace mixxx {
+
+/// Analyzes tracks of the library without starting the GUI, the engine
+/// or any sound and controller devices, see the --analyze command line
+/// option.
+///
+/// Intended for analyzing large libraries unattended and as a benchmark
+/// for the analysis. The results are stored in the library like after
+/// a batch analysis in the GUI. Tracks that have already been analyzed
+/// are skipped unless --reanalyze is given. The throughput and where
+/// the CPU time has been spent are reported when finished.
+class BatchAnalysis : public QObject {
+    Q_OBJECT
+
+  public:
+    explicit BatchAnalysis(const CmdlineArgs& args);
+    ~BatchAnalysis() override;
+
+    /// Runs the analysis until all tracks have been analyzed and
+    /// returns the exit code.
+    int exec(QCoreApplication* pApp);
+
+  private slots:
+    void slotProgress(AnalyzerProgress currentTrackProgress,
+            int currentTrackNumber,
+            int totalTracksCount);
+    void slotFinished();
+
+  private:
+    bool initialize();
+    bool applyAnalyzers(AnalyzerModeFlags* pModeFlags) const;
+    bool resolveTargets(QList<TrackId>* pTrackIds) const;
+    void resetResults(const QList<TrackId>& trackIds, AnalyzerModeFlags modeFlags) const;
+    void printReport() const;
+    void finalize();
+
+    const CmdlineArgs& m_args;
+
+    std::unique_ptr<SettingsManager> m_pSettingsManager;
+    DbConnectionPoolPtr m_pDbConnectionPool;
+    std::unique_ptr<TrackCollectionManager> m_pTrackCollectionManager;
+
+    std::shared_ptr<AnalysisStats> m_pStats;
+    TrackAnalysisScheduler::Pointer m_pTrackAnalysisScheduler;
+    int m_numWorkerThreads;
+    int m_scheduledTracks;
+
+    QElapsedTimer m_elapsedTimer;
+    QElapsedTimer m_progressTimer;
+};
+
+} // namespace mixxx
@@ -24,11 +24,14 @@
 #include "moc_coreservices.cpp"
 #include "preferences/dialog/dlgpreferences.h"
 #include "preferences/settingsmanager.h"
+#include "recording/recordingmanager.h"
 #ifdef __MODPLUG__
 #include "preferences/dialog/dlgprefmodplug.h"
 #endif
 #include "skin/skincontrols.h"
 #include "soundio/soundmanager.h"
+#include "sources/seekindexcache.h"
+#include "sources/soundsourcepool.h"
 #include "sources/soundsourceproxy.h"
 #include "util/clipboard.h"
 #include "util/db/dbconnectionpooled.h"
@@ -236,6 +239,8 @@ void CoreServices::initialize(QApplication* pApp) {
     UserSettingsPointer pConfig = m_pSettingsManager->settings();
 
     Sandbox::setPermissionsFilePath(QDir(pConfig->getSettingsPath()).filePath("sandbox.cfg"));
+    mixxx::SeekIndexCache::setDirectory(
+            QDir(pConfig->getSettingsPath()).filePath(QStringLiteral("seekindex")));
 
     QString resourcePath = pConfig->getResourcePath();
 
@@ -295,6 +300,10 @@ void CoreServices::initialize(QApplication* pApp) {
             m_pSoundManager.get(),
             m_pEffectsManager.get(),
             m_pEngine.get());
+    connect(m_pRecordingManager.get(),
+            &RecordingManager::recordingFinished,
+            m_pPlayerManager.get(),
+            &PlayerManager::slotAnalyzeFinishedRecording);
     // TODO: connect input not configured error dialog slots
     PlayerInfo::create();
 
@@ -626,6 +635,9 @@ void CoreServices::finalize() {
     qDebug() << t.elapsed(false).debugMillisWithUnit() << "detaching all track collections";
     CLEAR_AND_CHECK_DELETED(m_pTrackCollectionManager);
 
+    qDebug() << t.elapsed(false).debugMillisWithUnit() << "closing idle audio sources";
+    mixxx::SoundSourcePool::releaseAll();
+
     qDebug() << t.elapsed(false).debugMillisWithUnit() << "closing database connection(s)";
     m_pDbConnectionPool->destroyThreadLocalConnection();
     m_pDbConnectionPool.reset(); // should drop the last reference
@@ -15,17 +15,34 @@ static const QString kPitchParameterId = QStringLiteral("pitch");
 static const QString kRangeParameterId = QStringLiteral("range");
 static const QString kSemitonesModeParameterId = QStringLiteral("semitonesMode");
 static const QString kFormantPreservingParameterId = QStringLiteral("formantPreserving");
+static const QString kWorkerThreadParameterId = QStringLiteral("workerThread");
 } // anonymous namespace
 
-PitchShiftEffect::PitchShiftEffect()
-        : m_currentFormant(false) {
+PitchShiftEffect::PitchShiftEffect() {
+    // Effect processors are created in the main thread. The worker thread
+    // is idle until the first request is submitted.
+    m_worker.start(QThread::TimeCriticalPriority);
 }
 
 PitchShiftGroupState::PitchShiftGroupState(
         const mixxx::EngineParameters& engineParameters)
-        : EffectState(engineParameters) {
+        : EffectState(engineParameters),
+          m_formantPreserving(false),
+          m_workerResults(kWorkerBufferCount),
+          m_offloaded(false),
+          m_workerBuffersInFlight(0),
+          m_freeWorkerBufferCount(0),
+          m_workerGeneration(0),
+          m_workerBufferGenerations{},
+          m_resetWorkerStretcher(false),
+          m_groupDelayFrames(0) {
     initializeBuffer(engineParameters);
     audioParametersChanged(engineParameters);
+    for (int i = 0; i < kWorkerBufferCount; ++i) {
+        m_workerBuffers[i] = mixxx::SampleBuffer(
+                engineParameters.samplesPerBuffer());
+        releaseWorkerBuffer(i);
+    }
 }
 
 PitchShiftGroupState::~PitchShiftGroupState() {
@@ -52,6 +69,67 @@ void PitchShiftGroupState::audioParametersChanged(
     m_pRubberBand->setTimeRatio(1.0);
 };
 
+SINT PitchShiftGroupState::process(const CSAMPLE* pInput,
+        CSAMPLE* pOutput,
+        SINT frames,
+        double pitch,
+        bool formantPreserving) {
+    DEBUG_ASSERT(frames <= m_retrieveBuffer[0].size());
+
+    if (m_formantPreserving != formantPreserving) {
+        m_formantPreserving = formantPreserving;
+
+        m_pRubberBand->setFormantOption(m_formantPreserving
+                        ? RubberBand::RubberBandStretcher::
+                                  OptionFormantPreserved
+                        : RubberBand::RubberBandStretcher::
+                                  OptionFormantShifted);
+    }
+
+    m_pRubberBand->setPitchScale(pitch);
+
+    SampleUtil::deinterleaveBuffer(
+            m_retrieveBuffer[0].data(),
+            m_retrieveBuffer[1].data(),
+            pInput,
+            frames);
+
+    CSAMPLE* retrieveBuffers[2]{m_retrieveBuffer[0].data(),
+            m_retrieveBuffer[1].data()};
+    m_pRubberBand->process(
+            retrieveBuffers,
+            frames,
+            false);
+
+    SINT framesAvailable = m_pRubberBand->available();
+    SINT framesToRead = math_min(
+            framesAvailable,
+            frames);
+
+    SINT receivedFrames = m_pRubberBand->retrieve(
+            retrieveBuffers,
+            framesToRead);
+
+    SampleUtil::interleaveBuffer(pOutput,
+            m_retrieveBuffer[0].data(),
+            m_retrieveBuffer[1].data(),
+            receivedFrames);
+
+    return receivedFrames;
+}
+
+int PitchShiftGroupState::takeWorkerBuffer() {
+    if (m_freeWorkerBufferCount == 0) {
+        return -1;
+    }
+    return m_freeWorkerBuffers[--m_freeWorkerBufferCount];
+}
+
+void PitchShiftGroupState::releaseWorkerBuffer(int slot) {
+    DEBUG_ASSERT(m_freeWorkerBufferCount < kWorkerBufferCount);
+    m_freeWorkerBuffers[m_freeWorkerBufferCount++] = slot;
+}
+
 // static
 QString PitchShiftEffect::getId() {
     return QStringLiteral("org.mixxx.effects.pitchshift");
@@ -114,6 +192,19 @@ EffectManifestPointer PitchShiftEffect::getManifest() {
     formantPreserving->setUnitsHint(EffectManifestParameter::UnitsHint::Unknown);
     formantPreserving->setRange(0, 0, 1);
 
+    EffectManifestParameterPointer workerThread = pManifest->addParameter();
+    workerThread->setId(kWorkerThreadParameterId);
+    workerThread->setName(QObject::tr("Offload"));
+    workerThread->setShortName(QObject::tr("Offload"));
+    workerThread->setDescription(QObject::tr(
+            "Process the pitch shift on a separate thread, one audio buffer "
+            "ahead.\n"
+            "Reduces the load of the audio thread at the cost of one buffer "
+            "of latency, which is compensated for the dry signal"));
+    workerThread->setValueScaler(EffectManifestParameter::ValueScaler::Toggle);
+    workerThread->setUnitsHint(EffectManifestParameter::UnitsHint::Unknown);
+    workerThread->setRange(0, 0, 1);
+
     return pManifest;
 }
 
@@ -123,6 +214,7 @@ void PitchShiftEffect::loadEngineEffectParameters(
     m_pRangeParameter = parameters.value(kRangeParameterId);
     m_pSemitonesModeParameter = parameters.value(kSemitonesModeParameterId);
     m_pFormantPreservingParameter = parameters.value(kFormantPreservingParameterId);
+    m_pWorkerThreadParameter = parameters.value(kWorkerThreadParameterId);
 }
 
 void PitchShiftEffect::processChannel(
@@ -133,21 +225,9 @@ void PitchShiftEffect::processChannel(
         const EffectEnableState enableState,
         const GroupFeatureState& groupFeatures) {
     Q_UNUSED(groupFeatures);
-    Q_UNUSED(enableState);
 
     DEBUG_ASSERT(engineParameters.framesPerBuffer() <= pState->m_retrieveBuffer[0].size());
 
-    if (const bool formantPreserving = m_pFormantPreservingParameter->toBool();
-            m_currentFormant != formantPreserving) {
-        m_currentFormant = formantPreserving;
-
-        pState->m_pRubberBand->setFormantOption(m_currentFormant
-                        ? RubberBand::RubberBandStretcher::
-                                  OptionFormantPreserved
-                        : RubberBand::RubberBandStretcher::
-                                  OptionFormantShifted);
-    }
-
     // The range of the scale of the Pitch parameter is <-1.0, 1.0>
     // with the middle position 0.0. On the other hand, the range
     // of the scale of the Range parameter is <0.0, 2.0> with the middle
@@ -220,33 +300,122 @@ void PitchShiftEffect::processChannel(
     // a ratio of 2.0 would shift up by one octave, 0.5 down by one octave,
     // or 1.0 leaving the pitch unaffected.
     const double pitch = std::pow(2.0, pitchParameter);
+    const bool formantPreserving = m_pFormantPreservingParameter->toBool();
+
+    if (enableState == EffectEnableState::Enabling) {
+        // Discard the audio that was buffered before the effect has been
+        // disabled. Results of the worker that are still in flight belong
+        // to the previous generation.
+        ++pState->m_workerGeneration;
+        if (pState->m_offloaded) {
+            pState->m_resetWorkerStretcher = true;
+        } else {
+            pState->m_pRubberBand->reset();
+        }
+    }
 
-    pState->m_pRubberBand->setPitchScale(pitch);
-
-    SampleUtil::deinterleaveBuffer(
-            pState->m_retrieveBuffer[0].data(),
-            pState->m_retrieveBuffer[1].data(),
-            pInput,
-            engineParameters.framesPerBuffer());
+    bool offload = m_pWorkerThreadParameter->toBool() &&
+            engineParameters.samplesPerBuffer() <=
+                    pState->m_workerBuffers[0].size();
+    if (offload && !m_worker.isStarted()) {
+        // Process this buffer in the audio thread until the worker
+        // thread is running.
+        offload = false;
+    }
+    if (offload) {
+        pState->m_offloaded = true;
+        pState->m_groupDelayFrames = engineParameters.framesPerBuffer();
+        processOnWorker(pState,
+                pInput,
+                pOutput,
+                engineParameters,
+                pitch,
+                formantPreserving);
+        return;
+    }
+    pState->m_groupDelayFrames = 0;
+
+    if (pState->m_offloaded) {
+        // The stretcher can only be used again after the worker has
+        // finished all requests of this state.
+        int* pSlot;
+        while ((pSlot = pState->m_workerResults.front())) {
+            pState->releaseWorkerBuffer(*pSlot);
+            pState->m_workerResults.pop();
+            --pState->m_workerBuffersInFlight;
+        }
+        if (pState->m_workerBuffersInFlight > 0) {
+            SampleUtil::clear(pOutput, engineParameters.samplesPerBuffer());
+            return;
+        }
+        pState->m_offloaded = false;
+        if (pState->m_resetWorkerStretcher) {
+            pState->m_resetWorkerStretcher = false;
+            pState->m_pRubberBand->reset();
+        }
+    }
 
-    CSAMPLE* retrieveBuffers[2]{pState->m_retrieveBuffer[0].data(),
-            pState->m_retrieveBuffer[1].data()};
-    pState->m_pRubberBand->process(
-            retrieveBuffers,
+    pState->process(pInput,
+            pOutput,
             engineParameters.framesPerBuffer(),
-            false);
+            pitch,
+            formantPreserving);
+}
 
-    SINT framesAvailable = pState->m_pRubberBand->available();
-    SINT framesToRead = math_min(
-            framesAvailable,
-            engineParameters.framesPerBuffer());
+void PitchShiftEffect::processOnWorker(
+        PitchShiftGroupState* pState,
+        const CSAMPLE* pInput,
+        CSAMPLE* pOutput,
+        const mixxx::EngineParameters& engineParameters,
+        double pitch,
+        bool formantPreserving) {
+    // Collect the result of the previous buffer first, so the result of the
+    // buffer submitted below is never used in this callback. If the worker
+    // was late, two results are available now and the older one is dropped
+    // to keep the latency at exactly one buffer.
+    int resultSlot = -1;
+    int* pSlot;
+    while ((pSlot = pState->m_workerResults.front())) {
+        if (resultSlot >= 0) {
+            pState->releaseWorkerBuffer(resultSlot);
+        }
+        resultSlot = *pSlot;
+        pState->m_workerResults.pop();
+        --pState->m_workerBuffersInFlight;
+        if (pState->m_workerBufferGenerations[resultSlot] !=
+                pState->m_workerGeneration) {
+            // Submitted before the effect has been re-enabled
+            pState->releaseWorkerBuffer(resultSlot);
+            resultSlot = -1;
+        }
+    }
 
-    SINT receivedFrames = pState->m_pRubberBand->retrieve(
-            retrieveBuffers,
-            framesToRead);
+    const int requestSlot = pState->takeWorkerBuffer();
+    if (requestSlot >= 0) {
+        SampleUtil::copy(pState->m_workerBuffers[requestSlot].data(),
+                pInput,
+                engineParameters.samplesPerBuffer());
+        pState->m_workerBufferGenerations[requestSlot] = pState->m_workerGeneration;
+        if (m_worker.submit({pState,
+                    requestSlot,
+                    engineParameters.framesPerBuffer(),
+                    pitch,
+                    formantPreserving,
+                    pState->m_resetWorkerStretcher})) {
+            ++pState->m_workerBuffersInFlight;
+            pState->m_resetWorkerStretcher = false;
+        } else {
+            pState->releaseWorkerBuffer(requestSlot);
+        }
+    }
 
-    SampleUtil::interleaveBuffer(pOutput,
-            pState->m_retrieveBuffer[0].data(),
-            pState->m_retrieveBuffer[1].data(),
-            receivedFrames);
+    if (resultSlot >= 0) {
+        SampleUtil::copy(pOutput,
+                pState->m_workerBuffers[resultSlot].data(),
+                engineParameters.samplesPerBuffer());
+        pState->releaseWorkerBuffer(resultSlot);
+    } else {
+        // The worker did not finish in time or has just been enabled
+        SampleUtil::clear(pOutput, engineParameters.samplesPerBuffer());
+    }
 }
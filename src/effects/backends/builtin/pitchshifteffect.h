@@ -2,7 +2,9 @@
 
 #include <QMap>
 
+#include "effects/backends/builtin/pitchshiftworker.h"
 #include "effects/backends/effectprocessor.h"
+#include "rigtorp/SPSCQueue.h"
 #include "util/class.h"
 #include "util/samplebuffer.h"
 #include "util/types.h"
@@ -19,8 +21,44 @@ class PitchShiftGroupState : public EffectState {
     void initializeBuffer(const mixxx::EngineParameters& engineParameters);
     void audioParametersChanged(const mixxx::EngineParameters& engineParameters);
 
+    /// Shifts the pitch of the interleaved input and returns the number of
+    /// frames written to the output, which may be less than the number of
+    /// input frames while the stretcher is filling up. Input and output may
+    /// be the same buffer.
+    SINT process(const CSAMPLE* pInput,
+            CSAMPLE* pOutput,
+            SINT frames,
+            double pitch,
+            bool formantPreserving);
+
+    /// Returns a buffer that can be submitted to the PitchShiftWorker or -1
+    /// if all buffers are in use.
+    int takeWorkerBuffer();
+    void releaseWorkerBuffer(int slot);
+
     std::unique_ptr<RubberBand::RubberBandStretcher> m_pRubberBand;
     mixxx::SampleBuffer m_retrieveBuffer[2];
+    bool m_formantPreserving;
+
+    /// The number of buffers that circulate between the audio thread and the
+    /// PitchShiftWorker: one for the buffer being processed, one for a late
+    /// result and one spare.
+    static constexpr int kWorkerBufferCount = 3;
+    mixxx::SampleBuffer m_workerBuffers[kWorkerBufferCount];
+    rigtorp::SPSCQueue<int> m_workerResults;
+
+    /// The following members are only touched by the audio thread
+    bool m_offloaded;
+    int m_workerBuffersInFlight;
+    int m_freeWorkerBuffers[kWorkerBufferCount];
+    int m_freeWorkerBufferCount;
+    /// Results of requests that were submitted before the effect has been
+    /// re-enabled are stale and discarded.
+    int m_workerGeneration;
+    int m_workerBufferGenerations[kWorkerBufferCount];
+    bool m_resetWorkerStretcher;
+    /// One buffer of latency while offloaded
+    SINT m_groupDelayFrames;
 };
 
 class PitchShiftEffect final : public EffectProcessorImpl<PitchShiftGroupState> {
@@ -42,16 +80,32 @@ class PitchShiftEffect final : public EffectProcessorImpl<PitchShiftGroupState>
             const EffectEnableState enableState,
             const GroupFeatureState& groupFeatures) override;
 
+    /// Reports the additional buffer of latency while the stretcher of the
+    /// state runs on the worker thread.
+    SINT getChannelGroupDelayFrames(const PitchShiftGroupState& channelState) const override {
+        return channelState.m_groupDelayFrames;
+    }
+
   private:
     QString debugString() const {
         return getId();
     }
 
-    bool m_currentFormant;
+    void processOnWorker(
+            PitchShiftGroupState* pState,
+            const CSAMPLE* pInput,
+            CSAMPLE* pOutput,
+            const mixxx::EngineParameters& engineParameters,
+            double pitch,
+            bool formantPreserving);
+
     EngineEffectParameterPointer m_pPitchParameter;
     EngineEffectParameterPointer m_pRangeParameter;
     EngineEffectParameterPointer m_pSemitonesModeParameter;
     EngineEffectParameterPointer m_pFormantPreservingParameter;
+    EngineEffectParameterPointer m_pWorkerThreadParameter;
+
+    PitchShiftWorker m_worker;
 
     DISALLOW_COPY_AND_ASSIGN(PitchShiftEffect);
 };
@@ -0,0 +1,70 @@
+#include "effects/backends/builtin/pitchshiftworker.h"
+
+#include "effects/backends/builtin/pitchshifteffect.h"
+#include "engine/engine.h"
+#include "moc_pitchshiftworker.cpp"
+#include "util/assert.h"
+#include "util/sample.h"
+
+namespace {
+
+// Enough for every deck, sampler and auxiliary input being late once
+constexpr std::size_t kMaxRequests = 256;
+
+} // anonymous namespace
+
+PitchShiftWorker::PitchShiftWorker()
+        : m_requests(kMaxRequests),
+          m_bQuit(false),
+          m_bStarted(false) {
+}
+
+PitchShiftWorker::~PitchShiftWorker() {
+    m_bQuit.store(true);
+    m_semaRequests.release();
+    wait();
+}
+
+bool PitchShiftWorker::submit(const Request& request) {
+    if (!m_requests.try_push(request)) {
+        return false;
+    }
+    m_semaRequests.release();
+    return true;
+}
+
+void PitchShiftWorker::run() {
+    QThread::currentThread()->setObjectName(QStringLiteral("PitchShiftWorker"));
+    m_bStarted.store(true, std::memory_order_release);
+
+    while (true) {
+        m_semaRequests.acquire();
+        if (m_bQuit.load()) {
+            break;
+        }
+        const Request* pRequest = m_requests.front();
+        VERIFY_OR_DEBUG_ASSERT(pRequest) {
+            continue;
+        }
+        PitchShiftGroupState* pState = pRequest->pState;
+        if (pRequest->reset) {
+            pState->m_pRubberBand->reset();
+        }
+        CSAMPLE* pSamples = pState->m_workerBuffers[pRequest->slot].data();
+        const SINT receivedFrames = pState->process(pSamples,
+                pSamples,
+                pRequest->frames,
+                pRequest->pitch,
+                pRequest->formantPreserving);
+        // Not enough output yet while the stretcher is filling up
+        SampleUtil::clear(pSamples + receivedFrames * mixxx::kEngineChannelCount,
+                (pRequest->frames - receivedFrames) * mixxx::kEngineChannelCount);
+
+        const int slot = pRequest->slot;
+        m_requests.pop();
+        // The result queue has room for all buffers of the state
+        const bool pushed = pState->m_workerResults.try_push(slot);
+        DEBUG_ASSERT(pushed);
+        Q_UNUSED(pushed);
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QSemaphore>
+#include <QThread>
+#include <atomic>
+
+#include "rigtorp/SPSCQueue.h"
+#include "util/types.h"
+
+class PitchShiftGroupState;
+
+/// PitchShiftWorker runs the RubberBand stretchers of a PitchShiftEffect
+/// outside of the audio callback. The audio thread submits a buffer and
+/// collects the result one callback later, so the stretcher has a whole
+/// callback period for processing it.
+///
+/// Requests are handed over through a wait-free single producer, single
+/// consumer queue. The processed buffers are returned through the result
+/// queue of the PitchShiftGroupState they belong to. While a group state has
+/// requests in flight, its stretcher and buffers are owned by the worker.
+class PitchShiftWorker : public QThread {
+    Q_OBJECT
+  public:
+    struct Request {
+        PitchShiftGroupState* pState;
+        /// Index of the buffer in the PitchShiftGroupState, which contains
+        /// the input and receives the output.
+        int slot;
+        SINT frames;
+        double pitch;
+        bool formantPreserving;
+        /// Discard the audio that is buffered by the stretcher first
+        bool reset;
+    };
+
+    PitchShiftWorker();
+    ~PitchShiftWorker() override;
+
+    /// Returns true as soon as requests are processed. The thread must be
+    /// started outside of the audio thread, because creating a thread is
+    /// not real-time safe.
+    bool isStarted() const {
+        return m_bStarted.load(std::memory_order_acquire);
+    }
+
+    /// Called from the audio thread. Returns false if the request could
+    /// not be queued.
+    bool submit(const Request& request);
+
+  protected:
+    void run() override;
+
+  private:
+    rigtorp::SPSCQueue<Request> m_requests;
+    QSemaphore m_semaRequests;
+    std::atomic<bool> m_bQuit;
+    std::atomic<bool> m_bStarted;
+};
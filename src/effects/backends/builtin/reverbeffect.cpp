@@ -91,13 +91,15 @@ void ReverbEffect::processChannel(
     const auto damping = static_cast<sample_t>(m_pDampingParameter->value());
     const auto sendCurrent = static_cast<sample_t>(m_pSendParameter->value());
 
-    // Reinitialize the effect when turning it on to prevent replaying the old buffer
-    // from the last time the effect was enabled.
-    // Also, update the sample rate if it has changed.
-    if (enableState == EffectEnableState::Enabling ||
-            pState->sampleRate != engineParameters.sampleRate()) {
-        pState->reverb.init(engineParameters.sampleRate());
+    // The delay lines have been allocated for all sample rates, so neither
+    // of these allocates memory.
+    if (pState->sampleRate != engineParameters.sampleRate()) {
+        pState->reverb.setSampleRate(engineParameters.sampleRate());
         pState->sampleRate = engineParameters.sampleRate();
+    } else if (enableState == EffectEnableState::Enabling) {
+        // Clear the effect when turning it on to prevent replaying the old
+        // buffer from the last time the effect was enabled.
+        pState->reverb.clear();
     }
 
     pState->reverb.processBuffer(pInput,
@@ -7,6 +7,7 @@
 
 #include <QMap>
 
+#include "audio/types.h"
 #include "effects/backends/effectprocessor.h"
 #include "util/class.h"
 #include "util/types.h"
@@ -17,6 +18,11 @@ class ReverbGroupState : public EffectState {
             : EffectState(engineParameters),
               sampleRate(engineParameters.sampleRate()),
               sendPrevious(0) {
+        // Allocate the delay lines for all sample rates here, outside of
+        // the audio thread. Changing the sample rate in processChannel()
+        // only reuses the allocated memory.
+        reverb.allocate(mixxx::audio::SampleRate::kValueMax);
+        reverb.setSampleRate(sampleRate);
     }
     ~ReverbGroupState() override = default;
 
@@ -109,7 +109,8 @@ class EffectProcessor {
     /// on the sum of the delay value of every effect in the effect chain,
     /// the dry signal is delayed to overlap with the output wet signal
     /// after processing all effects in the effects chain.
-    virtual SINT getGroupDelayFrames() = 0;
+    virtual SINT getGroupDelayFrames(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle) = 0;
 };
 
 /// EffectProcessorImpl manages a separate EffectState for every combination of
@@ -144,10 +145,21 @@ class EffectProcessorImpl : public EffectProcessor {
 
     /// By default, the group delay for every effect is zero. The effect implementation
     /// can override this method and set actual number of frames for the effect delay.
-    virtual SINT getGroupDelayFrames() override {
+    virtual SINT getChannelGroupDelayFrames(const EffectSpecificState& channelState) const {
+        Q_UNUSED(channelState);
         return 0;
     }
 
+    SINT getGroupDelayFrames(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle) final {
+        const EffectSpecificState* pState =
+                m_channelStateMatrix[inputHandle][outputHandle].get();
+        if (!pState) {
+            return 0;
+        }
+        return getChannelGroupDelayFrames(*pState);
+    }
+
     void process(const ChannelHandle& inputHandle,
             const ChannelHandle& outputHandle,
             const CSAMPLE* pInput,
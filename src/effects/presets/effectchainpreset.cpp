@@ -1,5 +1,7 @@
 #include "effects/presets/effectchainpreset.h"
 
+#include <QDataStream>
+
 #include "effects/backends/effectmanifest.h"
 #include "effects/effectchain.h"
 #include "effects/presets/effectpreset.h"
@@ -102,3 +104,29 @@ const QDomElement EffectChainPreset::toXml(QDomDocument* doc) const {
 
 EffectChainPreset::~EffectChainPreset() {
 }
+
+QDataStream& operator<<(QDataStream& out, const EffectChainPreset& preset) {
+    out << preset.m_name
+        << static_cast<qint32>(preset.m_mixMode)
+        << preset.m_dSuper
+        << preset.m_readOnly
+        << static_cast<quint32>(preset.m_effectPresets.size());
+    for (const auto& pEffectPreset : preset.m_effectPresets) {
+        out << *pEffectPreset;
+    }
+    return out;
+}
+
+QDataStream& operator>>(QDataStream& in, EffectChainPreset& preset) {
+    qint32 mixMode;
+    quint32 effectCount;
+    in >> preset.m_name >> mixMode >> preset.m_dSuper >> preset.m_readOnly >> effectCount;
+    preset.m_mixMode = static_cast<EffectChainMixMode::Type>(mixMode);
+    preset.m_effectPresets.clear();
+    for (quint32 i = 0; i < effectCount && in.status() == QDataStream::Ok; ++i) {
+        auto pEffectPreset = EffectPresetPointer::create();
+        in >> *pEffectPreset;
+        preset.m_effectPresets.append(pEffectPreset);
+    }
+    return in;
+}
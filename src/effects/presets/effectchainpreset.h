@@ -5,6 +5,7 @@
 #include "effects/effectchainmixmode.h"
 
 class EffectChain;
+QT_FORWARD_DECLARE_CLASS(QDataStream);
 
 /// EffectChainPreset is a read-only snapshot of the state of an EffectChain
 /// that can be serialized to/deserialized from XML. It is used by
@@ -51,6 +52,9 @@ class EffectChainPreset {
     }
 
   private:
+    friend QDataStream& operator<<(QDataStream& out, const EffectChainPreset& preset);
+    friend QDataStream& operator>>(QDataStream& in, EffectChainPreset& preset);
+
     QString m_name;
     EffectChainMixMode::Type m_mixMode;
     double m_dSuper;
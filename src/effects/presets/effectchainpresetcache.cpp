@@ -0,0 +1,154 @@
+#include "effects/presets/effectchainpresetcache.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtDebug>
+
+#include "effects/presets/effectchainpreset.h"
+#include "util/assert.h"
+
+namespace {
+
+// "MXEC"
+constexpr quint32 kCacheMagic = 0x4D584543;
+// Version history:
+// 1 (Mixxx 2.5.0): initial version
+// Increment this whenever the serialization of EffectChainPreset,
+// EffectPreset or EffectParameterPreset changes.
+constexpr quint32 kCacheVersion = 1;
+
+constexpr auto kDataStreamVersion = QDataStream::Qt_5_15;
+
+qint64 lastModifiedMsecs(const QFileInfo& fileInfo) {
+    return fileInfo.lastModified().toMSecsSinceEpoch();
+}
+
+} // anonymous namespace
+
+EffectChainPresetCache::EffectChainPresetCache(const QString& cacheFilePath)
+        : m_cacheFilePath(cacheFilePath),
+          m_loaded(false),
+          m_dirty(false) {
+}
+
+void EffectChainPresetCache::load() {
+    DEBUG_ASSERT(!m_loaded);
+    m_loaded = true;
+
+    QFile file(m_cacheFilePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    const QByteArray data = file.readAll();
+    file.close();
+
+    QDataStream stream(data);
+    stream.setVersion(kDataStreamVersion);
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 entryCount = 0;
+    stream >> magic >> version >> entryCount;
+    if (stream.status() != QDataStream::Ok ||
+            magic != kCacheMagic ||
+            version != kCacheVersion) {
+        qInfo() << "Discarding outdated effect chain preset cache" << m_cacheFilePath;
+        m_dirty = true;
+        return;
+    }
+
+    QHash<QString, Entry> entries;
+    entries.reserve(entryCount);
+    for (quint32 i = 0; i < entryCount; ++i) {
+        QString fileName;
+        Entry entry;
+        stream >> fileName >> entry.fileSize >> entry.lastModifiedMsecs >> entry.presetData;
+        if (stream.status() != QDataStream::Ok) {
+            qWarning() << "Discarding corrupt effect chain preset cache" << m_cacheFilePath;
+            m_dirty = true;
+            return;
+        }
+        entries.insert(fileName, entry);
+    }
+    m_entries = std::move(entries);
+}
+
+EffectChainPresetPointer EffectChainPresetCache::getPreset(const QFileInfo& fileInfo) {
+    if (!m_loaded) {
+        load();
+    }
+    const QString fileName = fileInfo.fileName();
+    const auto it = m_entries.constFind(fileName);
+    if (it == m_entries.constEnd() ||
+            it->fileSize != fileInfo.size() ||
+            it->lastModifiedMsecs != lastModifiedMsecs(fileInfo)) {
+        return nullptr;
+    }
+
+    QDataStream stream(it->presetData);
+    stream.setVersion(kDataStreamVersion);
+    auto pPreset = EffectChainPresetPointer::create();
+    stream >> *pPreset;
+    if (stream.status() != QDataStream::Ok) {
+        qWarning() << "Failed to restore cached effect chain preset" << fileName;
+        return nullptr;
+    }
+    m_usedFileNames.insert(fileName);
+    return pPreset;
+}
+
+void EffectChainPresetCache::insertPreset(
+        const QFileInfo& fileInfo, const EffectChainPresetPointer& pPreset) {
+    VERIFY_OR_DEBUG_ASSERT(pPreset) {
+        return;
+    }
+    if (!m_loaded) {
+        load();
+    }
+    Entry entry{fileInfo.size(), lastModifiedMsecs(fileInfo), QByteArray()};
+    QDataStream stream(&entry.presetData, QIODevice::WriteOnly);
+    stream.setVersion(kDataStreamVersion);
+    stream << *pPreset;
+
+    const QString fileName = fileInfo.fileName();
+    m_entries.insert(fileName, entry);
+    m_usedFileNames.insert(fileName);
+    m_dirty = true;
+}
+
+void EffectChainPresetCache::save() {
+    if (!m_loaded) {
+        // Nothing has been requested, so the snapshot is still up to date
+        return;
+    }
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (m_usedFileNames.contains(it.key())) {
+            ++it;
+        } else {
+            it = m_entries.erase(it);
+            m_dirty = true;
+        }
+    }
+    if (!m_dirty) {
+        return;
+    }
+
+    QSaveFile file(m_cacheFilePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Could not save effect chain preset cache" << m_cacheFilePath;
+        return;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(kDataStreamVersion);
+    stream << kCacheMagic << kCacheVersion << static_cast<quint32>(m_entries.size());
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        stream << it.key() << it->fileSize << it->lastModifiedMsecs << it->presetData;
+    }
+    if (stream.status() != QDataStream::Ok || !file.commit()) {
+        qWarning() << "Could not write effect chain preset cache" << m_cacheFilePath;
+        return;
+    }
+    m_dirty = false;
+}
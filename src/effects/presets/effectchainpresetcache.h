@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QSet>
+#include <QString>
+
+#include "effects/defs.h"
+
+QT_FORWARD_DECLARE_CLASS(QFileInfo);
+
+/// EffectChainPresetCache keeps a binary snapshot of the chain presets parsed
+/// from the XML files in the "effects/chains" folder, so they don't need to be
+/// parsed with QDomDocument again on every start. The whole snapshot is read
+/// with a single read when it is first accessed.
+///
+/// The XML files remain the source of truth: a cached preset is only used as
+/// long as the size and the modification time of its file are unchanged.
+class EffectChainPresetCache {
+  public:
+    explicit EffectChainPresetCache(const QString& cacheFilePath);
+
+    /// Returns the cached preset for the file or nullptr if the file is not
+    /// cached or has been modified since it was cached.
+    EffectChainPresetPointer getPreset(const QFileInfo& fileInfo);
+    /// Stores the preset that has been parsed from the file.
+    void insertPreset(const QFileInfo& fileInfo, const EffectChainPresetPointer& pPreset);
+
+    /// Writes the snapshot if it has been modified. Entries for files that
+    /// have neither been requested nor inserted since the snapshot was loaded
+    /// belong to deleted or renamed files and are dropped.
+    void save();
+
+  private:
+    struct Entry {
+        qint64 fileSize;
+        qint64 lastModifiedMsecs;
+        QByteArray presetData;
+    };
+
+    void load();
+
+    const QString m_cacheFilePath;
+    bool m_loaded;
+    bool m_dirty;
+    QHash<QString, Entry> m_entries;
+    QSet<QString> m_usedFileNames;
+};
@@ -18,10 +18,18 @@
 
 namespace {
 const QString kEffectChainPresetDirectory = QStringLiteral("/effects/chains");
+const QString kEffectChainPresetCacheFile = QStringLiteral("/effects/chains.cache");
 const QString kXmlFileExtension = QStringLiteral(".xml");
 const QString kFolderDelimiter = QStringLiteral("/");
 
-EffectChainPresetPointer loadPresetFromFile(const QString& filePath) {
+EffectChainPresetPointer loadPresetFromFile(
+        const QString& filePath, EffectChainPresetCache* pCache) {
+    const QFileInfo fileInfo(filePath);
+    EffectChainPresetPointer pCachedPreset = pCache->getPreset(fileInfo);
+    if (pCachedPreset) {
+        return pCachedPreset;
+    }
+
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly)) {
         qWarning() << "Could not open chain preset file" << filePath;
@@ -35,6 +43,9 @@ EffectChainPresetPointer loadPresetFromFile(const QString& filePath) {
     }
     auto pEffectChainPreset = EffectChainPresetPointer::create(doc.documentElement());
     file.close();
+    if (!pEffectChainPreset->isEmpty()) {
+        pCache->insertPreset(fileInfo, pEffectChainPreset);
+    }
     return pEffectChainPreset;
 }
 
@@ -56,7 +67,8 @@ EffectChainPresetPointer createEmptyReadOnlyChainPreset() {
 EffectChainPresetManager::EffectChainPresetManager(UserSettingsPointer pConfig,
         EffectsBackendManagerPointer pBackendManager)
         : m_pConfig(pConfig),
-          m_pBackendManager(pBackendManager) {
+          m_pBackendManager(pBackendManager),
+          m_presetCache(pConfig->getSettingsPath() + kEffectChainPresetCacheFile) {
 }
 
 int EffectChainPresetManager::presetIndex(const QString& presetName) const {
@@ -530,7 +542,7 @@ void EffectChainPresetManager::importUserPresets() {
     const QStringList fileList = savedPresetsDir.entryList();
     for (const auto& filePath : fileList) {
         EffectChainPresetPointer pEffectChainPreset = loadPresetFromFile(
-                savedPresetsPath + kFolderDelimiter + filePath);
+                savedPresetsPath + kFolderDelimiter + filePath, &m_presetCache);
         if (pEffectChainPreset && !pEffectChainPreset->isEmpty()) {
             // Don't allow '---' because that's the name of the internal empty preset
             if (pEffectChainPreset->name() == kNoEffectString) {
@@ -562,7 +574,8 @@ void EffectChainPresetManager::importDefaultPresets() {
             }
         }
 
-        EffectChainPresetPointer pEffectChainPreset = loadPresetFromFile(copiedFileName);
+        EffectChainPresetPointer pEffectChainPreset =
+                loadPresetFromFile(copiedFileName, &m_presetCache);
         if (pEffectChainPreset && !pEffectChainPreset->isEmpty()) {
             m_effectChainPresets.insert(pEffectChainPreset->name(), pEffectChainPreset);
             m_effectChainPresetsSorted.append(pEffectChainPreset);
@@ -626,6 +639,7 @@ void EffectChainPresetManager::resetToDefaults() {
     importDefaultPresets();
     generateDefaultQuickEffectPresets();
     prependRemainingPresetsToLists();
+    m_presetCache.save();
 
     // Re-add the empty chain preset
     EffectChainPresetPointer pEmptyChainPreset = createEmptyReadOnlyChainPreset();
@@ -802,6 +816,7 @@ EffectsXmlData EffectChainPresetManager::readEffectsXml(
     }
 
     prependRemainingPresetsToLists();
+    m_presetCache.save();
 
     // Create the empty '---' chain preset on each start.
     // Its sole purpose is to eject the current QuickEffect chain presets via GUI.
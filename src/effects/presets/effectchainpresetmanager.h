@@ -4,6 +4,7 @@
 #include <QList>
 
 #include "effects/backends/effectsbackendmanager.h"
+#include "effects/presets/effectchainpresetcache.h"
 #include "preferences/usersettings.h"
 
 struct EffectsXmlData {
@@ -103,6 +104,8 @@ class EffectChainPresetManager : public QObject {
 
     UserSettingsPointer m_pConfig;
     EffectsBackendManagerPointer m_pBackendManager;
+
+    EffectChainPresetCache m_presetCache;
 };
 
 typedef QSharedPointer<EffectChainPresetManager> EffectChainPresetManagerPointer;
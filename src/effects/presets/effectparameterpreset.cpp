@@ -1,5 +1,7 @@
 #include "effects/presets/effectparameterpreset.h"
 
+#include <QDataStream>
+
 #include "effects/effectparameter.h"
 #include "effects/presets/effectxmlelements.h"
 #include "util/xml.h"
@@ -81,3 +83,20 @@ const QDomElement EffectParameterPreset::toXml(QDomDocument* doc) const {
 
 EffectParameterPreset::~EffectParameterPreset() {
 }
+
+QDataStream& operator<<(QDataStream& out, const EffectParameterPreset& preset) {
+    return out << preset.m_id
+               << preset.m_dValue
+               << static_cast<qint32>(preset.m_linkType)
+               << static_cast<qint32>(preset.m_linkInversion)
+               << preset.m_bHidden;
+}
+
+QDataStream& operator>>(QDataStream& in, EffectParameterPreset& preset) {
+    qint32 linkType;
+    qint32 linkInversion;
+    in >> preset.m_id >> preset.m_dValue >> linkType >> linkInversion >> preset.m_bHidden;
+    preset.m_linkType = static_cast<EffectManifestParameter::LinkType>(linkType);
+    preset.m_linkInversion = static_cast<EffectManifestParameter::LinkInversion>(linkInversion);
+    return in;
+}
@@ -5,6 +5,8 @@
 #include "effects/backends/effectmanifestparameter.h"
 #include "effects/defs.h"
 
+QT_FORWARD_DECLARE_CLASS(QDataStream);
+
 /// EffectParameterPreset is a read-only snapshot of the state of an effect
 /// parameter that can be serialized to/deserialized from XML. It is only used
 /// as a component of an EffectPreset; never on its own.
@@ -41,6 +43,9 @@ class EffectParameterPreset {
     }
 
   private:
+    friend QDataStream& operator<<(QDataStream& out, const EffectParameterPreset& preset);
+    friend QDataStream& operator>>(QDataStream& in, EffectParameterPreset& preset);
+
     double m_dValue;
     QString m_id;
     EffectManifestParameter::LinkType m_linkType;
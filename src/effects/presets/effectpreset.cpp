@@ -1,5 +1,6 @@
 #include "effects/presets/effectpreset.h"
 
+#include <QDataStream>
 #include <QHash>
 #include <functional>
 
@@ -127,3 +128,28 @@ void EffectPreset::updateParametersFrom(const EffectPreset& other) {
         }
     }
 }
+
+QDataStream& operator<<(QDataStream& out, const EffectPreset& preset) {
+    out << preset.m_id
+        << static_cast<qint32>(preset.m_backendType)
+        << preset.m_dMetaParameter
+        << static_cast<quint32>(preset.m_effectParameterPresets.size());
+    for (const auto& parameterPreset : preset.m_effectParameterPresets) {
+        out << parameterPreset;
+    }
+    return out;
+}
+
+QDataStream& operator>>(QDataStream& in, EffectPreset& preset) {
+    qint32 backendType;
+    quint32 parameterCount;
+    in >> preset.m_id >> backendType >> preset.m_dMetaParameter >> parameterCount;
+    preset.m_backendType = static_cast<EffectBackendType>(backendType);
+    preset.m_effectParameterPresets.clear();
+    for (quint32 i = 0; i < parameterCount && in.status() == QDataStream::Ok; ++i) {
+        EffectParameterPreset parameterPreset;
+        in >> parameterPreset;
+        preset.m_effectParameterPresets.append(parameterPreset);
+    }
+    return in;
+}
@@ -4,6 +4,8 @@
 #include "effects/defs.h"
 #include "effects/presets/effectparameterpreset.h"
 
+QT_FORWARD_DECLARE_CLASS(QDataStream);
+
 /// EffectPreset is a read-only snapshot of the state of an effect that can be
 /// serialized to/deserialized from XML. It is used by EffectChainPreset to
 /// save/load chain presets. It is also used by EffectPresetManager to save custom
@@ -47,6 +49,9 @@ class EffectPreset {
     void updateParametersFrom(const EffectPreset& preset);
 
   private:
+    friend QDataStream& operator<<(QDataStream& out, const EffectPreset& preset);
+    friend QDataStream& operator>>(QDataStream& in, EffectPreset& preset);
+
     QString m_id;
     EffectBackendType m_backendType;
     double m_dMetaParameter;
@@ -1,6 +1,7 @@
 #include "engine/cachingreader/cachingreader.h"
 
 #include <QtDebug>
+#include <limits>
 
 #include "moc_cachingreader.cpp"
 #include "util/assert.h"
@@ -35,6 +36,21 @@ constexpr SINT kDefaultHintFrames = 1024;
 // massive drop outs are expected to occur Mixxx should run reliably!
 constexpr SINT kNumberOfCachedChunksInMemory = 80;
 
+constexpr SINT kInvalidHintFrame = std::numeric_limits<SINT>::min();
+
+// Playing backwards moves the position by the frames of a single callback,
+// i.e. less than a chunk even with large buffers and fast rates. Larger
+// steps are jumps.
+constexpr SINT kMaxReverseStepFrames = CachingReaderChunk::kFrames;
+
+// The number of subsequent small backward steps before reading the
+// preceding chunks in advance
+constexpr int kMinReverseStepCount = 4;
+
+// Remapping a growing file for every audio callback would be wasted
+// effort
+constexpr auto kGrowthCheckInterval = mixxx::Duration::fromMillis(500);
+
 } // anonymous namespace
 
 CachingReader::CachingReader(const QString& group, UserSettingsPointer config)
@@ -54,9 +70,14 @@ CachingReader::CachingReader(const QString& group, UserSettingsPointer config)
           // the worker could get stuck in a hot loop!!!
           m_readerStatusUpdateFIFO(kNumberOfCachedChunksInMemory),
           m_state(STATE_IDLE),
+          m_previousPositionHintFrame(kInvalidHintFrame),
+          m_reverseStepCount(0),
           m_mruCachingReaderChunk(nullptr),
           m_lruCachingReaderChunk(nullptr),
           m_sampleBuffer(CachingReaderChunk::kSamples * kNumberOfCachedChunksInMemory),
+          m_trackGrowing(false),
+          m_trackGrown(false),
+          m_growthCheckPending(false),
           m_worker(group, &m_chunkReadRequestFIFO, &m_readerStatusUpdateFIFO) {
     m_allocatedCachingReaderChunks.reserve(kNumberOfCachedChunksInMemory);
     // Divide up the allocated raw memory buffer into total_chunks
@@ -270,7 +291,23 @@ void CachingReader::process() {
                 }
                 // Reset the readable frame index range
                 m_readableFrameIndexRange = update.readableFrameIndexRange();
+                m_previousPositionHintFrame = kInvalidHintFrame;
+                m_reverseStepCount = 0;
+                m_trackGrowing = false;
+                m_trackGrown = false;
+                m_growthCheckPending = false;
+                m_growthCheckTimer = PerformanceTimer();
                 m_state.storeRelease(STATE_TRACK_LOADED);
+            } else if (update.status == TRACK_GROWN ||
+                    update.status == TRACK_STOPPED_GROWING) {
+                m_growthCheckPending = false;
+                if (m_state.loadAcquire() != STATE_TRACK_LOADED) {
+                    // Response for the previous track
+                    continue;
+                }
+                m_trackGrowing = update.status == TRACK_GROWN;
+                m_trackGrown = true;
+                updateGrowingFrameIndexRange(update.readableFrameIndexRange());
             } else {
                 DEBUG_ASSERT(update.status == TRACK_UNLOADED);
                 // This message could be processed later when a new
@@ -286,6 +323,27 @@ void CachingReader::process() {
     }
 }
 
+void CachingReader::updateGrowingFrameIndexRange(
+        mixxx::IndexRange frameIndexRange) {
+    if (frameIndexRange.end() <= m_readableFrameIndexRange.end()) {
+        return;
+    }
+    if (!m_readableFrameIndexRange.empty()) {
+        // The last chunk has been read partially before and needs
+        // to be read again. All pending read requests for this chunk
+        // have been issued after the growth check and will already
+        // read the grown range.
+        auto* pChunk = lookupChunk(CachingReaderChunk::indexForFrame(
+                m_readableFrameIndexRange.end() - 1));
+        if (pChunk && pChunk->getState() == CachingReaderChunkForOwner::READY) {
+            freeChunk(pChunk);
+        }
+    }
+    m_readableFrameIndexRange = mixxx::IndexRange::between(
+            m_readableFrameIndexRange.start(),
+            frameIndexRange.end());
+}
+
 CachingReader::ReadResult CachingReader::read(SINT startSample,
         SINT numSamples,
         bool reverse,
@@ -532,6 +590,18 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
     // any are not, then wake.
     bool shouldWake = false;
 
+    if (m_trackGrowing && !m_growthCheckPending &&
+            (!m_growthCheckTimer.running() ||
+                    m_growthCheckTimer.elapsed() >= kGrowthCheckInterval)) {
+        CachingReaderChunkReadRequest request;
+        request.checkGrowth();
+        if (m_chunkReadRequestFIFO.write(&request, 1) == 1) {
+            m_growthCheckPending = true;
+            m_growthCheckTimer.start();
+            shouldWake = true;
+        }
+    }
+
     for (const auto& hint: hintList) {
         SINT hintFrame = hint.frame;
         SINT hintFrameCount = hint.frameCount;
@@ -556,6 +626,24 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
             continue;
         }
 
+        bool readReverseWindow = false;
+        if (hint.type == Hint::Type::CurrentPosition) {
+            // Detect the direction of playback from subsequent hints. The
+            // position is unchanged while paused and then keeps the most
+            // recent direction.
+            if (m_previousPositionHintFrame != kInvalidHintFrame &&
+                    hintFrame != m_previousPositionHintFrame) {
+                const SINT backwardFrames = m_previousPositionHintFrame - hintFrame;
+                if (backwardFrames > 0 && backwardFrames <= kMaxReverseStepFrames) {
+                    ++m_reverseStepCount;
+                } else {
+                    m_reverseStepCount = 0;
+                }
+            }
+            m_previousPositionHintFrame = hintFrame;
+            readReverseWindow = m_reverseStepCount >= kMinReverseStepCount;
+        }
+
         const auto readableFrameIndexRange = intersect(
                 m_readableFrameIndexRange,
                 mixxx::IndexRange::forward(hintFrame, hintFrameCount));
@@ -563,41 +651,36 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
             continue;
         }
 
-        const int firstChunkIndex = CachingReaderChunk::indexForFrame(readableFrameIndexRange.start());
-        const int lastChunkIndex = CachingReaderChunk::indexForFrame(readableFrameIndexRange.end() - 1);
-        for (int chunkIndex = firstChunkIndex; chunkIndex <= lastChunkIndex; ++chunkIndex) {
-            CachingReaderChunkForOwner* pChunk = lookupChunk(chunkIndex);
-            if (!pChunk) {
-                shouldWake = true;
-                pChunk = allocateChunkExpireLRU(chunkIndex);
-                if (!pChunk) {
-                    kLogger.warning()
-                            << "Failed to allocate chunk"
-                            << chunkIndex
-                            << "for read request";
-                    continue;
+        const SINT firstChunkIndex = CachingReaderChunk::indexForFrame(
+                readableFrameIndexRange.start());
+        const SINT lastChunkIndex = CachingReaderChunk::indexForFrame(
+                readableFrameIndexRange.end() - 1);
+        if (!readReverseWindow) {
+            for (SINT chunkIndex = firstChunkIndex; chunkIndex <= lastChunkIndex; ++chunkIndex) {
+                if (hintChunk(chunkIndex)) {
+                    shouldWake = true;
                 }
-                // Do not insert the allocated chunk into the MRU/LRU list,
-                // because it will be handed over to the worker immediately
-                CachingReaderChunkReadRequest request;
-                request.giveToWorker(pChunk);
-                if (kLogger.traceEnabled()) {
-                    kLogger.trace()
-                            << "Requesting read of chunk"
-                            << request.chunk;
-                }
-                if (m_chunkReadRequestFIFO.write(&request, 1) != 1) {
-                    kLogger.warning()
-                            << "Failed to submit read request for chunk"
-                            << chunkIndex;
-                    // Revoke the chunk from the worker and free it
-                    pChunk->takeFromWorker();
-                    freeChunk(pChunk);
-                }
-            } else if (pChunk->getState() == CachingReaderChunkForOwner::READY) {
-                // This will cause the chunk to be 'freshened' in the cache. The
-                // chunk will be moved to the end of the LRU list.
-                freshenChunk(pChunk);
+            }
+            continue;
+        }
+        // The hinted range precedes the position while playing backwards.
+        // The chunk under the position is needed first.
+        SINT firstWindowChunkIndex = firstChunkIndex;
+        if (!lookupChunk(firstChunkIndex)) {
+            // Request all preceding chunks of the window at once. They are
+            // submitted in ascending order and the worker decodes them in
+            // a single forward pass.
+            const auto windowChunkIndexRange = CachingReaderChunk::reverseReadWindow(
+                    firstChunkIndex,
+                    CachingReaderChunk::indexForFrame(m_readableFrameIndexRange.start()));
+            firstWindowChunkIndex = windowChunkIndexRange.start();
+        }
+        if (hintChunk(lastChunkIndex)) {
+            shouldWake = true;
+        }
+        for (SINT chunkIndex = firstWindowChunkIndex; chunkIndex < lastChunkIndex; ++chunkIndex) {
+            if (hintChunk(chunkIndex)) {
+                shouldWake = true;
             }
         }
     }
@@ -607,3 +690,41 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
         m_worker.workReady();
     }
 }
+
+bool CachingReader::hintChunk(SINT chunkIndex) {
+    CachingReaderChunkForOwner* pChunk = lookupChunk(chunkIndex);
+    if (pChunk) {
+        if (pChunk->getState() == CachingReaderChunkForOwner::READY) {
+            // This will cause the chunk to be 'freshened' in the cache. The
+            // chunk will be moved to the end of the LRU list.
+            freshenChunk(pChunk);
+        }
+        return false;
+    }
+    pChunk = allocateChunkExpireLRU(chunkIndex);
+    if (!pChunk) {
+        kLogger.warning()
+                << "Failed to allocate chunk"
+                << chunkIndex
+                << "for read request";
+        return true;
+    }
+    // Do not insert the allocated chunk into the MRU/LRU list,
+    // because it will be handed over to the worker immediately
+    CachingReaderChunkReadRequest request;
+    request.giveToWorker(pChunk);
+    if (kLogger.traceEnabled()) {
+        kLogger.trace()
+                << "Requesting read of chunk"
+                << request.chunk;
+    }
+    if (m_chunkReadRequestFIFO.write(&request, 1) != 1) {
+        kLogger.warning()
+                << "Failed to submit read request for chunk"
+                << chunkIndex;
+        // Revoke the chunk from the worker and free it
+        pChunk->takeFromWorker();
+        freeChunk(pChunk);
+    }
+    return true;
+}
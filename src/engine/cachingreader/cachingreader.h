@@ -11,6 +11,7 @@
 #include "preferences/usersettings.h"
 #include "track/track_decl.h"
 #include "util/fifo.h"
+#include "util/performancetimer.h"
 #include "util/types.h"
 
 // A Hint is an indication to the CachingReader that a certain section of a
@@ -112,6 +113,15 @@ class CachingReader : public QObject {
     // from the engine callback.
     void hintAndMaybeWake(const HintVector& hintList);
 
+    // The readable frame index range if the file of the track was
+    // still being written when loading it, e.g. a recording. It keeps
+    // the final range after the file has been finished. Returns an empty
+    // range for all other tracks. Must only be called from the engine
+    // callback.
+    mixxx::IndexRange growingFrameIndexRange() const {
+        return m_trackGrown ? m_readableFrameIndexRange : mixxx::IndexRange();
+    }
+
     // Request that the CachingReader load a new track. These requests are
     // processed in the work thread, so the reader must be woken up via wake()
     // for this to take effect.
@@ -131,6 +141,8 @@ class CachingReader : public QObject {
     void trackLoadFailed(TrackPointer pTrack, const QString& reason);
 
   private:
+    friend class CachingReaderTest;
+
     const UserSettingsPointer m_pConfig;
 
     // Thread-safe FIFOs for communication between the engine callback and
@@ -163,6 +175,10 @@ class CachingReader : public QObject {
     // Gets a chunk from the free list, frees the LRU CachingReaderChunk if none available.
     CachingReaderChunkForOwner* allocateChunkExpireLRU(SINT chunkIndex);
 
+    // Requests a read of the chunk if it is not in the cache or freshens it
+    // otherwise. Returns true if the worker needs to be woken up.
+    bool hintChunk(SINT chunkIndex);
+
     enum State {
         STATE_IDLE,
         STATE_TRACK_LOADING,
@@ -171,6 +187,14 @@ class CachingReader : public QObject {
     };
     QAtomicInt m_state;
 
+    // The frame of the previous hint for the current position and the
+    // number of subsequent small backward steps between these hints.
+    // Playing backwards is only detected after several of these steps,
+    // i.e. not after a single jump, e.g. a seek or a loop. Only accessed
+    // from the engine thread.
+    SINT m_previousPositionHintFrame;
+    int m_reverseStepCount;
+
     // Keeps track of all CachingReaderChunks we've allocated.
     QVector<CachingReaderChunkForOwner*> m_chunks;
 
@@ -192,5 +216,17 @@ class CachingReader : public QObject {
     // The readable frame index range as reported by the worker.
     mixxx::IndexRange m_readableFrameIndexRange;
 
+    // The readable frame index range of a growing file is extended
+    // by the responses to growth checks. Only a single check is
+    // pending at a time and the checks are rate-limited. No more checks
+    // are requested after the worker reported that the file has been
+    // finished. Only accessed from the engine thread.
+    bool m_trackGrowing;
+    bool m_trackGrown;
+    bool m_growthCheckPending;
+    PerformanceTimer m_growthCheckTimer;
+
+    void updateGrowingFrameIndexRange(mixxx::IndexRange frameIndexRange);
+
     CachingReaderWorker m_worker;
 };
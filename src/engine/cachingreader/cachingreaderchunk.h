@@ -1,6 +1,7 @@
 #pragma once
 
 #include "sources/audiosource.h"
+#include "util/math.h"
 
 // A Chunk is a memory-resident section of audio that has been cached.
 // Each chunk holds a fixed number kFrames of frames with samples for
@@ -60,6 +61,28 @@ public:
         return frameIndexOffset / kFrames;
     }
 
+    // Number of chunks that are read together while playing backwards.
+    // Decoders of compressed formats need to seek and decode some preroll
+    // frames before each chunk that does not directly follow the previous
+    // one. Reading a window of subsequent chunks in forward direction only
+    // needs a single seek.
+    static constexpr SINT kReverseReadWindowChunks = 8;
+
+    // Returns the range of chunk indices that should be read in a single
+    // forward pass if the chunk with the given index is missing while
+    // playing backwards. The windows are aligned to kReverseReadWindowChunks
+    // and end with the missing chunk. Chunks before minChunkIndex are
+    // excluded.
+    static mixxx::IndexRange reverseReadWindow(
+            SINT chunkIndex,
+            SINT minChunkIndex) {
+        DEBUG_ASSERT(chunkIndex >= minChunkIndex);
+        const SINT windowStart = chunkIndex - chunkIndex % kReverseReadWindowChunks;
+        return mixxx::IndexRange::between(
+                math_max(windowStart, minChunkIndex),
+                chunkIndex + 1);
+    }
+
     // Disable copy and move constructors
     CachingReaderChunk(const CachingReaderChunk&) = delete;
     CachingReaderChunk(CachingReaderChunk&&) = delete;
@@ -29,7 +29,8 @@ CachingReaderWorker::CachingReaderWorker(
         : m_group(group),
           m_tag(QString("CachingReaderWorker %1").arg(m_group)),
           m_pChunkReadRequestFIFO(pChunkReadRequestFIFO),
-          m_pReaderStatusFIFO(pReaderStatusFIFO) {
+          m_pReaderStatusFIFO(pReaderStatusFIFO),
+          m_trackGrowing(false) {
 }
 
 ReaderStatusUpdate CachingReaderWorker::processReadRequest(
@@ -89,6 +90,27 @@ ReaderStatusUpdate CachingReaderWorker::processReadRequest(
     return result;
 }
 
+ReaderStatusUpdate CachingReaderWorker::processGrowthCheck() {
+    if (!m_pAudioSource) {
+        return ReaderStatusUpdate::trackStoppedGrowing(mixxx::IndexRange());
+    }
+    if (m_trackGrowing) {
+        // Checked before growing for reading all audio data that has
+        // been written until the file has been finished
+        m_trackGrowing = SoundSourceProxy::isFileGrowing(m_trackLocation);
+        if (m_pAudioSource->tryGrowFrameIndexRange() && kLogger.traceEnabled()) {
+            kLogger.trace()
+                    << m_group
+                    << "Readable frame index range has grown:"
+                    << m_pAudioSource->frameIndexRange();
+        }
+    }
+    if (!m_trackGrowing) {
+        return ReaderStatusUpdate::trackStoppedGrowing(m_pAudioSource->frameIndexRange());
+    }
+    return ReaderStatusUpdate::trackGrown(m_pAudioSource->frameIndexRange());
+}
+
 // WARNING: Always called from a different thread (GUI)
 void CachingReaderWorker::newTrack(TrackPointer pTrack) {
     {
@@ -127,7 +149,9 @@ void CachingReaderWorker::run() {
             }
         } else if (m_pChunkReadRequestFIFO->read(&request, 1) == 1) {
             // Read the requested chunk and send the result
-            const ReaderStatusUpdate update = processReadRequest(request);
+            const ReaderStatusUpdate update = request.chunk
+                    ? processReadRequest(request)
+                    : processGrowthCheck();
             m_pReaderStatusFIFO->writeBlocking(&update, 1);
         } else {
             Event::end(m_tag);
@@ -140,6 +164,10 @@ void CachingReaderWorker::run() {
 void CachingReaderWorker::discardAllPendingRequests() {
     CachingReaderChunkReadRequest request;
     while (m_pChunkReadRequestFIFO->read(&request, 1) == 1) {
+        if (!request.chunk) {
+            // Growth checks don't need a response
+            continue;
+        }
         const auto update = ReaderStatusUpdate::readDiscarded(request.chunk);
         m_pReaderStatusFIFO->writeBlocking(&update, 1);
     }
@@ -153,6 +181,8 @@ void CachingReaderWorker::closeAudioSource() {
         m_pAudioSource->close();
         m_pAudioSource.reset();
     }
+    m_trackGrowing = false;
+    m_trackLocation.clear();
 
     // This function has to be called with the engine stopped only
     // to avoid collecting new requests for the old track
@@ -232,6 +262,16 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
                     m_pAudioSource->frameIndexRange());
     m_pReaderStatusFIFO->writeBlocking(&update, 1);
 
+    // Tracks that are still being recorded are extended while playing.
+    // The engine continues to request growth checks after the first
+    // response until the file has been finished.
+    m_trackLocation = pTrack->getLocation();
+    m_trackGrowing = SoundSourceProxy::isFileGrowing(m_trackLocation);
+    if (m_trackGrowing) {
+        const auto growthUpdate = processGrowthCheck();
+        m_pReaderStatusFIFO->writeBlocking(&growthUpdate, 1);
+    }
+
     // Emit that the track is loaded.
     const double sampleCount =
             CachingReaderChunk::dFrames2samples(m_pAudioSource->frameLength(),
@@ -22,6 +22,12 @@ typedef struct CachingReaderChunkReadRequest {
         chunk = chunkForOwner;
         chunkForOwner->giveToWorker();
     }
+
+    // A request without a chunk asks the worker to check if more
+    // audio data has been appended to a growing file.
+    void checkGrowth() {
+        chunk = nullptr;
+    }
 } CachingReaderChunkReadRequest;
 
 enum ReaderStatus {
@@ -30,7 +36,9 @@ enum ReaderStatus {
     CHUNK_READ_SUCCESS,
     CHUNK_READ_EOF,
     CHUNK_READ_INVALID,
-    CHUNK_READ_DISCARDED, // response without frame index range!
+    CHUNK_READ_DISCARDED,  // response without frame index range!
+    TRACK_GROWN,           // response to a growth check without a chunk
+    TRACK_STOPPED_GROWING, // final response to growth checks without a chunk
 };
 
 // POD with trivial ctor/dtor/copy for passing through FIFO
@@ -68,6 +76,20 @@ typedef struct ReaderStatusUpdate {
         return update;
     }
 
+    static ReaderStatusUpdate trackGrown(
+            const mixxx::IndexRange& readableFrameIndexRange) {
+        ReaderStatusUpdate update;
+        update.init(TRACK_GROWN, nullptr, readableFrameIndexRange);
+        return update;
+    }
+
+    static ReaderStatusUpdate trackStoppedGrowing(
+            const mixxx::IndexRange& readableFrameIndexRange) {
+        ReaderStatusUpdate update;
+        update.init(TRACK_STOPPED_GROWING, nullptr, readableFrameIndexRange);
+        return update;
+    }
+
     static ReaderStatusUpdate trackUnloaded() {
         ReaderStatusUpdate update;
         update.init(TRACK_UNLOADED, nullptr, mixxx::IndexRange());
@@ -151,6 +173,10 @@ class CachingReaderWorker : public EngineWorker {
     ReaderStatusUpdate processReadRequest(
             const CachingReaderChunkReadRequest& request);
 
+    /// Extends the readable range of a file that is still being written.
+    /// Reports when the file has been finished.
+    ReaderStatusUpdate processGrowthCheck();
+
     void verifyFirstSound(const CachingReaderChunk* pChunk,
             mixxx::audio::ChannelCount channelCount);
 
@@ -159,6 +185,10 @@ class CachingReaderWorker : public EngineWorker {
 
     mixxx::audio::FramePos m_firstSoundFrameToVerify;
 
+    // The file of the track is still being written, e.g. a recording
+    bool m_trackGrowing;
+    QString m_trackLocation;
+
     // Temporary buffer for reading samples from all channels
     // before conversion to a stereo signal.
     mixxx::SampleBuffer m_tempReadBuffer;
@@ -54,8 +54,9 @@ class EngineEffect final : public EffectsRequestHandler {
         return m_pManifest->name();
     }
 
-    SINT getGroupDelayFrames() {
-        return m_pProcessor->getGroupDelayFrames();
+    SINT getGroupDelayFrames(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle) {
+        return m_pProcessor->getGroupDelayFrames(inputHandle, outputHandle);
     }
 
   private:
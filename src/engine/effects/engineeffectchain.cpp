@@ -263,7 +263,8 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
                     }
 
                     processingOccured = true;
-                    effectChainGroupDelayFrames += pEffect->getGroupDelayFrames();
+                    effectChainGroupDelayFrames += pEffect->getGroupDelayFrames(
+                            inputHandle, outputHandle);
 
                     // Output of this effect becomes the input of the next effect
                     pIntermediateInput = pIntermediateOutput;
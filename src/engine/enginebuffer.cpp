@@ -851,6 +851,15 @@ void EngineBuffer::processTrackLocked(CSAMPLE* pOutput,
     ScopedTimer t(u"EngineBuffer::process_pauselock");
 
     m_trackSampleRateOld = mixxx::audio::SampleRate::fromDouble(m_pTrackSampleRate->get());
+    // Tracks that are still being recorded grow while playing
+    const auto growingFrameIndexRange = m_pReader->growingFrameIndexRange();
+    if (!growingFrameIndexRange.empty()) {
+        const auto growingTrackEndPosition =
+                mixxx::audio::FramePos(growingFrameIndexRange.end());
+        if (growingTrackEndPosition > getTrackEndPosition()) {
+            setTrackEndPosition(growingTrackEndPosition);
+        }
+    }
     m_trackEndPositionOld = getTrackEndPosition();
 
     double baseSampleRate = 0.0;
@@ -86,6 +86,9 @@ EngineMixer::EngineMixer(
     m_pAudioLatencyUsage = new ControlObject(
             ConfigKey(kAppGroup, QStringLiteral("audio_latency_usage")));
     m_pAudioLatencyUsage->addAlias(ConfigKey(kLegacyGroup, QStringLiteral("audio_latency_usage")));
+    // 99th percentile of the per callback usage, see SoundDevicePortAudio
+    m_pAudioLatencyUsagePeak = new ControlObject(
+            ConfigKey(kAppGroup, QStringLiteral("audio_latency_usage_peak")));
     m_pAudioLatencyOverload = new ControlObject(
             ConfigKey(kAppGroup, QStringLiteral("audio_latency_overload")));
     m_pAudioLatencyOverload->addAlias(
@@ -235,6 +238,7 @@ EngineMixer::~EngineMixer() {
     delete m_pOutputLatencyMs;
     delete m_pAudioLatencyOverloadCount;
     delete m_pAudioLatencyUsage;
+    delete m_pAudioLatencyUsagePeak;
     delete m_pAudioLatencyOverload;
 
     delete m_pMainEnabled;
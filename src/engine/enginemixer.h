@@ -302,6 +302,7 @@ class EngineMixer : public QObject, public AudioSource {
     ControlObject* m_pOutputLatencyMs;
     ControlObject* m_pAudioLatencyOverloadCount;
     ControlObject* m_pAudioLatencyUsage;
+    ControlObject* m_pAudioLatencyUsagePeak;
     ControlObject* m_pAudioLatencyOverload;
     EngineTalkoverDucking* m_pTalkoverDucking;
     EngineDelay* m_pMainDelay;
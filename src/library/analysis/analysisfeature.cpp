@@ -165,14 +165,6 @@ void AnalysisFeature::analyzeTracks(const QList<AnalyzerScheduledTrack>& tracks)
     }
 }
 
-void AnalysisFeature::suspendAnalysis() {
-    if (!m_pTrackAnalysisScheduler) {
-        return; // inactive
-    }
-    kLogger.info() << "Suspending analysis";
-    m_pTrackAnalysisScheduler->suspend();
-}
-
 void AnalysisFeature::resumeAnalysis() {
     if (!m_pTrackAnalysisScheduler) {
         return; // inactive
@@ -39,7 +39,6 @@ class AnalysisFeature : public LibraryFeature {
     void activate() override;
     void analyzeTracks(const QList<AnalyzerScheduledTrack>& tracks);
 
-    void suspendAnalysis();
     void resumeAnalysis();
     void stopAnalysis();
 
@@ -45,6 +45,8 @@ BaseSqlTableModel::BaseSqlTableModel(
         : BaseTrackTableModel(parent, pTrackCollectionManager, settingsNamespace),
           m_pTrackCollectionManager(pTrackCollectionManager),
           m_database(pTrackCollectionManager->internalCollection()->database()),
+          m_pSqlTableLoader(pTrackCollectionManager->sqlTableLoader()),
+          m_showPendingRows(false),
           m_bInitialized(false) {
 }
 
@@ -192,6 +194,12 @@ void BaseSqlTableModel::replaceRows(
     }
 }
 
+QString BaseSqlTableModel::selectQueryString() const {
+    // Prepare query for id and all columns not in m_trackSource
+    return QString("SELECT %1 FROM %2 %3")
+            .arg(m_tableColumns.join(","), m_tableName, m_tableOrderBy);
+}
+
 void BaseSqlTableModel::select() {
     if (!m_bInitialized) {
         return;
@@ -211,12 +219,13 @@ void BaseSqlTableModel::select() {
         qDebug() << this << "select()";
     }
 
+    // The synchronous result supersedes any pending asynchronous result
+    cancelSelectAsync();
+
     PerformanceTimer time;
     time.start();
 
-    // Prepare query for id and all columns not in m_trackSource
-    QString queryString = QString("SELECT %1 FROM %2 %3")
-                                  .arg(m_tableColumns.join(","), m_tableName, m_tableOrderBy);
+    const QString queryString = selectQueryString();
 
     if (sDebug) {
         qDebug() << this << "select() executing:" << queryString;
@@ -235,16 +244,10 @@ void BaseSqlTableModel::select() {
         return;
     }
 
-    // Remove all the rows from the table after(!) the query has been
-    // executed successfully. See issue #6782.
-    // TODO(rryan) we could edit the table in place instead of clearing it?
-    clearRows();
-
     // The size of the result set is not known in advance for a
     // forward-only query, so we cannot reserve memory for rows
     // in advance.
     QVector<RowInfo> rowInfos;
-    QSet<TrackId> trackIds;
     int idColumn = -1;
     while (query.next()) {
         QSqlRecord sqlRecord = query.record();
@@ -264,11 +267,8 @@ void BaseSqlTableModel::select() {
             return;
         }
 
-        TrackId trackId(sqlRecord.value(idColumn));
-        trackIds.insert(trackId);
-
         RowInfo rowInfo;
-        rowInfo.trackId = trackId;
+        rowInfo.trackId = TrackId(sqlRecord.value(idColumn));
         // current position defines the ordering
         rowInfo.order = rowInfos.size();
         rowInfo.metadata.reserve(sqlRecord.count());
@@ -282,7 +282,129 @@ void BaseSqlTableModel::select() {
         qDebug() << "Rows actually received:" << rowInfos.size();
     }
 
+    applyRows(std::move(rowInfos));
+
+    qDebug() << this << "select() returned" << m_rowInfo.size()
+             << "results in" << time.elapsed().debugMillisWithUnit();
+
+    emit selectFinished();
+}
+
+void BaseSqlTableModel::selectAsync() {
+    if (!m_bInitialized) {
+        return;
+    }
+    if (!m_pSqlTableLoader) {
+        select();
+        return;
+    }
+
+    if (sDebug) {
+        qDebug() << this << "selectAsync()";
+    }
+
+    // The new result supersedes any pending result
+    cancelSelectAsync();
+
+    m_selectTimer.start();
+
+    SqlTableLoader::Request request;
+    // The temporary views only exist within our database connection
+    request.createViewStatement =
+            SqlTableLoader::createTemporaryViewStatement(m_database, m_tableName);
+    request.tableName = m_tableName;
+    request.queryString = selectQueryString();
+
+    // The order of the query results is final unless the rows need to
+    // be filtered or sorted by the track source. This applies to all
+    // views that are sorted by a column of the library, e.g. the artist.
+    m_showPendingRows = m_currentSearch.isEmpty() &&
+            m_currentSearchFilter.isEmpty() &&
+            m_trackSourceOrderBy.isEmpty();
+    m_pSelectReply = m_pSqlTableLoader->load(std::move(request));
+    connect(m_pSelectReply.data(),
+            &SqlTableReply::rowsLoaded,
+            this,
+            &BaseSqlTableModel::slotRowsLoaded);
+}
+
+void BaseSqlTableModel::cancelSelectAsync() {
+    if (!isSelectPending()) {
+        return;
+    }
+    m_pSelectReply->cancel();
+    // Discard all batches that have already been loaded
+    m_pSelectReply->disconnect(this);
+    m_pSelectReply.reset();
+    m_pendingRowInfos.clear();
+}
+
+void BaseSqlTableModel::slotRowsLoaded(const SqlTableReply::Batch& batch) {
+    DEBUG_ASSERT(isSelectPending());
+
+    if (batch.failed) {
+        qWarning() << this << "selectAsync() failed, falling back to select()";
+        select();
+        return;
+    }
+
+    const int firstPendingRow = m_pendingRowInfos.size();
+    for (const auto& row : batch.rows) {
+        RowInfo rowInfo;
+        rowInfo.trackId = TrackId(row.value(kIdColumn));
+        // current position defines the ordering
+        rowInfo.order = m_pendingRowInfos.size();
+        rowInfo.metadata = row;
+        m_pendingRowInfos.push_back(std::move(rowInfo));
+    }
+
+    if (m_showPendingRows && m_pendingRowInfos.size() > firstPendingRow) {
+        if (firstPendingRow == 0) {
+            // Remove the previous rows when the first rows have been
+            // received. See issue #6782.
+            clearRows();
+        }
+        beginInsertRows(QModelIndex(),
+                m_rowInfo.size(),
+                m_rowInfo.size() + m_pendingRowInfos.size() - firstPendingRow - 1);
+        for (int i = firstPendingRow; i < m_pendingRowInfos.size(); ++i) {
+            const RowInfo& rowInfo = m_pendingRowInfos[i];
+            m_trackIdToRows[rowInfo.trackId].push_back(m_rowInfo.size());
+            m_rowInfo.push_back(rowInfo);
+        }
+        endInsertRows();
+    }
+
+    if (!batch.finished) {
+        return;
+    }
+
+    if (sDebug) {
+        qDebug() << "Rows actually received:" << m_pendingRowInfos.size();
+    }
+
+    m_pSelectReply.reset();
+    QVector<RowInfo> rowInfos;
+    rowInfos.swap(m_pendingRowInfos);
+    // The track source filters and sorts the rows in the GUI thread,
+    // because its cache and search index are only accessible from the
+    // GUI thread.
+    applyRows(std::move(rowInfos));
+
+    qDebug() << this << "selectAsync() returned" << m_rowInfo.size()
+             << "results in" << m_selectTimer.elapsed().debugMillisWithUnit();
+
+    emit selectFinished();
+}
+
+void BaseSqlTableModel::applyRows(QVector<RowInfo>&& rowInfos) {
     if (m_trackSource) {
+        QSet<TrackId> trackIds;
+        trackIds.reserve(rowInfos.size());
+        for (const auto& rowInfo : std::as_const(rowInfos)) {
+            trackIds.insert(rowInfo.trackId);
+        }
+
         m_trackSource->filterAndSort(trackIds,
                 m_currentSearch,
                 m_currentSearchFilter,
@@ -330,15 +452,31 @@ void BaseSqlTableModel::select() {
     // number of total rows returned by the query
     DEBUG_ASSERT(trackIdToRows.size() <= rowInfos.size());
 
+    // Rows that have already been displayed by selectAsync() are only
+    // updated if their order is unchanged. This preserves the selection
+    // and the scroll position of the views.
+    bool sameRows = !rowInfos.isEmpty() && rowInfos.size() == m_rowInfo.size();
+    for (int i = 0; sameRows && i < rowInfos.size(); ++i) {
+        sameRows = rowInfos[i].trackId == m_rowInfo[i].trackId;
+    }
+    if (sameRows) {
+        m_rowInfo = rowInfos;
+        m_trackIdToRows = trackIdToRows;
+        emit dataChanged(index(0, 0), index(m_rowInfo.size() - 1, columnCount() - 1));
+        return;
+    }
+
+    // Remove all the rows from the table after(!) the query has been
+    // executed successfully. See issue #6782.
+    // TODO(rryan) we could edit the table in place instead of clearing it?
+    clearRows();
+
     // We're done! Issue the update signals and replace the main maps.
     replaceRows(
             std::move(rowInfos),
             std::move(trackIdToRows));
     // Both rowInfo and trackIdToRows (might) have been moved and
     // must not be used afterwards!
-
-    qDebug() << this << "select() returned" << m_rowInfo.size()
-             << "results in" << time.elapsed().debugMillisWithUnit();
 }
 
 void BaseSqlTableModel::setTable(QString tableName,
@@ -419,7 +557,7 @@ void BaseSqlTableModel::search(const QString& searchText, const QString& extraFi
         qDebug() << this << "search" << searchText;
     }
     setSearch(searchText, extraFilter);
-    select();
+    selectAsync();
 }
 
 void BaseSqlTableModel::setSort(int column, Qt::SortOrder order) {
@@ -564,7 +702,7 @@ void BaseSqlTableModel::sort(int column, Qt::SortOrder order) {
         qDebug() << this << "sort()" << column << order;
     }
     setSort(column, order);
-    select();
+    selectAsync();
 }
 
 int BaseSqlTableModel::rowCount(const QModelIndex& parent) const {
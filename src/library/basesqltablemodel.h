@@ -1,13 +1,16 @@
 #pragma once
 
 #include <QHash>
+#include <QPointer>
 #include <QtSql>
 
 #include "library/basetrackcache.h"
 #include "library/dao/trackdao.h"
 #include "library/basetracktablemodel.h"
 #include "library/columncache.h"
+#include "library/sqltableloader.h"
 #include "util/class.h"
+#include "util/performancetimer.h"
 
 class TrackCollectionManager;
 
@@ -67,6 +70,21 @@ class BaseSqlTableModel : public BaseTrackTableModel {
 
     void select() override;
 
+    /// Populates the model like select() without blocking the GUI thread.
+    ///
+    /// The rows are loaded in the background. They are only displayed
+    /// while they are received if the table is sorted by one of its own
+    /// columns and not filtered by a search. Otherwise the track source
+    /// filters and sorts the rows in the GUI thread after all rows have
+    /// been received. selectFinished() is emitted when all rows have
+    /// been loaded, filtered, and sorted. Invoking select() or selectAsync()
+    /// again cancels a pending request.
+    void selectAsync();
+
+    bool isSelectPending() const {
+        return !m_pSelectReply.isNull();
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     // Inherited from BaseTrackTableModel
     ///////////////////////////////////////////////////////////////////////////
@@ -107,8 +125,13 @@ class BaseSqlTableModel : public BaseTrackTableModel {
     int m_columnIndexBySortColumnId[static_cast<int>(TrackModel::SortColumnId::IdMax)];
     QMap<int, TrackModel::SortColumnId> m_sortColumnIdByColumnIndex;
 
+  signals:
+    /// Emitted after select() or when selectAsync() has finished.
+    void selectFinished();
+
   private slots:
     void tracksChanged(const QSet<TrackId>& trackIds);
+    void slotRowsLoaded(const SqlTableReply::Batch& batch);
 
   private:
     void setTrackValueForColumn(
@@ -137,6 +160,13 @@ class BaseSqlTableModel : public BaseTrackTableModel {
 
     typedef QHash<TrackId, QVector<int>> TrackId2Rows;
 
+    QString selectQueryString() const;
+    void cancelSelectAsync();
+
+    /// Filters and sorts the rows of a query with the track source
+    /// before replacing the rows of the model.
+    void applyRows(QVector<RowInfo>&& rowInfos);
+
     void clearRows();
     void replaceRows(
             QVector<RowInfo>&& rows,
@@ -144,6 +174,15 @@ class BaseSqlTableModel : public BaseTrackTableModel {
 
     QVector<RowInfo> m_rowInfo;
 
+    // Loads the rows of selectAsync(). Not available in test mode.
+    QPointer<SqlTableLoader> m_pSqlTableLoader;
+
+    // The rows of a pending selectAsync()
+    SqlTableReplyPointer m_pSelectReply;
+    QVector<RowInfo> m_pendingRowInfos;
+    bool m_showPendingRows;
+    PerformanceTimer m_selectTimer;
+
     QString m_idColumn;
     QSharedPointer<BaseTrackCache> m_trackSource;
     QStringList m_tableColumns;
@@ -156,5 +195,7 @@ class BaseSqlTableModel : public BaseTrackTableModel {
     QVector<QHash<int, QVariant>> m_headerInfo;
     QString m_trackSourceOrderBy;
 
+    friend class BaseSqlTableModelTest;
+
     DISALLOW_COPY_AND_ASSIGN(BaseSqlTableModel);
 };
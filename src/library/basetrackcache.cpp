@@ -22,13 +22,16 @@ BaseTrackCache::BaseTrackCache(TrackCollection* pTrackCollection,
         QStringList columns,
         QStringList searchColumns,
         bool isCaching)
-        : m_tableName(std::move(tableName)),
+        : m_pTrackCollection(pTrackCollection),
+          m_tableName(std::move(tableName)),
           m_idColumn(std::move(idColumn)),
           m_columnCount(columns.size()),
           m_columnsJoined(columns.join(",")),
           m_columnCache(std::move(columns)),
           m_pQueryParser(std::make_unique<SearchQueryParser>(
                   pTrackCollection, std::move(searchColumns))),
+          m_searchIndex(m_columnCache),
+          m_sortedTrackIdsValid(false),
           m_bIndexBuilt(false),
           m_bIsCaching(isCaching),
           m_database(pTrackCollection->database()) {
@@ -79,6 +82,7 @@ void BaseTrackCache::slotTracksRemoved(const QSet<TrackId>& trackIds) {
     }
     for (const auto& trackId : std::as_const(trackIds)) {
         m_trackInfo.remove(trackId);
+        m_searchIndex.removeTrack(trackId);
         m_dirtyTracks.remove(trackId);
     }
 }
@@ -209,6 +213,7 @@ bool BaseTrackCache::updateTrackInIndex(
         for (int i = 0; i < numColumns; ++i) {
             getTrackValueForColumn(pTrack, i, record[i]);
         }
+        updateSearchIndex(trackId, record);
         if (m_bIsCaching) {
             replaceRecentTrack(std::move(trackId), pTrack);
         }
@@ -264,6 +269,7 @@ bool BaseTrackCache::updateIndexWithQuery(const QString& queryString) {
                 record[i] = query.value(i);
             }
         }
+        updateSearchIndex(trackId, record);
     }
 
     qDebug() << this << "updateIndexWithQuery took" << timer.elapsed().debugMillisWithUnit();
@@ -286,6 +292,7 @@ void BaseTrackCache::buildIndex() {
     // clear the table, and keep track of what IDs we see, then delete the ones
     // we don't see.
     m_trackInfo.clear();
+    m_searchIndex.clear();
 
     if (!updateIndexWithQuery(queryString)) {
         qDebug() << "buildIndex failed!";
@@ -294,6 +301,13 @@ void BaseTrackCache::buildIndex() {
     m_bIndexBuilt = true;
 }
 
+void BaseTrackCache::updateSearchIndex(
+        TrackId trackId, const QVector<QVariant>& record) {
+    m_searchIndex.updateTrack(trackId, record);
+    // The position of the track might have changed
+    m_sortedTrackIdsValid = false;
+}
+
 void BaseTrackCache::updateTrackInIndex(TrackId trackId) {
     QSet<TrackId> trackIds;
     trackIds.insert(trackId);
@@ -453,71 +467,27 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
         buildIndex();
     }
 
-    QStringList idStrings;
-    // TODO(rryan) consider making this the data passed in and a separate
-    // QVector for output
     QSet<TrackId> dirtyTracks;
     for (const auto& trackId: trackIds) {
-        idStrings << trackId.toString();
         if (m_dirtyTracks.contains(trackId)) {
             dirtyTracks.insert(trackId);
         }
     }
 
-    QStringList queryFragments;
-    if (!extraFilter.isNull() && extraFilter != "") {
-        queryFragments << QString("(%1)").arg(extraFilter);
-    }
-    if (idStrings.size() > 0) {
-        queryFragments << QString("%1 in (%2)")
-                .arg(m_idColumn, idStrings.join(","));
-    }
-
-    const std::unique_ptr<QueryNode> pQuery =
-            m_pQueryParser->parseQuery(
-                    searchQuery,
-                    queryFragments.join(" AND "));
-
-    QString filter = pQuery->toSql();
-    if (!filter.isEmpty()) {
-        filter.prepend("WHERE ");
-    }
-
-    QString queryString = QString("SELECT %1 FROM %2 %3 %4")
-            .arg(m_idColumn, m_tableName, filter, orderByClause);
-
-    if (sDebug) {
-        qDebug() << this << "select() executing:" << queryString;
-    }
-
-    QSqlQuery query(m_database);
-    // This causes a memory savings since QSqlCachedResult (what QtSQLite uses)
-    // won't allocate a giant in-memory table that we won't use at all.
-    query.setForwardOnly(true);
-    query.prepare(queryString);
-
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
-    }
-
-    int idColumn = query.record().indexOf(m_idColumn);
-    int rows = query.size();
-
-    if (sDebug) {
-        qDebug() << "Rows returned:" << rows;
-    }
-
     m_trackOrder.resize(0); // keeps allocated memory
     trackToIndex->clear();
-    if (rows > 0) {
-        trackToIndex->reserve(rows);
-        m_trackOrder.reserve(rows);
+
+    // An extra filter is an SQL expression that is only supported by
+    // the fallback
+    std::unique_ptr<QueryNode> pQuery =
+            m_pQueryParser->parseQuery(searchQuery, extraFilter);
+    if (!filterAndSortIndexed(trackIds, *pQuery, orderByClause)) {
+        filterAndSortSql(trackIds, searchQuery, extraFilter, orderByClause);
     }
 
-    while (query.next()) {
-        TrackId trackId(query.value(idColumn));
-        (*trackToIndex)[trackId] = m_trackOrder.size();
-        m_trackOrder.append(trackId);
+    trackToIndex->reserve(m_trackOrder.size());
+    for (int i = 0; i < m_trackOrder.size(); ++i) {
+        (*trackToIndex)[m_trackOrder[i]] = i;
     }
 
     // At this point, the original set of tracks have been divided into two
@@ -595,6 +565,155 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
     }
 }
 
+bool BaseTrackCache::filterAndSortIndexed(const QSet<TrackId>& trackIds,
+        const QueryNode& query,
+        const QString& orderByClause) {
+    PerformanceTimer timer;
+    timer.start();
+
+    // Without track ids all tracks are selected like in filterAndSortSql().
+    // Tracks that are not in the index would get lost.
+    std::vector<uint8_t> rowSelected(
+            m_searchIndex.rowCount(), trackIds.isEmpty() ? 1 : 0);
+    for (const auto& trackId : trackIds) {
+        const int row = m_searchIndex.rowOf(trackId);
+        if (row < 0) {
+            return false;
+        }
+        rowSelected[row] = 1;
+    }
+
+    if (!m_searchIndex.match(query, &m_rowMatches)) {
+        return false;
+    }
+    if (!orderByClause.isEmpty() && !updateSortedTrackIds(orderByClause)) {
+        return false;
+    }
+
+    for (int row = 0; row < m_searchIndex.rowCount(); ++row) {
+        m_rowMatches[row] &= rowSelected[row];
+    }
+    if (orderByClause.isEmpty()) {
+        // The order of the results is undefined
+        for (int row = 0; row < m_searchIndex.rowCount(); ++row) {
+            if (m_rowMatches[row]) {
+                m_trackOrder.append(m_searchIndex.trackIdAt(row));
+            }
+        }
+    } else {
+        for (const auto& trackId : std::as_const(m_sortedTrackIds)) {
+            const int row = m_searchIndex.rowOf(trackId);
+            if (row >= 0 && m_rowMatches[row]) {
+                m_trackOrder.append(trackId);
+            }
+        }
+    }
+
+    if (sDebug) {
+        qDebug() << this << "filterAndSortIndexed returned" << m_trackOrder.size()
+                 << "of" << trackIds.size() << "tracks in"
+                 << timer.elapsed().debugMillisWithUnit();
+    }
+    return true;
+}
+
+bool BaseTrackCache::updateSortedTrackIds(const QString& orderByClause) {
+    if (m_sortedTrackIdsValid && m_sortedTrackIdsOrderBy == orderByClause) {
+        return true;
+    }
+
+    QString queryString = QString("SELECT %1 FROM %2 %3")
+            .arg(m_idColumn, m_tableName, orderByClause);
+
+    if (sDebug) {
+        qDebug() << this << "updateSortedTrackIds executing:" << queryString;
+    }
+
+    QSqlQuery query(m_database);
+    query.setForwardOnly(true);
+    query.prepare(queryString);
+
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+
+    m_sortedTrackIds.resize(0); // keeps allocated memory
+    m_sortedTrackIds.reserve(m_searchIndex.rowCount());
+    const int idColumn = query.record().indexOf(m_idColumn);
+    while (query.next()) {
+        m_sortedTrackIds.append(TrackId(query.value(idColumn)));
+    }
+    m_sortedTrackIdsOrderBy = orderByClause;
+    m_sortedTrackIdsValid = true;
+    return true;
+}
+
+void BaseTrackCache::filterAndSortSql(const QSet<TrackId>& trackIds,
+        const QString& searchQuery,
+        const QString& extraFilter,
+        const QString& orderByClause) {
+    QStringList idStrings;
+    for (const auto& trackId: trackIds) {
+        idStrings << trackId.toString();
+    }
+
+    QStringList queryFragments;
+    if (!extraFilter.isNull() && extraFilter != "") {
+        queryFragments << QString("(%1)").arg(extraFilter);
+    }
+    if (idStrings.size() > 0) {
+        queryFragments << QString("%1 in (%2)")
+                .arg(m_idColumn, idStrings.join(","));
+    }
+
+    // The full-text index replaces the LIKE expressions of text filters
+    // if it is up-to-date
+    m_pQueryParser->setFullTextSearch(m_pTrackCollection->prepareFullTextSearch());
+    const std::unique_ptr<QueryNode> pQuery =
+            m_pQueryParser->parseQuery(
+                    searchQuery,
+                    queryFragments.join(" AND "));
+    m_pQueryParser->setFullTextSearch(false);
+
+    QString filter = pQuery->toSql();
+    if (!filter.isEmpty()) {
+        filter.prepend("WHERE ");
+    }
+
+    QString queryString = QString("SELECT %1 FROM %2 %3 %4")
+            .arg(m_idColumn, m_tableName, filter, orderByClause);
+
+    if (sDebug) {
+        qDebug() << this << "select() executing:" << queryString;
+    }
+
+    QSqlQuery query(m_database);
+    // This causes a memory savings since QSqlCachedResult (what QtSQLite uses)
+    // won't allocate a giant in-memory table that we won't use at all.
+    query.setForwardOnly(true);
+    query.prepare(queryString);
+
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+    }
+
+    int idColumn = query.record().indexOf(m_idColumn);
+    int rows = query.size();
+
+    if (sDebug) {
+        qDebug() << "Rows returned:" << rows;
+    }
+
+    if (rows > 0) {
+        m_trackOrder.reserve(rows);
+    }
+
+    while (query.next()) {
+        m_trackOrder.append(TrackId(query.value(idColumn)));
+    }
+}
+
 int BaseTrackCache::findSortInsertionPoint(TrackPointer pTrack,
         const QList<SortColumn>& sortColumns,
         const int columnOffset,
@@ -8,14 +8,18 @@
 #include <QString>
 #include <QStringList>
 #include <QVector>
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "library/columncache.h"
+#include "library/tracksearchindex.h"
 #include "track/track_decl.h"
 #include "track/trackid.h"
 #include "util/class.h"
 #include "util/string.h"
 
+class QueryNode;
 class SearchQueryParser;
 class TrackCollection;
 
@@ -93,6 +97,15 @@ class BaseTrackCache : public QObject {
     void resetRecentTrack() const;
 
     bool updateIndexWithQuery(const QString& query);
+    void updateSearchIndex(TrackId trackId, const QVector<QVariant>& record);
+    bool updateSortedTrackIds(const QString& orderByClause);
+    bool filterAndSortIndexed(const QSet<TrackId>& trackIds,
+            const QueryNode& query,
+            const QString& orderByClause);
+    void filterAndSortSql(const QSet<TrackId>& trackIds,
+            const QString& searchQuery,
+            const QString& extraFilter,
+            const QString& orderByClause);
     void updateTrackInIndex(TrackId trackId);
     bool updateTrackInIndex(const TrackPointer& pTrack);
     void updateTracksInIndex(const QSet<TrackId>& trackIds);
@@ -115,6 +128,7 @@ class BaseTrackCache : public QObject {
                              const QStringList& numberMatchers) const;
     bool evaluateNumeric(const int value, const QString& expression) const;
 
+    TrackCollection* const m_pTrackCollection;
     const QString m_tableName;
     const QString m_idColumn;
     const int m_columnCount;
@@ -129,6 +143,18 @@ class BaseTrackCache : public QObject {
     // Temporary storage for filterAndSort()
 
     QVector<TrackId> m_trackOrder;
+    std::vector<uint8_t> m_rowMatches;
+
+    // Searching is done with the in-memory index that is updated together
+    // with m_trackInfo. SQL is only used for queries that are not supported
+    // by the index.
+    TrackSearchIndex m_searchIndex;
+
+    // The order of all tracks in the table for the most recent ORDER BY
+    // clause. Invalidated whenever tracks are added or modified.
+    QString m_sortedTrackIdsOrderBy;
+    QVector<TrackId> m_sortedTrackIds;
+    bool m_sortedTrackIdsValid;
 
     // Remember key and value of the most recent cache lookup to avoid querying
     // the global track cache again and again while populating the columns
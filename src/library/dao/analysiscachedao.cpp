@@ -0,0 +1,104 @@
+#include "library/dao/analysiscachedao.h"
+
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QVariant>
+
+#include "library/dao/trackschema.h"
+#include "library/queryutil.h"
+
+const QString AnalysisCacheDao::s_analysisCacheTableName =
+        QStringLiteral("analysis_cache");
+
+std::optional<AnalysisCacheDao::Entry> AnalysisCacheDao::findEntry(
+        const QString& fingerprint) const {
+    if (!m_database.isOpen() || fingerprint.isEmpty()) {
+        return std::nullopt;
+    }
+
+    QSqlQuery query(m_database);
+    query.prepare(QStringLiteral(
+            "SELECT track_id, beats_version, beats_sub_version, beats, "
+            "keys_version, keys_sub_version, keys, replaygain, replaygain_peak, "
+            "first_sound, last_sound FROM %1 WHERE fingerprint=:fingerprint")
+                          .arg(s_analysisCacheTableName));
+    query.bindValue(QStringLiteral(":fingerprint"), fingerprint);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return std::nullopt;
+    }
+    if (!query.next()) {
+        return std::nullopt;
+    }
+
+    const QSqlRecord record = query.record();
+    Entry entry;
+    entry.fingerprint = fingerprint;
+    entry.trackId = TrackId(query.value(record.indexOf("track_id")));
+    entry.beatsVersion = query.value(record.indexOf("beats_version")).toString();
+    entry.beatsSubVersion = query.value(record.indexOf("beats_sub_version")).toString();
+    entry.beats = query.value(record.indexOf("beats")).toByteArray();
+    entry.keysVersion = query.value(record.indexOf("keys_version")).toString();
+    entry.keysSubVersion = query.value(record.indexOf("keys_sub_version")).toString();
+    entry.keys = query.value(record.indexOf("keys")).toByteArray();
+    entry.replayGainRatio = query.value(record.indexOf("replaygain")).toDouble();
+    entry.replayGainPeak = query.value(record.indexOf("replaygain_peak")).toDouble();
+    entry.firstSoundFrame = query.value(record.indexOf("first_sound")).toDouble();
+    entry.lastSoundFrame = query.value(record.indexOf("last_sound")).toDouble();
+    return entry;
+}
+
+bool AnalysisCacheDao::saveEntry(const Entry& entry) {
+    if (!m_database.isOpen()) {
+        return false;
+    }
+    VERIFY_OR_DEBUG_ASSERT(!entry.fingerprint.isEmpty()) {
+        return false;
+    }
+
+    QSqlQuery query(m_database);
+    query.prepare(QStringLiteral(
+            "INSERT OR REPLACE INTO %1 (fingerprint, track_id, "
+            "beats_version, beats_sub_version, beats, "
+            "keys_version, keys_sub_version, keys, replaygain, replaygain_peak, "
+            "first_sound, last_sound) VALUES (:fingerprint, :track_id, "
+            ":beats_version, :beats_sub_version, :beats, "
+            ":keys_version, :keys_sub_version, :keys, :replaygain, :replaygain_peak, "
+            ":first_sound, :last_sound)")
+                          .arg(s_analysisCacheTableName));
+    query.bindValue(QStringLiteral(":fingerprint"), entry.fingerprint);
+    query.bindValue(QStringLiteral(":track_id"), entry.trackId.toVariant());
+    query.bindValue(QStringLiteral(":beats_version"), entry.beatsVersion);
+    query.bindValue(QStringLiteral(":beats_sub_version"), entry.beatsSubVersion);
+    query.bindValue(QStringLiteral(":beats"), entry.beats);
+    query.bindValue(QStringLiteral(":keys_version"), entry.keysVersion);
+    query.bindValue(QStringLiteral(":keys_sub_version"), entry.keysSubVersion);
+    query.bindValue(QStringLiteral(":keys"), entry.keys);
+    query.bindValue(QStringLiteral(":replaygain"), entry.replayGainRatio);
+    query.bindValue(QStringLiteral(":replaygain_peak"), entry.replayGainPeak);
+    query.bindValue(QStringLiteral(":first_sound"), entry.firstSoundFrame);
+    query.bindValue(QStringLiteral(":last_sound"), entry.lastSoundFrame);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+    return true;
+}
+
+int AnalysisCacheDao::deleteOrphanedEntries() {
+    if (!m_database.isOpen()) {
+        return -1;
+    }
+
+    QSqlQuery query(m_database);
+    query.prepare(QStringLiteral(
+            "DELETE FROM %1 WHERE track_id NOT IN (SELECT %2 FROM %3)")
+                          .arg(s_analysisCacheTableName,
+                                  LIBRARYTABLE_ID,
+                                  LIBRARY_TABLE));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return -1;
+    }
+    return query.numRowsAffected();
+}
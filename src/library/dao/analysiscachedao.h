@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <optional>
+
+#include "library/dao/dao.h"
+#include "track/trackid.h"
+
+/// Stores analysis results by a fingerprint of the decoded audio data.
+///
+/// The results are stored in their serialized form and are independent
+/// of any track. The id of the track they have been obtained from is only
+/// kept for looking up the waveforms in the track_analysis table, i.e.
+/// the track might have been deleted in the meantime.
+class AnalysisCacheDao : public DAO {
+  public:
+    static const QString s_analysisCacheTableName;
+
+    struct Entry {
+        QString fingerprint;
+        TrackId trackId;
+        QString beatsVersion;
+        QString beatsSubVersion;
+        QByteArray beats;
+        QString keysVersion;
+        QString keysSubVersion;
+        QByteArray keys;
+        /// Undefined if 0
+        double replayGainRatio = 0.0;
+        /// Undefined if negative
+        double replayGainPeak = -1.0;
+        /// Undefined if negative
+        double firstSoundFrame = -1.0;
+        double lastSoundFrame = -1.0;
+    };
+
+    ~AnalysisCacheDao() override = default;
+
+    std::optional<Entry> findEntry(const QString& fingerprint) const;
+
+    /// Inserts or replaces the entry with the same fingerprint.
+    bool saveEntry(const Entry& entry);
+
+    /// Deletes all entries that have been obtained from tracks which are
+    /// no longer in the library, i.e. the table does not grow beyond the
+    /// size of the library. The waveforms of these entries have been
+    /// deleted together with their tracks. Returns the number of deleted
+    /// entries or -1 on failure.
+    int deleteOrphanedEntries();
+};
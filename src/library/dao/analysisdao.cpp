@@ -1,6 +1,7 @@
 #include "library/dao/analysisdao.h"
 
 #include <QSqlQuery>
+#include <QUuid>
 #include <QtDebug>
 
 #include "library/queryutil.h"
@@ -16,6 +17,8 @@ const QString AnalysisDao::s_analysisTableName = "track_analysis";
 // CPU time so I think we should stick with the default. rryan 4/3/2012
 constexpr int kCompressionLevel = -1;
 
+const QString kPyramidFileSuffix = QStringLiteral(".pyramid");
+
 AnalysisDao::AnalysisDao(UserSettingsPointer pConfig)
         : m_pConfig(pConfig) {
     QDir storagePath = getAnalysisStoragePath();
@@ -31,7 +34,7 @@ QList<AnalysisDao::AnalysisInfo> AnalysisDao::getAnalysesForTrack(TrackId trackI
 
     QSqlQuery query(m_database);
     query.prepare(QString(
-        "SELECT id, type, description, version, data_checksum FROM %1 "
+        "SELECT id, type, description, version, data_checksum, pyramid_file FROM %1 "
         "WHERE track_id=:trackId").arg(s_analysisTableName));
     query.bindValue(":trackId", trackId.toVariant());
 
@@ -46,7 +49,7 @@ QList<AnalysisDao::AnalysisInfo> AnalysisDao::getAnalysesForTrackByType(
 
     QSqlQuery query(m_database);
     query.prepare(QString(
-        "SELECT id, type, description, version, data_checksum FROM %1 "
+        "SELECT id, type, description, version, data_checksum, pyramid_file FROM %1 "
         "WHERE track_id=:trackId AND type=:type").arg(s_analysisTableName));
     query.bindValue(":trackId", trackId.toVariant());
     query.bindValue(":type", type);
@@ -71,6 +74,7 @@ QList<AnalysisDao::AnalysisInfo> AnalysisDao::loadAnalysesFromQuery(TrackId trac
     const int descriptionColumn = queryRecord.indexOf("description");
     const int versionColumn = queryRecord.indexOf("version");
     const int dataChecksumColumn = queryRecord.indexOf("data_checksum");
+    const int pyramidFileColumn = queryRecord.indexOf("pyramid_file");
 
     QDir analysisPath(getAnalysisStoragePath());
     while (query->next()) {
@@ -81,6 +85,19 @@ QList<AnalysisDao::AnalysisInfo> AnalysisDao::loadAnalysesFromQuery(TrackId trac
         info.description = query->value(descriptionColumn).toString();
         info.version = query->value(versionColumn).toString();
         int checksum = query->value(dataChecksumColumn).toInt();
+        const QString pyramidFile = query->value(pyramidFileColumn).toString();
+        if (!pyramidFile.isEmpty()) {
+            // The waveform is indexed in the mapped pyramid without
+            // reading, decompressing and parsing any data
+            info.pWaveformPyramid = WaveformPyramid::open(
+                    analysisPath.absoluteFilePath(pyramidFile));
+            if (!info.pWaveformPyramid) {
+                qDebug() << "WARNING: Failed to open waveform pyramid" << pyramidFile;
+                continue;
+            }
+            analyses.append(info);
+            continue;
+        }
         QString dataPath = analysisPath.absoluteFilePath(
             QString::number(info.analysisId));
         const QByteArray compressedData = loadDataFromFile(dataPath);
@@ -119,15 +136,21 @@ bool AnalysisDao::saveAnalysis(AnalysisDao::AnalysisInfo* info) {
     PerformanceTimer time;
     time.start();
 
-    const QByteArray compressedData = qCompress(info->data, kCompressionLevel);
+    // Analyses with a pyramid are only stored as the pyramid. The data
+    // file and its checksum are left empty.
+    QByteArray compressedData;
+    QVariant checksum;
+    if (!info->pWaveformPyramid) {
+        compressedData = qCompress(info->data, kCompressionLevel);
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-    const int checksum = qChecksum(
-            compressedData);
+        checksum = qChecksum(
+                compressedData);
 #else
-    const int checksum = qChecksum(
-            compressedData.constData(),
-            compressedData.length());
+        checksum = qChecksum(
+                compressedData.constData(),
+                compressedData.length());
 #endif
+    }
     QSqlQuery query(m_database);
     if (info->analysisId == -1) {
         query.prepare(QString(
@@ -169,13 +192,50 @@ bool AnalysisDao::saveAnalysis(AnalysisDao::AnalysisInfo* info) {
         }
     }
 
-    QString dataPath = getAnalysisStoragePath().absoluteFilePath(
+    const QDir analysisPath(getAnalysisStoragePath());
+    QString dataPath = analysisPath.absoluteFilePath(
         QString::number(info->analysisId));
-    if (!saveDataToFile(dataPath, compressedData)) {
+    QString pyramidFile;
+    ConstWaveformPyramidPointer pMappedPyramid;
+    if (info->pWaveformPyramid) {
+        // A file that is still mapped can't be replaced or deleted on all
+        // platforms. Each pyramid is written to a new file that is recorded
+        // in the database.
+        pyramidFile = QStringLiteral("%1-%2%3")
+                              .arg(QString::number(info->analysisId),
+                                      QUuid::createUuid().toString(QUuid::WithoutBraces),
+                                      kPyramidFileSuffix);
+        const QString pyramidPath = analysisPath.absoluteFilePath(pyramidFile);
+        if (!saveDataToFile(pyramidPath, info->pWaveformPyramid->toByteArray())) {
+            qDebug() << "WARNING: Couldn't save waveform pyramid to file" << pyramidPath;
+            return false;
+        }
+        pMappedPyramid = WaveformPyramid::open(pyramidPath);
+        deleteFile(dataPath);
+    } else if (!saveDataToFile(dataPath, compressedData)) {
         qDebug() << "WARNING: Couldn't save analysis data to file" << dataPath;
         return false;
     }
 
+    query.prepare(QString(
+        "UPDATE %1 SET pyramid_file = :pyramidFile "
+        "WHERE id = :analysisId").arg(s_analysisTableName));
+    query.bindValue(":analysisId", info->analysisId);
+    query.bindValue(":pyramidFile",
+            pyramidFile.isEmpty() ? QVariant() : QVariant(pyramidFile));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "couldn't update waveform pyramid of analysis";
+        deletePyramidFile(analysisPath, pyramidFile);
+        return false;
+    }
+    if (pMappedPyramid) {
+        // Continue with the mapped file instead of the encoded data
+        info->pWaveformPyramid = std::move(pMappedPyramid);
+    }
+    // Also deletes previous pyramids that could not be deleted while they
+    // were mapped
+    deletePyramidFiles(analysisPath, info->analysisId, pyramidFile);
+
     qDebug() << "AnalysisDAO saved analysis" << info->analysisId
              << QString("%1 (%2 compressed)").arg(QString::number(info->data.length()),
                                                   QString::number(compressedData.length()))
@@ -198,9 +258,11 @@ bool AnalysisDao::deleteAnalysis(const int analysisId) {
         return false;
     }
 
-    QString dataPath = getAnalysisStoragePath().absoluteFilePath(
+    const QDir analysisPath(getAnalysisStoragePath());
+    QString dataPath = analysisPath.absoluteFilePath(
         QString::number(analysisId));
     deleteFile(dataPath);
+    deletePyramidFiles(analysisPath, analysisId);
     return true;
 }
 
@@ -210,17 +272,20 @@ void AnalysisDao::deleteAnalyses(const QList<TrackId>& trackIds) {
         idList << trackId.toString();
     }
     QSqlQuery query(m_database);
-    query.prepare(QString("SELECT track_analysis.id FROM track_analysis WHERE "
+    query.prepare(QString("SELECT track_analysis.id, track_analysis.pyramid_file "
+                          "FROM track_analysis WHERE "
                           "track_id in (%1)").arg(idList.join(",")));
     if (!query.exec()) {
         LOG_FAILED_QUERY(query) << "couldn't delete analysis";
     }
     const int idColumn = query.record().indexOf("id");
+    const int pyramidFileColumn = query.record().indexOf("pyramid_file");
     QDir analysisPath(getAnalysisStoragePath());
     while (query.next()) {
         int id = query.value(idColumn).toInt();
         QString dataPath = analysisPath.absoluteFilePath(QString::number(id));
         deleteFile(dataPath);
+        deletePyramidFile(analysisPath, query.value(pyramidFileColumn).toString());
     }
     query.prepare(QString("DELETE FROM track_analysis "
                           "WHERE track_id in (%1)").arg(idList.join(",")));
@@ -261,6 +326,28 @@ QDir AnalysisDao::getAnalysisStoragePath() const {
     return dir.absolutePath().append("/");
 }
 
+void AnalysisDao::deletePyramidFile(
+        const QDir& analysisPath, const QString& pyramidFile) const {
+    if (pyramidFile.isEmpty()) {
+        return;
+    }
+    deleteFile(analysisPath.absoluteFilePath(pyramidFile));
+}
+
+void AnalysisDao::deletePyramidFiles(const QDir& analysisPath,
+        int analysisId,
+        const QString& keepPyramidFile) const {
+    const QStringList pyramidFiles = analysisPath.entryList(
+            QStringList{QStringLiteral("%1-*%2").arg(
+                    QString::number(analysisId), kPyramidFileSuffix)},
+            QDir::Files);
+    for (const auto& pyramidFile : pyramidFiles) {
+        if (pyramidFile != keepPyramidFile) {
+            deletePyramidFile(analysisPath, pyramidFile);
+        }
+    }
+}
+
 QByteArray AnalysisDao::loadDataFromFile(const QString& filename) const {
     QFile file(filename);
     if (!file.exists()) {
@@ -339,9 +426,16 @@ void AnalysisDao::saveTrackAnalyses(
     analysis.type = AnalysisDao::TYPE_WAVEFORM;
     analysis.description = pWaveform->getDescription();
     analysis.version = pWaveform->getVersion();
-    analysis.data = pWaveform->toByteArray();
+    // The waveform is only stored as a pyramid, see saveAnalysis()
+    analysis.pWaveformPyramid = WaveformPyramid::fromByteArray(
+            WaveformPyramid::encode(*pWaveform));
+    if (!analysis.pWaveformPyramid) {
+        analysis.data = pWaveform->toByteArray();
+    }
     bool success = saveAnalysis(&analysis);
     if (success) {
+        // Renderers use the pyramid as soon as it is available
+        pWaveform->setPyramid(analysis.pWaveformPyramid);
         pWaveform->setSaveState(Waveform::SaveState::Saved);
     }
 
@@ -354,6 +448,7 @@ void AnalysisDao::saveTrackAnalyses(
     analysis.type = AnalysisDao::TYPE_WAVESUMMARY;
     analysis.description = pWaveSummary->getDescription();
     analysis.version = pWaveSummary->getVersion();
+    analysis.pWaveformPyramid.reset();
     analysis.data = pWaveSummary->toByteArray();
 
     success = saveAnalysis(&analysis);
@@ -371,7 +466,8 @@ size_t AnalysisDao::getDiskUsageInBytes(
     QDir analysisPath(getAnalysisStoragePath());
 
     QSqlQuery query(database);
-    query.prepare(QString("SELECT id FROM %1 WHERE type=:type").arg(s_analysisTableName));
+    query.prepare(QString("SELECT id, pyramid_file FROM %1 WHERE type=:type")
+                          .arg(s_analysisTableName));
     query.bindValue(":type", type);
 
     if (!query.exec()) {
@@ -380,10 +476,14 @@ size_t AnalysisDao::getDiskUsageInBytes(
     }
 
     const int idColumn = query.record().indexOf("id");
+    const int pyramidFileColumn = query.record().indexOf("pyramid_file");
     size_t total = 0;
     while (query.next()) {
-        total += QFileInfo(analysisPath.absoluteFilePath(
-                query.value(idColumn).toString())).size();
+        const QString pyramidFile = query.value(pyramidFileColumn).toString();
+        total += QFileInfo(analysisPath.absoluteFilePath(pyramidFile.isEmpty()
+                                           ? query.value(idColumn).toString()
+                                           : pyramidFile))
+                         .size();
     }
     return total;
 }
@@ -394,7 +494,8 @@ bool AnalysisDao::deleteAnalysesByType(
     QDir analysisPath(getAnalysisStoragePath());
 
     QSqlQuery query(database);
-    query.prepare(QString("SELECT id FROM %1 WHERE type=:type").arg(s_analysisTableName));
+    query.prepare(QString("SELECT id, pyramid_file FROM %1 WHERE type=:type")
+                          .arg(s_analysisTableName));
     query.bindValue(":type", type);
 
     if (!query.exec()) {
@@ -403,9 +504,11 @@ bool AnalysisDao::deleteAnalysesByType(
     }
 
     const int idColumn = query.record().indexOf("id");
+    const int pyramidFileColumn = query.record().indexOf("pyramid_file");
     while (query.next()) {
         QString dataPath = analysisPath.absoluteFilePath(query.value(idColumn).toString());
         deleteFile(dataPath);
+        deletePyramidFile(analysisPath, query.value(pyramidFileColumn).toString());
     }
     query.prepare(QString("DELETE FROM %1 WHERE type=:type").arg(s_analysisTableName));
     query.bindValue(":type", type);
@@ -6,6 +6,7 @@
 #include "library/dao/dao.h"
 #include "track/trackid.h"
 #include "waveform/waveform.h"
+#include "waveform/waveformpyramid.h"
 
 class QSqlDatabase;
 
@@ -30,6 +31,9 @@ class AnalysisDao : public DAO {
         QString description;
         QString version;
         QByteArray data;
+        // Waveforms are stored as a memory-mapped pyramid instead of the
+        // data, which is left empty in this case.
+        ConstWaveformPyramidPointer pWaveformPyramid;
     };
 
     explicit AnalysisDao(UserSettingsPointer pConfig);
@@ -59,6 +63,11 @@ class AnalysisDao : public DAO {
 
   private:
     QDir getAnalysisStoragePath() const;
+    void deletePyramidFile(const QDir& analysisPath, const QString& pyramidFile) const;
+    // Deletes all pyramid files of an analysis except the given one
+    void deletePyramidFiles(const QDir& analysisPath,
+            int analysisId,
+            const QString& keepPyramidFile = QString()) const;
     QByteArray loadDataFromFile(const QString& fileName) const;
     bool saveDataToFile(const QString& fileName, const QByteArray& data) const;
     bool deleteFile(const QString& filename) const;
@@ -0,0 +1,194 @@
+#include "library/dao/fulltextsearchdao.h"
+
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QVariant>
+#include <vector>
+
+#include "library/queryutil.h"
+#include "util/db/dbconnection.h"
+#include "util/db/sqltransaction.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("FullTextSearchDao");
+
+const QString kDirtyTableName = QStringLiteral("library_fts_dirty");
+
+const QString kLocationColumn = QStringLiteral("location");
+
+// The triggers are not part of schema.xml, because the schema
+// manager splits the migrations into statements at each semicolon.
+const QStringList kCreateTriggerStatements = {
+        QStringLiteral(
+                "CREATE TRIGGER IF NOT EXISTS library_fts_insert "
+                "AFTER INSERT ON library BEGIN "
+                "INSERT OR IGNORE INTO library_fts_dirty (id) VALUES (new.id); "
+                "END"),
+        QStringLiteral(
+                "CREATE TRIGGER IF NOT EXISTS library_fts_update "
+                "AFTER UPDATE OF artist, album_artist, album, title, genre, "
+                "composer, grouping, comment, location ON library BEGIN "
+                "INSERT OR IGNORE INTO library_fts_dirty (id) VALUES (new.id); "
+                "END"),
+        QStringLiteral(
+                "CREATE TRIGGER IF NOT EXISTS library_fts_delete "
+                "AFTER DELETE ON library BEGIN "
+                "INSERT OR IGNORE INTO library_fts_dirty (id) VALUES (old.id); "
+                "END"),
+        QStringLiteral(
+                "CREATE TRIGGER IF NOT EXISTS library_fts_location "
+                "AFTER UPDATE OF location ON track_locations BEGIN "
+                "INSERT OR IGNORE INTO library_fts_dirty (id) "
+                "SELECT id FROM library WHERE location=new.id; "
+                "END"),
+};
+
+struct DirtyTrack {
+    QVariant id;
+    bool removed;
+    QVariantList values;
+};
+
+} // anonymous namespace
+
+const QString FullTextSearchDao::s_ftsTableName = QStringLiteral("library_fts");
+
+//static
+const QStringList& FullTextSearchDao::indexedColumns() {
+    static const QStringList kIndexedColumns = {
+            QStringLiteral("artist"),
+            QStringLiteral("album_artist"),
+            QStringLiteral("album"),
+            QStringLiteral("title"),
+            QStringLiteral("genre"),
+            QStringLiteral("composer"),
+            QStringLiteral("grouping"),
+            QStringLiteral("comment"),
+            kLocationColumn,
+    };
+    return kIndexedColumns;
+}
+
+void FullTextSearchDao::initialize(const QSqlDatabase& database) {
+    DAO::initialize(database);
+    m_available = false;
+    if (!m_database.isOpen()) {
+        return;
+    }
+
+    for (const auto& statement : kCreateTriggerStatements) {
+        QSqlQuery query(m_database);
+        if (!query.exec(statement)) {
+            LOG_FAILED_QUERY(query);
+            return;
+        }
+    }
+
+    // Modified tracks are recorded by the triggers even if the index is
+    // not available. They are indexed as soon as it becomes available,
+    // e.g. after an update of the SQLite library.
+    QSqlQuery query(m_database);
+    if (!query.exec(QStringLiteral(
+                "CREATE VIRTUAL TABLE IF NOT EXISTS %1 USING fts5(%2, "
+                "tokenize='trigram')")
+                        .arg(s_ftsTableName, indexedColumns().join(", ")))) {
+        kLogger.info()
+                << "Full-text search is not supported by the SQLite library:"
+                << query.lastError();
+        return;
+    }
+    m_available = true;
+}
+
+int FullTextSearchDao::updateDirtyTracks(int maxTrackCount) {
+    if (!m_available) {
+        return -1;
+    }
+    DEBUG_ASSERT(maxTrackCount > 0);
+
+    QStringList columns;
+    for (const auto& column : indexedColumns()) {
+        // The library only contains the id of the location
+        if (column == kLocationColumn) {
+            columns << QStringLiteral("track_locations.location");
+        } else {
+            columns << QStringLiteral("library.") + column;
+        }
+    }
+
+    SqlTransaction transaction(m_database);
+    QSqlQuery selectQuery(m_database);
+    selectQuery.setForwardOnly(true);
+    selectQuery.prepare(QStringLiteral(
+            "SELECT %1.id, library.id IS NULL, %2 FROM %1 "
+            "LEFT JOIN library ON library.id=%1.id "
+            "LEFT JOIN track_locations ON track_locations.id=library.location "
+            "LIMIT %3")
+                                .arg(kDirtyTableName,
+                                        columns.join(", "),
+                                        QString::number(maxTrackCount)));
+    if (!selectQuery.exec()) {
+        LOG_FAILED_QUERY(selectQuery);
+        return -1;
+    }
+    std::vector<DirtyTrack> dirtyTracks;
+    while (selectQuery.next()) {
+        DirtyTrack dirtyTrack;
+        dirtyTrack.id = selectQuery.value(0);
+        dirtyTrack.removed = selectQuery.value(1).toBool();
+        for (int i = 0; i < indexedColumns().size(); ++i) {
+            QString value = selectQuery.value(i + 2).toString();
+            if (value.isNull()) {
+                dirtyTrack.values << QVariant();
+            } else {
+                mixxx::DbConnection::makeStringLatinLow(&value);
+                dirtyTrack.values << value;
+            }
+        }
+        dirtyTracks.push_back(std::move(dirtyTrack));
+    }
+
+    QStringList placeholders;
+    for (int i = 0; i < indexedColumns().size(); ++i) {
+        placeholders << QStringLiteral("?");
+    }
+    QSqlQuery deleteQuery(m_database);
+    deleteQuery.prepare(QStringLiteral("DELETE FROM %1 WHERE rowid=?")
+                                .arg(s_ftsTableName));
+    QSqlQuery insertQuery(m_database);
+    insertQuery.prepare(QStringLiteral("INSERT INTO %1 (rowid, %2) VALUES (?, %3)")
+                                .arg(s_ftsTableName,
+                                        indexedColumns().join(", "),
+                                        placeholders.join(", ")));
+    QSqlQuery cleanQuery(m_database);
+    cleanQuery.prepare(QStringLiteral("DELETE FROM %1 WHERE id=?")
+                               .arg(kDirtyTableName));
+    for (const auto& dirtyTrack : dirtyTracks) {
+        deleteQuery.addBindValue(dirtyTrack.id);
+        if (!deleteQuery.exec()) {
+            LOG_FAILED_QUERY(deleteQuery);
+            return -1;
+        }
+        if (!dirtyTrack.removed) {
+            insertQuery.addBindValue(dirtyTrack.id);
+            for (const auto& value : dirtyTrack.values) {
+                insertQuery.addBindValue(value);
+            }
+            if (!insertQuery.exec()) {
+                LOG_FAILED_QUERY(insertQuery);
+                return -1;
+            }
+        }
+        cleanQuery.addBindValue(dirtyTrack.id);
+        if (!cleanQuery.exec()) {
+            LOG_FAILED_QUERY(cleanQuery);
+            return -1;
+        }
+    }
+    if (!transaction.commit()) {
+        return -1;
+    }
+    return static_cast<int>(dirtyTracks.size());
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+
+#include "library/dao/dao.h"
+
+/// Maintains an SQLite FTS5 index of the text columns of the library
+/// that are searched with TextFilterNode.
+///
+/// The trigram tokenizer of FTS5 matches arbitrary substrings with at
+/// least 3 characters. The indexed strings are folded with
+/// DbConnection::makeStringLatinLow() like the custom LIKE operator of
+/// our database connections, i.e. a MATCH query returns the same tracks
+/// as the corresponding LIKE '%x%' expressions.
+///
+/// Triggers only record the ids of modified tracks in the table
+/// library_fts_dirty, because the folding function is not available for
+/// other database connections. The index is updated incrementally from
+/// this table by updateDirtyTracks().
+class FullTextSearchDao : public DAO {
+  public:
+    static const QString s_ftsTableName;
+
+    ~FullTextSearchDao() override = default;
+
+    /// Creates the triggers and the index if they do not exist yet.
+    void initialize(const QSqlDatabase& database) override;
+
+    /// The columns that are indexed. The column names of the index are
+    /// identical to those of the library table.
+    static const QStringList& indexedColumns();
+
+    /// Returns false if the SQLite library does not support FTS5 or the
+    /// trigram tokenizer.
+    bool isAvailable() const {
+        return m_available;
+    }
+
+    /// Indexes up to maxTrackCount tracks that have been modified.
+    ///
+    /// Returns the number of updated tracks or -1 on failure. All tracks
+    /// are up-to-date if less than maxTrackCount tracks have been updated.
+    int updateDirtyTracks(int maxTrackCount);
+
+  private:
+    bool m_available = false;
+};
@@ -18,6 +18,7 @@
 #include "library/library_prefs.h"
 #include "library/queryutil.h"
 #include "moc_trackdao.cpp"
+#include "sources/importedtracksource.h"
 #include "sources/soundsourceproxy.h"
 #include "track/beats.h"
 #include "track/globaltrackcache.h"
@@ -814,7 +815,8 @@ TrackId TrackDAO::addTracksAddTrack(const TrackPointer& pTrack, bool unremove) {
 
 TrackPointer TrackDAO::addTracksAddFile(
         const mixxx::FileAccess& fileAccess,
-        bool unremove) {
+        bool unremove,
+        ImportedTrackSource* pImportedTrackSource) {
     // Check that track is a supported extension.
     // TODO(uklotzde): The following check can be skipped if
     // the track is already in the library. A refactoring is
@@ -862,9 +864,15 @@ TrackPointer TrackDAO::addTracksAddFile(
 
     // Initially (re-)import the metadata for the newly created track
     // from the file.
-    SoundSourceProxy(pTrack).updateTrackFromSource(
-            SoundSourceProxy::UpdateTrackFromSourceMode::Once,
-            SyncTrackMetadataParams::readFromUserSettings(*m_pConfig));
+    if (pImportedTrackSource) {
+        SoundSourceProxy(pTrack).updateTrackFromImportedSource(
+                std::move(*pImportedTrackSource),
+                SyncTrackMetadataParams::readFromUserSettings(*m_pConfig));
+    } else {
+        SoundSourceProxy(pTrack).updateTrackFromSource(
+                SoundSourceProxy::UpdateTrackFromSourceMode::Once,
+                SyncTrackMetadataParams::readFromUserSettings(*m_pConfig));
+    }
     if (!pTrack->checkSourceSynchronized()) {
         qWarning() << "TrackDAO::addTracksAddFile:"
                 << "Failed to parse track metadata from file"
@@ -984,7 +992,8 @@ QList<TrackRef> TrackDAO::getAllTrackRefs(const QDir& rootDir) const {
 }
 
 bool TrackDAO::onPurgingTracks(
-        const QList<TrackId>& trackIds) const {
+        const QList<TrackId>& trackIds,
+        QStringList* pLocations) const {
     if (trackIds.empty()) {
         return true; // nothing to do
     }
@@ -1055,6 +1064,9 @@ bool TrackDAO::onPurgingTracks(
         }
     }
 
+    if (pLocations) {
+        *pLocations = std::move(locations);
+    }
     return true;
 }
 
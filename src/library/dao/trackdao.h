@@ -17,6 +17,7 @@ class PlaylistDAO;
 class AnalysisDao;
 class CueDAO;
 class LibraryHashDAO;
+struct ImportedTrackSource;
 
 namespace mixxx {
 class FileInfo;
@@ -147,9 +148,12 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     TrackId addTracksAddTrack(
             const TrackPointer& pTrack,
             bool unremove);
+    /// The optional metadata that has been imported in advance is
+    /// consumed when initializing a newly created track object.
     TrackPointer addTracksAddFile(
             const mixxx::FileAccess& fileAccess,
-            bool unremove);
+            bool unremove,
+            ImportedTrackSource* pImportedTrackSource = nullptr);
     TrackPointer addTracksAddFile(
             const QString& filePath,
             bool unremove) {
@@ -173,8 +177,10 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     void afterUnhidingTracks(
             const QList<TrackId>& trackIds);
 
+    // Optionally returns the locations of the purged tracks
     bool onPurgingTracks(
-            const QList<TrackId>& trackIds) const;
+            const QList<TrackId>& trackIds,
+            QStringList* pLocations = nullptr) const;
     void afterPurgingTracks(
             const QList<TrackId>& trackIds);
 
@@ -0,0 +1,86 @@
+#include "library/fulltextsearchindexer.h"
+
+#include "library/dao/fulltextsearchdao.h"
+#include "moc_fulltextsearchindexer.cpp"
+#include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("FullTextSearchIndexer");
+
+// The number of tracks that are indexed in a single transaction
+constexpr int kBatchSize = 500;
+
+// The pause between two batches for writing with other connections
+constexpr unsigned long kBatchIntervalMillis = 20;
+
+} // anonymous namespace
+
+FullTextSearchIndexer::FullTextSearchIndexer(mixxx::DbConnectionPoolPtr pDbConnectionPool)
+        : m_pDbConnectionPool(std::move(pDbConnectionPool)),
+          m_updating(0) {
+    // Move FullTextSearchIndexer to its own thread so that our signals/slots
+    // will queue to our event loop.
+    moveToThread(this);
+    setObjectName(QStringLiteral("FullTextSearchIndexer"));
+
+    connect(this,
+            &FullTextSearchIndexer::updateRequested,
+            this,
+            &FullTextSearchIndexer::slotUpdate);
+}
+
+FullTextSearchIndexer::~FullTextSearchIndexer() {
+    // Abort indexing after the current batch
+    requestInterruption();
+    quit();
+    wait();
+}
+
+void FullTextSearchIndexer::update() {
+    m_updating.storeRelease(1);
+    emit updateRequested();
+}
+
+void FullTextSearchIndexer::run() {
+    kLogger.debug() << "Entering thread";
+    {
+        const mixxx::DbConnectionPooler dbConnectionPooler(m_pDbConnectionPool);
+        if (dbConnectionPooler.isPooling()) {
+            m_pFullTextSearchDao = std::make_unique<FullTextSearchDao>();
+            m_pFullTextSearchDao->initialize(
+                    mixxx::DbConnectionPooled(m_pDbConnectionPool));
+        } else {
+            kLogger.warning()
+                    << "Failed to open database connection for full-text search";
+        }
+
+        // Start the event loop. Updates fail without a database connection.
+        exec();
+
+        // Release the database connection before it is closed
+        m_pFullTextSearchDao.reset();
+    }
+    kLogger.debug() << "Exiting thread";
+}
+
+void FullTextSearchIndexer::slotUpdate() {
+    if (!m_pFullTextSearchDao || !m_pFullTextSearchDao->isAvailable()) {
+        m_updating.storeRelease(0);
+        return;
+    }
+    while (!isInterruptionRequested()) {
+        const int updatedTrackCount = m_pFullTextSearchDao->updateDirtyTracks(kBatchSize);
+        if (updatedTrackCount < kBatchSize) {
+            // Either finished or failed
+            if (updatedTrackCount >= 0) {
+                kLogger.info() << "Full-text index is up-to-date";
+            }
+            break;
+        }
+        msleep(kBatchIntervalMillis);
+    }
+    m_updating.storeRelease(0);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QAtomicInt>
+#include <QThread>
+#include <memory>
+
+#include "util/db/dbconnectionpool.h"
+
+class FullTextSearchDao;
+
+/// Indexes modified tracks for full-text search with a pooled database
+/// connection on its own thread, e.g. after the schema migration or a
+/// library scan.
+///
+/// The tracks are indexed in small batches, each in a separate
+/// transaction. Other database connections are able to write in
+/// between.
+class FullTextSearchIndexer : public QThread {
+    Q_OBJECT
+  public:
+    explicit FullTextSearchIndexer(mixxx::DbConnectionPoolPtr pDbConnectionPool);
+    ~FullTextSearchIndexer() override;
+
+    /// Call from any thread. Indexes all modified tracks in the
+    /// background.
+    void update();
+
+    /// Returns true until all modified tracks have been indexed
+    /// after update() has been invoked.
+    bool isUpdating() const {
+        return m_updating.loadAcquire() != 0;
+    }
+
+  signals:
+    // Emitted by update() to invoke slotUpdate() in the indexer thread's
+    // event loop.
+    void updateRequested();
+
+  protected:
+    void run() override;
+
+  private slots:
+    void slotUpdate();
+
+  private:
+    const mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+
+    // Only accessed by the indexer thread
+    std::unique_ptr<FullTextSearchDao> m_pFullTextSearchDao;
+
+    QAtomicInt m_updating;
+};
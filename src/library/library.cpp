@@ -3,8 +3,10 @@
 #include <QApplication>
 #include <QDir>
 #include <QMessageBox>
+#include <QThread>
 
 #include "control/controlobject.h"
+#include "control/pollingcontrolproxy.h"
 #include "controllers/keyboard/keyboardeventfilter.h"
 #include "library/analysis/analysisfeature.h"
 #include "library/autodj/autodjfeature.h"
@@ -35,6 +37,7 @@
 #include "moc_library.cpp"
 #include "util/assert.h"
 #include "util/logger.h"
+#include "util/math.h"
 #include "util/sandbox.h"
 #include "widget/wlibrary.h"
 #include "widget/wlibrarysidebar.h"
@@ -67,6 +70,20 @@ Library::Library(
           m_pConfig(pConfig),
           m_pDbConnectionPool(std::move(pDbConnectionPool)),
           m_pTrackCollectionManager(pTrackCollectionManager),
+          m_pAnalysisExecutor(std::make_shared<AnalysisExecutor>(
+                  math_max(1, QThread::idealThreadCount()),
+                  [audioLatencyUsage = PollingControlProxy(
+                           ConfigKey(QStringLiteral("[App]"),
+                                   QStringLiteral("audio_latency_usage")),
+                           ControlFlag::AllowMissingOrInvalid)] {
+                      return audioLatencyUsage.get();
+                  },
+                  [audioLatencyUsagePeak = PollingControlProxy(
+                           ConfigKey(QStringLiteral("[App]"),
+                                   QStringLiteral("audio_latency_usage_peak")),
+                           ControlFlag::AllowMissingOrInvalid)] {
+                      return audioLatencyUsagePeak.get();
+                  })),
           m_pSidebarModel(make_parented<SidebarModel>(this)),
           m_pLibraryControl(make_parented<LibraryControl>(this)),
           m_pLibraryWidget(nullptr),
@@ -152,16 +169,9 @@ Library::Library(
             m_pAnalysisFeature,
             &AnalysisFeature::analyzeTracks);
     addFeature(m_pAnalysisFeature);
-    // Suspend a batch analysis while an ad-hoc analysis of
-    // loaded tracks is in progress and resume it afterwards.
-    connect(pPlayerManager,
-            &PlayerManager::trackAnalyzerProgress,
-            this,
-            &Library::onPlayerManagerTrackAnalyzerProgress);
-    connect(pPlayerManager,
-            &PlayerManager::trackAnalyzerIdle,
-            this,
-            &Library::onPlayerManagerTrackAnalyzerIdle);
+    // A batch analysis is not suspended while loaded tracks are analyzed.
+    // Instead the shared AnalysisExecutor grants the loaded tracks a
+    // higher priority.
 
     // iTunes and Rhythmbox should be last until we no longer have an obnoxious
     // messagebox popup when you select them. (This forces you to reach for your
@@ -289,7 +299,8 @@ TrackAnalysisScheduler::Pointer Library::createTrackAnalysisScheduler(
             numWorkerThreads,
             m_pDbConnectionPool,
             m_pConfig,
-            modeFlags);
+            modeFlags,
+            m_pAnalysisExecutor);
 }
 
 void Library::stopPendingTasks() {
@@ -515,19 +526,6 @@ void Library::addFeature(LibraryFeature* feature) {
             &Library::restoreModelState);
 }
 
-void Library::onPlayerManagerTrackAnalyzerProgress(
-        TrackId /*trackId*/, AnalyzerProgress /*analyzerProgress*/) {
-    if (m_pAnalysisFeature) {
-        m_pAnalysisFeature->suspendAnalysis();
-    }
-}
-
-void Library::onPlayerManagerTrackAnalyzerIdle() {
-    if (m_pAnalysisFeature) {
-        m_pAnalysisFeature->resumeAnalysis();
-    }
-}
-
 void Library::slotShowTrackModel(QAbstractItemModel* model) {
     // qDebug() << "Library::slotShowTrackModel" << model;
     TrackModel* trackModel = dynamic_cast<TrackModel*>(model);
@@ -5,6 +5,7 @@
 #include <QObject>
 #include <QPointer>
 
+#include "analyzer/analysisexecutor.h"
 #include "analyzer/trackanalysisscheduler.h"
 #include "library/library_decl.h"
 #ifdef __ENGINEPRIME__
@@ -141,10 +142,6 @@ class Library: public QObject {
     void setTrackTableRowHeight(int rowHeight);
     void setSelectedClick(bool enable);
 
-  private slots:
-      void onPlayerManagerTrackAnalyzerProgress(TrackId trackId, AnalyzerProgress analyzerProgress);
-      void onPlayerManagerTrackAnalyzerIdle();
-
   private:
     const UserSettingsPointer m_pConfig;
 
@@ -153,6 +150,11 @@ class Library: public QObject {
 
     const QPointer<TrackCollectionManager> m_pTrackCollectionManager;
 
+    // Shared by the analyzer threads of all TrackAnalysisScheduler
+    // instances that limits the number of concurrent analyses and
+    // prefers tracks that have been loaded into a deck.
+    const std::shared_ptr<AnalysisExecutor> m_pAnalysisExecutor;
+
     parented_ptr<SidebarModel> m_pSidebarModel;
     parented_ptr<LibraryControl> m_pLibraryControl;
 
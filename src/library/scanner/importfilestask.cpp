@@ -1,6 +1,8 @@
 #include "library/scanner/importfilestask.h"
 
+#include "library/coverartutils.h"
 #include "moc_importfilestask.cpp"
+#include "sources/soundsourceproxy.h"
 #include "util/timer.h"
 
 ImportFilesTask::ImportFilesTask(LibraryScanner* pScanner,
@@ -22,6 +24,10 @@ ImportFilesTask::ImportFilesTask(LibraryScanner* pScanner,
 
 void ImportFilesTask::run() {
     ScopedTimer timer(u"ImportFilesTask::run");
+    lowerThreadPriority();
+    // All files are located in the same directory that only needs
+    // to be searched once for cover art
+    CoverInfoGuesser coverInfoGuesser;
     for (const QFileInfo& fileInfo: m_filesToImport) {
         // If a flag was raised telling us to cancel the library scan then stop.
         if (m_scannerGlobal->shouldCancel()) {
@@ -47,9 +53,21 @@ void ImportFilesTask::run() {
                         << trackLocation;
                 continue;
             }
+            // Released by the scanner thread after the track has been added
+            if (!m_scannerGlobal->acquirePendingImportedTrack()) {
+                setSuccess(false);
+                return;
+            }
             qDebug() << "Importing track" << trackLocation;
 
-            emit addNewTrack(trackLocation);
+            // Parse the file on this worker thread. Only the resulting
+            // values are passed to the scanner thread that adds the
+            // new tracks to the database one after another.
+            emit addNewTrack(trackLocation,
+                    SoundSourceProxy::importTrackSourceFromFile(
+                            mixxx::FileAccess(mixxx::FileInfo(fileInfo), m_pToken),
+                            m_scannerGlobal->syncTrackMetadataParams(),
+                            &coverInfoGuesser));
         }
     }
     // Insert or update the hash in the database.
@@ -21,6 +21,7 @@ RecursiveScanDirectoryTask::RecursiveScanDirectoryTask(
 
 void RecursiveScanDirectoryTask::run() {
     ScopedTimer timer(u"RecursiveScanDirectoryTask::run");
+    lowerThreadPriority();
     if (m_scannerGlobal->shouldCancel()) {
         setSuccess(false);
         return;
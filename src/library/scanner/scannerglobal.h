@@ -4,10 +4,12 @@
 #include <QHash>
 #include <QMutex>
 #include <QRegularExpression>
+#include <QSemaphore>
 #include <QSet>
 #include <QSharedPointer>
 #include <QStringList>
 
+#include "track/track_decl.h"
 #include "util/cache.h"
 #include "util/compatibility/qmutex.h"
 #include "util/fileaccess.h"
@@ -20,15 +22,18 @@ class ScannerGlobal {
             const QHash<QString, mixxx::cache_key_t>& directoryHashes,
             const QRegularExpression& supportedExtensionsMatcher,
             const QRegularExpression& supportedCoverExtensionsMatcher,
-            const QStringList& directoriesBlacklist)
+            const QStringList& directoriesBlacklist,
+            const SyncTrackMetadataParams& syncTrackMetadataParams)
             : m_trackLocations(trackLocations),
               m_directoryHashes(directoryHashes),
               m_supportedExtensionsMatcher(supportedExtensionsMatcher),
               m_supportedCoverExtensionsMatcher(supportedCoverExtensionsMatcher),
               m_directoriesBlacklist(directoriesBlacklist),
+              m_syncTrackMetadataParams(syncTrackMetadataParams),
               // Unless marked un-clean, we assume it will finish cleanly.
               m_scanFinishedCleanly(true),
               m_shouldCancel(false),
+              m_pendingImportedTracks(kMaxPendingImportedTracks),
               m_numScannedDirectories(0) {
     }
 
@@ -50,6 +55,10 @@ class ScannerGlobal {
         return m_directoriesBlacklist.contains(directoryPath);
     }
 
+    const SyncTrackMetadataParams& syncTrackMetadataParams() const {
+        return m_syncTrackMetadataParams;
+    }
+
     const QRegularExpression& supportedExtensionsRegex() const {
         return m_supportedExtensionsMatcher;
     }
@@ -106,6 +115,25 @@ class ScannerGlobal {
         m_shouldCancel = true;
     }
 
+    // Blocks the importing worker thread while too many imported tracks
+    // are waiting to be added to the database by the scanner thread.
+    // Otherwise the event queue of the scanner thread would grow without
+    // bound. Returns false if the scan has been cancelled while waiting.
+    bool acquirePendingImportedTrack() {
+        while (!m_pendingImportedTracks.tryAcquire(1, kPendingImportedTrackTimeoutMillis)) {
+            if (shouldCancel()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Invoked by the scanner thread after an imported track has been
+    // added to the database.
+    void releasePendingImportedTrack() {
+        m_pendingImportedTracks.release();
+    }
+
     bool scanFinishedCleanly() const {
         return m_scanFinishedCleanly;
     }
@@ -154,6 +182,10 @@ class ScannerGlobal {
     }
 
   private:
+    // Each imported track occupies some memory, e.g. for the cover art
+    static constexpr int kMaxPendingImportedTracks = 64;
+    static constexpr int kPendingImportedTrackTimeoutMillis = 100;
+
     TaskWatcher m_watcher;
 
     QSet<QString> m_trackLocations;
@@ -182,6 +214,8 @@ class ScannerGlobal {
     // this has never been investigated.
     QStringList m_directoriesBlacklist;
 
+    const SyncTrackMetadataParams m_syncTrackMetadataParams;
+
     // The list of directories verified by the scan.
     QStringList m_verifiedDirectories;
 
@@ -194,6 +228,8 @@ class ScannerGlobal {
     volatile bool m_scanFinishedCleanly;
     volatile bool m_shouldCancel;
 
+    QSemaphore m_pendingImportedTracks;
+
     // Stats tracking.
     PerformanceTimer m_timer;
     int m_numScannedDirectories;
@@ -1,6 +1,7 @@
 #include "library/scanner/scannertask.h"
 
 #include "moc_scannertask.cpp"
+#include "util/backgroundthread.h"
 
 ScannerTask::ScannerTask(LibraryScanner* pScanner,
                          const ScannerGlobalPointer scannerGlobal)
@@ -16,3 +17,11 @@ ScannerTask::~ScannerTask() {
     }
     m_scannerGlobal->getTaskWatcher().taskDone();
 }
+
+void ScannerTask::lowerThreadPriority() {
+    // The thread pool of the LibraryScanner is only used for scanner
+    // tasks and the settings persist for all following tasks. Repeating
+    // them is cheap and picks up when the audio thread has migrated.
+    mixxx::setCurrentThreadBackgroundScheduling();
+    mixxx::avoidAudioCallbackCpu();
+}
@@ -4,6 +4,7 @@
 #include <QRunnable>
 
 #include "library/scanner/scannerglobal.h"
+#include "sources/importedtracksource.h"
 
 class LibraryScanner;
 
@@ -23,13 +24,18 @@ class ScannerTask : public QObject, public QRunnable {
                                    bool newDirectory, mixxx::cache_key_t hash);
     void directoryUnchanged(const QString& directoryPath);
     void trackExists(const QString& filePath);
-    void addNewTrack(const QString& filePath);
+    void addNewTrack(const QString& filePath,
+            const ImportedTrackSource& importedTrackSource);
 
     // Feedback to GUI
     void progressLoading(const QString& fileName);
     void progressHashing(const QString& directoryPath);
 
   protected:
+    /// Lowers the priority of the pooled thread that runs the task.
+    /// Must be invoked at the beginning of run().
+    void lowerThreadPriority();
+
     void setSuccess(bool success) {
         m_success = success;
     }
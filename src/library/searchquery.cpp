@@ -1,9 +1,13 @@
 #include "library/searchquery.h"
 
 #include <QRegularExpression>
+#include <algorithm>
+#include <cmath>
 
+#include "library/dao/fulltextsearchdao.h"
 #include "library/dao/trackschema.h"
 #include "library/queryutil.h"
+#include "library/tracksearchindex.h"
 #include "library/trackset/crate/crateschema.h"
 #include "library/trackset/crate/cratestorage.h" // for CrateTrackSelectResult
 #include "track/keyutils.h"
@@ -24,6 +28,10 @@ const QRegularExpression kDurationRegex(QStringLiteral("^(\\d+)(m|:)?([0-5]?\\d)
 // > are not necessarily greedy.
 const QRegularExpression kNumericOperatorRegex(QStringLiteral("^(<=|>=|=|<|>)(.*)$"));
 
+// The trigram tokenizer of the full-text index only matches
+// substrings with at least 3 characters.
+constexpr int kFullTextSearchMinArgumentLength = 3;
+
 QVariant getTrackValueForColumn(const TrackPointer& pTrack, const QString& column) {
     if (column == LIBRARYTABLE_ARTIST) {
         return pTrack->getArtist();
@@ -96,8 +104,86 @@ QString concatSqlClauses(
     }
 }
 
+bool hasIndexedTextColumns(const TrackSearchIndex& index, const QStringList& sqlColumns) {
+    for (const auto& sqlColumn : sqlColumns) {
+        if (!index.textColumn(sqlColumn)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool hasIndexedNumericColumns(const TrackSearchIndex& index, const QStringList& sqlColumns) {
+    for (const auto& sqlColumn : sqlColumns) {
+        if (!index.numericColumn(sqlColumn)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Evaluates the predicate for the values of all columns and combines
+/// the results by OR. A comparison with NULL results in NULL.
+template<typename Predicate>
+void matchIndexedNumericColumns(const TrackSearchIndex& index,
+        const QStringList& sqlColumns,
+        mixxx::IndexRange rows,
+        uint8_t* pMatches,
+        Predicate predicate) {
+    std::fill(pMatches, pMatches + rows.length(), TrackSearchIndex::kFalse);
+    for (const auto& sqlColumn : sqlColumns) {
+        const TrackSearchIndex::NumericColumn* pColumn = index.numericColumn(sqlColumn);
+        VERIFY_OR_DEBUG_ASSERT(pColumn) {
+            continue;
+        }
+        const double* pValues = pColumn->data() + rows.start();
+        for (SINT i = 0; i < rows.length(); ++i) {
+            const uint8_t match = std::isnan(pValues[i])
+                    ? TrackSearchIndex::kNull
+                    : (predicate(pValues[i]) ? TrackSearchIndex::kTrue
+                                             : TrackSearchIndex::kFalse);
+            pMatches[i] = std::max(pMatches[i], match);
+        }
+    }
+}
+
+/// Evaluates "column IS NULL".
+void matchIndexedNullNumericColumn(const TrackSearchIndex& index,
+        const QString& sqlColumn,
+        mixxx::IndexRange rows,
+        uint8_t* pMatches) {
+    const double* pValues = index.numericColumn(sqlColumn)->data() + rows.start();
+    for (SINT i = 0; i < rows.length(); ++i) {
+        pMatches[i] = std::isnan(pValues[i]) ? TrackSearchIndex::kTrue
+                                             : TrackSearchIndex::kFalse;
+    }
+}
+
 } // namespace
 
+void QueryNode::matchIndexed(const TrackSearchIndex& index,
+        mixxx::IndexRange rows,
+        uint8_t* pMatches) const {
+    Q_UNUSED(index);
+    DEBUG_ASSERT(!"Unreachable: Node cannot be evaluated with the search index");
+    std::fill(pMatches, pMatches + rows.length(), TrackSearchIndex::kFalse);
+}
+
+bool GroupNode::prepareIndexed(const TrackSearchIndex& index) const {
+    m_indexedNodes.clear();
+    for (const auto& pNode : m_nodes) {
+        // Nodes without an SQL expression are skipped by toSql()
+        if (pNode->toSql().isEmpty()) {
+            continue;
+        }
+        if (!pNode->prepareIndexed(index)) {
+            return false;
+        }
+        m_indexedNodes.push_back(pNode.get());
+    }
+    return true;
+}
+
 bool AndNode::match(const TrackPointer& pTrack) const {
     for (const auto& pNode : m_nodes) {
         if (!pNode->match(pTrack)) {
@@ -121,6 +207,21 @@ QString AndNode::toSql() const {
     return concatSqlClauses(queryFragments, "AND");
 }
 
+void AndNode::matchIndexed(const TrackSearchIndex& index,
+        mixxx::IndexRange rows,
+        uint8_t* pMatches) const {
+    // An empty AND node always evaluates to true
+    std::fill(pMatches, pMatches + rows.length(), TrackSearchIndex::kTrue);
+    std::vector<uint8_t> nodeMatches(rows.length());
+    for (const auto* pNode : m_indexedNodes) {
+        pNode->matchIndexed(index, rows, nodeMatches.data());
+        // note: LOOP VECTORIZED.
+        for (SINT i = 0; i < rows.length(); ++i) {
+            pMatches[i] = std::min(pMatches[i], nodeMatches[i]);
+        }
+    }
+}
+
 bool OrNode::match(const TrackPointer& pTrack) const {
     for (const auto& pNode : m_nodes) {
         if (pNode->match(pTrack)) {
@@ -145,6 +246,21 @@ QString OrNode::toSql() const {
     return concatSqlClauses(queryFragments, "OR");
 }
 
+void OrNode::matchIndexed(const TrackSearchIndex& index,
+        mixxx::IndexRange rows,
+        uint8_t* pMatches) const {
+    // An OR node without nodes evaluates to FALSE, see toSql()
+    std::fill(pMatches, pMatches + rows.length(), TrackSearchIndex::kFalse);
+    std::vector<uint8_t> nodeMatches(rows.length());
+    for (const auto* pNode : m_indexedNodes) {
+        pNode->matchIndexed(index, rows, nodeMatches.data());
+        // note: LOOP VECTORIZED.
+        for (SINT i = 0; i < rows.length(); ++i) {
+            pMatches[i] = std::max(pMatches[i], nodeMatches[i]);
+        }
+    }
+}
+
 bool NotNode::match(const TrackPointer& pTrack) const {
     return !m_pNode->match(pTrack);
 }
@@ -161,15 +277,33 @@ QString NotNode::toSql() const {
     }
 }
 
+bool NotNode::prepareIndexed(const TrackSearchIndex& index) const {
+    return m_pNode->prepareIndexed(index);
+}
+
+void NotNode::matchIndexed(const TrackSearchIndex& index,
+        mixxx::IndexRange rows,
+        uint8_t* pMatches) const {
+    m_pNode->matchIndexed(index, rows, pMatches);
+    // NOT NULL is NULL
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < rows.length(); ++i) {
+        pMatches[i] = TrackSearchIndex::kTrue - pMatches[i];
+    }
+}
+
 TextFilterNode::TextFilterNode(const QSqlDatabase& database,
         const QStringList& sqlColumns,
         const QString& argument,
-        const StringMatch matchMode)
+        const StringMatch matchMode,
+        bool fullTextSearch)
         : m_database(database),
           m_sqlColumns(sqlColumns),
           m_argument(argument),
-          m_matchMode(matchMode) {
+          m_matchMode(matchMode),
+          m_fullTextSearch(fullTextSearch) {
     mixxx::DbConnection::makeStringLatinLow(&m_argument);
+    m_argumentMatcher.setPattern(m_argument);
 }
 
 bool TextFilterNode::match(const TrackPointer& pTrack) const {
@@ -194,7 +328,52 @@ bool TextFilterNode::match(const TrackPointer& pTrack) const {
     return false;
 }
 
+bool TextFilterNode::canUseFullTextSearch() const {
+    if (!m_fullTextSearch || m_matchMode != StringMatch::Contains) {
+        return false;
+    }
+    // The wildcards of the LIKE operator and the special handling of a
+    // trailing space in toSql() are not supported
+    if (m_argument.toUcs4().size() < kFullTextSearchMinArgumentLength ||
+            m_argument.contains(kSqlLikeMatchAll) ||
+            m_argument.contains(kSqlLikeMatchOne) ||
+            m_argument[m_argument.size() - 1].isSpace()) {
+        return false;
+    }
+    for (const auto& sqlColumn : m_sqlColumns) {
+        if (!FullTextSearchDao::indexedColumns().contains(sqlColumn)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QString TextFilterNode::toFullTextSearchSql() const {
+    FieldEscaper escaper(m_database);
+    // The argument is matched as a single phrase in all columns, i.e. as
+    // a substring like with LIKE '%argument%'
+    QString phrase = m_argument;
+    phrase.replace(QChar('"'), QStringLiteral("\"\""));
+    const QString matchExpression = QStringLiteral("{%1} : \"%2\"")
+                                            .arg(m_sqlColumns.join(' '), phrase);
+    QStringList nullClauses;
+    for (const auto& sqlColumn : m_sqlColumns) {
+        nullClauses << QStringLiteral("%1 IS NULL").arg(sqlColumn);
+    }
+    // LIKE evaluates to NULL for NULL values and a negated query must not
+    // match those tracks either, see NotNode.
+    return QStringLiteral(
+            "CASE WHEN id IN (SELECT rowid FROM %1 WHERE %1 MATCH %2) THEN 1 "
+            "WHEN %3 THEN NULL ELSE 0 END")
+            .arg(FullTextSearchDao::s_ftsTableName,
+                    escaper.escapeString(matchExpression),
+                    nullClauses.join(" OR "));
+}
+
 QString TextFilterNode::toSql() const {
+    if (canUseFullTextSearch()) {
+        return toFullTextSearchSql();
+    }
     FieldEscaper escaper(m_database);
     QString argument = m_argument;
     if (argument.size() > 0) {
@@ -222,6 +401,39 @@ QString TextFilterNode::toSql() const {
     return concatSqlClauses(searchClauses, "OR");
 }
 
+bool TextFilterNode::prepareIndexed(const TrackSearchIndex& index) const {
+    // The wildcards of the LIKE operator and the special handling of a
+    // trailing space in toSql() are not supported by the index.
+    if (m_argument.isEmpty() ||
+            m_argument.contains(kSqlLikeMatchAll) ||
+            m_argument.contains(kSqlLikeMatchOne) ||
+            m_argument[m_argument.size() - 1].isSpace()) {
+        return false;
+    }
+    return hasIndexedTextColumns(index, m_sqlColumns);
+}
+
+void TextFilterNode::matchIndexed(const TrackSearchIndex& index,
+        mixxx::IndexRange rows,
+        uint8_t* pMatches) const {
+    std::fill(pMatches, pMatches + rows.length(), TrackSearchIndex::kFalse);
+    for (const auto& sqlColumn : m_sqlColumns) {
+        const TrackSearchIndex::TextColumn* pColumn = index.textColumn(sqlColumn);
+        VERIFY_OR_DEBUG_ASSERT(pColumn) {
+            continue;
+        }
+        // Using a switch-case without default case to get a compile-time -Wswitch warning
+        switch (m_matchMode) {
+        case StringMatch::Contains:
+            pColumn->matchContains(m_argumentMatcher, rows, pMatches);
+            break;
+        case StringMatch::Equals:
+            pColumn->matchEquals(m_argument, rows, pMatches);
+            break;
+        }
+    }
+}
+
 bool NullOrEmptyTextFilterNode::match(const TrackPointer& pTrack) const {
     if (!m_sqlColumns.isEmpty()) {
         // only use the major column
@@ -242,6 +454,17 @@ QString NullOrEmptyTextFilterNode::toSql() const {
     return QString();
 }
 
+bool NullOrEmptyTextFilterNode::prepareIndexed(const TrackSearchIndex& index) const {
+    return !m_sqlColumns.isEmpty() && index.textColumn(m_sqlColumns.first()) != nullptr;
+}
+
+void NullOrEmptyTextFilterNode::matchIndexed(const TrackSearchIndex& index,
+        mixxx::IndexRange rows,
+        uint8_t* pMatches) const {
+    // only use the major column
+    index.textColumn(m_sqlColumns.first())->matchEmpty(rows, pMatches);
+}
+
 CrateFilterNode::CrateFilterNode(const CrateStorage* pCrateStorage,
         const QString& crateNameLike)
         : m_pCrateStorage(pCrateStorage),
@@ -249,21 +472,46 @@ CrateFilterNode::CrateFilterNode(const CrateStorage* pCrateStorage,
           m_matchInitialized(false) {
 }
 
-bool CrateFilterNode::match(const TrackPointer& pTrack) const {
-    if (!m_matchInitialized) {
-        CrateTrackSelectResult crateTracks(
-                m_pCrateStorage->selectTracksSortedByCrateNameLike(m_crateNameLike));
-
-        while (crateTracks.next()) {
-            m_matchingTrackIds.push_back(crateTracks.trackId());
-        }
+void CrateFilterNode::initMatchingTrackIds() const {
+    if (m_matchInitialized) {
+        return;
+    }
+    CrateTrackSelectResult crateTracks(
+            m_pCrateStorage->selectTracksSortedByCrateNameLike(m_crateNameLike));
 
-        m_matchInitialized = true;
+    while (crateTracks.next()) {
+        m_matchingTrackIds.push_back(crateTracks.trackId());
     }
 
+    m_matchInitialized = true;
+}
+
+bool CrateFilterNode::match(const TrackPointer& pTrack) const {
+    initMatchingTrackIds();
     return std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), pTrack->getId());
 }
 
+bool CrateFilterNode::prepareIndexed(const TrackSearchIndex& index) const {
+    Q_UNUSED(index);
+    // The tracks of the crates are loaded in advance, because the
+    // nodes are evaluated concurrently
+    initMatchingTrackIds();
+    return true;
+}
+
+void CrateFilterNode::matchIndexed(const TrackSearchIndex& index,
+        mixxx::IndexRange rows,
+        uint8_t* pMatches) const {
+    for (auto row = rows.start(); row < rows.end(); ++row) {
+        pMatches[row - rows.start()] =
+                std::binary_search(m_matchingTrackIds.begin(),
+                        m_matchingTrackIds.end(),
+                        index.trackIdAt(static_cast<int>(row)))
+                ? TrackSearchIndex::kTrue
+                : TrackSearchIndex::kFalse;
+    }
+}
+
 QString CrateFilterNode::toSql() const {
     return QString("id IN (%1)")
             .arg(m_pCrateStorage->formatQueryForTrackIdsByCrateNameLike(
@@ -275,21 +523,46 @@ NoCrateFilterNode::NoCrateFilterNode(const CrateStorage* pCrateStorage)
           m_matchInitialized(false) {
 }
 
-bool NoCrateFilterNode::match(const TrackPointer& pTrack) const {
-    if (!m_matchInitialized) {
-        TrackSelectResult tracks(
-                m_pCrateStorage->selectAllTracksSorted());
-
-        while (tracks.next()) {
-            m_matchingTrackIds.push_back(tracks.trackId());
-        }
+void NoCrateFilterNode::initMatchingTrackIds() const {
+    if (m_matchInitialized) {
+        return;
+    }
+    TrackSelectResult tracks(
+            m_pCrateStorage->selectAllTracksSorted());
 
-        m_matchInitialized = true;
+    while (tracks.next()) {
+        m_matchingTrackIds.push_back(tracks.trackId());
     }
 
+    m_matchInitialized = true;
+}
+
+bool NoCrateFilterNode::match(const TrackPointer& pTrack) const {
+    initMatchingTrackIds();
     return !std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), pTrack->getId());
 }
 
+bool NoCrateFilterNode::prepareIndexed(const TrackSearchIndex& index) const {
+    Q_UNUSED(index);
+    // The tracks of all crates are loaded in advance, because the
+    // nodes are evaluated concurrently
+    initMatchingTrackIds();
+    return true;
+}
+
+void NoCrateFilterNode::matchIndexed(const TrackSearchIndex& index,
+        mixxx::IndexRange rows,
+        uint8_t* pMatches) const {
+    for (auto row = rows.start(); row < rows.end(); ++row) {
+        pMatches[row - rows.start()] =
+                std::binary_search(m_matchingTrackIds.begin(),
+                        m_matchingTrackIds.end(),
+                        index.trackIdAt(static_cast<int>(row)))
+                ? TrackSearchIndex::kFalse
+                : TrackSearchIndex::kTrue;
+    }
+}
+
 QString NoCrateFilterNode::toSql() const {
     return QString("%1 NOT IN (%2)")
             .arg(CRATETABLE_ID,
@@ -411,6 +684,61 @@ QString NumericFilterNode::toSql() const {
     return QString();
 }
 
+bool NumericFilterNode::prepareIndexed(const TrackSearchIndex& index) const {
+    return hasIndexedNumericColumns(index, m_sqlColumns);
+}
+
+void NumericFilterNode::matchIndexed(const TrackSearchIndex& index,
+        mixxx::IndexRange rows,
+        uint8_t* pMatches) const {
+    if (m_bNullQuery) {
+        // only use the major column
+        matchIndexedNullNumericColumn(index, m_sqlColumns.first(), rows, pMatches);
+        return;
+    }
+    // Use the same precision as the formatted numbers in toSql()
+    if (m_bOperatorQuery) {
+        const double argument = QString::number(m_dOperatorArgument).toDouble();
+        if (m_operator == "<") {
+            matchIndexedNumericColumns(index, m_sqlColumns, rows, pMatches, [argument](double value) {
+                return value < argument;
+            });
+        } else if (m_operator == ">") {
+            matchIndexedNumericColumns(index, m_sqlColumns, rows, pMatches, [argument](double value) {
+                return value > argument;
+            });
+        } else if (m_operator == "<=") {
+            matchIndexedNumericColumns(index, m_sqlColumns, rows, pMatches, [argument](double value) {
+                return value <= argument;
+            });
+        } else if (m_operator == ">=") {
+            matchIndexedNumericColumns(index, m_sqlColumns, rows, pMatches, [argument](double value) {
+                return value >= argument;
+            });
+        } else {
+            DEBUG_ASSERT(m_operator == "=");
+            matchIndexedNumericColumns(index, m_sqlColumns, rows, pMatches, [argument](double value) {
+                return value == argument;
+            });
+        }
+        return;
+    }
+    if (m_bRangeQuery) {
+        const double rangeLow = QString::number(m_dRangeLow).toDouble();
+        const double rangeHigh = QString::number(m_dRangeHigh).toDouble();
+        matchIndexedNumericColumns(index,
+                m_sqlColumns,
+                rows,
+                pMatches,
+                [rangeLow, rangeHigh](double value) {
+                    return value >= rangeLow && value <= rangeHigh;
+                });
+        return;
+    }
+    // No SQL expression, i.e. never evaluated
+    std::fill(pMatches, pMatches + rows.length(), TrackSearchIndex::kTrue);
+}
+
 NullNumericFilterNode::NullNumericFilterNode(const QStringList& sqlColumns)
         : m_sqlColumns(sqlColumns) {
 }
@@ -434,6 +762,17 @@ QString NullNumericFilterNode::toSql() const {
     return QString();
 }
 
+bool NullNumericFilterNode::prepareIndexed(const TrackSearchIndex& index) const {
+    return !m_sqlColumns.isEmpty() && index.numericColumn(m_sqlColumns.first()) != nullptr;
+}
+
+void NullNumericFilterNode::matchIndexed(const TrackSearchIndex& index,
+        mixxx::IndexRange rows,
+        uint8_t* pMatches) const {
+    // only use the major column
+    matchIndexedNullNumericColumn(index, m_sqlColumns.first(), rows, pMatches);
+}
+
 DurationFilterNode::DurationFilterNode(
         const QStringList& sqlColumns, const QString& argument)
         : NumericFilterNode(sqlColumns) {
@@ -492,6 +831,26 @@ QString KeyFilterNode::toSql() const {
     return concatSqlClauses(searchClauses, "OR");
 }
 
+bool KeyFilterNode::prepareIndexed(const TrackSearchIndex& index) const {
+    return index.numericColumn(LIBRARYTABLE_KEY_ID) != nullptr;
+}
+
+void KeyFilterNode::matchIndexed(const TrackSearchIndex& index,
+        mixxx::IndexRange rows,
+        uint8_t* pMatches) const {
+    // The IS operator never results in NULL
+    std::fill(pMatches, pMatches + rows.length(), TrackSearchIndex::kFalse);
+    const double* pKeyIds = index.numericColumn(LIBRARYTABLE_KEY_ID)->data() + rows.start();
+    for (const auto& matchKey : m_matchKeys) {
+        const double keyId = matchKey;
+        for (SINT i = 0; i < rows.length(); ++i) {
+            if (pKeyIds[i] == keyId) {
+                pMatches[i] = TrackSearchIndex::kTrue;
+            }
+        }
+    }
+}
+
 YearFilterNode::YearFilterNode(
         const QStringList& sqlColumns, const QString& argument)
         : NumericFilterNode(sqlColumns, argument) {
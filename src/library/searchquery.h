@@ -5,16 +5,20 @@
 #include <QSqlDatabase>
 #include <QString>
 #include <QStringList>
+#include <QStringMatcher>
+#include <cstdint>
 #include <utility>
 #include <vector>
 
 #include "proto/keys.pb.h"
 #include "track/track_decl.h"
 #include "util/assert.h"
+#include "util/indexrange.h"
 #include "util/memory.h"
 
 class CrateStorage;
 class TrackId;
+class TrackSearchIndex;
 
 const QString kMissingFieldSearchTerm = "\"\""; // "" searches for an empty string
 
@@ -31,6 +35,24 @@ class QueryNode {
     virtual bool match(const TrackPointer& pTrack) const = 0;
     virtual QString toSql() const = 0;
 
+    /// Checks if the node can be evaluated with the in-memory search index
+    /// instead of SQL and prepares it for matchIndexed(). Only nodes with
+    /// a non-empty toSql() expression are prepared and evaluated.
+    virtual bool prepareIndexed(const TrackSearchIndex& index) const {
+        Q_UNUSED(index);
+        return false;
+    }
+
+    /// Stores the result of each row of the in-memory search index in
+    /// pMatches, starting with the first row of the range. The results
+    /// must be consistent with toSql().
+    ///
+    /// Invoked concurrently for disjoint ranges of rows after the node
+    /// has been prepared successfully.
+    virtual void matchIndexed(const TrackSearchIndex& index,
+            mixxx::IndexRange rows,
+            uint8_t* pMatches) const;
+
   protected:
     QueryNode() = default;
 };
@@ -42,23 +64,33 @@ class GroupNode : public QueryNode {
         m_nodes.push_back(std::move(pNode));
     }
 
+    bool prepareIndexed(const TrackSearchIndex& index) const override;
+
   protected:
     // NOTE(uklotzde): std::vector is more suitable (efficiency)
     // than a QList for a private member. And QList from Qt 4
     // does not support std::unique_ptr yet.
     std::vector<std::unique_ptr<QueryNode>> m_nodes;
+    // All nodes with a non-empty SQL expression
+    mutable std::vector<const QueryNode*> m_indexedNodes;
 };
 
 class OrNode : public GroupNode {
   public:
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    void matchIndexed(const TrackSearchIndex& index,
+            mixxx::IndexRange rows,
+            uint8_t* pMatches) const override;
 };
 
 class AndNode : public GroupNode {
   public:
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    void matchIndexed(const TrackSearchIndex& index,
+            mixxx::IndexRange rows,
+            uint8_t* pMatches) const override;
 };
 
 class NotNode : public QueryNode {
@@ -70,6 +102,10 @@ class NotNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool prepareIndexed(const TrackSearchIndex& index) const override;
+    void matchIndexed(const TrackSearchIndex& index,
+            mixxx::IndexRange rows,
+            uint8_t* pMatches) const override;
 
   private:
     std::unique_ptr<QueryNode> m_pNode;
@@ -80,16 +116,28 @@ class TextFilterNode : public QueryNode {
     TextFilterNode(const QSqlDatabase& database,
             const QStringList& sqlColumns,
             const QString& argument,
-            const StringMatch matchMode = StringMatch::Contains);
+            const StringMatch matchMode = StringMatch::Contains,
+            bool fullTextSearch = false);
 
     bool match(const TrackPointer& pTrack) const override;
+    /// Uses the full-text index of FullTextSearchDao instead of LIKE
+    /// expressions if it has been enabled and supports the query.
     QString toSql() const override;
+    bool prepareIndexed(const TrackSearchIndex& index) const override;
+    void matchIndexed(const TrackSearchIndex& index,
+            mixxx::IndexRange rows,
+            uint8_t* pMatches) const override;
 
   private:
+    bool canUseFullTextSearch() const;
+    QString toFullTextSearchSql() const;
+
     QSqlDatabase m_database;
     QStringList m_sqlColumns;
     QString m_argument;
     StringMatch m_matchMode;
+    bool m_fullTextSearch;
+    QStringMatcher m_argumentMatcher;
 };
 
 class NullOrEmptyTextFilterNode : public QueryNode {
@@ -102,6 +150,10 @@ class NullOrEmptyTextFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool prepareIndexed(const TrackSearchIndex& index) const override;
+    void matchIndexed(const TrackSearchIndex& index,
+            mixxx::IndexRange rows,
+            uint8_t* pMatches) const override;
 
   private:
     QSqlDatabase m_database;
@@ -115,8 +167,14 @@ class CrateFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool prepareIndexed(const TrackSearchIndex& index) const override;
+    void matchIndexed(const TrackSearchIndex& index,
+            mixxx::IndexRange rows,
+            uint8_t* pMatches) const override;
 
   private:
+    void initMatchingTrackIds() const;
+
     const CrateStorage* m_pCrateStorage;
     QString m_crateNameLike;
     mutable bool m_matchInitialized;
@@ -129,8 +187,14 @@ class NoCrateFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool prepareIndexed(const TrackSearchIndex& index) const override;
+    void matchIndexed(const TrackSearchIndex& index,
+            mixxx::IndexRange rows,
+            uint8_t* pMatches) const override;
 
   private:
+    void initMatchingTrackIds() const;
+
     const CrateStorage* m_pCrateStorage;
     QString m_crateNameLike;
     mutable bool m_matchInitialized;
@@ -143,6 +207,10 @@ class NumericFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool prepareIndexed(const TrackSearchIndex& index) const override;
+    void matchIndexed(const TrackSearchIndex& index,
+            mixxx::IndexRange rows,
+            uint8_t* pMatches) const override;
 
   protected:
     // Single argument constructor for that does not call init()
@@ -172,6 +240,10 @@ class NullNumericFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool prepareIndexed(const TrackSearchIndex& index) const override;
+    void matchIndexed(const TrackSearchIndex& index,
+            mixxx::IndexRange rows,
+            uint8_t* pMatches) const override;
 
     QStringList m_sqlColumns;
 };
@@ -190,6 +262,10 @@ class KeyFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool prepareIndexed(const TrackSearchIndex& index) const override;
+    void matchIndexed(const TrackSearchIndex& index,
+            mixxx::IndexRange rows,
+            uint8_t* pMatches) const override;
 
   private:
     QList<mixxx::track::io::key::ChromaticKey> m_matchKeys;
@@ -69,7 +69,8 @@ const QRegularExpression kSplitOnOrOperatorRegexp = QRegularExpression(
 
 SearchQueryParser::SearchQueryParser(TrackCollection* pTrackCollection, QStringList searchColumns)
         : m_pTrackCollection(pTrackCollection),
-          m_searchCrates(false) {
+          m_searchCrates(false),
+          m_fullTextSearch(false) {
     setSearchColumns(std::move(searchColumns));
 
     m_textFilters << "artist"
@@ -209,7 +210,8 @@ void SearchQueryParser::parseTokens(QStringList tokens,
                             m_pTrackCollection->database(),
                             m_fieldToSqlColumns[field],
                             argument,
-                            matchMode);
+                            matchMode,
+                            m_fullTextSearch);
                 }
             }
         } else if (numericFilterMatch.hasMatch()) {
@@ -277,11 +279,19 @@ void SearchQueryParser::parseTokens(QStringList tokens,
                     gNode->addNode(std::make_unique<CrateFilterNode>(
                                     &m_pTrackCollection->crates(), argument));
                     gNode->addNode(std::make_unique<TextFilterNode>(
-                            m_pTrackCollection->database(), m_queryColumns, argument));
+                            m_pTrackCollection->database(),
+                            m_queryColumns,
+                            argument,
+                            StringMatch::Contains,
+                            m_fullTextSearch));
                     pNode = std::move(gNode);
                 } else {
                     pNode = std::make_unique<TextFilterNode>(
-                            m_pTrackCollection->database(), m_queryColumns, argument);
+                            m_pTrackCollection->database(),
+                            m_queryColumns,
+                            argument,
+                            StringMatch::Contains,
+                            m_fullTextSearch);
                 }
             }
         }
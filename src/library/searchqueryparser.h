@@ -17,6 +17,12 @@ class SearchQueryParser {
 
     void setSearchColumns(QStringList searchColumns);
 
+    /// Enables the full-text index for text filters, see TextFilterNode.
+    /// The index must be up-to-date.
+    void setFullTextSearch(bool fullTextSearch) {
+        m_fullTextSearch = fullTextSearch;
+    }
+
     std::unique_ptr<QueryNode> parseQuery(
             const QString& query,
             const QString& extraFilter) const;
@@ -44,6 +50,7 @@ class SearchQueryParser {
     TrackCollection* m_pTrackCollection;
     QStringList m_queryColumns;
     bool m_searchCrates;
+    bool m_fullTextSearch;
     QStringList m_textFilters;
     QStringList m_numericFilters;
     QStringList m_specialFilters;
@@ -0,0 +1,181 @@
+#include "library/sqltableloader.h"
+
+#include <QSqlQuery>
+#include <QSqlRecord>
+
+#include "library/queryutil.h"
+#include "moc_sqltableloader.cpp"
+#include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("SqlTableLoader");
+
+// Roughly the number of rows that are visible in a table view
+constexpr int kFirstBatchRowCount = 100;
+
+constexpr int kBatchRowCount = 10000;
+
+const QString kCreateViewPrefix = QStringLiteral("CREATE VIEW ");
+
+const QString kCreateTemporaryViewPrefix = QStringLiteral("CREATE TEMPORARY VIEW ");
+
+} // anonymous namespace
+
+void SqlTableReply::postRows(const Batch& batch) {
+    QMetaObject::invokeMethod(
+            this,
+            [this, batch] {
+                emit rowsLoaded(batch);
+            },
+            Qt::QueuedConnection);
+}
+
+SqlTableLoader::SqlTableLoader(mixxx::DbConnectionPoolPtr pDbConnectionPool)
+        : m_pDbConnectionPool(std::move(pDbConnectionPool)) {
+    qRegisterMetaType<SqlTableLoader::Request>();
+    qRegisterMetaType<SqlTableReply::Batch>();
+
+    // Move SqlTableLoader to its own thread so that our signals/slots will
+    // queue to our event loop.
+    moveToThread(this);
+    setObjectName(QStringLiteral("SqlTableLoader"));
+
+    connect(this, &SqlTableLoader::loadRequested, this, &SqlTableLoader::slotLoad);
+}
+
+SqlTableLoader::~SqlTableLoader() {
+    // Abort loading the current request
+    requestInterruption();
+    quit();
+    wait();
+}
+
+//static
+QString SqlTableLoader::createTemporaryViewStatement(
+        const QSqlDatabase& database,
+        const QString& tableName) {
+    QSqlQuery query(database);
+    query.prepare(QStringLiteral(
+            "SELECT sql FROM sqlite_temp_master WHERE type='view' AND name=:name"));
+    query.bindValue(QStringLiteral(":name"), tableName);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return QString();
+    }
+    if (!query.next()) {
+        return QString();
+    }
+    // SQLite stores the statements of temporary views without the
+    // TEMPORARY keyword
+    QString statement = query.value(0).toString();
+    VERIFY_OR_DEBUG_ASSERT(statement.startsWith(kCreateViewPrefix, Qt::CaseInsensitive)) {
+        return QString();
+    }
+    statement.replace(0, kCreateViewPrefix.size(), kCreateTemporaryViewPrefix);
+    return statement;
+}
+
+SqlTableReplyPointer SqlTableLoader::load(Request request) {
+    // The last reference might be released by the loader thread
+    request.pReply = SqlTableReplyPointer(new SqlTableReply, &QObject::deleteLater);
+    SqlTableReplyPointer pReply = request.pReply;
+    emit loadRequested(request);
+    return pReply;
+}
+
+bool SqlTableLoader::isCancelled(const Request& request) const {
+    return request.pReply->isCancelled() || isInterruptionRequested();
+}
+
+void SqlTableLoader::run() {
+    kLogger.debug() << "Entering thread";
+    {
+        const mixxx::DbConnectionPooler dbConnectionPooler(m_pDbConnectionPool);
+        if (!dbConnectionPooler.isPooling()) {
+            kLogger.warning()
+                    << "Failed to open database connection for loading tables";
+        }
+
+        // Start the event loop. Requests fail without a database connection.
+        exec();
+    }
+    kLogger.debug() << "Exiting thread";
+}
+
+bool SqlTableLoader::createView(const QSqlDatabase& database, const Request& request) {
+    if (request.createViewStatement.isEmpty() ||
+            m_createViewStatements.value(request.tableName) ==
+                    request.createViewStatement) {
+        return true;
+    }
+    // The table models re-create their views with a different definition
+    // under the same name, e.g. for different playlists
+    QSqlQuery query(database);
+    if (!query.exec(QStringLiteral("DROP VIEW IF EXISTS temp.%1").arg(request.tableName))) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+    m_createViewStatements.remove(request.tableName);
+    if (!query.exec(request.createViewStatement)) {
+        // The view might depend on other temporary views
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+    m_createViewStatements.insert(request.tableName, request.createViewStatement);
+    return true;
+}
+
+void SqlTableLoader::slotLoad(const SqlTableLoader::Request& request) {
+    if (isCancelled(request)) {
+        return;
+    }
+
+    SqlTableReply::Batch batch;
+    const QSqlDatabase database = mixxx::DbConnectionPooled(m_pDbConnectionPool);
+    if (!database.isOpen() || !createView(database, request)) {
+        batch.finished = true;
+        batch.failed = true;
+        request.pReply->postRows(batch);
+        return;
+    }
+
+    QSqlQuery query(database);
+    // This causes a memory savings since QSqlCachedResult (what QtSQLite uses)
+    // won't allocate a giant in-memory table that we won't use at all.
+    query.setForwardOnly(true);
+    if (!query.prepare(request.queryString) || !query.exec()) {
+        LOG_FAILED_QUERY(query);
+        batch.finished = true;
+        batch.failed = true;
+        request.pReply->postRows(batch);
+        return;
+    }
+
+    const int columnCount = query.record().count();
+    int batchRowCount = kFirstBatchRowCount;
+    batch.rows.reserve(batchRowCount);
+    while (query.next()) {
+        QVector<QVariant> row;
+        row.reserve(columnCount);
+        for (int i = 0; i < columnCount; ++i) {
+            row.push_back(query.value(i));
+        }
+        batch.rows.push_back(std::move(row));
+        if (batch.rows.size() >= batchRowCount) {
+            if (isCancelled(request)) {
+                return;
+            }
+            request.pReply->postRows(batch);
+            batch.rows.clear();
+            batchRowCount = kBatchRowCount;
+        }
+    }
+    if (isCancelled(request)) {
+        return;
+    }
+    batch.finished = true;
+    request.pReply->postRows(batch);
+}
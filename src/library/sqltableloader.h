@@ -0,0 +1,125 @@
+#pragma once
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QMetaType>
+#include <QObject>
+#include <QSharedPointer>
+#include <QSqlDatabase>
+#include <QString>
+#include <QThread>
+#include <QVariant>
+#include <QVector>
+
+#include "util/db/dbconnectionpool.h"
+
+/// The reply to a single request of SqlTableLoader.
+///
+/// The rows of the result are reported by rowsLoaded() in batches. The
+/// signal is emitted in the thread of the reply, i.e. connections that
+/// are established right after SqlTableLoader::load() returns receive
+/// all batches. The reply is shared with the loader and deleted in its
+/// own thread. Cancelling the reply stops loading, but batches that have
+/// been loaded before might still be emitted.
+class SqlTableReply : public QObject {
+    Q_OBJECT
+  public:
+    struct Batch {
+        QVector<QVector<QVariant>> rows;
+        /// The last batch of the request
+        bool finished = false;
+        /// The query failed. Use a synchronous query as a fallback.
+        bool failed = false;
+    };
+
+    SqlTableReply()
+            : m_cancelled(0) {
+    }
+    ~SqlTableReply() override = default;
+
+    /// Call from any thread.
+    void cancel() {
+        m_cancelled.storeRelease(1);
+    }
+
+    bool isCancelled() const {
+        return m_cancelled.loadAcquire() != 0;
+    }
+
+  signals:
+    void rowsLoaded(const SqlTableReply::Batch& batch);
+
+  private:
+    friend class SqlTableLoader;
+
+    /// Call from the loader thread. Emits rowsLoaded() in the thread
+    /// of the reply.
+    void postRows(const Batch& batch);
+
+    QAtomicInt m_cancelled;
+};
+
+typedef QSharedPointer<SqlTableReply> SqlTableReplyPointer;
+
+/// Executes the queries of BaseSqlTableModel::selectAsync() with a pooled
+/// database connection on its own thread.
+///
+/// The rows of the result are sent back in batches. The first batch is
+/// small and roughly contains a single page of a table view, i.e. it can
+/// be displayed before the remaining rows have been received.
+///
+/// The client cancels the reply of its previous request before starting
+/// a new request, e.g. while the user is typing a search query or
+/// switching between views that share a table model.
+class SqlTableLoader : public QThread {
+    Q_OBJECT
+  public:
+    struct Request {
+        /// The statement that creates the table as a temporary view. The
+        /// temporary views of the table models only exist within the
+        /// database connection of the GUI thread and need to be re-created.
+        /// Empty for regular tables.
+        QString createViewStatement;
+        QString tableName;
+        QString queryString;
+        /// Created by load()
+        SqlTableReplyPointer pReply;
+    };
+
+    explicit SqlTableLoader(mixxx::DbConnectionPoolPtr pDbConnectionPool);
+    ~SqlTableLoader() override;
+
+    /// Returns the statement for re-creating the temporary view on the
+    /// database connection of the loader or an empty string if the table
+    /// is not a temporary view.
+    static QString createTemporaryViewStatement(
+            const QSqlDatabase& database,
+            const QString& tableName);
+
+    /// Call from any thread. The reply lives in the calling thread.
+    SqlTableReplyPointer load(Request request);
+
+  signals:
+    // Emitted by load() to invoke slotLoad() in the loader thread's
+    // event loop.
+    void loadRequested(const SqlTableLoader::Request& request);
+
+  protected:
+    void run() override;
+
+  private slots:
+    void slotLoad(const SqlTableLoader::Request& request);
+
+  private:
+    bool isCancelled(const Request& request) const;
+    bool createView(const QSqlDatabase& database, const Request& request);
+
+    const mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+
+    // The statements of all temporary views that have been created
+    // on the database connection of the loader thread
+    QHash<QString, QString> m_createViewStatements;
+};
+
+Q_DECLARE_METATYPE(SqlTableLoader::Request);
+Q_DECLARE_METATYPE(SqlTableReply::Batch);
@@ -1,8 +1,10 @@
 #include "library/trackcollection.h"
 
 #include "library/basetrackcache.h"
+#include "library/fulltextsearchindexer.h"
 #include "library/trackset/crate/crate.h"
 #include "moc_trackcollection.cpp"
+#include "sources/seekindexcache.h"
 #include "track/globaltrackcache.h"
 #include "util/assert.h"
 #include "util/db/sqltransaction.h"
@@ -13,6 +15,10 @@ namespace {
 
 mixxx::Logger kLogger("TrackCollection");
 
+// Indexing more tracks before a search is slower than falling back
+// to the LIKE operator
+constexpr int kFullTextSearchMaxTracksBeforeSearch = 2000;
+
 } // anonymous namespace
 
 TrackCollection::TrackCollection(
@@ -21,7 +27,8 @@ TrackCollection::TrackCollection(
         : QObject(parent),
           m_analysisDao(pConfig),
           m_trackDao(m_cueDao, m_playlistDao,
-                     m_analysisDao, m_libraryHashDao, pConfig) {
+                     m_analysisDao, m_libraryHashDao, pConfig),
+          m_pFullTextSearchIndexer(nullptr) {
     // Forward signals from TrackDAO
     connect(&m_trackDao,
             &TrackDAO::trackClean,
@@ -81,7 +88,9 @@ void TrackCollection::connectDatabase(const QSqlDatabase& database) {
     m_cueDao.initialize(database);
     m_directoryDao.initialize(database);
     m_analysisDao.initialize(database);
+    m_analysisCacheDao.initialize(database);
     m_libraryHashDao.initialize(database);
+    m_fullTextSearchDao.initialize(database);
     m_crates.connectDatabase(database);
 }
 
@@ -89,6 +98,7 @@ void TrackCollection::disconnectDatabase() {
     DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
 
     kLogger.info() << "Disconnecting database";
+    DEBUG_ASSERT(!m_pFullTextSearchIndexer);
     m_database = QSqlDatabase();
     m_trackDao.finish();
     m_crates.disconnectDatabase();
@@ -141,6 +151,28 @@ QWeakPointer<BaseTrackCache> TrackCollection::disconnectTrackSource() {
     return pWeakPtr;
 }
 
+void TrackCollection::connectFullTextSearchIndexer(
+        FullTextSearchIndexer* pFullTextSearchIndexer) {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+
+    VERIFY_OR_DEBUG_ASSERT(!m_pFullTextSearchIndexer) {
+        kLogger.warning() << "Full-text search indexer has already been connected";
+        return;
+    }
+    m_pFullTextSearchIndexer = pFullTextSearchIndexer;
+    if (m_fullTextSearchDao.isAvailable()) {
+        // Index all tracks that have been modified since the last run,
+        // e.g. after the schema migration
+        m_pFullTextSearchIndexer->update();
+    }
+}
+
+void TrackCollection::disconnectFullTextSearchIndexer() {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+
+    m_pFullTextSearchIndexer = nullptr;
+}
+
 QList<mixxx::FileInfo> TrackCollection::loadRootDirs(bool skipInvalidOrMissing) const {
     return m_directoryDao.loadAllDirectories(skipInvalidOrMissing);
 }
@@ -353,7 +385,8 @@ bool TrackCollection::purgeTracks(
     VERIFY_OR_DEBUG_ASSERT(transaction) {
         return false;
     }
-    VERIFY_OR_DEBUG_ASSERT(m_trackDao.onPurgingTracks(trackIds)) {
+    QStringList locations;
+    VERIFY_OR_DEBUG_ASSERT(m_trackDao.onPurgingTracks(trackIds, &locations)) {
         return false;
     }
     // Collect crates of tracks that will be purged before actually purging
@@ -371,6 +404,10 @@ bool TrackCollection::purgeTracks(
     m_cueDao.deleteCuesForTracks(trackIds);
     m_playlistDao.removeTracksFromPlaylists(trackIds);
     m_analysisDao.deleteAnalyses(trackIds);
+    m_analysisCacheDao.deleteOrphanedEntries();
+    for (const auto& location : locations) {
+        mixxx::SeekIndexCache::remove(location);
+    }
 
     // Post-processing
     // TODO(XXX): Move signals from TrackDAO to TrackCollection
@@ -556,6 +593,28 @@ TrackId TrackCollection::getTrackIdByRef(
     return m_trackDao.getTrackIdByRef(trackRef);
 }
 
+bool TrackCollection::prepareFullTextSearch() {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+
+    if (!m_fullTextSearchDao.isAvailable() ||
+            (m_pFullTextSearchIndexer && m_pFullTextSearchIndexer->isUpdating())) {
+        return false;
+    }
+    const int updatedTrackCount = m_fullTextSearchDao.updateDirtyTracks(
+            kFullTextSearchMaxTracksBeforeSearch);
+    if (updatedTrackCount < 0) {
+        return false;
+    }
+    if (updatedTrackCount >= kFullTextSearchMaxTracksBeforeSearch) {
+        // Index the remaining tracks in the background
+        if (m_pFullTextSearchIndexer) {
+            m_pFullTextSearchIndexer->update();
+        }
+        return false;
+    }
+    return true;
+}
+
 TrackPointer TrackCollection::getOrAddTrack(
         const TrackRef& trackRef,
         bool* pAlreadyInLibrary) {
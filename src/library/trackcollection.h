@@ -6,9 +6,11 @@
 #include <QSharedPointer>
 #include <QSqlDatabase>
 
+#include "library/dao/analysiscachedao.h"
 #include "library/dao/analysisdao.h"
 #include "library/dao/cuedao.h"
 #include "library/dao/directorydao.h"
+#include "library/dao/fulltextsearchdao.h"
 #include "library/dao/libraryhashdao.h"
 #include "library/dao/playlistdao.h"
 #include "library/dao/trackdao.h"
@@ -18,6 +20,7 @@
 
 // forward declaration(s)
 class BaseTrackCache;
+class FullTextSearchIndexer;
 class QDir;
 
 // Manages the internal database.
@@ -71,6 +74,10 @@ class TrackCollection : public QObject,
     void connectTrackSource(QSharedPointer<BaseTrackCache> pTrackSource);
     QWeakPointer<BaseTrackCache> disconnectTrackSource();
 
+    /// The indexer updates the full-text index in the background.
+    void connectFullTextSearchIndexer(FullTextSearchIndexer* pFullTextSearchIndexer);
+    void disconnectFullTextSearchIndexer();
+
     QSharedPointer<BaseTrackCache> getTrackSource() const {
         DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
         return m_pTrackSource;
@@ -87,6 +94,11 @@ class TrackCollection : public QObject,
     TrackId getTrackIdByRef(
             const TrackRef& trackRef) const;
 
+    /// Indexes recently modified tracks for full-text search. Returns true
+    /// if the full-text index is available and up-to-date. Otherwise
+    /// indexing continues in the background.
+    bool prepareFullTextSearch();
+
   signals:
     // Forwarded signals from LibraryScanner
     void scanTrackAdded(TrackPointer pTrack);
@@ -172,8 +184,12 @@ class TrackCollection : public QObject,
     CueDAO m_cueDao;
     DirectoryDAO m_directoryDao;
     AnalysisDao m_analysisDao;
+    AnalysisCacheDao m_analysisCacheDao;
     LibraryHashDAO m_libraryHashDao;
     TrackDAO m_trackDao;
+    FullTextSearchDao m_fullTextSearchDao;
+
+    FullTextSearchIndexer* m_pFullTextSearchIndexer;
 
     QSharedPointer<BaseTrackCache> m_pTrackSource;
 };
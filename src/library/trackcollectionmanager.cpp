@@ -3,8 +3,10 @@
 #include <utility>
 
 #include "library/externaltrackcollection.h"
+#include "library/fulltextsearchindexer.h"
 #include "library/library_prefs.h"
 #include "library/scanner/libraryscanner.h"
+#include "library/sqltableloader.h"
 #include "library/trackcollection.h"
 #include "moc_trackcollectionmanager.cpp"
 #include "sources/soundsourceproxy.h"
@@ -126,9 +128,48 @@ TrackCollectionManager::TrackCollectionManager(
         kLogger.info() << "Starting library scanner thread";
         m_pScanner->start();
     }
+
+    if (deleteTrackForTestingFn) {
+        // Table models are populated synchronously in tests
+        kLogger.info() << "Table loader is disabled in test mode";
+    } else {
+        m_pSqlTableLoader = std::make_unique<SqlTableLoader>(pDbConnectionPool);
+        kLogger.info() << "Starting table loader thread";
+        m_pSqlTableLoader->start();
+    }
+
+    if (deleteTrackForTestingFn) {
+        // The full-text index is updated synchronously in tests
+        kLogger.info() << "Full-text search indexer is disabled in test mode";
+    } else {
+        m_pFullTextSearchIndexer = std::make_unique<FullTextSearchIndexer>(pDbConnectionPool);
+        kLogger.info() << "Starting full-text search indexer thread";
+        m_pFullTextSearchIndexer->start();
+        m_pInternalCollection->connectFullTextSearchIndexer(m_pFullTextSearchIndexer.get());
+        // Index the tracks that have been added or modified by a scan
+        // before they are searched
+        connect(m_pScanner.get(),
+                &LibraryScanner::scanFinished,
+                m_pFullTextSearchIndexer.get(),
+                &FullTextSearchIndexer::update);
+    }
 }
 
 TrackCollectionManager::~TrackCollectionManager() {
+    if (m_pFullTextSearchIndexer) {
+        kLogger.info() << "Stopping full-text search indexer thread";
+        m_pInternalCollection->disconnectFullTextSearchIndexer();
+        // Aborts indexing and waits until the thread has finished
+        m_pFullTextSearchIndexer.reset();
+    }
+
+    if (m_pSqlTableLoader) {
+        kLogger.info() << "Stopping table loader thread";
+        // Aborts the current request and waits until the thread
+        // has finished
+        m_pSqlTableLoader.reset();
+    }
+
     if (m_pScanner) {
         while (m_pScanner->isRunning()) {
             kLogger.info() << "Stopping library scanner thread";
@@ -11,7 +11,9 @@
 #include "util/parented_ptr.h"
 #include "util/thread_affinity.h"
 
+class FullTextSearchIndexer;
 class LibraryScanner;
+class SqlTableLoader;
 class TrackCollection;
 class ExternalTrackCollection;
 class RelocatedTrack;
@@ -46,6 +48,13 @@ class TrackCollectionManager: public QObject,
         return m_externalCollections;
     }
 
+    /// Loads the contents of table models in the background.
+    /// Returns nullptr in test mode.
+    SqlTableLoader* sqlTableLoader() const {
+        DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+        return m_pSqlTableLoader.get();
+    }
+
     TrackPointer getTrackById(
             TrackId trackId) const;
     TrackPointer getTrackByRef(
@@ -126,4 +135,8 @@ class TrackCollectionManager: public QObject,
 
     // TODO: Extract and decouple LibraryScanner from TrackCollectionManager
     std::unique_ptr<LibraryScanner> m_pScanner;
+
+    std::unique_ptr<SqlTableLoader> m_pSqlTableLoader;
+
+    std::unique_ptr<FullTextSearchIndexer> m_pFullTextSearchIndexer;
 };
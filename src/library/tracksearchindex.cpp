@@ -0,0 +1,335 @@
+#include "library/tracksearchindex.h"
+
+#include <QDir>
+#include <QThread>
+#include <QtConcurrentMap>
+#include <algorithm>
+#include <limits>
+
+#include "library/columncache.h"
+#include "library/dao/trackschema.h"
+#include "library/searchquery.h"
+#include "util/db/dbconnection.h"
+
+namespace {
+
+const QStringList kTextColumns = {
+        LIBRARYTABLE_ARTIST,
+        LIBRARYTABLE_ALBUMARTIST,
+        LIBRARYTABLE_ALBUM,
+        LIBRARYTABLE_TITLE,
+        LIBRARYTABLE_GENRE,
+        LIBRARYTABLE_COMPOSER,
+        LIBRARYTABLE_GROUPING,
+        LIBRARYTABLE_COMMENT,
+        LIBRARYTABLE_KEY,
+        TRACKLOCATIONSTABLE_LOCATION,
+};
+
+// The column "tracknumber" is not included, because it contains text
+// that is compared differently with numbers by SQLite.
+const QStringList kNumericColumns = {
+        LIBRARYTABLE_BPM,
+        LIBRARYTABLE_DURATION,
+        LIBRARYTABLE_RATING,
+        LIBRARYTABLE_TIMESPLAYED,
+        LIBRARYTABLE_BITRATE,
+        LIBRARYTABLE_KEY_ID,
+        LIBRARYTABLE_YEAR,
+};
+
+// Terminates the string of each row in the arena of a text column.
+// Search arguments never contain this character, i.e. a match never
+// spans multiple rows.
+const QChar kRowSeparator = QChar(0);
+
+// Partitions that are evaluated concurrently should not be too small
+// to compensate the overhead of the thread pool.
+constexpr int kMinRowsPerPartition = 16384;
+
+// Removed rows are only dropped after a considerable number has
+// been accumulated to avoid rebuilding the index too often.
+constexpr int kMinRemovedRowsBeforeCompaction = 1024;
+
+constexpr double kNullValue = std::numeric_limits<double>::quiet_NaN();
+
+double numericValue(const QVariant& value) {
+    if (value.isNull()) {
+        return kNullValue;
+    }
+    bool ok = false;
+    const double result = value.toDouble(&ok);
+    return ok ? result : kNullValue;
+}
+
+/// Equivalent to CAST(substr(year,1,4) AS INTEGER) in SQLite, see
+/// YearFilterNode::toSql().
+double yearValue(const QVariant& value) {
+    if (value.isNull()) {
+        return kNullValue;
+    }
+    const QString year = value.toString().left(4);
+    int i = 0;
+    while (i < year.size() && year[i].isSpace()) {
+        ++i;
+    }
+    bool negative = false;
+    if (i < year.size() &&
+            (year[i] == QLatin1Char('-') || year[i] == QLatin1Char('+'))) {
+        negative = year[i] == QLatin1Char('-');
+        ++i;
+    }
+    int result = 0;
+    while (i < year.size() && year[i].unicode() >= '0' && year[i].unicode() <= '9') {
+        result = 10 * result + (year[i].unicode() - '0');
+        ++i;
+    }
+    return negative ? -result : result;
+}
+
+} // anonymous namespace
+
+TrackSearchIndex::TextColumn::TextColumn(int fieldIndex)
+        : m_fieldIndex(fieldIndex),
+          m_offsets(1, 0) {
+}
+
+void TrackSearchIndex::TextColumn::append(QString value) {
+    m_nullRows.push_back(value.isNull() ? 1 : 0);
+    mixxx::DbConnection::makeStringLatinLow(&value);
+    m_text.append(value);
+    m_text.append(kRowSeparator);
+    m_offsets.push_back(m_text.size());
+}
+
+void TrackSearchIndex::TextColumn::appendFrom(const TextColumn& other, int row) {
+    const int offset = other.m_offsets[row];
+    m_text.append(other.m_text.constData() + offset,
+            other.m_offsets[row + 1] - offset);
+    m_offsets.push_back(m_text.size());
+    m_nullRows.push_back(other.m_nullRows[row]);
+}
+
+void TrackSearchIndex::TextColumn::clear() {
+    m_text.clear();
+    m_offsets.resize(1);
+    m_nullRows.clear();
+}
+
+void TrackSearchIndex::TextColumn::matchNull(
+        mixxx::IndexRange rows,
+        uint8_t* pMatches) const {
+    const uint8_t* pNullRows = m_nullRows.data() + rows.start();
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < rows.length(); ++i) {
+        pMatches[i] = std::max(pMatches[i], pNullRows[i] ? kNull : kFalse);
+    }
+}
+
+void TrackSearchIndex::TextColumn::matchContains(
+        const QStringMatcher& matcher,
+        mixxx::IndexRange rows,
+        uint8_t* pMatches) const {
+    DEBUG_ASSERT(!matcher.pattern().isEmpty());
+    // NULL rows are empty and never contain the pattern
+    matchNull(rows, pMatches);
+    const QChar* pText = m_text.constData();
+    const int endOffset = m_offsets[rows.end()];
+    int row = static_cast<int>(rows.start());
+    // All rows of the range are scanned at once. After each match the
+    // scan continues with the next row.
+    auto pos = matcher.indexIn(pText, endOffset, m_offsets[row]);
+    while (pos >= 0) {
+        while (m_offsets[row + 1] <= pos) {
+            ++row;
+        }
+        pMatches[row - rows.start()] = kTrue;
+        ++row;
+        if (row >= rows.end()) {
+            break;
+        }
+        pos = matcher.indexIn(pText, endOffset, m_offsets[row]);
+    }
+}
+
+void TrackSearchIndex::TextColumn::matchEquals(
+        const QString& value,
+        mixxx::IndexRange rows,
+        uint8_t* pMatches) const {
+    DEBUG_ASSERT(!value.isEmpty());
+    matchNull(rows, pMatches);
+    const QChar* pText = m_text.constData();
+    for (auto row = rows.start(); row < rows.end(); ++row) {
+        const int offset = m_offsets[row];
+        const int length = m_offsets[row + 1] - offset - 1;
+        if (length == value.size() &&
+                std::equal(value.constBegin(), value.constEnd(), pText + offset)) {
+            pMatches[row - rows.start()] = kTrue;
+        }
+    }
+}
+
+void TrackSearchIndex::TextColumn::matchEmpty(
+        mixxx::IndexRange rows,
+        uint8_t* pMatches) const {
+    for (auto row = rows.start(); row < rows.end(); ++row) {
+        // Only the row separator
+        pMatches[row - rows.start()] =
+                m_offsets[row + 1] - m_offsets[row] == 1 ? kTrue : kFalse;
+    }
+}
+
+TrackSearchIndex::TrackSearchIndex(const ColumnCache& columnCache)
+        : m_removedRowCount(0) {
+    for (const auto& columnName : kTextColumns) {
+        const int fieldIndex = columnCache.fieldIndex(columnName);
+        if (fieldIndex >= 0) {
+            m_textColumns.insert(columnName, TextColumn(fieldIndex));
+        }
+    }
+    for (const auto& columnName : kNumericColumns) {
+        const int fieldIndex = columnCache.fieldIndex(columnName);
+        if (fieldIndex >= 0) {
+            m_numericColumns.insert(columnName, NumericColumnInfo{fieldIndex, {}});
+        }
+    }
+}
+
+const TrackSearchIndex::TextColumn* TrackSearchIndex::textColumn(
+        const QString& columnName) const {
+    const auto i = m_textColumns.constFind(columnName);
+    if (i == m_textColumns.constEnd()) {
+        return nullptr;
+    }
+    return &i.value();
+}
+
+const TrackSearchIndex::NumericColumn* TrackSearchIndex::numericColumn(
+        const QString& columnName) const {
+    const auto i = m_numericColumns.constFind(columnName);
+    if (i == m_numericColumns.constEnd()) {
+        return nullptr;
+    }
+    return &i.value().values;
+}
+
+void TrackSearchIndex::clear() {
+    m_trackIds.clear();
+    m_rowByTrackId.clear();
+    m_removedRowCount = 0;
+    for (auto& column : m_textColumns) {
+        column.clear();
+    }
+    for (auto& column : m_numericColumns) {
+        column.values.clear();
+    }
+}
+
+void TrackSearchIndex::updateTrack(TrackId trackId, const QVector<QVariant>& record) {
+    VERIFY_OR_DEBUG_ASSERT(trackId.isValid()) {
+        return;
+    }
+    removeTrack(trackId);
+    m_rowByTrackId.insert(trackId, rowCount());
+    m_trackIds.push_back(trackId);
+    for (auto i = m_textColumns.begin(); i != m_textColumns.end(); ++i) {
+        QString value = record.value(i.value().m_fieldIndex).toString();
+        if (i.key() == TRACKLOCATIONSTABLE_LOCATION && !value.isNull()) {
+            // The cache contains the location with native separators for
+            // displaying, but the database stores all locations with "/".
+            value = QDir::fromNativeSeparators(value);
+        }
+        i.value().append(std::move(value));
+    }
+    for (auto i = m_numericColumns.begin(); i != m_numericColumns.end(); ++i) {
+        const QVariant& value = record.value(i.value().fieldIndex);
+        i.value().values.push_back(i.key() == LIBRARYTABLE_YEAR
+                        ? yearValue(value)
+                        : numericValue(value));
+    }
+}
+
+void TrackSearchIndex::removeTrack(TrackId trackId) {
+    const auto i = m_rowByTrackId.find(trackId);
+    if (i == m_rowByTrackId.end()) {
+        return;
+    }
+    const int row = i.value();
+    m_rowByTrackId.erase(i);
+    m_trackIds[row] = TrackId();
+    ++m_removedRowCount;
+    if (m_removedRowCount >= kMinRemovedRowsBeforeCompaction &&
+            m_removedRowCount >= rowCount() / 4) {
+        compact();
+    }
+}
+
+void TrackSearchIndex::compact() {
+    std::vector<TrackId> trackIds;
+    trackIds.reserve(m_trackIds.size() - m_removedRowCount);
+    for (auto& column : m_textColumns) {
+        TextColumn compacted(column.m_fieldIndex);
+        for (int row = 0; row < rowCount(); ++row) {
+            if (m_trackIds[row].isValid()) {
+                compacted.appendFrom(column, row);
+            }
+        }
+        column = std::move(compacted);
+    }
+    for (auto& column : m_numericColumns) {
+        NumericColumn compacted;
+        compacted.reserve(trackIds.capacity());
+        for (int row = 0; row < rowCount(); ++row) {
+            if (m_trackIds[row].isValid()) {
+                compacted.push_back(column.values[row]);
+            }
+        }
+        column.values = std::move(compacted);
+    }
+    m_rowByTrackId.clear();
+    for (const auto& trackId : m_trackIds) {
+        if (trackId.isValid()) {
+            m_rowByTrackId.insert(trackId, static_cast<int>(trackIds.size()));
+            trackIds.push_back(trackId);
+        }
+    }
+    m_trackIds = std::move(trackIds);
+    m_removedRowCount = 0;
+}
+
+bool TrackSearchIndex::match(
+        const QueryNode& query, std::vector<uint8_t>* pMatches) const {
+    if (!query.prepareIndexed(*this)) {
+        return false;
+    }
+    pMatches->assign(m_trackIds.size(), 0);
+
+    const int partitionCount = std::max(1,
+            std::min(QThread::idealThreadCount(),
+                    rowCount() / kMinRowsPerPartition));
+    const int rowsPerPartition = (rowCount() + partitionCount - 1) / partitionCount;
+    std::vector<mixxx::IndexRange> partitions;
+    partitions.reserve(partitionCount);
+    for (int start = 0; start < rowCount(); start += rowsPerPartition) {
+        partitions.push_back(mixxx::IndexRange::forward(
+                start, std::min(rowsPerPartition, rowCount() - start)));
+    }
+    const auto matchPartition = [this, &query, pMatches](mixxx::IndexRange rows) {
+        uint8_t* pPartitionMatches = pMatches->data() + rows.start();
+        query.matchIndexed(*this, rows, pPartitionMatches);
+        // Like in a WHERE clause only rows with a result of TRUE match.
+        // Removed rows never match.
+        for (auto row = rows.start(); row < rows.end(); ++row) {
+            uint8_t& match = pPartitionMatches[row - rows.start()];
+            match = match == kTrue && m_trackIds[row].isValid() ? 1 : 0;
+        }
+    };
+    if (partitions.size() > 1) {
+        QtConcurrent::blockingMap(partitions, matchPartition);
+    } else {
+        for (const auto& rows : partitions) {
+            matchPartition(rows);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QStringMatcher>
+#include <QVariant>
+#include <QVector>
+#include <cstdint>
+#include <vector>
+
+#include "track/trackid.h"
+#include "util/indexrange.h"
+
+class ColumnCache;
+class QueryNode;
+
+/// An in-memory, columnar index of the searchable fields of all tracks
+/// in a BaseTrackCache.
+///
+/// The strings of each text column are folded with
+/// DbConnection::makeStringLatinLow() and stored consecutively in a single
+/// arena, i.e. searching for a substring scans contiguous memory instead
+/// of visiting each track. Numeric columns are stored as plain arrays
+/// with NaN representing NULL values.
+///
+/// Search queries are evaluated by the QueryNode tree itself, see
+/// QueryNode::matchIndexed(). The results are consistent with the SQL
+/// expressions returned by QueryNode::toSql(). Queries that contain nodes
+/// which can only be evaluated by SQL are rejected.
+///
+/// Tracks that are updated are removed and appended as a new row. Removed
+/// rows are dropped when their number exceeds a threshold.
+///
+/// Not thread-safe, except for concurrent invocations of match().
+class TrackSearchIndex final {
+  public:
+    /// Truth values of the three-valued logic of SQL for evaluating the
+    /// nodes of a query. They are ordered such that AND and OR are evaluated
+    /// by std::min() and std::max() and NOT by subtracting from kTrue.
+    static constexpr uint8_t kFalse = 0;
+    static constexpr uint8_t kNull = 1;
+    static constexpr uint8_t kTrue = 2;
+
+    /// All strings of a column, folded for case- and accent-insensitive
+    /// matching like the LIKE operator of our database connections.
+    class TextColumn final {
+      public:
+        explicit TextColumn(int fieldIndex = -1);
+
+        /// Combines the result of each row with the result of checking if
+        /// it contains the string of the matcher by OR.
+        void matchContains(
+                const QStringMatcher& matcher,
+                mixxx::IndexRange rows,
+                uint8_t* pMatches) const;
+        /// Combines the result of each row with the result of checking if
+        /// it is equal to the (folded) string by OR.
+        void matchEquals(
+                const QString& value,
+                mixxx::IndexRange rows,
+                uint8_t* pMatches) const;
+        /// Stores if each row is either NULL or empty.
+        void matchEmpty(
+                mixxx::IndexRange rows,
+                uint8_t* pMatches) const;
+
+      private:
+        friend class TrackSearchIndex;
+
+        /// A null string is stored as NULL
+        void append(QString value);
+        void appendFrom(const TextColumn& other, int row);
+        void clear();
+
+        void matchNull(mixxx::IndexRange rows, uint8_t* pMatches) const;
+
+        int m_fieldIndex;
+        // The strings of all rows, each terminated by kRowSeparator
+        QString m_text;
+        // The offset of each row in m_text plus the total length
+        std::vector<int> m_offsets;
+        std::vector<uint8_t> m_nullRows;
+    };
+
+    /// The values of a numeric column, NaN if NULL.
+    using NumericColumn = std::vector<double>;
+
+    /// The columns of the cache are resolved by their names. Only
+    /// columns that are available in the cache are indexed.
+    explicit TrackSearchIndex(const ColumnCache& columnCache);
+
+    /// Returns nullptr if the column is not indexed.
+    const TextColumn* textColumn(const QString& columnName) const;
+    /// Returns nullptr if the column is not indexed.
+    const NumericColumn* numericColumn(const QString& columnName) const;
+
+    int rowCount() const {
+        return static_cast<int>(m_trackIds.size());
+    }
+    /// Returns an invalid id for removed rows.
+    TrackId trackIdAt(int row) const {
+        return m_trackIds[row];
+    }
+    /// Returns -1 if the track is not indexed.
+    int rowOf(TrackId trackId) const {
+        return m_rowByTrackId.value(trackId, -1);
+    }
+
+    void clear();
+    /// Inserts or replaces the values of a track. The record contains the
+    /// values of all columns of the cache.
+    void updateTrack(TrackId trackId, const QVector<QVariant>& record);
+    void removeTrack(TrackId trackId);
+
+    /// Evaluates the query for all rows and stores if each row matches
+    /// in pMatches, indexed by row. Large indexes are split into partitions
+    /// that are evaluated concurrently.
+    ///
+    /// Returns false without evaluating the query if it contains nodes that
+    /// can only be evaluated by SQL.
+    bool match(const QueryNode& query, std::vector<uint8_t>* pMatches) const;
+
+  private:
+    void compact();
+
+    std::vector<TrackId> m_trackIds;
+    QHash<TrackId, int> m_rowByTrackId;
+    int m_removedRowCount;
+
+    QHash<QString, TextColumn> m_textColumns;
+    struct NumericColumnInfo {
+        int fieldIndex = -1;
+        NumericColumn values;
+    };
+    QHash<QString, NumericColumnInfo> m_numericColumns;
+};
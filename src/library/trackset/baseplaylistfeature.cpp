@@ -5,6 +5,7 @@
 #include <QInputDialog>
 #include <QList>
 
+#include "analyzer/analyzerscheduledtrack.h"
 #include "library/export/trackexportwizard.h"
 #include "library/library.h"
 #include "library/library_prefs.h"
@@ -668,9 +669,13 @@ void BasePlaylistFeature::slotAnalyzePlaylist() {
         int playlistId = playlistIdFromIndex(m_lastRightClickedIndex);
         if (playlistId >= 0) {
             QList<TrackId> ids = m_playlistDao.getTrackIds(playlistId);
+            // Tracks in a playlist are prepared for playback and should
+            // be analyzed before the rest of the library
+            AnalyzerTrack::Options options;
+            options.priority = AnalyzerTrack::Priority::Prepared;
             QList<AnalyzerScheduledTrack> tracks;
             for (auto id : ids) {
-                tracks.append(id);
+                tracks.append(AnalyzerScheduledTrack(id, options));
             }
             emit analyzeTracks(tracks);
         }
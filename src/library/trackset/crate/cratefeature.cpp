@@ -747,6 +747,10 @@ void CrateFeature::slotAnalyzeCrate() {
     if (m_lastRightClickedIndex.isValid()) {
         CrateId crateId = crateIdFromIndex(m_lastRightClickedIndex);
         if (crateId.isValid()) {
+            // Tracks in a crate are prepared for playback and should
+            // be analyzed before the rest of the library
+            AnalyzerTrack::Options options;
+            options.priority = AnalyzerTrack::Priority::Prepared;
             QList<AnalyzerScheduledTrack> tracks;
             tracks.reserve(
                     m_pTrackCollection->crates().countCrateTracks(crateId));
@@ -755,7 +759,8 @@ void CrateFeature::slotAnalyzeCrate() {
                         m_pTrackCollection->crates().selectCrateTracksSorted(
                                 crateId));
                 while (crateTracks.next()) {
-                    tracks.append(crateTracks.trackId());
+                    tracks.append(AnalyzerScheduledTrack(
+                            crateTracks.trackId(), options));
                 }
             }
             emit analyzeTracks(tracks);
@@ -10,6 +10,7 @@
 #include <cstdio>
 #include <stdexcept>
 
+#include "batchanalysis.h"
 #include "config.h"
 #include "controllers/controllermanager.h"
 #include "coreservices.h"
@@ -111,6 +112,13 @@ int runMixxx(MixxxApplication* pApp, const CmdlineArgs& args) {
     return exitCode;
 }
 
+int runBatchAnalysis(MixxxApplication* pApp, const CmdlineArgs& args) {
+    CmdlineArgs::Instance().parseForUserFeedback();
+
+    mixxx::BatchAnalysis batchAnalysis(args);
+    return batchAnalysis.exec(pApp);
+}
+
 void adjustScaleFactor(CmdlineArgs* pArgs) {
     if (qEnvironmentVariableIsSet(kScaleFactorEnvVar)) {
         bool ok;
@@ -206,6 +214,17 @@ int main(int argc, char * argv[]) {
 
     adjustScaleFactor(&args);
 
+#ifdef __LINUX__
+    // The batch analysis does not show any windows and must also run
+    // on machines without a display, e.g. via ssh.
+    if (args.isBatchAnalysis() &&
+            !qEnvironmentVariableIsSet("QT_QPA_PLATFORM") &&
+            !qEnvironmentVariableIsSet("DISPLAY") &&
+            !qEnvironmentVariableIsSet("WAYLAND_DISPLAY")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+#endif
+
     MixxxApplication app(argc, argv);
 
 #ifdef Q_OS_MACOS
@@ -240,7 +259,9 @@ int main(int argc, char * argv[]) {
     // When the last window is closed, terminate the Qt event loop.
     QObject::connect(&app, &MixxxApplication::lastWindowClosed, &app, &MixxxApplication::quit);
 
-    int exitCode = runMixxx(&app, args);
+    int exitCode = args.isBatchAnalysis()
+            ? runBatchAnalysis(&app, args)
+            : runMixxx(&app, args);
 
     qDebug() << "Mixxx shutdown complete with code" << exitCode;
 
@@ -184,7 +184,9 @@ void PlayerManager::bindToLibrary(Library* pLibrary) {
     DEBUG_ASSERT(!m_pTrackAnalysisScheduler);
     m_pTrackAnalysisScheduler = pLibrary->createTrackAnalysisScheduler(
             kNumberOfAnalyzerThreads,
-            AnalyzerModeFlags::WithWaveform);
+            static_cast<AnalyzerModeFlags>(
+                    AnalyzerModeFlags::WithWaveform | AnalyzerModeFlags::Pipelined |
+                    AnalyzerModeFlags::Segmented));
 
     connect(m_pTrackAnalysisScheduler.get(), &TrackAnalysisScheduler::trackProgress,
             this, &PlayerManager::onTrackAnalysisProgress);
@@ -794,16 +796,40 @@ void PlayerManager::slotAnalyzeTrack(TrackPointer track) {
         return;
     }
     if (m_pTrackAnalysisScheduler) {
-        if (m_pTrackAnalysisScheduler->scheduleTrack(track->getId())) {
+        AnalyzerTrack::Options options;
+        // Preempts a running batch analysis, see AnalysisExecutor
+        options.priority = AnalyzerTrack::Priority::Deck;
+        // Sync and quantize need beats before the analysis is finished
+        options.provisionalResults = true;
+        if (m_pTrackAnalysisScheduler->scheduleTrack(
+                    AnalyzerScheduledTrack(track->getId(), options))) {
             m_pTrackAnalysisScheduler->resume();
         }
-        // The first progress signal will suspend a running batch analysis
-        // until all loaded tracks have been analyzed. Emit it once just now
-        // before any signals from the analyzer queue arrive.
+        // Emit the first progress signal just now before any signals
+        // from the analyzer queue arrive.
         emit trackAnalyzerProgress(track->getId(), kAnalyzerProgressUnknown);
     }
 }
 
+void PlayerManager::slotAnalyzeFinishedRecording(const QString& location) {
+    // The analysis has been deferred while the recording was written,
+    // see AnalyzerThread
+    QList<TrackPointer> tracks;
+    {
+        const auto locker = lockMutex(&m_mutex);
+        for (BaseTrackPlayer* pPlayer : std::as_const(m_players)) {
+            TrackPointer pTrack = pPlayer->getLoadedTrack();
+            if (pTrack && pTrack->getLocation() == location &&
+                    !tracks.contains(pTrack)) {
+                tracks.append(pTrack);
+            }
+        }
+    }
+    for (const auto& pTrack : std::as_const(tracks)) {
+        slotAnalyzeTrack(pTrack);
+    }
+}
+
 void PlayerManager::slotSaveEjectedTrack(TrackPointer track) {
     VERIFY_OR_DEBUG_ASSERT(track) {
         return;
@@ -210,6 +210,9 @@ class PlayerManager : public QObject, public PlayerManagerInterface {
     void slotChangeNumMicrophones(double v);
     void slotChangeNumAuxiliaries(double v);
 
+    // Analyzes the loaded tracks of a recording that has been finished
+    void slotAnalyzeFinishedRecording(const QString& location);
+
   protected slots:
     FRIEND_TEST(PlayerManagerTest, UnEjectInvalidTrackIdTest);
     void slotSaveEjectedTrack(TrackPointer track);
@@ -12,6 +12,7 @@
 #include "library/trackset/crate/crateid.h"
 #include "moc_mixxxapplication.cpp"
 #include "soundio/soundmanagerutil.h"
+#include "sources/importedtracksource.h"
 #include "track/track.h"
 #include "track/trackref.h"
 #include "util/cache.h"
@@ -117,6 +118,7 @@ void MixxxApplication::registerMetaTypes() {
     // Library Scanner
     qRegisterMetaType<RelocatedTrack>();
     qRegisterMetaType<QList<RelocatedTrack>>();
+    qRegisterMetaType<ImportedTrackSource>();
 
     // Various custom data types
     qRegisterMetaType<mixxx::ReplayGain>("mixxx::ReplayGain");
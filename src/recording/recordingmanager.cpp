@@ -13,6 +13,7 @@
 #include "errordialoghandler.h"
 #include "moc_recordingmanager.cpp"
 #include "recording/defs_recording.h"
+#include "sources/soundsourceproxy.h"
 
 #define MIN_DISK_FREE 1024 * 1024 * 1024ll // one gibibyte
 
@@ -131,6 +132,8 @@ void RecordingManager::startRecording() {
     m_recording_base_file.append("/").append(date_time_str);
     // Appending file extension to get the filelocation.
     m_recordingLocation = m_recording_base_file + QChar('.') + fileExtension;
+    // Allows to play the recording in a deck while it is still written
+    SoundSourceProxy::setFileGrowing(m_recordingLocation, true);
     m_pConfig->set(ConfigKey(RECORDING_PREF_KEY, "Path"), m_recordingLocation);
     m_pConfig->set(ConfigKey(RECORDING_PREF_KEY, "CuePath"), ConfigValue(m_recording_base_file + QStringLiteral(".cue")));
 
@@ -151,7 +154,10 @@ void RecordingManager::splitContinueRecording()
                                     .fileExtension;
 
     QString new_base_filename = m_recording_base_file + QStringLiteral("part") + QString::number(m_iNumberSplits);
+    SoundSourceProxy::setFileGrowing(m_recordingLocation, false);
+    emit recordingFinished(m_recordingLocation);
     m_recordingLocation = new_base_filename + QChar('.') + fileExtension;
+    SoundSourceProxy::setFileGrowing(m_recordingLocation, true);
 
     m_pConfig->set(ConfigKey(RECORDING_PREF_KEY, "Path"), m_recordingLocation);
     m_pConfig->set(ConfigKey(RECORDING_PREF_KEY, "CuePath"), ConfigValue(new_base_filename + QStringLiteral(".cue")));
@@ -163,6 +169,10 @@ void RecordingManager::splitContinueRecording()
 void RecordingManager::stopRecording() {
     qDebug() << "Recording stopped";
     m_pCoRecStatus->set(RECORD_OFF);
+    SoundSourceProxy::setFileGrowing(m_recordingLocation, false);
+    if (!m_recordingLocation.isEmpty()) {
+        emit recordingFinished(m_recordingLocation);
+    }
     m_recordingFile = "";
     m_recordingLocation = "";
     m_iNumberOfBytesRecorded = 0;
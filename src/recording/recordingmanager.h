@@ -43,6 +43,9 @@ class RecordingManager : public QObject {
     void bytesRecorded(int);
     void isRecording(bool);
     void durationRecorded(const QString&);
+    // Emitted when a file has been written completely, i.e. when
+    // the recording has been stopped or split.
+    void recordingFinished(const QString& location);
 
   public slots:
     void slotIsRecording(bool recording, bool error);
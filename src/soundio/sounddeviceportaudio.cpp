@@ -11,6 +11,7 @@
 #include "soundio/sounddevice.h"
 #include "soundio/soundmanager.h"
 #include "soundio/soundmanagerutil.h"
+#include "util/backgroundthread.h"
 #include "util/defs.h"
 #include "util/denormalsarezero.h"
 #include "util/fifo.h"
@@ -37,6 +38,13 @@ constexpr int kFifoSize = 2 * kDriftReserve + 1;
 
 constexpr int kCpuUsageUpdateRate = 30; // in 1/s, fits to display frame rate
 
+// The peak usage is the 99th percentile of the usage of single callbacks
+// within a window of this length. Short enough to react on overload
+// before it becomes audible and long enough to collect ~100 callbacks
+// at common buffer sizes.
+constexpr int kCpuUsagePeakUpdateRate = 1; // in 1/s
+constexpr double kCpuUsagePeakPercentile = 0.99;
+
 // We warn only at invalid timing 3, since the first two
 // callbacks can be always wrong due to a setup/open jitter
 constexpr int m_invalidTimeInfoWarningCount = 3;
@@ -92,6 +100,8 @@ SoundDevicePortAudio::SoundDevicePortAudio(UserSettingsPointer config,
           m_bSetThreadPriority(false),
           m_audioLatencyUsage(kAppGroup, QStringLiteral("audio_latency_usage")),
           m_framesSinceAudioLatencyUsageUpdate(0),
+          m_audioLatencyUsagePeak(kAppGroup, QStringLiteral("audio_latency_usage_peak")),
+          m_framesSinceAudioLatencyUsagePeakUpdate(0),
           m_syncBuffers(2),
           m_invalidTimeInfoCount(0),
           m_lastCallbackEntrytoDacSecs(0) {
@@ -887,6 +897,9 @@ int SoundDevicePortAudio::callbackProcessClkRef(
 
     //qDebug() << "SoundDevicePortAudio::callbackProcess:" << m_deviceId;
 
+    // Allows background threads to avoid the core of the audio thread
+    mixxx::setAudioCallbackCpu();
+
     if (!m_bSetThreadPriority) {
 #ifdef __LINUX__
         // Verify if we are a thread with "real-time" policy.
@@ -1104,5 +1117,17 @@ void SoundDevicePortAudio::updateAudioLatencyUsage(
         //          << m_audioLatencyUsage->get();
     }
     // measure time in Audio callback at the very last
-    m_timeInAudioCallback += m_clkRefTimer.elapsed();
+    const mixxx::Duration timeInAudioCallback = m_clkRefTimer.elapsed();
+    m_timeInAudioCallback += timeInAudioCallback;
+
+    m_audioLatencyUsageHistogram.add(timeInAudioCallback.toDoubleSeconds() /
+            (framesPerBuffer / m_sampleRate.toDouble()));
+    m_framesSinceAudioLatencyUsagePeakUpdate += framesPerBuffer;
+    if (m_framesSinceAudioLatencyUsagePeakUpdate >
+            (m_sampleRate.toDouble() / kCpuUsagePeakUpdateRate)) {
+        m_audioLatencyUsagePeak.set(
+                m_audioLatencyUsageHistogram.percentile(kCpuUsagePeakPercentile));
+        m_audioLatencyUsageHistogram.reset();
+        m_framesSinceAudioLatencyUsagePeakUpdate = 0;
+    }
 }
@@ -10,6 +10,7 @@
 #include "soundio/soundmanagerconfig.h"
 #include "util/duration.h"
 #include "util/fifo.h"
+#include "util/loadhistogram.h"
 #include "util/performancetimer.h"
 
 class SoundManager;
@@ -80,6 +81,9 @@ class SoundDevicePortAudio : public SoundDevice {
     PollingControlProxy m_audioLatencyUsage;
     mixxx::Duration m_timeInAudioCallback;
     int m_framesSinceAudioLatencyUsageUpdate;
+    PollingControlProxy m_audioLatencyUsagePeak;
+    mixxx::LoadHistogram m_audioLatencyUsageHistogram;
+    int m_framesSinceAudioLatencyUsagePeakUpdate;
     int m_syncBuffers;
     int m_invalidTimeInfoCount;
     PerformanceTimer m_clkRefTimer;
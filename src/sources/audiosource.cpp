@@ -345,4 +345,11 @@ void AudioSource::adjustFrameIndexRange(
     m_frameIndexRange = frameIndexRange;
 }
 
+void AudioSource::growFrameIndexRange(
+        IndexRange frameIndexRange) {
+    DEBUG_ASSERT(frameIndexRange.start() == m_frameIndexRange.start());
+    DEBUG_ASSERT(frameIndexRange.end() >= m_frameIndexRange.end());
+    m_frameIndexRange = frameIndexRange;
+}
+
 } // namespace mixxx
@@ -215,6 +215,23 @@ class AudioSource : public UrlResource, public virtual /*implements*/ IAudioSour
             m_signalInfo.setSampleRate(sampleRate);
         }
 
+        // The number of channels for decoders that are able to remap
+        // the channels of a stream while decoding. A stereo signal is
+        // decoded if it has been requested explicitly or if the stream
+        // has more channels than requested. Mono signals are preserved
+        // unless stereo has been requested explicitly.
+        audio::ChannelCount decodedChannelCount(
+                audio::ChannelCount streamChannelCount) const {
+            const auto requestedChannelCount = m_signalInfo.getChannelCount();
+            if (requestedChannelCount.isValid() &&
+                    requestedChannelCount <= audio::ChannelCount::stereo() &&
+                    (requestedChannelCount == audio::ChannelCount::stereo() ||
+                            streamChannelCount > audio::ChannelCount::stereo())) {
+                return audio::ChannelCount::stereo();
+            }
+            return streamChannelCount;
+        }
+
       private:
         audio::SignalInfo m_signalInfo;
     };
@@ -301,6 +318,24 @@ class AudioSource : public UrlResource, public virtual /*implements*/ IAudioSour
     ReadableSampleFrames readSampleFrames(
             const WritableSampleFrames& sampleFrames);
 
+    /// Checks if more frames have become readable at the end of a
+    /// file that is still being written, e.g. a recording. Returns
+    /// true if the frame index range has been extended.
+    ///
+    /// Only supported by sources that read the file directly without
+    /// decoding it in advance. The default implementation never grows.
+    virtual bool tryGrowFrameIndexRange() {
+        return false;
+    }
+
+    /// Returns true if the decoder natively produces a lower sample rate
+    /// when requested in the OpenParams, i.e. with less work than decoding
+    /// at the full rate. Sources that ignore the requested sample rate or
+    /// that resample after a full decode return false.
+    virtual bool canDecodeAtReducedSampleRate() const {
+        return false;
+    }
+
   protected:
     explicit AudioSource(const QUrl& url);
 
@@ -336,6 +371,11 @@ class AudioSource : public UrlResource, public virtual /*implements*/ IAudioSour
         that.adjustFrameIndexRange(frameIndexRange);
     }
 
+    // Extends the frame index range towards the end while the
+    // start remains unchanged, see tryGrowFrameIndexRange().
+    void growFrameIndexRange(
+            IndexRange frameIndexRange);
+
     // Tries to open the AudioSource for reading audio data according
     // to the "Template Method" design pattern.
     //
@@ -23,6 +23,18 @@ class AudioSourceProxy : public AudioSource {
         m_pAudioSource->close();
     }
 
+    bool tryGrowFrameIndexRange() override {
+        if (!m_pAudioSource->tryGrowFrameIndexRange()) {
+            return false;
+        }
+        growFrameIndexRange(m_pAudioSource->frameIndexRange());
+        return true;
+    }
+
+    bool canDecodeAtReducedSampleRate() const override {
+        return m_pAudioSource->canDecodeAtReducedSampleRate();
+    }
+
   protected:
     OpenResult tryOpen(
             OpenMode mode,
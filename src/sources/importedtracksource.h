@@ -0,0 +1,28 @@
+#pragma once
+
+#include <QDateTime>
+#include <QMetaType>
+
+#include "library/coverart.h"
+#include "sources/metadatasource.h"
+#include "track/trackmetadata.h"
+
+/// Track metadata and guessed cover art of a file that is about to be
+/// added to the library.
+///
+/// Parsing the file tags and hashing the embedded cover image are the
+/// most expensive parts of adding a new track. Both are done by the
+/// scanner's worker threads in advance and the results are passed as
+/// values to the single thread that writes into the database, see
+/// SoundSourceProxy::importTrackSourceFromFile().
+struct ImportedTrackSource {
+    mixxx::MetadataSource::ImportResult importResult =
+            mixxx::MetadataSource::ImportResult::Unavailable;
+    /// The synchronization time stamp of the file after reading it.
+    /// Used for detecting modifications that happened in the meantime.
+    QDateTime sourceSynchronizedAt;
+    mixxx::TrackMetadata trackMetadata;
+    CoverInfoRelative coverInfo;
+};
+
+Q_DECLARE_METATYPE(ImportedTrackSource);
@@ -0,0 +1,209 @@
+#include "sources/seekindexcache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QSaveFile>
+#include <atomic>
+
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("SeekIndexCache");
+
+// "MXSI"
+constexpr quint32 kIndexMagic = 0x4D585349;
+// Version history:
+// 1: initial version
+constexpr quint32 kIndexVersion = 1;
+
+constexpr auto kDataStreamVersion = QDataStream::Qt_5_15;
+
+const QString kIndexFileSuffix = QStringLiteral(".seekindex");
+
+// A typical index takes a few KB per track, i.e. the limits are reached
+// with large libraries only
+constexpr int kMaxIndexFileCount = 20000;
+constexpr qint64 kMaxTotalIndexBytes = 64 * 1024 * 1024;
+
+// Listing the directory is too expensive after each store
+constexpr int kPruneIntervalStores = 100;
+
+QMutex s_directoryMutex;
+QString s_directory;
+
+QMutex s_pruneMutex;
+std::atomic<int> s_storeCount = 0;
+
+qint64 lastModifiedMsecs(const QFileInfo& fileInfo) {
+    return fileInfo.lastModified().toMSecsSinceEpoch();
+}
+
+} // anonymous namespace
+
+// static
+void SeekIndexCache::setDirectory(const QString& dirPath) {
+    const auto locker = lockMutex(&s_directoryMutex);
+    s_directory = dirPath;
+    if (!s_directory.isEmpty() && !QDir().mkpath(s_directory)) {
+        kLogger.warning() << "Failed to create directory" << s_directory;
+    }
+}
+
+// static
+QString SeekIndexCache::directory() {
+    const auto locker = lockMutex(&s_directoryMutex);
+    return s_directory;
+}
+
+// static
+QString SeekIndexCache::indexFilePath(const QString& audioFilePath) {
+    const QString dirPath = directory();
+    if (dirPath.isEmpty()) {
+        return QString();
+    }
+    // The absolute path of the audio file is stored in the index file
+    // to detect (unlikely) collisions
+    const QByteArray hash = QCryptographicHash::hash(
+            audioFilePath.toUtf8(), QCryptographicHash::Sha1);
+    return QDir(dirPath).filePath(QString::fromLatin1(hash.toHex()) + kIndexFileSuffix);
+}
+
+// static
+QByteArray SeekIndexCache::load(
+        const QString& audioFilePath,
+        const QString& decoderId) {
+    const QString filePath = indexFilePath(audioFilePath);
+    if (filePath.isEmpty()) {
+        return QByteArray();
+    }
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    const QFileInfo audioFileInfo(audioFilePath);
+
+    QDataStream stream(&file);
+    stream.setVersion(kDataStreamVersion);
+    quint32 magic = 0;
+    quint32 version = 0;
+    QString storedAudioFilePath;
+    QString storedDecoderId;
+    qint64 fileSize = 0;
+    qint64 fileLastModifiedMsecs = 0;
+    QByteArray index;
+    stream >> magic >> version;
+    if (stream.status() != QDataStream::Ok ||
+            magic != kIndexMagic ||
+            version != kIndexVersion) {
+        return QByteArray();
+    }
+    stream >> storedAudioFilePath >> storedDecoderId >>
+            fileSize >> fileLastModifiedMsecs >> index;
+    if (stream.status() != QDataStream::Ok ||
+            storedAudioFilePath != audioFilePath ||
+            storedDecoderId != decoderId) {
+        return QByteArray();
+    }
+    if (fileSize != audioFileInfo.size() ||
+            fileLastModifiedMsecs != lastModifiedMsecs(audioFileInfo)) {
+        kLogger.debug() << "Discarding stale seek index of" << audioFilePath;
+        return QByteArray();
+    }
+    file.close();
+    // The modification time of the index file tracks the last use for
+    // pruning. Failing to update it only affects the order of eviction.
+    if (file.open(QIODevice::ReadWrite)) {
+        file.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+    }
+    return index;
+}
+
+// static
+bool SeekIndexCache::store(
+        const QString& audioFilePath,
+        const QString& decoderId,
+        const QByteArray& index) {
+    const QString filePath = indexFilePath(audioFilePath);
+    if (filePath.isEmpty()) {
+        return false;
+    }
+    const QFileInfo audioFileInfo(audioFilePath);
+    if (!audioFileInfo.exists()) {
+        return false;
+    }
+
+    // Concurrent writers for the same audio file store the same
+    // index, the file is replaced atomically.
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        kLogger.warning() << "Failed to create seek index file" << filePath;
+        return false;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(kDataStreamVersion);
+    stream << kIndexMagic << kIndexVersion
+           << audioFilePath << decoderId
+           << audioFileInfo.size() << lastModifiedMsecs(audioFileInfo)
+           << index;
+    if (stream.status() != QDataStream::Ok || !file.commit()) {
+        kLogger.warning() << "Failed to write seek index file" << filePath;
+        return false;
+    }
+    if (++s_storeCount % kPruneIntervalStores == 0) {
+        prune(kMaxIndexFileCount, kMaxTotalIndexBytes);
+    }
+    return true;
+}
+
+// static
+void SeekIndexCache::remove(const QString& audioFilePath) {
+    const QString filePath = indexFilePath(audioFilePath);
+    if (filePath.isEmpty()) {
+        return;
+    }
+    QFile::remove(filePath);
+}
+
+// static
+void SeekIndexCache::prune(int maxFileCount, qint64 maxTotalBytes) {
+    const QString dirPath = directory();
+    if (dirPath.isEmpty()) {
+        return;
+    }
+    // Concurrent writers don't need to prune twice
+    if (!s_pruneMutex.tryLock()) {
+        return;
+    }
+    // Most recently used first
+    const QFileInfoList fileInfos = QDir(dirPath).entryInfoList(
+            QStringList{QStringLiteral("*") + kIndexFileSuffix},
+            QDir::Files,
+            QDir::Time);
+    int fileCount = 0;
+    qint64 totalBytes = 0;
+    int removedCount = 0;
+    for (const auto& fileInfo : fileInfos) {
+        ++fileCount;
+        totalBytes += fileInfo.size();
+        if (fileCount > maxFileCount || totalBytes > maxTotalBytes) {
+            if (QFile::remove(fileInfo.absoluteFilePath())) {
+                ++removedCount;
+            }
+        }
+    }
+    s_pruneMutex.unlock();
+    if (removedCount > 0) {
+        kLogger.debug() << "Pruned" << removedCount << "seek index files";
+    }
+}
+
+} // namespace mixxx
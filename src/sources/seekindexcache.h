@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+namespace mixxx {
+
+/// Persists the seek indices of decoders that otherwise need to scan the
+/// whole file when opening it, e.g. the frame headers of MP3 files.
+///
+/// Each index is stored in a separate file in the cache directory. The
+/// size and modification time of the audio file are stored along with the
+/// index and a stale index is discarded when loading it. The contents of
+/// an index are opaque and versioned by the decoder.
+///
+/// The cache is pruned by evicting the least recently used indices when it
+/// exceeds a maximum number of files or total size. Loading an index
+/// counts as a use.
+///
+/// All functions are thread-safe, but the directory must be set before
+/// the first audio source is opened.
+class SeekIndexCache final {
+  public:
+    SeekIndexCache() = delete;
+
+    /// An empty path disables the cache, which is the default.
+    static void setDirectory(const QString& dirPath);
+    static QString directory();
+
+    /// Returns the index that has been stored for the audio file by
+    /// the decoder or an empty byte array if the index is missing,
+    /// outdated or stale.
+    static QByteArray load(
+            const QString& audioFilePath,
+            const QString& decoderId);
+
+    static bool store(
+            const QString& audioFilePath,
+            const QString& decoderId,
+            const QByteArray& index);
+
+    /// Deletes the index of an audio file, e.g. when its track has been
+    /// purged from the library.
+    static void remove(const QString& audioFilePath);
+
+    /// Deletes the least recently used indices until both limits are met.
+    /// Invoked periodically when storing indices.
+    static void prune(int maxFileCount, qint64 maxTotalBytes);
+
+  private:
+    static QString indexFilePath(const QString& audioFilePath);
+};
+
+} // namespace mixxx
@@ -1,5 +1,7 @@
 #include "sources/soundsourceflac.h"
 
+#include <type_traits>
+
 #include "util/logger.h"
 #include "util/math.h"
 #include "util/sample.h"
@@ -102,8 +104,10 @@ SoundSourceFLAC::~SoundSourceFLAC() {
 
 SoundSource::OpenResult SoundSourceFLAC::tryOpen(
         OpenMode /*mode*/,
-        const OpenParams& /*config*/) {
+        const OpenParams& params) {
     DEBUG_ASSERT(!m_file.isOpen());
+    // Needed when receiving the stream info while decoding the metadata
+    m_openParams = params;
     if (!m_file.open(QIODevice::ReadOnly)) {
         kLogger.warning()
                 << "Failed to open FLAC file:"
@@ -391,50 +395,17 @@ FLAC__bool SoundSourceFLAC::flacEOF() {
     return m_file.atEnd();
 }
 
-namespace {
-
-// Workaround for improperly encoded FLAC files that may contain
-// garbage in the most significant, unused bits of decoded samples.
-// Required at least for libFLAC 1.3.2. This workaround might become
-// obsolete once libFLAC is taking care of these issues internally.
-// https://github.com/mixxxdj/mixxx/issues/9275
-// https://hydrogenaud.io/index.php/topic,61792.msg559045.html#msg559045
-
-// We multiply the decoded samples by 2 ^ (32 - m_bitsPerSample) to
-// get rid of the garbage in the most significant bits which get shifted
-// out to the left. The resulting, upscaled integer value is then scaled
-// down to the floating point range [-CSAMPLE_PEAK, CSAMPLE_PEAK - epsilon]
-// with epsilon = 1 / 2 ^ bitsPerSample.
-//
-// We have to negate the nominator to compensate for the negative denominator!
-// Otherwise the phase would be inverted: https://github.com/mixxxdj/mixxx/issues/10445
-constexpr CSAMPLE kSampleScaleFactor = -CSAMPLE_PEAK /
-        (static_cast<FLAC__int32>(1) << std::numeric_limits<FLAC__int32>::digits);
-
-inline CSAMPLE convertDecodedSample(FLAC__int32 decodedSample, int bitsPerSample) {
-    static_assert(std::numeric_limits<FLAC__int32>::is_signed);
-    static_assert(kSampleScaleFactor > CSAMPLE_ZERO, "preserve phase of decoded signal");
-    // Multiples by 2 ^ (32 - bitsPerSample)
-    const auto upscaleShift = (std::numeric_limits<FLAC__int32>::digits + 1) - bitsPerSample;
-    const auto upscaledSample = decodedSample << upscaleShift;
-    // upscaledSample is now a 32-bit signed integer that needs to scaled
-    // to the range [-CSAMPLE_PEAK, CSAMPLE_PEAK - epsilon]
-    return upscaledSample * kSampleScaleFactor;
-}
-
-} // anonymous namespace
-
 FLAC__StreamDecoderWriteStatus SoundSourceFLAC::flacWrite(
         const FLAC__Frame* frame, const FLAC__int32* const buffer[]) {
     VERIFY_OR_DEBUG_ASSERT(frame->header.channels > 0) {
         return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT;
     }
     const auto channelCount = mixxx::audio::ChannelCount::fromInt(frame->header.channels);
-    if (getSignalInfo().getChannelCount() > channelCount) {
+    if (m_streamChannelCount > channelCount) {
         kLogger.warning()
                 << "Corrupt or unsupported FLAC file:"
                 << "Invalid number of channels in FLAC frame header"
-                << channelCount << "<>" << getSignalInfo().getChannelCount();
+                << channelCount << "<>" << m_streamChannelCount;
         return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT;
     }
     VERIFY_OR_DEBUG_ASSERT(frame->header.sample_rate > 0) {
@@ -477,33 +448,20 @@ FLAC__StreamDecoderWriteStatus SoundSourceFLAC::flacWrite(
                 << numWritableFrames << "<" << numReadableFrames;
     }
 
-    CSAMPLE* pSampleBuffer = writableSlice.data();
-    DEBUG_ASSERT(getSignalInfo().getChannelCount() <= channelCount);
-    switch (getSignalInfo().getChannelCount()) {
-    case 1: {
-        // optimized code for 1 channel (mono)
-        for (SINT i = 0; i < numWritableFrames; ++i) {
-            *pSampleBuffer++ = convertDecodedSample(buffer[0][i], m_bitsPerSample);
-        }
-        break;
-    }
-    case 2: {
-        // optimized code for 2 channels (stereo)
-        for (SINT i = 0; i < numWritableFrames; ++i) {
-            *pSampleBuffer++ = convertDecodedSample(buffer[0][i], m_bitsPerSample);
-            *pSampleBuffer++ = convertDecodedSample(buffer[1][i], m_bitsPerSample);
-        }
-        break;
-    }
-    default: {
-        // generic code for multiple channels
-        for (SINT i = 0; i < numWritableFrames; ++i) {
-            for (SINT j = 0; j < getSignalInfo().getChannelCount(); ++j) {
-                *pSampleBuffer++ = convertDecodedSample(buffer[j][i], m_bitsPerSample);
-            }
-        }
-    }
-    }
+    // Workaround for improperly encoded FLAC files that may contain
+    // garbage in the most significant, unused bits of decoded samples.
+    // Required at least for libFLAC 1.3.2. This workaround might become
+    // obsolete once libFLAC is taking care of these issues internally.
+    // https://github.com/mixxxdj/mixxx/issues/9275
+    // https://hydrogenaud.io/index.php/topic,61792.msg559045.html#msg559045
+    static_assert(std::is_same_v<FLAC__int32, qint32>);
+    SampleUtil::convertPlanarSNToFloat32(
+            writableSlice.data(),
+            getSignalInfo().getChannelCount(),
+            buffer,
+            m_streamChannelCount,
+            numWritableFrames,
+            static_cast<int>(m_bitsPerSample));
 
     return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
 }
@@ -515,7 +473,11 @@ void SoundSourceFLAC::flacMetadata(const FLAC__StreamMetadata* metadata) {
     // "...always before the first audio frame (i.e. write callback)."
     switch (metadata->type) {
     case FLAC__METADATA_TYPE_STREAMINFO: {
-        initChannelCountOnce(metadata->data.stream_info.channels);
+        m_streamChannelCount = audio::ChannelCount::fromInt(
+                metadata->data.stream_info.channels);
+        // Mono or multi-channel signals are remapped while converting
+        // the decoded samples if requested
+        initChannelCountOnce(m_openParams.decodedChannelCount(m_streamChannelCount));
         initSampleRateOnce(metadata->data.stream_info.sample_rate);
         initFrameIndexRangeOnce(
                 IndexRange::forward(
@@ -38,6 +38,9 @@ class SoundSourceFLAC final : public SoundSource {
 
     QFile m_file;
 
+    OpenParams m_openParams;
+    audio::ChannelCount m_streamChannelCount;
+
     FLAC__StreamDecoder* m_decoder;
     // misc bits about the flac format:
     // flac encodes from and decodes to LPCM in blocks, each block is made up of
@@ -1,11 +1,16 @@
 #include "sources/soundsourcemp3.h"
 #include "sources/mp3decoding.h"
 
+#include "sources/seekindexcache.h"
 #include "util/logger.h"
 #include "util/math.h"
+#include "util/sample.h"
 
 #include <id3tag.h>
 
+#include <QDataStream>
+#include <type_traits>
+
 namespace mixxx {
 
 namespace {
@@ -25,6 +30,11 @@ constexpr int kSampleRateCount = 9;
 // constexpr char kVbrTag1[] = "Info";
 constexpr int kInfoTagStrLen = 4;
 
+// Identifies the contents of the persisted seek index, see
+// SoundSourceMp3::storeSeekIndex(). Increment the version whenever
+// the scanning of the frame headers or the format changes.
+const QString kSeekIndexDecoderId = QStringLiteral("MAD/1");
+
 int getIndexBySampleRate(audio::SampleRate sampleRate) {
     switch (sampleRate) {
     case 8000:
@@ -77,12 +87,9 @@ audio::SampleRate getSampleRateByIndex(int sampleRateIndex) {
     }
 }
 
+// Fixed-point samples with MAD_F_FRACBITS fractional bits
 constexpr CSAMPLE kMadScale = CSAMPLE_PEAK / CSAMPLE(MAD_F_ONE);
 
-inline CSAMPLE madScaleSampleValue(mad_fixed_t sampleValue) {
-    return sampleValue * kMadScale;
-}
-
 // Optimization: Reserve initial capacity for seek frame list
 constexpr SINT kMinutesPerFile = 10;        // enough for the majority of files (tunable)
 constexpr SINT kSecondsPerMinute = 60;      // fixed
@@ -196,8 +203,10 @@ SoundSourceMp3::SoundSourceMp3(const QUrl& url)
           m_pFileData(nullptr),
           m_avgSeekFrameCount(0),
           m_curFrameIndex(0),
+          m_madOptions(MAD_OPTION_IGNORECRC),
           m_madSynthCount(0),
-          m_leftoverBuffer(kMaxBytesPerMp3Frame + MAD_BUFFER_GUARD) {
+          m_leftoverBuffer(kMaxBytesPerMp3Frame + MAD_BUFFER_GUARD),
+          m_leftoverFileOffset(-1) {
     m_seekFrameList.reserve(kSeekFrameListCapacity);
     initDecoding();
 }
@@ -222,7 +231,7 @@ void SoundSourceMp3::finishDecoding() {
 
 SoundSource::OpenResult SoundSourceMp3::tryOpen(
         OpenMode /*mode*/,
-        const OpenParams& /*config*/) {
+        const OpenParams& params) {
     DEBUG_ASSERT(!m_file.isOpen());
     if (!m_file.open(QIODevice::ReadOnly)) {
         kLogger.warning() << "Failed to open file:" << m_file.fileName();
@@ -247,6 +256,71 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
     DEBUG_ASSERT(m_seekFrameList.empty());
     m_avgSeekFrameCount = 0;
     m_curFrameIndex = 0;
+    m_leftoverFileOffset = -1;
+
+    // Scanning all frame headers of long files takes a while and
+    // is only needed once
+    StreamProperties properties;
+    if (!restoreSeekIndex(&properties)) {
+        const OpenResult result = scanFrameHeaders(&properties);
+        if (result != OpenResult::Succeeded) {
+            return result;
+        }
+        storeSeekIndex(properties);
+    }
+    DEBUG_ASSERT(!m_seekFrameList.empty());
+    DEBUG_ASSERT(m_seekFrameList.front().frameIndex == 0);
+
+    // Initialize the AudioSource
+    initChannelCountOnce(properties.channelCount);
+    const auto sampleRate = properties.sampleRate;
+    const auto halfSampleRate = audio::SampleRate(sampleRate.value() / 2);
+    m_madOptions = MAD_OPTION_IGNORECRC;
+    if (params.getSignalInfo().getSampleRate().isValid() &&
+            sampleRate.value() % 2 == 0 &&
+            halfSampleRate.isValid() &&
+            params.getSignalInfo().getSampleRate() <= halfSampleRate) {
+        // The synthesis filterbank of libmad is able to output only
+        // every other sample, which reduces the decoding time. The
+        // number of samples of all MP3 frames is even.
+        m_madOptions |= MAD_OPTION_HALFSAMPLERATE;
+        for (auto& seekFrame : m_seekFrameList) {
+            DEBUG_ASSERT(seekFrame.frameIndex % 2 == 0);
+            seekFrame.frameIndex /= 2;
+        }
+        m_curFrameIndex /= 2;
+        initSampleRateOnce(halfSampleRate);
+    } else {
+        initSampleRateOnce(sampleRate);
+    }
+    initFrameIndexRangeOnce(IndexRange::forward(0, m_curFrameIndex));
+
+    DEBUG_ASSERT(m_seekFrameList.size() > 0); // see above
+    m_avgSeekFrameCount = frameLength() / static_cast<SINT>(m_seekFrameList.size());
+    if (properties.bitrate.isValid()) {
+        initBitrateOnce(properties.bitrate);
+    } else {
+        kLogger.warning() << "Bitrate cannot be calculated from headers";
+    }
+
+    // Terminate m_seekFrameList
+    addSeekFrame(m_curFrameIndex, nullptr);
+    DEBUG_ASSERT(m_seekFrameList.back().frameIndex == frameIndexMax());
+
+    // Restart decoding at the beginning of the audio stream
+    restartDecoding(m_seekFrameList.front());
+
+    if (m_curFrameIndex != frameIndexMin()) {
+        kLogger.warning() << "Failed to start decoding:" << m_file.fileName();
+        // Abort
+        return OpenResult::Failed;
+    }
+
+    return OpenResult::Succeeded;
+}
+
+SoundSource::OpenResult SoundSourceMp3::scanFrameHeaders(
+        StreamProperties* pProperties) {
     int headerPerSampleRate[kSampleRateCount];
     for (int i = 0; i < kSampleRateCount; ++i) {
         headerPerSampleRate[i] = 0;
@@ -440,7 +514,6 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
         kLogger.warning() << "Mixxx tries to plays it with the most common sample rate for this file";
     }
 
-    // Initialize the AudioSource
     if (!maxChannelCount.isValid() || (maxChannelCount > kChannelCountMax)) {
         kLogger.warning()
                 << "Invalid number of channels"
@@ -450,7 +523,7 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
         // Abort
         return OpenResult::Failed;
     }
-    initChannelCountOnce(maxChannelCount);
+    pProperties->channelCount = maxChannelCount;
     if (mostCommonSampleRateIndex > kSampleRateCount) {
         kLogger.warning()
                 << "Unknown sample rate in MP3 file:"
@@ -458,33 +531,131 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
         // Abort
         return OpenResult::Failed;
     }
-    initSampleRateOnce(getSampleRateByIndex(mostCommonSampleRateIndex));
-    initFrameIndexRangeOnce(IndexRange::forward(0, m_curFrameIndex));
+    pProperties->sampleRate = getSampleRateByIndex(mostCommonSampleRateIndex);
 
     // Calculate average bitrate values
-    DEBUG_ASSERT(m_seekFrameList.size() > 0); // see above
-    m_avgSeekFrameCount = frameLength() / static_cast<SINT>(m_seekFrameList.size());
     if (cntBitrateFrames > 0) {
         const unsigned long avgBitrate = sumBitrateFrames / cntBitrateFrames;
-        initBitrateOnce(avgBitrate / 1000); // bps -> kbps
-    } else {
-        kLogger.warning() << "Bitrate cannot be calculated from headers";
+        pProperties->bitrate = audio::Bitrate(avgBitrate / 1000); // bps -> kbps
     }
 
-    // Terminate m_seekFrameList
-    addSeekFrame(m_curFrameIndex, nullptr);
-    DEBUG_ASSERT(m_seekFrameList.back().frameIndex == frameIndexMax());
+    return OpenResult::Succeeded;
+}
 
-    // Restart decoding at the beginning of the audio stream
-    restartDecoding(m_seekFrameList.front());
+bool SoundSourceMp3::restoreSeekIndex(StreamProperties* pProperties) {
+    const QByteArray compressedIndex =
+            SeekIndexCache::load(m_file.fileName(), kSeekIndexDecoderId);
+    if (compressedIndex.isEmpty()) {
+        return false;
+    }
+    const QByteArray index = qUncompress(compressedIndex);
+    QDataStream stream(index);
+    quint8 channelCount = 0;
+    quint32 sampleRate = 0;
+    quint32 bitrate = 0;
+    qint64 frameCount = 0;
+    qint64 leftoverFileOffset = -1;
+    quint32 seekFrameCount = 0;
+    stream >> channelCount >> sampleRate >> bitrate >>
+            frameCount >> leftoverFileOffset >> seekFrameCount;
+    pProperties->channelCount = audio::ChannelCount(channelCount);
+    pProperties->sampleRate = audio::SampleRate(sampleRate);
+    pProperties->bitrate = audio::Bitrate(bitrate);
+    if (stream.status() != QDataStream::Ok ||
+            !pProperties->channelCount.isValid() ||
+            pProperties->channelCount > kChannelCountMax ||
+            getIndexBySampleRate(pProperties->sampleRate) >= kSampleRateCount ||
+            seekFrameCount == 0 ||
+            leftoverFileOffset >= static_cast<qint64>(m_fileSize) ||
+            (leftoverFileOffset >= 0 &&
+                    static_cast<qint64>(m_fileSize) - leftoverFileOffset >
+                            kMaxBytesPerMp3Frame)) {
+        kLogger.warning() << "Discarding invalid seek index of" << m_file.fileName();
+        return false;
+    }
 
-    if (m_curFrameIndex != frameIndexMin()) {
-        kLogger.warning() << "Failed to start decoding:" << m_file.fileName();
-        // Abort
-        return OpenResult::Failed;
+    unsigned char* pLeftoverBuffer = &*m_leftoverBuffer.begin();
+    if (leftoverFileOffset >= 0) {
+        // Restore the copy of the last MP3 frame, see copyLeftoverFrame()
+        const SINT remainingBytes = static_cast<SINT>(m_fileSize - leftoverFileOffset);
+        std::copy(m_pFileData + leftoverFileOffset,
+                m_pFileData + m_fileSize,
+                pLeftoverBuffer);
+        std::fill(pLeftoverBuffer + remainingBytes,
+                pLeftoverBuffer + remainingBytes + MAD_BUFFER_GUARD,
+                0);
     }
 
-    return OpenResult::Succeeded;
+    // Both the frame indices and the file offsets are stored as
+    // increments of the previous seek frame
+    DEBUG_ASSERT(m_seekFrameList.empty());
+    m_seekFrameList.reserve(seekFrameCount);
+    SINT frameIndex = 0;
+    qint64 fileOffset = 0;
+    for (quint32 i = 0; i < seekFrameCount; ++i) {
+        quint32 frameIndexIncrement = 0;
+        quint32 fileOffsetIncrement = 0;
+        stream >> frameIndexIncrement >> fileOffsetIncrement;
+        frameIndex += frameIndexIncrement;
+        fileOffset += fileOffsetIncrement;
+        if (stream.status() != QDataStream::Ok ||
+                (i > 0 && frameIndexIncrement == 0) ||
+                frameIndex >= frameCount ||
+                fileOffset >= static_cast<qint64>(m_fileSize)) {
+            kLogger.warning() << "Discarding invalid seek index of" << m_file.fileName();
+            m_seekFrameList.clear();
+            return false;
+        }
+        SeekFrameType seekFrame;
+        seekFrame.frameIndex = frameIndex;
+        if (leftoverFileOffset >= 0 && fileOffset >= leftoverFileOffset) {
+            seekFrame.pInputData = pLeftoverBuffer + (fileOffset - leftoverFileOffset);
+        } else {
+            seekFrame.pInputData = m_pFileData + fileOffset;
+        }
+        m_seekFrameList.push_back(seekFrame);
+    }
+    if (m_seekFrameList.front().frameIndex != 0) {
+        m_seekFrameList.clear();
+        return false;
+    }
+    m_curFrameIndex = static_cast<SINT>(frameCount);
+    m_leftoverFileOffset = leftoverFileOffset;
+    return true;
+}
+
+void SoundSourceMp3::storeSeekIndex(const StreamProperties& properties) const {
+    if (SeekIndexCache::directory().isEmpty()) {
+        return;
+    }
+    const unsigned char* pLeftoverBuffer = &*m_leftoverBuffer.begin();
+    QByteArray index;
+    QDataStream stream(&index, QIODevice::WriteOnly);
+    stream << static_cast<quint8>(properties.channelCount.value())
+           << static_cast<quint32>(properties.sampleRate.value())
+           << static_cast<quint32>(properties.bitrate.value())
+           << static_cast<qint64>(m_curFrameIndex)
+           << static_cast<qint64>(m_leftoverFileOffset)
+           << static_cast<quint32>(m_seekFrameList.size());
+    SINT prevFrameIndex = 0;
+    qint64 prevFileOffset = 0;
+    for (const auto& seekFrame : m_seekFrameList) {
+        qint64 fileOffset;
+        if (seekFrame.pInputData >= pLeftoverBuffer &&
+                seekFrame.pInputData < pLeftoverBuffer + m_leftoverBuffer.size()) {
+            DEBUG_ASSERT(m_leftoverFileOffset >= 0);
+            fileOffset = m_leftoverFileOffset + (seekFrame.pInputData - pLeftoverBuffer);
+        } else {
+            fileOffset = seekFrame.pInputData - m_pFileData;
+        }
+        DEBUG_ASSERT(fileOffset >= prevFileOffset);
+        stream << static_cast<quint32>(seekFrame.frameIndex - prevFrameIndex)
+               << static_cast<quint32>(fileOffset - prevFileOffset);
+        prevFrameIndex = seekFrame.frameIndex;
+        prevFileOffset = fileOffset;
+    }
+    // The increments are very similar and compress well
+    SeekIndexCache::store(m_file.fileName(), kSeekIndexDecoderId, qCompress(index));
 }
 
 void SoundSourceMp3::close() {
@@ -521,7 +692,7 @@ void SoundSourceMp3::restartDecoding(
     mad_stream_finish(&m_madStream);
 
     mad_stream_init(&m_madStream);
-    mad_stream_options(&m_madStream, MAD_OPTION_IGNORECRC);
+    mad_stream_options(&m_madStream, m_madOptions);
     if (frameIndexMin() == seekFrame.frameIndex) {
         mad_synth_init(&m_madSynth);
         mad_frame_init(&m_madFrame);
@@ -788,41 +959,23 @@ ReadableSampleFrames SoundSourceMp3::readSampleFramesClamped(
                 kLogger.warning() << "Reading MP3 data with different number of channels"
                                   << madSynthChannelCount << "<>" << getSignalInfo().getChannelCount();
             }
-            if (madSynthChannelCount == 1) {
-                // MP3 frame contains a mono signal
-                if (getSignalInfo().getChannelCount() == 2) {
-                    // The reader explicitly requested a stereo signal
-                    // or the AudioSource itself provides a stereo signal.
-                    // Mono -> Stereo: Copy 1st channel twice
-                    for (SINT i = 0; i < synthReadCount; ++i) {
-                        const CSAMPLE sampleValue = madScaleSampleValue(
-                                m_madSynth.pcm.samples[0][madSynthOffset + i]);
-                        *pSampleBuffer++ = sampleValue;
-                        *pSampleBuffer++ = sampleValue;
-                    }
-                } else {
-                    // Mono -> Mono: Copy 1st channel
-                    for (SINT i = 0; i < synthReadCount; ++i) {
-                        const CSAMPLE sampleValue = madScaleSampleValue(
-                                m_madSynth.pcm.samples[0][madSynthOffset + i]);
-                        *pSampleBuffer++ = sampleValue;
-                    }
-                }
-            } else {
-                // MP3 frame contains a stereo signal
-                DEBUG_ASSERT(madSynthChannelCount == 2);
-                // If the MP3 frame contains a stereo signal then the whole
-                // AudioSource must also provide 2 channels, because the
-                // maximum channel count of all MP3 frames is used.
-                DEBUG_ASSERT(getSignalInfo().getChannelCount() == 2);
-                // Stereo -> Stereo: Copy 1st + 2nd channel
-                for (SINT i = 0; i < synthReadCount; ++i) {
-                    *pSampleBuffer++ = madScaleSampleValue(
-                            m_madSynth.pcm.samples[0][madSynthOffset + i]);
-                    *pSampleBuffer++ = madScaleSampleValue(
-                            m_madSynth.pcm.samples[1][madSynthOffset + i]);
-                }
-            }
+            // The reader might have requested a stereo signal explicitly
+            // or the AudioSource itself provides a stereo signal, because
+            // the maximum channel count of all MP3 frames is used. Mono
+            // frames are then copied into both channels.
+            static_assert(std::is_same_v<mad_fixed_t, qint32>);
+            const mad_fixed_t* const madSynthSamples[] = {
+                    m_madSynth.pcm.samples[0] + madSynthOffset,
+                    m_madSynth.pcm.samples[1] + madSynthOffset,
+            };
+            SampleUtil::convertPlanarS32ToFloat32(
+                    pSampleBuffer,
+                    getSignalInfo().getChannelCount(),
+                    madSynthSamples,
+                    audio::ChannelCount::fromInt(madSynthChannelCount),
+                    synthReadCount,
+                    kMadScale);
+            pSampleBuffer += getSignalInfo().frames2samples(synthReadCount);
         }
         // consume decoded output data
         m_madSynthCount -= synthReadCount;
@@ -861,6 +1014,7 @@ bool SoundSourceMp3::copyLeftoverFrame() {
         DEBUG_ASSERT(remainingBytes <= kMaxBytesPerMp3Frame); // only last MP3 frame
         const SINT leftoverBytes = remainingBytes + MAD_BUFFER_GUARD;
         if ((remainingBytes > 0) && (leftoverBytes <= SINT(m_leftoverBuffer.size()))) {
+            m_leftoverFileOffset = m_madStream.next_frame - m_pFileData;
             // Copy the data of the last MP3 frame into the leftover buffer...
             std::copy(m_madStream.next_frame,
                     m_madStream.next_frame + remainingBytes,
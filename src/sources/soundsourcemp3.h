@@ -23,6 +23,11 @@ class SoundSourceMp3 final : public SoundSource {
 
     void close() override;
 
+    /// Uses the half-sample-rate synthesis of libmad.
+    bool canDecodeAtReducedSampleRate() const override {
+        return true;
+    }
+
   protected:
     ReadableSampleFrames readSampleFramesClamped(
             const WritableSampleFrames& sampleFrames) override;
@@ -32,6 +37,21 @@ class SoundSourceMp3 final : public SoundSource {
             OpenMode mode,
             const OpenParams& params) override;
 
+    struct StreamProperties {
+        audio::ChannelCount channelCount;
+        audio::SampleRate sampleRate;
+        audio::Bitrate bitrate;
+    };
+
+    /// Builds the seek frame list by decoding the headers of all
+    /// MP3 frames.
+    OpenResult scanFrameHeaders(StreamProperties* pProperties);
+
+    /// Restores the seek frame list from the SeekIndexCache instead
+    /// of scanning the file.
+    bool restoreSeekIndex(StreamProperties* pProperties);
+    void storeSeekIndex(const StreamProperties& properties) const;
+
     QFile m_file;
     quint64 m_fileSize;
     unsigned char* m_pFileData;
@@ -67,6 +87,7 @@ class SoundSourceMp3 final : public SoundSource {
     void finishDecoding();
 
     // MAD decoder
+    int m_madOptions;
     mad_stream m_madStream;
     mad_frame m_madFrame;
     mad_synth m_madSynth;
@@ -74,6 +95,9 @@ class SoundSourceMp3 final : public SoundSource {
     SINT m_madSynthCount; // left overs from the previous read
 
     std::vector<unsigned char> m_leftoverBuffer;
+    // The position of the data in the leftover buffer within the file
+    // or -1 if the leftover buffer is unused
+    qint64 m_leftoverFileOffset;
 };
 
 class SoundSourceProviderMp3 : public SoundSourceProvider {
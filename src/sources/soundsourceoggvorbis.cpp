@@ -3,6 +3,7 @@
 #include <QFile>
 
 #include "util/logger.h"
+#include "util/sample.h"
 
 namespace mixxx {
 
@@ -55,7 +56,7 @@ SoundSourceOggVorbis::~SoundSourceOggVorbis() {
 
 SoundSource::OpenResult SoundSourceOggVorbis::tryOpen(
         OpenMode /*mode*/,
-        const OpenParams& /*config*/) {
+        const OpenParams& params) {
     m_pFile = std::make_unique<QFile>(getLocalFileName());
     if (!m_pFile->open(QFile::ReadOnly)) {
         kLogger.warning()
@@ -98,7 +99,10 @@ SoundSource::OpenResult SoundSourceOggVorbis::tryOpen(
                 << getUrlString();
         return OpenResult::Failed;
     }
-    initChannelCountOnce(vi->channels);
+    m_streamChannelCount = audio::ChannelCount::fromInt(vi->channels);
+    // Mono or multi-channel signals are remapped while interleaving
+    // the decoded samples if requested
+    initChannelCountOnce(params.decodedChannelCount(m_streamChannelCount));
     initSampleRateOnce(vi->rate);
     if (0 < vi->bitrate_nominal) {
         initBitrateOnce(vi->bitrate_nominal / 1000);
@@ -170,25 +174,13 @@ ReadableSampleFrames SoundSourceOggVorbis::readSampleFramesClamped(
         if (0 < readResult) {
             m_curFrameIndex += readResult;
             if (pSampleBuffer) {
-                switch (getSignalInfo().getChannelCount()) {
-                case 1:
-                    for (long i = 0; i < readResult; ++i) {
-                        *pSampleBuffer++ = pcmChannels[0][i];
-                    }
-                    break;
-                case 2:
-                    for (long i = 0; i < readResult; ++i) {
-                        *pSampleBuffer++ = pcmChannels[0][i];
-                        *pSampleBuffer++ = pcmChannels[1][i];
-                    }
-                    break;
-                default:
-                    for (long i = 0; i < readResult; ++i) {
-                        for (SINT j = 0; j < getSignalInfo().getChannelCount(); ++j) {
-                            *pSampleBuffer++ = pcmChannels[j][i];
-                        }
-                    }
-                }
+                SampleUtil::interleavePlanarBuffer(
+                        pSampleBuffer,
+                        getSignalInfo().getChannelCount(),
+                        pcmChannels,
+                        m_streamChannelCount,
+                        readResult);
+                pSampleBuffer += getSignalInfo().frames2samples(readResult);
             }
             numberOfFramesRemaining -= readResult;
         } else {
@@ -35,6 +35,7 @@ class SoundSourceOggVorbis final : public SoundSource {
     std::unique_ptr<QFile> m_pFile;
 
     OggVorbis_File m_vf;
+    audio::ChannelCount m_streamChannelCount;
 
     SINT m_curFrameIndex;
 };
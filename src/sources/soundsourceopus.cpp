@@ -130,16 +130,8 @@ SoundSource::OpenResult SoundSourceOpus::tryOpen(
     const int streamChannelCount = op_channel_count(m_pOggOpusFile, kCurrentStreamLink);
     if (0 < streamChannelCount) {
         // opusfile supports to enforce stereo decoding
-        bool enforceStereoDecoding =
-                params.getSignalInfo().getChannelCount().isValid() &&
-                (params.getSignalInfo().getChannelCount() <= 2) &&
-                // preserve mono signals if stereo signal is not requested explicitly
-                ((params.getSignalInfo().getChannelCount() == 2) || (streamChannelCount > 2));
-        if (enforceStereoDecoding) {
-            initChannelCountOnce(2);
-        } else {
-            initChannelCountOnce(streamChannelCount);
-        }
+        initChannelCountOnce(params.decodedChannelCount(
+                audio::ChannelCount(streamChannelCount)));
     } else {
         kLogger.warning()
                 << "Failed to read channel configuration of OggOpus file:"
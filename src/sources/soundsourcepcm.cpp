@@ -0,0 +1,429 @@
+#include "sources/soundsourcepcm.h"
+
+#include <QtEndian>
+#include <cmath>
+#include <cstring>
+
+#include "util/logger.h"
+#include "util/math.h"
+#include "util/sample.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("SoundSourcePcm");
+
+constexpr quint16 kWavFormatPcm = 0x0001;
+constexpr quint16 kWavFormatIeeeFloat = 0x0003;
+constexpr quint16 kWavFormatExtensible = 0xFFFE;
+
+constexpr bool kHostIsLittleEndian = Q_BYTE_ORDER == Q_LITTLE_ENDIAN;
+
+bool hasChunkId(const uchar* pData, const char* id) {
+    return std::memcmp(pData, id, 4) == 0;
+}
+
+/// Converts an 80-bit IEEE 754 extended precision number, which is
+/// used for the sample rate in AIFF files.
+double fromExtended(const uchar* pData) {
+    const int exponent = ((pData[0] & 0x7F) << 8) | pData[1];
+    const quint64 mantissa = qFromBigEndian<quint64>(pData + 2);
+    if (exponent == 0 && mantissa == 0) {
+        return 0.0;
+    }
+    const double value = std::ldexp(static_cast<double>(mantissa), exponent - 16383 - 63);
+    return (pData[0] & 0x80) ? -value : value;
+}
+
+bool isAligned(const void* pData, std::size_t alignment) {
+    return reinterpret_cast<quintptr>(pData) % alignment == 0;
+}
+
+template<typename T, bool bigEndian>
+T loadSample(const uchar* pSrc) {
+    // Supports unaligned access
+    return bigEndian ? qFromBigEndian<T>(pSrc) : qFromLittleEndian<T>(pSrc);
+}
+
+template<bool bigEndian>
+void convertS16(CSAMPLE* pDest, const uchar* pSrc, SINT numSamples) {
+    for (SINT i = 0; i < numSamples; ++i) {
+        pDest[i] = CSAMPLE(loadSample<qint16, bigEndian>(pSrc + 2 * i)) / 32768.0f;
+    }
+}
+
+template<bool bigEndian>
+void convertS24(CSAMPLE* pDest, const uchar* pSrc, SINT numSamples) {
+    for (SINT i = 0; i < numSamples; ++i) {
+        const uchar* pSample = pSrc + 3 * i;
+        // Shift the sample into the upper 24 bits to preserve the sign
+        const quint32 sample = bigEndian
+                ? (static_cast<quint32>(pSample[0]) << 24) |
+                        (static_cast<quint32>(pSample[1]) << 16) |
+                        (static_cast<quint32>(pSample[2]) << 8)
+                : (static_cast<quint32>(pSample[2]) << 24) |
+                        (static_cast<quint32>(pSample[1]) << 16) |
+                        (static_cast<quint32>(pSample[0]) << 8);
+        pDest[i] = CSAMPLE(static_cast<qint32>(sample)) / 2147483648.0f;
+    }
+}
+
+template<bool bigEndian>
+void convertS32(CSAMPLE* pDest, const uchar* pSrc, SINT numSamples) {
+    for (SINT i = 0; i < numSamples; ++i) {
+        pDest[i] = CSAMPLE(loadSample<qint32, bigEndian>(pSrc + 4 * i)) / 2147483648.0f;
+    }
+}
+
+template<bool bigEndian>
+void convertFloat32(CSAMPLE* pDest, const uchar* pSrc, SINT numSamples) {
+    for (SINT i = 0; i < numSamples; ++i) {
+        const quint32 bits = loadSample<quint32, bigEndian>(pSrc + 4 * i);
+        std::memcpy(&pDest[i], &bits, sizeof(bits));
+    }
+}
+
+} // anonymous namespace
+
+//static
+const QString SoundSourceProviderPcm::kDisplayName = QStringLiteral("Mixxx PCM");
+
+//static
+const QStringList SoundSourceProviderPcm::kSupportedFileTypes = {
+        QStringLiteral("aiff"),
+        QStringLiteral("wav"),
+};
+
+SoundSourceProviderPriority SoundSourceProviderPcm::getPriorityHint(
+        const QString& supportedFileType) const {
+    Q_UNUSED(supportedFileType)
+    // Reading uncompressed samples doesn't need a decoder. Unsupported
+    // files are aborted and passed on to the next provider.
+    return SoundSourceProviderPriority::Higher;
+}
+
+SoundSourcePcm::SoundSourcePcm(const QUrl& url)
+        : SoundSource(url),
+          m_file(getLocalFileName()),
+          m_pFileData(nullptr),
+          m_fileSize(0),
+          m_dataOffset(0),
+          m_pSampleData(nullptr),
+          m_sampleFormat(SampleFormat::S16),
+          m_bigEndian(false),
+          m_bytesPerSample(0) {
+}
+
+SoundSourcePcm::~SoundSourcePcm() {
+    close();
+}
+
+SoundSource::OpenResult SoundSourcePcm::tryOpen(
+        OpenMode /*mode*/,
+        const OpenParams& /*params*/) {
+    DEBUG_ASSERT(!m_file.isOpen());
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        kLogger.warning() << "Failed to open file:" << m_file.fileName();
+        return OpenResult::Failed;
+    }
+    m_fileSize = m_file.size();
+    // NOTE: Like in SoundSourceMp3 a SIGBUS error might occur if the
+    // file is truncated while mapped
+    m_pFileData = m_file.map(0, m_fileSize);
+    if (!m_pFileData) {
+        kLogger.info() << "Failed to map file:" << m_file.fileName();
+        return OpenResult::Aborted;
+    }
+
+    Layout layout;
+    if (!parseWav(&layout) && !parseAiff(&layout)) {
+        // Not a file that we are able to read, try the next provider
+        return OpenResult::Aborted;
+    }
+
+    switch (layout.sampleFormat) {
+    case SampleFormat::S16:
+        m_bytesPerSample = 2;
+        break;
+    case SampleFormat::S24:
+        m_bytesPerSample = 3;
+        break;
+    case SampleFormat::S32:
+    case SampleFormat::Float32:
+        m_bytesPerSample = 4;
+        break;
+    }
+    m_sampleFormat = layout.sampleFormat;
+    m_bigEndian = layout.bigEndian;
+    m_dataOffset = layout.dataOffset;
+    m_pSampleData = m_pFileData + m_dataOffset;
+
+    if (!initChannelCountOnce(layout.channelCount) ||
+            !initSampleRateOnce(layout.sampleRate)) {
+        return OpenResult::Aborted;
+    }
+    initFrameIndexRangeOnce(IndexRange::forward(0, readableFrameCount(layout)));
+    return OpenResult::Succeeded;
+}
+
+SINT SoundSourcePcm::readableFrameCount(const Layout& layout) const {
+    // Files that have been truncated while recording might end
+    // within the announced data chunk
+    const qint64 dataSize = math_min(layout.dataSize, m_fileSize - layout.dataOffset);
+    return static_cast<SINT>(
+            dataSize / (m_bytesPerSample * layout.channelCount));
+}
+
+bool SoundSourcePcm::tryGrowFrameIndexRange() {
+    if (!m_pFileData) {
+        return false;
+    }
+    const qint64 fileSize = m_file.size();
+    if (fileSize <= m_fileSize) {
+        return false;
+    }
+    // An existing mapping doesn't cover the appended data
+    const uchar* pFileData = m_file.map(0, fileSize);
+    if (!pFileData) {
+        kLogger.warning() << "Failed to remap grown file:" << m_file.fileName();
+        return false;
+    }
+    m_file.unmap(const_cast<uchar*>(m_pFileData));
+    m_pFileData = pFileData;
+    m_fileSize = fileSize;
+    m_pSampleData = m_pFileData + m_dataOffset;
+
+    // The header might have been rewritten by the writer in the meantime
+    Layout layout;
+    if ((!parseWav(&layout) && !parseAiff(&layout)) ||
+            layout.dataOffset != m_dataOffset ||
+            layout.sampleFormat != m_sampleFormat ||
+            layout.channelCount != getSignalInfo().getChannelCount()) {
+        kLogger.warning() << "Unexpected header of grown file:" << m_file.fileName();
+        return false;
+    }
+    const SINT frameCount = readableFrameCount(layout);
+    if (frameCount <= frameIndexMax()) {
+        return false;
+    }
+    growFrameIndexRange(IndexRange::forward(frameIndexMin(), frameCount));
+    return true;
+}
+
+bool SoundSourcePcm::parseWav(Layout* pLayout) const {
+    if (m_fileSize < 12 ||
+            !hasChunkId(m_pFileData, "RIFF") ||
+            !hasChunkId(m_pFileData + 8, "WAVE")) {
+        return false;
+    }
+    bool formatFound = false;
+    qint64 offset = 12;
+    while (offset + 8 <= m_fileSize) {
+        const uchar* pChunk = m_pFileData + offset;
+        const qint64 chunkSize = qFromLittleEndian<quint32>(pChunk + 4);
+        const qint64 bodyOffset = offset + 8;
+        if (hasChunkId(pChunk, "fmt ")) {
+            if (chunkSize < 16 || bodyOffset + chunkSize > m_fileSize) {
+                return false;
+            }
+            const uchar* pBody = pChunk + 8;
+            quint16 formatTag = qFromLittleEndian<quint16>(pBody);
+            const quint16 channelCount = qFromLittleEndian<quint16>(pBody + 2);
+            const quint32 sampleRate = qFromLittleEndian<quint32>(pBody + 4);
+            const quint16 blockAlign = qFromLittleEndian<quint16>(pBody + 12);
+            const quint16 bitsPerSample = qFromLittleEndian<quint16>(pBody + 14);
+            if (formatTag == kWavFormatExtensible) {
+                if (chunkSize < 40) {
+                    return false;
+                }
+                // The first two bytes of the sub-format GUID
+                formatTag = qFromLittleEndian<quint16>(pBody + 24);
+            }
+            if (formatTag == kWavFormatPcm && bitsPerSample == 16) {
+                pLayout->sampleFormat = SampleFormat::S16;
+            } else if (formatTag == kWavFormatPcm && bitsPerSample == 24) {
+                pLayout->sampleFormat = SampleFormat::S24;
+            } else if (formatTag == kWavFormatPcm && bitsPerSample == 32) {
+                pLayout->sampleFormat = SampleFormat::S32;
+            } else if (formatTag == kWavFormatIeeeFloat && bitsPerSample == 32) {
+                pLayout->sampleFormat = SampleFormat::Float32;
+            } else {
+                return false;
+            }
+            if (channelCount == 0 || blockAlign != channelCount * bitsPerSample / 8) {
+                return false;
+            }
+            pLayout->channelCount = audio::ChannelCount(channelCount);
+            pLayout->sampleRate = audio::SampleRate(sampleRate);
+            pLayout->bigEndian = false;
+            formatFound = true;
+        } else if (hasChunkId(pChunk, "data")) {
+            if (!formatFound) {
+                return false;
+            }
+            // The size might be 0 or 0xFFFFFFFF if the file has been
+            // written as a stream without updating the header
+            pLayout->dataOffset = bodyOffset;
+            pLayout->dataSize = (chunkSize == 0 || chunkSize == 0xFFFFFFFF)
+                    ? m_fileSize - bodyOffset
+                    : chunkSize;
+            return true;
+        }
+        // Chunks are padded to an even size
+        offset = bodyOffset + chunkSize + (chunkSize & 1);
+    }
+    return false;
+}
+
+bool SoundSourcePcm::parseAiff(Layout* pLayout) const {
+    if (m_fileSize < 12 || !hasChunkId(m_pFileData, "FORM")) {
+        return false;
+    }
+    const bool aifc = hasChunkId(m_pFileData + 8, "AIFC");
+    if (!aifc && !hasChunkId(m_pFileData + 8, "AIFF")) {
+        return false;
+    }
+    bool formatFound = false;
+    bool dataFound = false;
+    qint64 offset = 12;
+    while (offset + 8 <= m_fileSize && !(formatFound && dataFound)) {
+        const uchar* pChunk = m_pFileData + offset;
+        const qint64 chunkSize = qFromBigEndian<quint32>(pChunk + 4);
+        const qint64 bodyOffset = offset + 8;
+        if (hasChunkId(pChunk, "COMM")) {
+            if (chunkSize < (aifc ? 22 : 18) || bodyOffset + chunkSize > m_fileSize) {
+                return false;
+            }
+            const uchar* pBody = pChunk + 8;
+            const quint16 channelCount = qFromBigEndian<quint16>(pBody);
+            const quint16 bitsPerSample = qFromBigEndian<quint16>(pBody + 6);
+            const double sampleRate = fromExtended(pBody + 8);
+            bool bigEndian = true;
+            bool floatingPoint = false;
+            if (aifc) {
+                const uchar* pCompression = pBody + 18;
+                if (hasChunkId(pCompression, "sowt")) {
+                    bigEndian = false;
+                } else if (hasChunkId(pCompression, "fl32") ||
+                        hasChunkId(pCompression, "FL32")) {
+                    floatingPoint = true;
+                } else if (!hasChunkId(pCompression, "NONE") &&
+                        !hasChunkId(pCompression, "twos")) {
+                    return false;
+                }
+            }
+            if (floatingPoint) {
+                pLayout->sampleFormat = SampleFormat::Float32;
+            } else if (bitsPerSample == 16) {
+                pLayout->sampleFormat = SampleFormat::S16;
+            } else if (bitsPerSample == 24) {
+                pLayout->sampleFormat = SampleFormat::S24;
+            } else if (bitsPerSample == 32) {
+                pLayout->sampleFormat = SampleFormat::S32;
+            } else {
+                return false;
+            }
+            if (channelCount == 0 ||
+                    sampleRate <= 0 ||
+                    sampleRate != std::floor(sampleRate)) {
+                return false;
+            }
+            pLayout->channelCount = audio::ChannelCount(channelCount);
+            pLayout->sampleRate = audio::SampleRate(
+                    static_cast<audio::SampleRate::value_t>(sampleRate));
+            pLayout->bigEndian = bigEndian;
+            formatFound = true;
+        } else if (hasChunkId(pChunk, "SSND")) {
+            if (chunkSize < 8 || bodyOffset + 8 > m_fileSize) {
+                return false;
+            }
+            const qint64 dataOffset = qFromBigEndian<quint32>(pChunk + 8);
+            pLayout->dataOffset = bodyOffset + 8 + dataOffset;
+            pLayout->dataSize = chunkSize - 8 - dataOffset;
+            if (pLayout->dataSize < 0 || pLayout->dataOffset > m_fileSize) {
+                return false;
+            }
+            if (pLayout->dataSize == 0) {
+                // Like for WAV the header of a file that is written as
+                // a stream is not updated until the stream is closed.
+                // In this case the sound data is the last chunk.
+                pLayout->dataSize = m_fileSize - pLayout->dataOffset;
+                dataFound = true;
+                break;
+            }
+            dataFound = true;
+        }
+        // Chunks are padded to an even size
+        offset = bodyOffset + chunkSize + (chunkSize & 1);
+    }
+    return formatFound && dataFound;
+}
+
+void SoundSourcePcm::close() {
+    if (m_pFileData) {
+        m_file.unmap(const_cast<uchar*>(m_pFileData));
+        m_pFileData = nullptr;
+    }
+    m_pSampleData = nullptr;
+    m_fileSize = 0;
+    m_file.close();
+}
+
+ReadableSampleFrames SoundSourcePcm::readSampleFramesClamped(
+        const WritableSampleFrames& writableSampleFrames) {
+    const SINT firstFrameIndex = writableSampleFrames.frameIndexRange().start();
+    const SINT numSamples = getSignalInfo().frames2samples(
+            writableSampleFrames.frameLength());
+    const uchar* pSrc = m_pSampleData +
+            getSignalInfo().frames2samples(firstFrameIndex) * m_bytesPerSample;
+    CSAMPLE* pDest = writableSampleFrames.writableData();
+
+    // The optimized conversions of SampleUtil require the native byte
+    // order and aligned samples, otherwise each sample is loaded separately
+    const bool nativeByteOrder = m_bigEndian == !kHostIsLittleEndian;
+    switch (m_sampleFormat) {
+    case SampleFormat::S16:
+        if (nativeByteOrder && isAligned(pSrc, alignof(SAMPLE))) {
+            SampleUtil::convertS16ToFloat32(
+                    pDest, reinterpret_cast<const SAMPLE*>(pSrc), numSamples);
+        } else if (m_bigEndian) {
+            convertS16<true>(pDest, pSrc, numSamples);
+        } else {
+            convertS16<false>(pDest, pSrc, numSamples);
+        }
+        break;
+    case SampleFormat::S24:
+        if (m_bigEndian) {
+            convertS24<true>(pDest, pSrc, numSamples);
+        } else {
+            SampleUtil::convertS24LEToFloat32(pDest, pSrc, numSamples);
+        }
+        break;
+    case SampleFormat::S32:
+        if (nativeByteOrder && isAligned(pSrc, alignof(qint32))) {
+            SampleUtil::convertS32ToFloat32(
+                    pDest, reinterpret_cast<const qint32*>(pSrc), numSamples);
+        } else if (m_bigEndian) {
+            convertS32<true>(pDest, pSrc, numSamples);
+        } else {
+            convertS32<false>(pDest, pSrc, numSamples);
+        }
+        break;
+    case SampleFormat::Float32:
+        if (nativeByteOrder) {
+            std::memcpy(pDest, pSrc, numSamples * sizeof(CSAMPLE));
+        } else if (m_bigEndian) {
+            convertFloat32<true>(pDest, pSrc, numSamples);
+        } else {
+            convertFloat32<false>(pDest, pSrc, numSamples);
+        }
+        break;
+    }
+
+    return ReadableSampleFrames(
+            writableSampleFrames.frameIndexRange(),
+            SampleBuffer::ReadableSlice(pDest, numSamples));
+}
+
+} // namespace mixxx
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <QFile>
+
+#include "sources/soundsourceprovider.h"
+
+namespace mixxx {
+
+/// Reads uncompressed WAV and AIFF files by memory-mapping the file and
+/// converting the samples of the requested frames directly into the
+/// buffer of the caller.
+///
+/// Only integer PCM with 16, 24 or 32 bits and 32-bit float samples are
+/// supported. Opening other files, e.g. 8-bit, A-law or RF64, is aborted
+/// to fall back to the next provider.
+class SoundSourcePcm final : public SoundSource {
+  public:
+    explicit SoundSourcePcm(const QUrl& url);
+    ~SoundSourcePcm() override;
+
+    void close() override;
+
+    /// Remaps the file if it has grown since it has been opened, e.g.
+    /// while recording into the file.
+    bool tryGrowFrameIndexRange() override;
+
+  protected:
+    ReadableSampleFrames readSampleFramesClamped(
+            const WritableSampleFrames& sampleFrames) override;
+
+  private:
+    enum class SampleFormat {
+        S16,
+        S24,
+        S32,
+        Float32,
+    };
+
+    struct Layout {
+        audio::ChannelCount channelCount;
+        audio::SampleRate sampleRate;
+        SampleFormat sampleFormat;
+        bool bigEndian;
+        qint64 dataOffset;
+        qint64 dataSize;
+    };
+
+    OpenResult tryOpen(
+            OpenMode mode,
+            const OpenParams& params) override;
+
+    bool parseWav(Layout* pLayout) const;
+    bool parseAiff(Layout* pLayout) const;
+
+    SINT readableFrameCount(const Layout& layout) const;
+
+    QFile m_file;
+    const uchar* m_pFileData;
+    qint64 m_fileSize;
+
+    qint64 m_dataOffset;
+    const uchar* m_pSampleData;
+    SampleFormat m_sampleFormat;
+    bool m_bigEndian;
+    SINT m_bytesPerSample;
+};
+
+class SoundSourceProviderPcm : public SoundSourceProvider {
+  public:
+    static const QString kDisplayName;
+    static const QStringList kSupportedFileTypes;
+
+    QString getDisplayName() const override {
+        return kDisplayName;
+    }
+
+    QStringList getSupportedFileTypes() const override {
+        return kSupportedFileTypes;
+    }
+
+    SoundSourceProviderPriority getPriorityHint(
+            const QString& supportedFileType) const override;
+
+    SoundSourcePointer newSoundSource(const QUrl& url) override {
+        return newSoundSourceFromUrl<SoundSourcePcm>(url);
+    }
+};
+
+} // namespace mixxx
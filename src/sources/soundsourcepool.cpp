@@ -0,0 +1,191 @@
+#include "sources/soundsourcepool.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QMutex>
+#include <QTimer>
+#include <list>
+
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("SoundSourcePool");
+
+// Only a few files are opened repeatedly at the same time, e.g. the
+// track in the preview deck that is also analyzed.
+constexpr std::size_t kMaxIdleSoundSources = 4;
+
+// Idle sound sources keep their files open. Close them soon to avoid
+// interfering with other applications that access the files.
+constexpr int kMaxIdleMillis = 10000;
+
+struct IdleSoundSource {
+    QString localFileName;
+    AudioSource::OpenParams params;
+    qint64 fileSize;
+    QDateTime fileLastModified;
+    SoundSourceProviderPointer pProvider;
+    SoundSourcePointer pSoundSource;
+    QElapsedTimer idleTimer;
+};
+
+QMutex s_mutex;
+// Ordered from the most recently to the least recently returned
+std::list<IdleSoundSource> s_idleSoundSources;
+bool s_releaseExpiredScheduled = false;
+
+bool isUnmodified(const IdleSoundSource& idleSoundSource) {
+    const QFileInfo fileInfo(idleSoundSource.localFileName);
+    return fileInfo.exists() &&
+            fileInfo.size() == idleSoundSource.fileSize &&
+            fileInfo.lastModified() == idleSoundSource.fileLastModified;
+}
+
+/// Closing is done outside of the locking scope
+void closeAll(std::list<IdleSoundSource>* pSoundSources) {
+    for (auto& soundSource : *pSoundSources) {
+        soundSource.pSoundSource->close();
+    }
+    pSoundSources->clear();
+}
+
+} // anonymous namespace
+
+// static
+std::pair<SoundSourceProviderPointer, SoundSourcePointer> SoundSourcePool::checkOut(
+        const QString& localFileName,
+        const AudioSource::OpenParams& params) {
+    std::list<IdleSoundSource> staleSoundSources;
+    std::pair<SoundSourceProviderPointer, SoundSourcePointer> result;
+    {
+        const auto locker = lockMutex(&s_mutex);
+        for (auto i = s_idleSoundSources.begin(); i != s_idleSoundSources.end(); ++i) {
+            if (i->localFileName != localFileName ||
+                    i->params.getSignalInfo() != params.getSignalInfo()) {
+                continue;
+            }
+            if (!isUnmodified(*i)) {
+                staleSoundSources.splice(staleSoundSources.end(), s_idleSoundSources, i);
+                break;
+            }
+            result = std::make_pair(std::move(i->pProvider), std::move(i->pSoundSource));
+            s_idleSoundSources.erase(i);
+            break;
+        }
+    }
+    closeAll(&staleSoundSources);
+    if (kLogger.debugEnabled() && result.second) {
+        kLogger.debug() << "Reusing opened sound source for" << localFileName;
+    }
+    return result;
+}
+
+// static
+void SoundSourcePool::checkIn(
+        const QString& localFileName,
+        const AudioSource::OpenParams& params,
+        SoundSourceProviderPointer pProvider,
+        SoundSourcePointer pSoundSource) {
+    DEBUG_ASSERT(pProvider);
+    DEBUG_ASSERT(pSoundSource);
+    const QFileInfo fileInfo(localFileName);
+    if (!fileInfo.exists()) {
+        pSoundSource->close();
+        return;
+    }
+    std::list<IdleSoundSource> evictedSoundSources;
+    {
+        const auto locker = lockMutex(&s_mutex);
+        s_idleSoundSources.push_front(IdleSoundSource{
+                localFileName,
+                params,
+                fileInfo.size(),
+                fileInfo.lastModified(),
+                std::move(pProvider),
+                std::move(pSoundSource),
+                QElapsedTimer()});
+        s_idleSoundSources.front().idleTimer.start();
+        while (s_idleSoundSources.size() > kMaxIdleSoundSources) {
+            evictedSoundSources.splice(evictedSoundSources.end(),
+                    s_idleSoundSources,
+                    std::prev(s_idleSoundSources.end()));
+        }
+    }
+    closeAll(&evictedSoundSources);
+    scheduleReleaseExpired();
+}
+
+// static
+void SoundSourcePool::release(const QString& localFileName) {
+    std::list<IdleSoundSource> releasedSoundSources;
+    {
+        const auto locker = lockMutex(&s_mutex);
+        for (auto i = s_idleSoundSources.begin(); i != s_idleSoundSources.end();) {
+            const auto next = std::next(i);
+            if (i->localFileName == localFileName) {
+                releasedSoundSources.splice(releasedSoundSources.end(), s_idleSoundSources, i);
+            }
+            i = next;
+        }
+    }
+    closeAll(&releasedSoundSources);
+}
+
+// static
+void SoundSourcePool::releaseAll() {
+    std::list<IdleSoundSource> releasedSoundSources;
+    {
+        const auto locker = lockMutex(&s_mutex);
+        releasedSoundSources.swap(s_idleSoundSources);
+    }
+    closeAll(&releasedSoundSources);
+}
+
+// static
+void SoundSourcePool::releaseExpired() {
+    std::list<IdleSoundSource> expiredSoundSources;
+    {
+        const auto locker = lockMutex(&s_mutex);
+        s_releaseExpiredScheduled = false;
+        // The least recently returned sound sources are at the end
+        while (!s_idleSoundSources.empty() &&
+                s_idleSoundSources.back().idleTimer.hasExpired(kMaxIdleMillis)) {
+            expiredSoundSources.splice(expiredSoundSources.end(),
+                    s_idleSoundSources,
+                    std::prev(s_idleSoundSources.end()));
+        }
+    }
+    closeAll(&expiredSoundSources);
+    scheduleReleaseExpired();
+}
+
+// static
+void SoundSourcePool::scheduleReleaseExpired() {
+    QCoreApplication* pApp = QCoreApplication::instance();
+    if (!pApp) {
+        return;
+    }
+    {
+        const auto locker = lockMutex(&s_mutex);
+        if (s_releaseExpiredScheduled || s_idleSoundSources.empty()) {
+            return;
+        }
+        s_releaseExpiredScheduled = true;
+    }
+    // Sound sources are returned from threads without an event loop,
+    // so the timer is started on the main thread.
+    QMetaObject::invokeMethod(
+            pApp,
+            [] {
+                QTimer::singleShot(kMaxIdleMillis, &SoundSourcePool::releaseExpired);
+            },
+            Qt::QueuedConnection);
+}
+
+} // namespace mixxx
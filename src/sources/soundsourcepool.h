@@ -0,0 +1,92 @@
+#pragma once
+
+#include <QString>
+#include <utility>
+
+#include "sources/audiosourceproxy.h"
+#include "sources/soundsourceprovider.h"
+
+namespace mixxx {
+
+/// Keeps recently used sound sources open for reuse.
+///
+/// Deck preview, waveform overview generation, analysis and loading a
+/// track into a deck often open the same file within a few seconds. Each
+/// open probes the providers and creates new file and codec contexts.
+///
+/// Sound sources are checked out exclusively and returned into the pool
+/// when they are closed by their user. An idle sound source is closed
+/// after a few seconds, when it is evicted by a more recently returned
+/// one, or when the file has been modified in the meantime.
+///
+/// All functions are thread-safe.
+class SoundSourcePool final {
+  public:
+    SoundSourcePool() = delete;
+
+    /// Returns an idle sound source for the file that has been opened with
+    /// the same parameters together with its provider. Both pointers are
+    /// null if no such sound source is available.
+    static std::pair<SoundSourceProviderPointer, SoundSourcePointer> checkOut(
+            const QString& localFileName,
+            const AudioSource::OpenParams& params);
+
+    /// Returns an opened sound source into the pool. The least recently
+    /// returned sound source is closed if the pool is full.
+    static void checkIn(
+            const QString& localFileName,
+            const AudioSource::OpenParams& params,
+            SoundSourceProviderPointer pProvider,
+            SoundSourcePointer pSoundSource);
+
+    /// Closes all idle sound sources of the file, e.g. before writing
+    /// into the file.
+    static void release(const QString& localFileName);
+
+    /// Closes all idle sound sources.
+    static void releaseAll();
+
+  private:
+    static void releaseExpired();
+    static void scheduleReleaseExpired();
+};
+
+/// Returns the wrapped sound source into the pool when it is closed
+/// or destroyed instead of closing it.
+class PooledSoundSourceProxy final : public AudioSourceProxy {
+  public:
+    PooledSoundSourceProxy(
+            QString localFileName,
+            AudioSource::OpenParams params,
+            SoundSourceProviderPointer pProvider,
+            SoundSourcePointer pSoundSource)
+            : AudioSourceProxy(AudioSourcePointer(pSoundSource)),
+              m_localFileName(std::move(localFileName)),
+              m_params(std::move(params)),
+              m_pProvider(std::move(pProvider)),
+              m_pSoundSource(std::move(pSoundSource)) {
+    }
+    ~PooledSoundSourceProxy() override {
+        close();
+    }
+
+    void close() override {
+        if (!m_pSoundSource) {
+            return;
+        }
+        SoundSourcePool::checkIn(
+                m_localFileName,
+                m_params,
+                std::move(m_pProvider),
+                std::move(m_pSoundSource));
+        m_pSoundSource.reset();
+    }
+
+  private:
+    const QString m_localFileName;
+    const AudioSource::OpenParams m_params;
+    SoundSourceProviderPointer m_pProvider;
+    SoundSourcePointer m_pSoundSource;
+};
+
+} // namespace mixxx
@@ -11,6 +11,8 @@
 #include "sources/soundsourcemp3.h"
 #endif
 #include "sources/soundsourceoggvorbis.h"
+#include "sources/soundsourcepcm.h"
+#include "sources/soundsourcepool.h"
 #ifdef __OPUS__
 #include "sources/soundsourceopus.h"
 #endif
@@ -40,9 +42,17 @@
 #include "sources/soundsourcestem.h"
 #endif
 
+#include <QCache>
+#include <QFileInfo>
+#include <QMutex>
+#include <QSet>
+#include <tuple>
+
 #include "library/coverartutils.h"
+#include "sources/importedtracksource.h"
 #include "track/globaltrackcache.h"
 #include "track/track.h"
+#include "util/compatibility/qmutex.h"
 #include "util/logger.h"
 #include "util/regex.h"
 
@@ -56,6 +66,36 @@ namespace {
 
 const mixxx::Logger kLogger("SoundSourceProxy");
 
+// The provider that succeeded to open a file is tried first when opening
+// the same file again. This skips providers that fail for this file.
+constexpr int kMaxProviderMemoSize = 1000;
+
+QMutex s_providerMemoMutex;
+QCache<QString, mixxx::SoundSourceProviderPointer> s_providerMemo(kMaxProviderMemoSize);
+
+void memoizeProvider(
+        const QUrl& url,
+        const mixxx::SoundSourceProviderPointer& pProvider) {
+    const auto locker = lockMutex(&s_providerMemoMutex);
+    s_providerMemo.insert(url.toLocalFile(),
+            new mixxx::SoundSourceProviderPointer(pProvider));
+}
+
+mixxx::SoundSourceProviderPointer memoizedProvider(const QUrl& url) {
+    const auto locker = lockMutex(&s_providerMemoMutex);
+    const auto* pProvider = s_providerMemo.object(url.toLocalFile());
+    return pProvider ? *pProvider : nullptr;
+}
+
+// Files that are currently written by Mixxx itself, i.e. recordings
+QMutex s_growingFilesMutex;
+QSet<QString> s_growingFiles;
+
+QString growingFileKey(const QString& localFileName) {
+    // The track location is an absolute path
+    return QFileInfo(localFileName).absoluteFilePath();
+}
+
 bool registerSoundSourceProvider(
         mixxx::SoundSourceProviderRegistry* pProviderRegistry,
         const mixxx::SoundSourceProviderPointer& pProvider) {
@@ -156,6 +196,9 @@ void registerReferenceSoundSourceProviders(
     registerReferenceSoundSourceProvider(
             pProviderRegistry,
             std::make_shared<mixxx::SoundSourceProviderOggVorbis>());
+    registerReferenceSoundSourceProvider(
+            pProviderRegistry,
+            std::make_shared<mixxx::SoundSourceProviderPcm>());
 #ifdef __OPUS__
     registerReferenceSoundSourceProvider(
             pProviderRegistry,
@@ -316,6 +359,22 @@ mixxx::SoundSourceProviderPointer SoundSourceProxy::getPrimaryProviderForFileTyp
     return s_soundSourceProviders.getPrimaryProviderForFileType(fileType);
 }
 
+//static
+void SoundSourceProxy::setFileGrowing(const QString& localFileName, bool growing) {
+    const auto locker = lockMutex(&s_growingFilesMutex);
+    if (growing) {
+        s_growingFiles.insert(growingFileKey(localFileName));
+    } else {
+        s_growingFiles.remove(growingFileKey(localFileName));
+    }
+}
+
+//static
+bool SoundSourceProxy::isFileGrowing(const QString& localFileName) {
+    const auto locker = lockMutex(&s_growingFilesMutex);
+    return s_growingFiles.contains(growingFileKey(localFileName));
+}
+
 //static
 QStringList SoundSourceProxy::getFileSuffixesForFileType(
         const QString& fileType) {
@@ -372,6 +431,24 @@ SoundSourceProxy::allProviderRegistrationsForUrl(
     return providerRegistrations;
 }
 
+// static
+QList<mixxx::SoundSourceProviderRegistration>
+SoundSourceProxy::providerRegistrationsForUrl(
+        const QUrl& url) {
+    auto providerRegistrations = allProviderRegistrationsForUrl(url);
+    const auto pProvider = memoizedProvider(url);
+    if (!pProvider) {
+        return providerRegistrations;
+    }
+    for (int i = 1; i < providerRegistrations.size(); ++i) {
+        if (providerRegistrations[i].getProvider() == pProvider) {
+            providerRegistrations.move(i, 0);
+            break;
+        }
+    }
+    return providerRegistrations;
+}
+
 //static
 ExportTrackMetadataResult
 SoundSourceProxy::exportTrackMetadataBeforeSaving(
@@ -379,6 +456,9 @@ SoundSourceProxy::exportTrackMetadataBeforeSaving(
         const SyncTrackMetadataParams& syncParams) {
     DEBUG_ASSERT(pTrack);
     const auto fileInfo = pTrack->getFileInfo();
+    // Idle audio sources of this file must not keep it open
+    // while writing the metadata.
+    mixxx::SoundSourcePool::release(fileInfo.location());
     mixxx::SoundSourcePointer pSoundSource;
     {
         auto proxy = SoundSourceProxy(fileInfo.toQUrl());
@@ -427,13 +507,13 @@ SoundSourceProxy::SoundSourceProxy(
 SoundSourceProxy::SoundSourceProxy(TrackPointer pTrack)
         : m_pTrack(std::move(pTrack)),
           m_url(m_pTrack ? m_pTrack->getFileInfo().toQUrl() : QUrl()),
-          m_providerRegistrations(allProviderRegistrationsForUrl(m_url)) {
+          m_providerRegistrations(providerRegistrationsForUrl(m_url)) {
     findProviderAndInitSoundSource();
 }
 
 SoundSourceProxy::SoundSourceProxy(const QUrl& url)
         : m_url(url),
-          m_providerRegistrations(allProviderRegistrationsForUrl(m_url)) {
+          m_providerRegistrations(providerRegistrationsForUrl(m_url)) {
     findProviderAndInitSoundSource();
 }
 
@@ -621,9 +701,52 @@ inline bool shouldImportSeratoTagsFromSource(
 
 } // namespace
 
+//static
+ImportedTrackSource SoundSourceProxy::importTrackSourceFromFile(
+        mixxx::FileAccess trackFileAccess,
+        const SyncTrackMetadataParams& syncParams,
+        CoverInfoGuesser* pCoverInfoGuesser) {
+    DEBUG_ASSERT(pCoverInfoGuesser);
+    ImportedTrackSource importedTrackSource;
+    const auto trackFileInfo = trackFileAccess.info();
+    if (!trackFileInfo.checkFileExists()) {
+        return importedTrackSource;
+    }
+    QImage coverImage;
+    std::tie(importedTrackSource.importResult, importedTrackSource.sourceSynchronizedAt) =
+            SoundSourceProxy(Track::newTemporary(std::move(trackFileAccess)))
+                    .importTrackMetadataAndCoverImage(
+                            &importedTrackSource.trackMetadata,
+                            &coverImage,
+                            syncParams.resetMissingTagMetadataOnImport);
+    // Hashing the embedded cover image or searching the folder for
+    // cover art is as expensive as parsing the tags
+    importedTrackSource.coverInfo = pCoverInfoGuesser->guessCoverInfo(
+            trackFileInfo,
+            importedTrackSource.trackMetadata.getAlbumInfo().getTitle(),
+            coverImage);
+    return importedTrackSource;
+}
+
 SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromSource(
         UpdateTrackFromSourceMode mode,
         const SyncTrackMetadataParams& syncParams) {
+    return updateTrackFromSource(mode, syncParams, nullptr);
+}
+
+SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromImportedSource(
+        ImportedTrackSource&& importedTrackSource,
+        const SyncTrackMetadataParams& syncParams) {
+    return updateTrackFromSource(
+            UpdateTrackFromSourceMode::Once,
+            syncParams,
+            &importedTrackSource);
+}
+
+SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromSource(
+        UpdateTrackFromSourceMode mode,
+        const SyncTrackMetadataParams& syncParams,
+        ImportedTrackSource* pImportedTrackSource) {
     DEBUG_ASSERT(m_pTrack);
 
     if (getUrl().isEmpty()) {
@@ -693,13 +816,36 @@ SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromS
         }
     }
 
+    // The imported metadata could only replace the default values of a
+    // track object that has never been initialized from the file before.
+    // Otherwise existing values would get lost, see above.
+    if (pImportedTrackSource &&
+            (sourceSyncStatus != mixxx::TrackRecord::SourceSyncStatus::Void ||
+                    !pCoverImg ||
+                    trackMetadata != mixxx::TrackMetadata() ||
+                    pImportedTrackSource->sourceSynchronizedAt !=
+                            mixxx::MetadataSource::getFileSynchronizedAt(
+                                    QFile(m_pTrack->getFileInfo().location())))) {
+        if (kLogger.debugEnabled()) {
+            kLogger.debug()
+                    << "Discarding metadata that has been imported in advance from file"
+                    << getUrl().toString();
+        }
+        pImportedTrackSource = nullptr;
+    }
+
     // Parse the tags stored in the audio file and the date and time when the
     // file has been last modified to detect future changes of the tags.
-    auto [metadataImportResult, sourceSynchronizedAt] =
-            importTrackMetadataAndCoverImage(
-                    &trackMetadata,
-                    pCoverImg,
-                    syncParams.resetMissingTagMetadataOnImport);
+    auto [metadataImportResult, sourceSynchronizedAt] = pImportedTrackSource
+            ? std::make_pair(pImportedTrackSource->importResult,
+                      pImportedTrackSource->sourceSynchronizedAt)
+            : importTrackMetadataAndCoverImage(
+                      &trackMetadata,
+                      pCoverImg,
+                      syncParams.resetMissingTagMetadataOnImport);
+    if (pImportedTrackSource) {
+        trackMetadata = std::move(pImportedTrackSource->trackMetadata);
+    }
     VERIFY_OR_DEBUG_ASSERT(!sourceSynchronizedAt.isValid() ||
             sourceSynchronizedAt.timeSpec() == Qt::UTC) {
         qWarning() << "Converting source synchronization time to UTC:" << sourceSynchronizedAt;
@@ -847,7 +993,11 @@ SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromS
         }
     }
 
-    if (pCoverImg) {
+    if (pImportedTrackSource) {
+        DEBUG_ASSERT(pCoverImg);
+        DEBUG_ASSERT(pImportedTrackSource->coverInfo.source == CoverInfo::GUESSED);
+        m_pTrack->setCoverInfo(pImportedTrackSource->coverInfo);
+    } else if (pCoverImg) {
         // If the pointer is not null then the cover art should be guessed
         auto coverInfo =
                 CoverInfoGuesser().guessCoverInfo(
@@ -871,6 +1021,9 @@ bool SoundSourceProxy::openSoundSource(
                 m_pSoundSource->open(openMode, params);
         if (openResult == mixxx::SoundSource::OpenResult::Succeeded) {
             if (m_pSoundSource->verifyReadable()) {
+                if (m_providerRegistrationIndex >= 0) {
+                    memoizeProvider(m_url, m_pProvider);
+                }
                 return true;
             }
             kLogger.warning()
@@ -932,11 +1085,29 @@ mixxx::AudioSourcePointer SoundSourceProxy::openAudioSource(
     VERIFY_OR_DEBUG_ASSERT(m_pTrack) {
         return nullptr;
     }
-    if (!openSoundSource(params)) {
+    // Sound sources for an explicitly selected provider are not pooled
+    const bool pooled = m_providerRegistrationIndex >= 0;
+    const QString localFileName = m_url.toLocalFile();
+    auto [pPooledProvider, pPooledSoundSource] = pooled
+            ? mixxx::SoundSourcePool::checkOut(localFileName, params)
+            : std::make_pair(mixxx::SoundSourceProviderPointer(),
+                      mixxx::SoundSourcePointer());
+    if (pPooledSoundSource) {
+        m_pProvider = std::move(pPooledProvider);
+        m_pSoundSource = std::move(pPooledSoundSource);
+    } else if (!openSoundSource(params)) {
         return nullptr;
     }
-    // Overwrite metadata with actual audio properties
-    m_pTrack->updateStreamInfoFromSource(
-            m_pSoundSource->getStreamInfo());
-    return mixxx::AudioSourceTrackProxy::create(m_pTrack, m_pSoundSource);
+    // Overwrite metadata with actual audio properties unless the
+    // caller requested a different sample rate, e.g. for the analysis.
+    if (!params.getSignalInfo().getSampleRate().isValid()) {
+        m_pTrack->updateStreamInfoFromSource(
+                m_pSoundSource->getStreamInfo());
+    }
+    if (!pooled) {
+        return mixxx::AudioSourceTrackProxy::create(m_pTrack, m_pSoundSource);
+    }
+    return mixxx::AudioSourceTrackProxy::create(m_pTrack,
+            std::make_shared<mixxx::PooledSoundSourceProxy>(
+                    localFileName, params, m_pProvider, m_pSoundSource));
 }
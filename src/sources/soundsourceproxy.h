@@ -5,6 +5,9 @@
 #include "sources/soundsourceproviderregistry.h"
 #include "track/track_decl.h"
 
+class CoverInfoGuesser;
+struct ImportedTrackSource;
+
 namespace mixxx {
 
 class FileAccess;
@@ -60,6 +63,16 @@ class SoundSourceProxy {
     static mixxx::SoundSourceProviderPointer getPrimaryProviderForFileType(
             const QString& fileType);
 
+    /// Marks a file that is still being written, e.g. a recording.
+    ///
+    /// Readers of growing files periodically check if more audio
+    /// data has become available, see
+    /// mixxx::AudioSource::tryGrowFrameIndexRange().
+    ///
+    /// Both functions are thread-safe.
+    static void setFileGrowing(const QString& localFileName, bool growing);
+    static bool isFileGrowing(const QString& localFileName);
+
     explicit SoundSourceProxy(TrackPointer pTrack);
 
     // Only needed for testing all available providers explicitly
@@ -177,6 +190,29 @@ class SoundSourceProxy {
             UpdateTrackFromSourceMode mode,
             const SyncTrackMetadataParams& syncParams);
 
+    /// Import track metadata and cover art of a file that is about to be
+    /// added to the library, see ImportedTrackSource.
+    ///
+    /// This function is thread-safe and can be invoked concurrently from
+    /// multiple threads. Unlike importTrackMetadataAndCoverImageFromFile()
+    /// it does not lock GlobalTrackCache while reading. Modifications of
+    /// the file in the meantime are detected afterwards by
+    /// updateTrackFromImportedSource().
+    static ImportedTrackSource importTrackSourceFromFile(
+            mixxx::FileAccess trackFileAccess,
+            const SyncTrackMetadataParams& syncParams,
+            CoverInfoGuesser* pCoverInfoGuesser);
+
+    /// Same as updateTrackFromSource() with mode Once, but uses the
+    /// metadata and cover art that have been imported in advance by
+    /// importTrackSourceFromFile() instead of reading the file again.
+    ///
+    /// The file is only read again if the track object has already been
+    /// initialized or if the file has been modified in the meantime.
+    UpdateTrackFromSourceResult updateTrackFromImportedSource(
+            ImportedTrackSource&& importedTrackSource,
+            const SyncTrackMetadataParams& syncParams);
+
     /// Opening the audio source through the proxy will update the
     /// audio properties of the corresponding track object. Returns
     /// a null pointer on failure.
@@ -186,6 +222,10 @@ class SoundSourceProxy {
     /// last reference is dropped. One of these references is hold
     /// by SoundSourceProxy as a member.
     ///
+    /// Closing the audio source returns it into SoundSourcePool for
+    /// reuse by subsequent calls with the same parameters. It must not
+    /// be accessed after it has been closed.
+    ///
     /// Note: If opening the audio stream fails the selection
     /// process may continue among the available providers and
     /// sound sources might be resumed and continue until a
@@ -209,9 +249,19 @@ class SoundSourceProxy {
     // for writing metadata immediately before the TIO is destroyed.
     explicit SoundSourceProxy(const QUrl& url);
 
+    /// The registrations for the URL with the provider that succeeded
+    /// to open the file most recently moved to the front.
+    static QList<mixxx::SoundSourceProviderRegistration> providerRegistrationsForUrl(
+            const QUrl& url);
+
     bool openSoundSource(
             const mixxx::AudioSource::OpenParams& params = mixxx::AudioSource::OpenParams());
 
+    UpdateTrackFromSourceResult updateTrackFromSource(
+            UpdateTrackFromSourceMode mode,
+            const SyncTrackMetadataParams& syncParams,
+            ImportedTrackSource* pImportedTrackSource);
+
     const TrackPointer m_pTrack;
 
     const QUrl m_url;
@@ -1,4 +1,9 @@
 #include "sources/soundsourcestem.h"
+
+#include <QThreadPool>
+#include <condition_variable>
+#include <mutex>
+
 #include "sources/readaheadframebuffer.h"
 
 extern "C" {
@@ -28,6 +33,19 @@ constexpr int kRequiredStreamCount = kNumStreams - 1; // Stem count doesn't incl
 
 const Logger kLogger("SoundSourceSTEM");
 
+/// The stems are decoded on a dedicated pool instead of the global thread
+/// pool, which may be busy with analysis tasks. The first stem is decoded
+/// on the reading thread itself.
+QThreadPool* stemDecodingThreadPool() {
+    static QThreadPool* const pThreadPool = [] {
+        auto* pThreadPool = new QThreadPool();
+        pThreadPool->setObjectName(QStringLiteral("SoundSourceSTEM"));
+        pThreadPool->setMaxThreadCount(kRequiredStreamCount - 1);
+        return pThreadPool;
+    }();
+    return pThreadPool;
+}
+
 } // anonymous namespace
 
 const QString SoundSourceProviderSTEM::kDisplayName = QStringLiteral("STEM");
@@ -414,6 +432,18 @@ void SoundSourceSTEM::close() {
     }
 }
 
+void SoundSourceSTEM::readStemSampleFrames(
+        std::size_t stemIdx,
+        IndexRange frameIndexRange,
+        SINT stemSampleLength) {
+    m_pStereoStreams[stemIdx]->readSampleFrames(
+            WritableSampleFrames(
+                    frameIndexRange,
+                    SampleBuffer::WritableSlice(
+                            m_stemBuffers[stemIdx].data(),
+                            stemSampleLength)));
+}
+
 ReadableSampleFrames SoundSourceSTEM::readSampleFramesClamped(
         const WritableSampleFrames& globalSampleFrames) {
     if (m_pStereoStreams.size() == 1) {
@@ -432,11 +462,14 @@ ReadableSampleFrames SoundSourceSTEM::readSampleFramesClamped(
     SINT stemSampleLength = m_pStereoStreams.front()->getSignalInfo().frames2samples(
             globalSampleFrames.frameLength());
 
-    // The same buffer is reused between requests tp prevent reallocation, but
-    // it will be reallocated if a larger chunk is requested and will keep the
-    // new maximum size
-    if (stemSampleLength > m_buffer.size()) {
-        m_buffer = SampleBuffer(stemSampleLength);
+    // The same buffers are reused between requests to prevent reallocation,
+    // but they will be reallocated if a larger chunk is requested and will
+    // keep the new maximum size
+    m_stemBuffers.resize(stemCount);
+    for (auto& stemBuffer : m_stemBuffers) {
+        if (stemSampleLength > stemBuffer.size()) {
+            stemBuffer = SampleBuffer(stemSampleLength);
+        }
     }
 
     ReadableSampleFrames read(globalSampleFrames.frameIndexRange(),
@@ -444,23 +477,44 @@ ReadableSampleFrames SoundSourceSTEM::readSampleFramesClamped(
                     globalSampleFrames.writableData(),
                     globalSampleFrames.writableLength()));
     DEBUG_ASSERT(stemSampleLength * stemCount == globalSampleFrames.writableLength());
+
+    // Each stem is decoded independently by its own FFmpeg context. All
+    // but the first stem are decoded on the thread pool.
+    const auto frameIndexRange = globalSampleFrames.frameIndexRange();
+    std::mutex mutex;
+    std::condition_variable finished;
+    int pendingStemCount = stemCount - 1;
+    for (int streamIdx = 1; streamIdx < stemCount; streamIdx++) {
+        stemDecodingThreadPool()->start([&, streamIdx] {
+            readStemSampleFrames(streamIdx, frameIndexRange, stemSampleLength);
+            std::lock_guard locked(mutex);
+            if (--pendingStemCount == 0) {
+                finished.notify_one();
+            }
+        });
+    }
+    readStemSampleFrames(0, frameIndexRange, stemSampleLength);
+    {
+        std::unique_lock locked(mutex);
+        finished.wait(locked, [&pendingStemCount] {
+            return pendingStemCount == 0;
+        });
+    }
+
+    // TODO(XXX): currently, stem samples are interleaved and packed next to each other as such:
+    //    1L1R1L1R1L1R...2L2R2L2R2L2R2L2R......3L3R3L3R3L3R3L3R......4L4R4L4R4L4R4L4R....
+    //    Can FFmpeg decode as without having to use a decoder per channel?
+    //    1LLLLLLLLLLLLLL....1RRRRRRRRR...2LLLLLLL...?
+
+    // Change the sample layout to interleave all channels together. This
+    // is done after decoding to avoid concurrent writes into the same
+    // cache lines.
     CSAMPLE* pBuffer = globalSampleFrames.writableData();
     for (int streamIdx = 0; streamIdx < stemCount; streamIdx++) {
-        WritableSampleFrames currentStemFrame = WritableSampleFrames(
-                globalSampleFrames.frameIndexRange(),
-                SampleBuffer::WritableSlice(
-                        m_buffer.data(),
-                        stemSampleLength));
-        m_pStereoStreams[streamIdx]->readSampleFrames(currentStemFrame);
-        // TODO(XXX): currently, stem samples are interleaved and packed next to each other as such:
-        //    1L1R1L1R1L1R...2L2R2L2R2L2R2L2R......3L3R3L3R3L3R3L3R......4L4R4L4R4L4R4L4R....
-        //    Can FFmpeg decode as without having to use a decoder per channel?
-        //    1LLLLLLLLLLLLLL....1RRRRRRRRR...2LLLLLLL...?
-
-        // Change the sample layout to interleave all channels together
+        const SampleBuffer& stemBuffer = m_stemBuffers[streamIdx];
         for (SINT i = 0; i < stemSampleLength / 2; i++) {
-            pBuffer[2 * stemCount * i + 2 * streamIdx] = m_buffer[2 * i];
-            pBuffer[2 * stemCount * i + 2 * streamIdx + 1] = m_buffer[2 * i + 1];
+            pBuffer[2 * stemCount * i + 2 * streamIdx] = stemBuffer[2 * i];
+            pBuffer[2 * stemCount * i + 2 * streamIdx + 1] = stemBuffer[2 * i + 1];
         }
     }
 
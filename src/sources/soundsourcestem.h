@@ -24,6 +24,9 @@ class SoundSourceSingleSTEM : public SoundSourceFFmpeg {
 
 /// @brief Handle a stem file, composed of multiple audio channel. Can open in
 /// stereo or in stem (4 x stereo)
+///
+/// When opened in stem mode the stems are decoded concurrently on a small
+/// thread pool that is shared by all stem files.
 class SoundSourceSTEM : public SoundSource {
   public:
     explicit SoundSourceSTEM(const QUrl& url);
@@ -31,9 +34,15 @@ class SoundSourceSTEM : public SoundSource {
     void close() override;
 
   private:
+    void readStemSampleFrames(
+            std::size_t stemIdx,
+            IndexRange frameIndexRange,
+            SINT stemSampleLength);
+
     // Contains each stem source, or the main mix if opened in stereo mode
     std::vector<std::unique_ptr<SoundSourceSingleSTEM>> m_pStereoStreams;
-    SampleBuffer m_buffer;
+    // A separate buffer for each stem that are filled concurrently
+    std::vector<SampleBuffer> m_stemBuffers;
 
   protected:
     OpenResult tryOpen(
@@ -3,6 +3,7 @@
 #include <wavpack.h>
 
 #include "util/logger.h"
+#include "util/sample.h"
 
 namespace mixxx {
 
@@ -159,12 +160,10 @@ ReadableSampleFrames SoundSourceWV::readSampleFramesClamped(
     DEBUG_ASSERT(unpackCount <= numberOfFramesTotal);
     if (!(WavpackGetMode(static_cast<WavpackContext*>(m_wpc)) & MODE_FLOAT)) {
         // signed integer -> float
-        const SINT sampleCount = getSignalInfo().frames2samples(unpackCount);
-        for (SINT i = 0; i < sampleCount; ++i) {
-            const int32_t sampleValue =
-                    *reinterpret_cast<int32_t*>(pOutputBuffer);
-            *pOutputBuffer++ = CSAMPLE(sampleValue) * m_sampleScaleFactor;
-        }
+        SampleUtil::convertScaledS32ToFloat32InPlace(
+                pOutputBuffer,
+                getSignalInfo().frames2samples(unpackCount),
+                m_sampleScaleFactor);
     }
     const auto resultRange = IndexRange::forward(m_curFrameIndex, unpackCount);
     m_curFrameIndex += unpackCount;
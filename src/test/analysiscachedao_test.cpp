@@ -0,0 +1,72 @@
+#include "library/dao/analysiscachedao.h"
+
+#include <gtest/gtest.h>
+
+#include <QSqlQuery>
+
+#include "test/mixxxdbtest.h"
+
+namespace {
+
+class AnalysisCacheDaoTest : public MixxxDbTest {
+  protected:
+    AnalysisCacheDaoTest()
+            : MixxxDbTest(true) {
+        EXPECT_TRUE(MixxxDb::initDatabaseSchema(dbConnection()));
+        m_analysisCacheDao.initialize(dbConnection());
+    }
+
+    AnalysisCacheDao m_analysisCacheDao;
+};
+
+TEST_F(AnalysisCacheDaoTest, SaveAndFindEntry) {
+    EXPECT_FALSE(m_analysisCacheDao.findEntry(QStringLiteral("abc")));
+
+    AnalysisCacheDao::Entry entry;
+    entry.fingerprint = QStringLiteral("abc");
+    entry.trackId = TrackId(QVariant(42));
+    entry.beatsVersion = QStringLiteral("BeatGrid-2.0");
+    entry.beats = QByteArray("beats");
+    entry.replayGainRatio = 0.5;
+    entry.firstSoundFrame = 100.0;
+    entry.lastSoundFrame = 1000.0;
+    ASSERT_TRUE(m_analysisCacheDao.saveEntry(entry));
+
+    auto found = m_analysisCacheDao.findEntry(QStringLiteral("abc"));
+    ASSERT_TRUE(found);
+    EXPECT_EQ(entry.trackId, found->trackId);
+    EXPECT_EQ(entry.beatsVersion, found->beatsVersion);
+    EXPECT_EQ(entry.beats, found->beats);
+    EXPECT_TRUE(found->keysVersion.isEmpty());
+    EXPECT_EQ(0.5, found->replayGainRatio);
+    EXPECT_EQ(-1.0, found->replayGainPeak);
+    EXPECT_EQ(100.0, found->firstSoundFrame);
+    EXPECT_EQ(1000.0, found->lastSoundFrame);
+
+    // Entries with the same fingerprint are replaced
+    entry.trackId = TrackId(QVariant(43));
+    ASSERT_TRUE(m_analysisCacheDao.saveEntry(entry));
+    found = m_analysisCacheDao.findEntry(QStringLiteral("abc"));
+    ASSERT_TRUE(found);
+    EXPECT_EQ(entry.trackId, found->trackId);
+}
+
+TEST_F(AnalysisCacheDaoTest, DeleteOrphanedEntries) {
+    QSqlQuery query(dbConnection());
+    ASSERT_TRUE(query.exec(QStringLiteral("INSERT INTO library (id) VALUES (1)")));
+
+    AnalysisCacheDao::Entry entry;
+    entry.fingerprint = QStringLiteral("abc");
+    entry.trackId = TrackId(QVariant(1));
+    ASSERT_TRUE(m_analysisCacheDao.saveEntry(entry));
+    // The track has been purged from the library
+    entry.fingerprint = QStringLiteral("def");
+    entry.trackId = TrackId(QVariant(2));
+    ASSERT_TRUE(m_analysisCacheDao.saveEntry(entry));
+
+    EXPECT_EQ(1, m_analysisCacheDao.deleteOrphanedEntries());
+    EXPECT_TRUE(m_analysisCacheDao.findEntry(QStringLiteral("abc")));
+    EXPECT_FALSE(m_analysisCacheDao.findEntry(QStringLiteral("def")));
+}
+
+} // namespace
@@ -0,0 +1,123 @@
+#include "analyzer/analysisexecutor.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+namespace {
+
+using Priority = AnalysisExecutor::Priority;
+
+constexpr std::chrono::milliseconds kNoWait(0);
+constexpr std::chrono::milliseconds kLongWait(10000);
+
+class AnalysisExecutorTest : public testing::Test {
+  protected:
+    // Waits until the other thread has started to wait for a slot
+    static void awaitYield(const AnalysisExecutor& executor, Priority priority) {
+        while (!executor.shouldYield(priority)) {
+            std::this_thread::yield();
+        }
+    }
+};
+
+TEST_F(AnalysisExecutorTest, EngineLoadLimitsLowerPriorities) {
+    double engineLoad = 0.5;
+    AnalysisExecutor executor(4, [&engineLoad] {
+        return engineLoad;
+    });
+    EXPECT_EQ(4, executor.concurrencyLimit(Priority::Deck));
+    EXPECT_EQ(2, executor.concurrencyLimit(Priority::Prepared));
+    EXPECT_EQ(2, executor.concurrencyLimit(Priority::Batch));
+
+    // At least one analysis is always allowed
+    engineLoad = 1.5;
+    EXPECT_EQ(1, executor.concurrencyLimit(Priority::Batch));
+    EXPECT_EQ(4, executor.concurrencyLimit(Priority::Deck));
+
+    engineLoad = 0.0;
+    EXPECT_EQ(4, executor.concurrencyLimit(Priority::Batch));
+}
+
+TEST_F(AnalysisExecutorTest, PeakEngineLoadPausesLowerPriorities) {
+    double engineLoadPeak = 0.9;
+    AnalysisExecutor executor(
+            4,
+            [] {
+                return 0.2;
+            },
+            [&engineLoadPeak] {
+                return engineLoadPeak;
+            });
+    EXPECT_EQ(0, executor.concurrencyLimit(Priority::Batch));
+    EXPECT_EQ(0, executor.concurrencyLimit(Priority::Prepared));
+    EXPECT_EQ(4, executor.concurrencyLimit(Priority::Deck));
+    EXPECT_FALSE(executor.tryAcquire(Priority::Batch, kNoWait));
+    EXPECT_TRUE(executor.tryAcquire(Priority::Deck, kNoWait));
+
+    engineLoadPeak = 0.5;
+    EXPECT_EQ(3, executor.concurrencyLimit(Priority::Batch));
+    ASSERT_TRUE(executor.tryAcquire(Priority::Batch, kNoWait));
+
+    // A running analysis yields when the load peaks again
+    EXPECT_FALSE(executor.shouldYield(Priority::Batch));
+    engineLoadPeak = 0.9;
+    EXPECT_TRUE(executor.shouldYield(Priority::Batch));
+    EXPECT_FALSE(executor.shouldYield(Priority::Deck));
+}
+
+TEST_F(AnalysisExecutorTest, LimitIsEnforced) {
+    AnalysisExecutor executor(2);
+    EXPECT_TRUE(executor.tryAcquire(Priority::Batch, kNoWait));
+    EXPECT_TRUE(executor.tryAcquire(Priority::Batch, kNoWait));
+    EXPECT_FALSE(executor.tryAcquire(Priority::Batch, kNoWait));
+    EXPECT_FALSE(executor.shouldYield(Priority::Batch));
+
+    executor.release(Priority::Batch);
+    EXPECT_TRUE(executor.tryAcquire(Priority::Batch, kNoWait));
+}
+
+TEST_F(AnalysisExecutorTest, YieldsToHigherPriority) {
+    AnalysisExecutor executor(1);
+    ASSERT_TRUE(executor.tryAcquire(Priority::Batch, kNoWait));
+
+    std::atomic<bool> deckAcquired = false;
+    std::thread deckThread([&] {
+        deckAcquired = executor.tryAcquire(Priority::Deck, kLongWait);
+    });
+
+    // The batch analysis is asked to yield at the next chunk boundary
+    awaitYield(executor, Priority::Batch);
+    EXPECT_FALSE(deckAcquired.load());
+    executor.release(Priority::Batch);
+    deckThread.join();
+    EXPECT_TRUE(deckAcquired.load());
+
+    // The batch analysis has to wait until the deck analysis is done
+    EXPECT_FALSE(executor.tryAcquire(Priority::Batch, kNoWait));
+    EXPECT_FALSE(executor.shouldYield(Priority::Deck));
+    executor.release(Priority::Deck);
+    EXPECT_TRUE(executor.tryAcquire(Priority::Batch, kNoWait));
+}
+
+TEST_F(AnalysisExecutorTest, WaitingHigherPriorityBlocksLowerPriorities) {
+    AnalysisExecutor executor(2);
+    ASSERT_TRUE(executor.tryAcquire(Priority::Deck, kNoWait));
+    ASSERT_TRUE(executor.tryAcquire(Priority::Deck, kNoWait));
+
+    std::atomic<bool> preparedAcquired = false;
+    std::thread preparedThread([&] {
+        preparedAcquired = executor.tryAcquire(Priority::Prepared, kLongWait);
+    });
+    awaitYield(executor, Priority::Batch);
+
+    // A free slot is granted to the waiting analysis with the
+    // higher priority
+    executor.release(Priority::Deck);
+    preparedThread.join();
+    EXPECT_TRUE(preparedAcquired.load());
+    EXPECT_FALSE(executor.tryAcquire(Priority::Batch, kNoWait));
+}
+
+} // namespace
@@ -0,0 +1,187 @@
+#include "analyzer/analyzerpipeline.h"
+
+#include <gtest/gtest.h>
+
+#include <QSemaphore>
+#include <QThreadPool>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "analyzer/constants.h"
+#include "test/mixxxtest.h"
+#include "track/track.h"
+
+namespace {
+
+constexpr int kChunks = 100;
+
+// Expects that the first sample of each chunk contains the chunk index
+class SequenceAnalyzer : public Analyzer {
+  public:
+    SequenceAnalyzer(std::atomic<int>* pProcessedChunks, int failAfterChunks = -1)
+            : m_pProcessedChunks(pProcessedChunks),
+              m_failAfterChunks(failAfterChunks),
+              m_nextChunk(0) {
+    }
+
+    bool initialize(const AnalyzerTrack& track,
+            mixxx::audio::SampleRate sampleRate,
+            SINT frameLength) override {
+        Q_UNUSED(track);
+        Q_UNUSED(sampleRate);
+        Q_UNUSED(frameLength);
+        return true;
+    }
+
+    bool processSamples(const CSAMPLE* pIn, SINT count) override {
+        EXPECT_EQ(mixxx::kAnalysisSamplesPerChunk, count);
+        EXPECT_EQ(static_cast<CSAMPLE>(m_nextChunk), pIn[0]);
+        ++m_nextChunk;
+        m_pProcessedChunks->fetch_add(1);
+        return m_failAfterChunks < 0 || m_nextChunk < m_failAfterChunks;
+    }
+
+    void storeResults(TrackPointer pTrack) override {
+        Q_UNUSED(pTrack);
+    }
+
+    void cleanup() override {
+    }
+
+  private:
+    std::atomic<int>* const m_pProcessedChunks;
+    const int m_failAfterChunks;
+    int m_nextChunk;
+};
+
+// Blocks after the first chunk until the latch is released
+class BlockingAnalyzer : public SequenceAnalyzer {
+  public:
+    BlockingAnalyzer(std::atomic<int>* pProcessedChunks,
+            QSemaphore* pBlocked,
+            QSemaphore* pLatch)
+            : SequenceAnalyzer(pProcessedChunks),
+              m_pBlocked(pBlocked),
+              m_pLatch(pLatch),
+              m_firstChunk(true) {
+    }
+
+    bool processSamples(const CSAMPLE* pIn, SINT count) override {
+        const bool result = SequenceAnalyzer::processSamples(pIn, count);
+        if (m_firstChunk) {
+            m_firstChunk = false;
+            m_pBlocked->release();
+            m_pLatch->acquire();
+        }
+        return result;
+    }
+
+  private:
+    QSemaphore* const m_pBlocked;
+    QSemaphore* const m_pLatch;
+    bool m_firstChunk;
+};
+
+class AnalyzerPipelineTest : public MixxxTest {
+  protected:
+    AnalyzerPipelineTest()
+            : m_pTrack(Track::newTemporary()) {
+        m_threadPool.setMaxThreadCount(2);
+    }
+
+    void addAnalyzer(std::atomic<int>* pProcessedChunks, int failAfterChunks = -1) {
+        addAnalyzer(std::make_unique<SequenceAnalyzer>(
+                pProcessedChunks, failAfterChunks));
+    }
+
+    void addAnalyzer(std::unique_ptr<Analyzer> pAnalyzer) {
+        m_analyzers.emplace_back(std::move(pAnalyzer));
+        m_analyzers.back().initialize(AnalyzerTrack(m_pTrack),
+                mixxx::audio::SampleRate(44100),
+                kChunks * mixxx::kAnalysisFramesPerChunk);
+    }
+
+    void publishChunks(AnalyzerPipeline* pPipeline, int chunks = kChunks) {
+        for (int i = 0; i < chunks; ++i) {
+            auto chunk = pPipeline->nextChunk();
+            ASSERT_EQ(mixxx::kAnalysisSamplesPerChunk, chunk.length());
+            std::fill(chunk.data(),
+                    chunk.data() + chunk.length(),
+                    static_cast<CSAMPLE>(i));
+            pPipeline->publishChunk(chunk.data(), chunk.length());
+        }
+    }
+
+    void TearDown() override {
+        for (auto& analyzer : m_analyzers) {
+            analyzer.cancel();
+        }
+    }
+
+    const TrackPointer m_pTrack;
+    QThreadPool m_threadPool;
+    std::vector<AnalyzerWithState> m_analyzers;
+};
+
+TEST_F(AnalyzerPipelineTest, AllAnalyzersProcessAllChunksInOrder) {
+    std::atomic<int> processedChunks[3] = {0, 0, 0};
+    for (auto& counter : processedChunks) {
+        addAnalyzer(&counter);
+    }
+
+    AnalyzerPipeline pipeline(&m_analyzers, &m_threadPool);
+    publishChunks(&pipeline);
+    pipeline.wait();
+
+    for (const auto& counter : processedChunks) {
+        EXPECT_EQ(kChunks, counter.load());
+    }
+}
+
+TEST_F(AnalyzerPipelineTest, FailedAnalyzerStopsProcessing) {
+    std::atomic<int> processedChunks = 0;
+    std::atomic<int> failingProcessedChunks = 0;
+    addAnalyzer(&processedChunks);
+    addAnalyzer(&failingProcessedChunks, 10);
+
+    AnalyzerPipeline pipeline(&m_analyzers, &m_threadPool);
+    publishChunks(&pipeline);
+    pipeline.wait();
+
+    EXPECT_EQ(kChunks, processedChunks.load());
+    EXPECT_EQ(10, failingProcessedChunks.load());
+    EXPECT_TRUE(m_analyzers[0].isActive());
+    EXPECT_FALSE(m_analyzers[1].isActive());
+}
+
+TEST_F(AnalyzerPipelineTest, CancelSkipsPendingChunks) {
+    // Less than the capacity of the ring. Otherwise publishing would
+    // block until the blocked analyzer continues.
+    constexpr int kPublishedChunks = 4;
+    std::atomic<int> processedChunks = 0;
+    QSemaphore blocked;
+    QSemaphore latch;
+    addAnalyzer(std::make_unique<BlockingAnalyzer>(
+            &processedChunks, &blocked, &latch));
+
+    AnalyzerPipeline pipeline(&m_analyzers, &m_threadPool);
+    publishChunks(&pipeline, kPublishedChunks);
+    blocked.acquire();
+
+    // cancel() blocks until the running task has finished
+    std::thread cancelThread([&pipeline] {
+        pipeline.cancel();
+    });
+    // Give cancel() some time to take effect before the analyzer continues
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    latch.release();
+    cancelThread.join();
+    pipeline.wait();
+
+    // The pending chunks have been skipped after the chunk that was
+    // processed while cancelling
+    EXPECT_EQ(1, processedChunks.load());
+}
+
+} // namespace
@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "analyzer/analyzerbeats.h"
+#include "analyzer/analyzerkey.h"
+#include "analyzer/analyzertrack.h"
+#include "analyzer/constants.h"
+#include "analyzer/provisionalresults.h"
+#include "preferences/keydetectionsettings.h"
+#include "proto/keys.pb.h"
+#include "test/mixxxtest.h"
+#include "track/keyfactory.h"
+#include "track/track.h"
+#include "util/math.h"
+
+namespace {
+
+constexpr mixxx::audio::SampleRate kSampleRate(44100);
+constexpr double kBpm = 120.0;
+constexpr int kClickFrames = 200;
+// A major triad
+constexpr double kChordPitchesHz[] = {440.0, 554.37, 659.26};
+
+// Long enough for the first provisional keys after one minute
+constexpr double kTrackSeconds = 70;
+constexpr SINT kTrackLengthFrames = static_cast<SINT>(kTrackSeconds * 44100);
+
+class AnalyzerProvisionalResultsTest : public MixxxTest {
+  protected:
+    // A sustained chord with short clicks on every beat
+    void SetUp() override {
+        const SINT framesPerBeat = static_cast<SINT>(kSampleRate.toDouble() * 60 / kBpm);
+        m_trackSamples.resize(kTrackLengthFrames * mixxx::kAnalysisChannels);
+        for (SINT frame = 0; frame < kTrackLengthFrames; ++frame) {
+            double value = 0;
+            for (const double pitchHz : kChordPitchesHz) {
+                value += 0.2 * sin(2.0 * M_PI * pitchHz * frame / kSampleRate.toDouble());
+            }
+            if (frame % framesPerBeat < kClickFrames) {
+                value += (frame % 2 == 0) ? 0.3 : -0.3;
+            }
+            for (int channel = 0; channel < mixxx::kAnalysisChannels; ++channel) {
+                m_trackSamples[frame * mixxx::kAnalysisChannels + channel] =
+                        static_cast<CSAMPLE>(value);
+            }
+        }
+
+        m_pTrack = Track::newTemporary();
+        m_pTrack->setAudioProperties(
+                mixxx::audio::ChannelCount(mixxx::kAnalysisChannels),
+                kSampleRate,
+                mixxx::audio::Bitrate(),
+                mixxx::Duration::fromSeconds(kTrackSeconds));
+    }
+
+    AnalyzerTrack provisionalTrack() const {
+        AnalyzerTrack::Options options;
+        options.provisionalResults = true;
+        return AnalyzerTrack(m_pTrack, options);
+    }
+
+    // Processes the frames in chunks like the analyzer threads
+    void process(Analyzer* pAnalyzer, double startSeconds, double endSeconds) const {
+        const SINT startFrame = static_cast<SINT>(startSeconds * kSampleRate.toDouble());
+        const SINT endFrame = math_min(kTrackLengthFrames,
+                static_cast<SINT>(endSeconds * kSampleRate.toDouble()));
+        for (SINT frame = startFrame; frame < endFrame;
+                frame += mixxx::kAnalysisFramesPerChunk) {
+            const SINT frames = math_min(mixxx::kAnalysisFramesPerChunk, endFrame - frame);
+            ASSERT_TRUE(pAnalyzer->processSamples(
+                    &m_trackSamples[frame * mixxx::kAnalysisChannels],
+                    frames * mixxx::kAnalysisChannels));
+        }
+    }
+
+    std::vector<CSAMPLE> m_trackSamples;
+    TrackPointer m_pTrack;
+};
+
+TEST_F(AnalyzerProvisionalResultsTest, ProvisionalBeatsAreReplaced) {
+    AnalyzerBeats analyzer(config());
+    ASSERT_TRUE(analyzer.initialize(provisionalTrack(), kSampleRate, kTrackLengthFrames));
+
+    process(&analyzer, 0, 35);
+    const mixxx::BeatsPointer pProvisionalBeats = m_pTrack->getBeats();
+    ASSERT_TRUE(pProvisionalBeats);
+    EXPECT_TRUE(mixxx::provisionalresults::isProvisional(
+            pProvisionalBeats->getSubVersion()));
+
+    process(&analyzer, 35, kTrackSeconds);
+    analyzer.storeResults(m_pTrack);
+    analyzer.cleanup();
+
+    const mixxx::BeatsPointer pBeats = m_pTrack->getBeats();
+    ASSERT_TRUE(pBeats);
+    EXPECT_NE(pProvisionalBeats, pBeats);
+    EXPECT_FALSE(mixxx::provisionalresults::isProvisional(pBeats->getSubVersion()));
+}
+
+TEST_F(AnalyzerProvisionalResultsTest, EditedBeatsAreNotOverwritten) {
+    AnalyzerBeats analyzer(config());
+    ASSERT_TRUE(analyzer.initialize(provisionalTrack(), kSampleRate, kTrackLengthFrames));
+
+    process(&analyzer, 0, 35);
+    ASSERT_TRUE(m_pTrack->getBeats());
+
+    // The user adjusts the provisional beatgrid while the analysis continues
+    const mixxx::BeatsPointer pEditedBeats = mixxx::Beats::fromConstTempo(
+            kSampleRate, mixxx::audio::kStartFramePos, mixxx::Bpm(100));
+    ASSERT_TRUE(m_pTrack->trySetBeats(pEditedBeats));
+
+    // Passes the next provisional beats after one minute
+    process(&analyzer, 35, kTrackSeconds);
+    EXPECT_EQ(pEditedBeats, m_pTrack->getBeats());
+
+    analyzer.storeResults(m_pTrack);
+    analyzer.cleanup();
+    EXPECT_EQ(pEditedBeats, m_pTrack->getBeats());
+}
+
+TEST_F(AnalyzerProvisionalResultsTest, ProvisionalKeysAreReplaced) {
+    AnalyzerKey analyzer(KeyDetectionSettings(config()));
+    ASSERT_TRUE(analyzer.initialize(provisionalTrack(), kSampleRate, kTrackLengthFrames));
+
+    process(&analyzer, 0, 65);
+    const Keys provisionalKeys = m_pTrack->getKeys();
+    ASSERT_NE(mixxx::track::io::key::INVALID, provisionalKeys.getGlobalKey());
+    EXPECT_TRUE(mixxx::provisionalresults::isProvisional(
+            provisionalKeys.getSubVersion()));
+
+    process(&analyzer, 65, kTrackSeconds);
+    analyzer.storeResults(m_pTrack);
+    analyzer.cleanup();
+
+    const Keys keys = m_pTrack->getKeys();
+    EXPECT_NE(mixxx::track::io::key::INVALID, keys.getGlobalKey());
+    EXPECT_FALSE(mixxx::provisionalresults::isProvisional(keys.getSubVersion()));
+}
+
+TEST_F(AnalyzerProvisionalResultsTest, EditedKeysAreNotOverwritten) {
+    AnalyzerKey analyzer(KeyDetectionSettings(config()));
+    ASSERT_TRUE(analyzer.initialize(provisionalTrack(), kSampleRate, kTrackLengthFrames));
+
+    process(&analyzer, 0, 65);
+    ASSERT_NE(mixxx::track::io::key::INVALID, m_pTrack->getKeys().getGlobalKey());
+
+    // The user sets the key while the analysis continues
+    const Keys editedKeys = KeyFactory::makeBasicKeys(
+            mixxx::track::io::key::C_MINOR,
+            mixxx::track::io::key::USER);
+    m_pTrack->setKeys(editedKeys);
+
+    process(&analyzer, 65, kTrackSeconds);
+    analyzer.storeResults(m_pTrack);
+    analyzer.cleanup();
+
+    EXPECT_TRUE(editedKeys == m_pTrack->getKeys());
+}
+
+} // namespace
@@ -0,0 +1,67 @@
+#include "analyzer/plugins/analyzerqueenmarybeats.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "analyzer/constants.h"
+
+namespace {
+
+constexpr mixxx::audio::SampleRate kSampleRate(44100);
+constexpr double kBpm = 120.0;
+constexpr int kClickFrames = 200;
+
+class AnalyzerQueenMaryBeatsTest : public testing::Test {
+  protected:
+    // Short clicks on every beat
+    static std::vector<CSAMPLE> makeClickTrack(double seconds) {
+        const SINT frameLength = static_cast<SINT>(seconds * kSampleRate.toDouble());
+        const SINT framesPerBeat = static_cast<SINT>(kSampleRate.toDouble() * 60 / kBpm);
+        std::vector<CSAMPLE> samples(frameLength * mixxx::kAnalysisChannels, 0);
+        for (SINT frame = 0; frame < frameLength; frame += framesPerBeat) {
+            for (SINT i = 0; i < kClickFrames && frame + i < frameLength; ++i) {
+                const CSAMPLE value = (i % 2 == 0) ? 0.9f : -0.9f;
+                samples[(frame + i) * mixxx::kAnalysisChannels] = value;
+                samples[(frame + i) * mixxx::kAnalysisChannels + 1] = value;
+            }
+        }
+        return samples;
+    }
+
+    void process(const std::vector<CSAMPLE>& samples) {
+        for (std::size_t i = 0; i < samples.size(); i += mixxx::kAnalysisSamplesPerChunk) {
+            const SINT count = static_cast<SINT>(std::min(
+                    samples.size() - i,
+                    static_cast<std::size_t>(mixxx::kAnalysisSamplesPerChunk)));
+            ASSERT_TRUE(m_analyzer.processSamples(&samples[i], count));
+        }
+    }
+
+    static double averageBeatLength(const QVector<mixxx::audio::FramePos>& beats) {
+        return (beats.last() - beats.first()) / (beats.size() - 1);
+    }
+
+    mixxx::AnalyzerQueenMaryBeats m_analyzer;
+};
+
+TEST_F(AnalyzerQueenMaryBeatsTest, ProvisionalBeats) {
+    ASSERT_TRUE(m_analyzer.initialize(kSampleRate));
+    EXPECT_TRUE(m_analyzer.calculateProvisionalBeats().isEmpty());
+
+    process(makeClickTrack(30));
+
+    const auto provisionalBeats = m_analyzer.calculateProvisionalBeats();
+    ASSERT_GT(provisionalBeats.size(), 2);
+    const double framesPerBeat = kSampleRate.toDouble() * 60 / kBpm;
+    EXPECT_NEAR(framesPerBeat, averageBeatLength(provisionalBeats), framesPerBeat * 0.01);
+
+    // The analysis continues after calculating provisional beats
+    process(makeClickTrack(30));
+    ASSERT_TRUE(m_analyzer.finalize());
+    const auto beats = m_analyzer.getBeats();
+    EXPECT_GT(beats.size(), provisionalBeats.size());
+}
+
+} // namespace
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "analyzer/analyzerebur128.h"
+#include "analyzer/analyzergain.h"
+#include "analyzer/analyzertrack.h"
+#include "analyzer/constants.h"
+#include "preferences/replaygainsettings.h"
+#include "test/mixxxtest.h"
+#include "track/track.h"
+#include "util/math.h"
+
+namespace {
+
+constexpr mixxx::audio::SampleRate kSampleRate(44100);
+constexpr SINT kTrackLengthFrames = 20 * 44100;
+constexpr double kTonePitchHz = 1000.0; // 1kHz
+
+// The merged results deviate slightly at the boundaries of the segments
+constexpr double kMaxDeviationDb = 0.1;
+
+class AnalyzerReplayGainTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        // A tone whose level changes at positions that are not aligned
+        // with the segments
+        const double omega = 2.0 * M_PI * kTonePitchHz / kSampleRate;
+        const double amplitudes[] = {0.1, 0.5, 0.25, 0.8, 0.4};
+        const SINT framesPerLevel = kTrackLengthFrames / 5;
+        m_trackSamples.resize(kTrackLengthFrames * mixxx::kAnalysisChannels);
+        for (SINT frame = 0; frame < kTrackLengthFrames; ++frame) {
+            const auto sample = static_cast<CSAMPLE>(
+                    amplitudes[math_min<SINT>(frame / framesPerLevel, 4)] *
+                    sin(frame * omega));
+            for (int channel = 0; channel < mixxx::kAnalysisChannels; ++channel) {
+                m_trackSamples[frame * mixxx::kAnalysisChannels + channel] = sample;
+            }
+        }
+    }
+
+    TrackPointer newTrack() const {
+        TrackPointer pTrack = Track::newTemporary();
+        pTrack->setAudioProperties(
+                mixxx::audio::ChannelCount(mixxx::kAnalysisChannels),
+                kSampleRate,
+                mixxx::audio::Bitrate(),
+                mixxx::Duration::fromSeconds(
+                        static_cast<double>(kTrackLengthFrames) / kSampleRate));
+        return pTrack;
+    }
+
+    void enableAnalyzer(int version) {
+        ReplayGainSettings rgSettings(config());
+        rgSettings.setReplayGainAnalyzerEnabled(true);
+        rgSettings.setReplayGainAnalyzerVersion(version);
+    }
+
+    // Processes the frames in chunks like the analyzer threads
+    template<typename T>
+    bool processFrames(T* pTarget, SINT startFrame, SINT endFrame) const {
+        for (SINT frame = startFrame; frame < endFrame;
+                frame += mixxx::kAnalysisFramesPerChunk) {
+            const SINT frames = math_min(mixxx::kAnalysisFramesPerChunk, endFrame - frame);
+            if (!pTarget->processSamples(
+                        &m_trackSamples[frame * mixxx::kAnalysisChannels],
+                        frames * mixxx::kAnalysisChannels)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    double analyzeWholeTrack(Analyzer* pAnalyzer) const {
+        TrackPointer pTrack = newTrack();
+        EXPECT_TRUE(pAnalyzer->initialize(
+                AnalyzerTrack(pTrack), kSampleRate, kTrackLengthFrames));
+        EXPECT_TRUE(processFrames(pAnalyzer, 0, kTrackLengthFrames));
+        pAnalyzer->storeResults(pTrack);
+        pAnalyzer->cleanup();
+        EXPECT_TRUE(pTrack->getReplayGain().hasRatio());
+        return ratio2db(pTrack->getReplayGain().getRatio());
+    }
+
+    // The segments are processed in reverse order to verify that the
+    // results don't depend on the order
+    double analyzeSegments(Analyzer* pAnalyzer) const {
+        TrackPointer pTrack = newTrack();
+        EXPECT_TRUE(pAnalyzer->initialize(
+                AnalyzerTrack(pTrack), kSampleRate, kTrackLengthFrames));
+        const std::vector<SINT> startFrames = {
+                0, 3 * 44100, 9 * 44100, 14 * 44100};
+        AnalyzerSegments segments;
+        for (const auto startFrame : startFrames) {
+            segments.push_back(pAnalyzer->createSegment(startFrame));
+            EXPECT_TRUE(segments.back());
+        }
+        for (int i = static_cast<int>(startFrames.size()) - 1; i >= 0; --i) {
+            const SINT endFrame = i + 1 < static_cast<int>(startFrames.size())
+                    ? startFrames[i + 1]
+                    : kTrackLengthFrames;
+            EXPECT_TRUE(processFrames(segments[i].get(), startFrames[i], endFrame));
+        }
+        EXPECT_TRUE(pAnalyzer->mergeSegments(std::move(segments)));
+        pAnalyzer->storeResults(pTrack);
+        pAnalyzer->cleanup();
+        EXPECT_TRUE(pTrack->getReplayGain().hasRatio());
+        return ratio2db(pTrack->getReplayGain().getRatio());
+    }
+
+    std::vector<CSAMPLE> m_trackSamples;
+};
+
+TEST_F(AnalyzerReplayGainTest, GainMergedSegmentsMatchWholeTrack) {
+    enableAnalyzer(1);
+    AnalyzerGain analyzer(config());
+
+    const double wholeTrackDb = analyzeWholeTrack(&analyzer);
+    const double segmentsDb = analyzeSegments(&analyzer);
+
+    EXPECT_NEAR(wholeTrackDb, segmentsDb, kMaxDeviationDb);
+}
+
+TEST_F(AnalyzerReplayGainTest, Ebur128MergedSegmentsMatchWholeTrack) {
+    enableAnalyzer(2);
+    AnalyzerEbur128 analyzer(config());
+
+    const double wholeTrackDb = analyzeWholeTrack(&analyzer);
+    const double segmentsDb = analyzeSegments(&analyzer);
+
+    EXPECT_NEAR(wholeTrackDb, segmentsDb, kMaxDeviationDb);
+}
+
+} // namespace
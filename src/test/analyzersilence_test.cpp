@@ -53,6 +53,12 @@ class AnalyzerSilenceTest : public MixxxTest {
     SINT nTrackSampleDataLength; // in samples
 };
 
+TEST_F(AnalyzerSilenceTest, RequiresFullSampleRate) {
+    // The first sound is verified at the sample-accurate position when
+    // loading the track, see CachingReaderWorker::verifyFirstSound()
+    EXPECT_FALSE(analyzerSilence.supportsReducedSampleRate());
+}
+
 TEST_F(AnalyzerSilenceTest, SilenceTrack) {
     // Fill the entire buffer with silence
     for (SINT i = 0; i < nTrackSampleDataLength; i++) {
@@ -168,6 +174,55 @@ TEST_F(AnalyzerSilenceTest, ToneTrackWithSilenceInTheMiddle) {
     EXPECT_DOUBLE_EQ(4 * oneFifthOfTrackLength, pOutroCue->getLengthFrames() * kChannelCount);
 }
 
+TEST_F(AnalyzerSilenceTest, MergedSegmentsMatchWholeTrack) {
+    // Silence, tone, silence, tone, silence
+    double omega = 2.0 * M_PI * kTonePitchHz / pTrack->getSampleRate();
+    const int oneFifthOfTrackLength = nTrackSampleDataLength / 5;
+    for (int i = 0; i < nTrackSampleDataLength; i++) {
+        const int fifth = i / oneFifthOfTrackLength;
+        pTrackSampleData[i] = (fifth % 2 == 1)
+                ? static_cast<CSAMPLE>(cos(i / kChannelCount * omega))
+                : 0.0f;
+    }
+
+    analyzeTrack();
+
+    TrackPointer pSegmentedTrack = Track::newTemporary();
+    pSegmentedTrack->setAudioProperties(
+            mixxx::audio::ChannelCount(kChannelCount),
+            mixxx::audio::SampleRate(44100),
+            mixxx::audio::Bitrate(),
+            mixxx::Duration::fromSeconds(kTrackLengthFrames / 44100.0));
+    ASSERT_TRUE(analyzerSilence.initialize(AnalyzerTrack(pSegmentedTrack),
+            pSegmentedTrack->getSampleRate(),
+            kTrackLengthFrames));
+    // The segments are processed in reverse order and split the tone
+    // and the silence in the middle
+    const std::vector<SINT> startFrames = {0, 30000, 50000, 90000};
+    AnalyzerSegments segments;
+    for (const auto startFrame : startFrames) {
+        segments.push_back(analyzerSilence.createSegment(startFrame));
+        ASSERT_TRUE(segments.back());
+    }
+    for (int i = static_cast<int>(startFrames.size()) - 1; i >= 0; --i) {
+        const SINT endFrame = i + 1 < static_cast<int>(startFrames.size())
+                ? startFrames[i + 1]
+                : kTrackLengthFrames;
+        ASSERT_TRUE(segments[i]->processSamples(
+                &pTrackSampleData[startFrames[i] * kChannelCount],
+                (endFrame - startFrames[i]) * kChannelCount));
+    }
+    ASSERT_TRUE(analyzerSilence.mergeSegments(std::move(segments)));
+    analyzerSilence.storeResults(pSegmentedTrack);
+    analyzerSilence.cleanup();
+
+    EXPECT_EQ(pTrack->getMainCuePosition(), pSegmentedTrack->getMainCuePosition());
+    EXPECT_EQ(pTrack->findCueByType(mixxx::CueType::Intro)->getPosition(),
+            pSegmentedTrack->findCueByType(mixxx::CueType::Intro)->getPosition());
+    EXPECT_EQ(pTrack->findCueByType(mixxx::CueType::Outro)->getEndPosition(),
+            pSegmentedTrack->findCueByType(mixxx::CueType::Outro)->getEndPosition());
+}
+
 TEST_F(AnalyzerSilenceTest, RespectUserEdits) {
     // Arbitrary values
     const auto kManualCuePosition = mixxx::audio::FramePos::fromEngineSamplePos(
@@ -0,0 +1,86 @@
+#include "analyzer/analyzerthread.h"
+
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QTest>
+
+#include "library/dao/analysisdao.h"
+#include "library/trackcollection.h"
+#include "sources/soundsourceproxy.h"
+#include "test/librarytest.h"
+#include "track/track.h"
+
+namespace {
+
+const QString kTrackLocation = QStringLiteral("id3-test-data/cover-test.mp3");
+
+class AnalyzerThreadTest : public LibraryTest {
+  protected:
+    AnalyzerThreadTest()
+            : m_pThread(AnalyzerThread::createInstance(
+                      0,
+                      dbConnectionPooler(),
+                      config(),
+                      AnalyzerModeFlags::All)),
+              m_state(AnalyzerThreadState::Void) {
+        QObject::connect(m_pThread.get(),
+                &AnalyzerThread::progress,
+                &m_context,
+                [this](int /*threadId*/,
+                        AnalyzerThreadState threadState,
+                        TrackId /*trackId*/,
+                        AnalyzerProgress /*trackProgress*/) {
+                    m_state = threadState;
+                });
+        m_pThread->start();
+    }
+
+    ~AnalyzerThreadTest() override {
+        m_pThread->stop();
+        m_pThread->wait();
+        m_pThread.reset();
+        // The thread is deleted after it has finished
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+        SoundSourceProxy::setFileGrowing(getTestDir().filePath(kTrackLocation), false);
+    }
+
+    void analyzeTrack(const TrackPointer& pTrack) {
+        ASSERT_TRUE(QTest::qWaitFor([this] {
+            return m_state == AnalyzerThreadState::Idle;
+        }));
+        m_state = AnalyzerThreadState::Void;
+        ASSERT_TRUE(m_pThread->submitNextTrack(AnalyzerTrack(pTrack)));
+        ASSERT_TRUE(QTest::qWaitFor(
+                [this] {
+                    return m_state == AnalyzerThreadState::Done;
+                },
+                30000));
+    }
+
+    QObject m_context;
+    AnalyzerThread::Pointer m_pThread;
+    AnalyzerThreadState m_state;
+};
+
+TEST_F(AnalyzerThreadTest, GrowingFileIsNotAnalyzed) {
+    const QString location = getTestDir().filePath(kTrackLocation);
+    const TrackPointer pTrack = getOrAddTrackByLocation(location);
+    ASSERT_TRUE(pTrack);
+
+    // A recording that is still written
+    SoundSourceProxy::setFileGrowing(location, true);
+    analyzeTrack(pTrack);
+    EXPECT_FALSE(pTrack->getBeats());
+    EXPECT_TRUE(internalCollection()->getAnalysisDAO().getAnalysesForTrack(
+            pTrack->getId()).isEmpty());
+
+    // The recording has been finished
+    SoundSourceProxy::setFileGrowing(location, false);
+    analyzeTrack(pTrack);
+    EXPECT_TRUE(pTrack->getBeats());
+    EXPECT_FALSE(internalCollection()->getAnalysisDAO().getAnalysesForTrack(
+            pTrack->getId()).isEmpty());
+}
+
+} // namespace
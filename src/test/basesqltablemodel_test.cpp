@@ -0,0 +1,179 @@
+#include "library/basesqltablemodel.h"
+
+#include <gtest/gtest.h>
+
+#include <QList>
+#include <QSemaphore>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTest>
+
+#include "library/dao/trackschema.h"
+#include "library/sqltableloader.h"
+#include "test/librarytest.h"
+
+namespace {
+
+const QString kTableName = QStringLiteral("basesqltablemodel_test");
+
+/// A table model without a track source
+class TestTableModel : public BaseSqlTableModel {
+  public:
+    explicit TestTableModel(TrackCollectionManager* pTrackCollectionManager)
+            : BaseSqlTableModel(nullptr, pTrackCollectionManager, "mixxx.db.model.test") {
+        QSqlQuery query(m_database);
+        EXPECT_TRUE(query.exec(QStringLiteral(
+                "CREATE TEMPORARY VIEW IF NOT EXISTS %1 AS "
+                "SELECT id, title FROM library")
+                                       .arg(kTableName)));
+        setTable(kTableName,
+                LIBRARYTABLE_ID,
+                QStringList{LIBRARYTABLE_ID, LIBRARYTABLE_TITLE},
+                QSharedPointer<BaseTrackCache>());
+    }
+
+    bool isColumnInternal(int /*column*/) override {
+        return false;
+    }
+};
+
+} // namespace
+
+/// Populates a table model with SqlTableLoader, which is disabled
+/// in test mode.
+class BaseSqlTableModelTest : public LibraryTest {
+  protected:
+    BaseSqlTableModelTest()
+            : m_sqlTableLoader(dbConnectionPooler()),
+              m_model(trackCollectionManager()),
+              m_removedRowCount(0),
+              m_dataChangedCount(0),
+              m_selectFinishedCount(0) {
+        m_sqlTableLoader.start();
+        BaseSqlTableModel* pModel = &m_model;
+        pModel->m_pSqlTableLoader = &m_sqlTableLoader;
+
+        QObject::connect(&m_model,
+                &QAbstractItemModel::rowsInserted,
+                [this](const QModelIndex& /*parent*/, int first, int last) {
+                    m_insertedRowCounts.append(last - first + 1);
+                });
+        QObject::connect(&m_model,
+                &QAbstractItemModel::rowsRemoved,
+                [this](const QModelIndex& /*parent*/, int first, int last) {
+                    m_removedRowCount += last - first + 1;
+                });
+        QObject::connect(&m_model,
+                &QAbstractItemModel::dataChanged,
+                [this] {
+                    ++m_dataChangedCount;
+                });
+        QObject::connect(&m_model,
+                &BaseSqlTableModel::selectFinished,
+                [this] {
+                    ++m_selectFinishedCount;
+                });
+    }
+
+    void execute(const QString& statement) {
+        QSqlQuery query(dbConnection());
+        EXPECT_TRUE(query.exec(statement)) << query.lastError().text().toStdString();
+    }
+
+    void insertTracks(int count) {
+        for (int i = 0; i < count; ++i) {
+            execute(QStringLiteral("INSERT INTO library (title) VALUES ('Track %1')")
+                            .arg(i));
+        }
+    }
+
+    /// Blocks until the loader has finished all pending requests without
+    /// receiving their results
+    void waitForLoader() {
+        QSemaphore semaphore;
+        QMetaObject::invokeMethod(
+                &m_sqlTableLoader,
+                [&semaphore] {
+                    semaphore.release();
+                },
+                Qt::QueuedConnection);
+        semaphore.acquire();
+    }
+
+    void waitForSelect() {
+        EXPECT_TRUE(QTest::qWaitFor([this] {
+            return !m_model.isSelectPending();
+        }));
+    }
+
+    void resetSignalCounts() {
+        m_insertedRowCounts.clear();
+        m_removedRowCount = 0;
+        m_dataChangedCount = 0;
+        m_selectFinishedCount = 0;
+    }
+
+    SqlTableLoader m_sqlTableLoader;
+    TestTableModel m_model;
+
+    QList<int> m_insertedRowCounts;
+    int m_removedRowCount;
+    int m_dataChangedCount;
+    int m_selectFinishedCount;
+};
+
+namespace {
+
+TEST_F(BaseSqlTableModelTest, PendingRowsAreDisplayed) {
+    insertTracks(250);
+    m_model.selectAsync();
+    EXPECT_TRUE(m_model.isSelectPending());
+    EXPECT_EQ(0, m_model.rowCount());
+
+    waitForSelect();
+    EXPECT_EQ(250, m_model.rowCount());
+    EXPECT_EQ(1, m_selectFinishedCount);
+    // The first page has been displayed before all rows were loaded
+    ASSERT_LE(2, m_insertedRowCounts.size());
+    EXPECT_GT(250, m_insertedRowCounts.first());
+    // The final rows match the displayed rows and are only updated
+    EXPECT_EQ(0, m_removedRowCount);
+    EXPECT_EQ(1, m_dataChangedCount);
+}
+
+TEST_F(BaseSqlTableModelTest, StaleResultsAreDiscarded) {
+    insertTracks(10);
+    m_model.selectAsync();
+    // The rows of the first request have been loaded, but not received
+    waitForLoader();
+
+    execute(QStringLiteral("DELETE FROM library WHERE id > 5"));
+    m_model.selectAsync();
+    waitForSelect();
+    EXPECT_EQ(5, m_model.rowCount());
+    EXPECT_EQ(1, m_selectFinishedCount);
+    // Only the rows of the second request have been inserted
+    EXPECT_EQ(QList<int>{5}, m_insertedRowCounts);
+    EXPECT_EQ(0, m_removedRowCount);
+}
+
+TEST_F(BaseSqlTableModelTest, UnchangedRowsAreUpdatedInPlace) {
+    insertTracks(10);
+    m_model.select();
+    ASSERT_EQ(10, m_model.rowCount());
+    resetSignalCounts();
+
+    // Rows that need to be filtered by the track source are not displayed
+    // until all rows have been loaded. The model has no track source,
+    // i.e. the rows remain unchanged.
+    m_model.setSearch(QStringLiteral("Track"));
+    m_model.selectAsync();
+    waitForSelect();
+    EXPECT_EQ(10, m_model.rowCount());
+    EXPECT_EQ(1, m_selectFinishedCount);
+    EXPECT_TRUE(m_insertedRowCounts.isEmpty());
+    EXPECT_EQ(0, m_removedRowCount);
+    EXPECT_EQ(1, m_dataChangedCount);
+}
+
+} // namespace
@@ -0,0 +1,282 @@
+#include "engine/cachingreader/cachingreader.h"
+
+#include <gtest/gtest.h>
+
+#include <QList>
+#include <memory>
+
+#include "engine/cachingreader/cachingreaderchunk.h"
+#include "engine/engineworkerscheduler.h"
+#include "sources/mp3decoding.h"
+#include "sources/soundsource.h"
+#include "test/mixxxtest.h"
+#include "util/sample.h"
+
+namespace {
+
+const QString kGroup = QStringLiteral("[test]");
+
+constexpr SINT kChunkCount = 100;
+constexpr SINT kFramesPerCallback = 1024;
+
+// The reader keeps 2 chunks ahead of the play position in cache,
+// see ReadAheadManager::hintReader()
+constexpr SINT kHintFrames = 2 * CachingReaderChunk::kFrames;
+
+// Decoding preroll after each seek, i.e. the worst case for MP3
+constexpr SINT kSeekPrerollFrames = mixxx::kMp3SeekFramePrefetchCount * 1152;
+
+/// Simulates the decoding costs of a compressed format. Every read that
+/// does not continue the previous read needs to seek and decode the
+/// preroll frames in advance.
+class CompressedAudioSource : public mixxx::SoundSource {
+  public:
+    CompressedAudioSource()
+            : SoundSource(QUrl::fromLocalFile(QStringLiteral("reverse.mp3"))),
+              m_nextFrameIndex(0),
+              m_decodedFrames(0) {
+    }
+
+    void close() override {
+    }
+
+    SINT decodedFrames() const {
+        return m_decodedFrames;
+    }
+
+  protected:
+    mixxx::ReadableSampleFrames readSampleFramesClamped(
+            const mixxx::WritableSampleFrames& sampleFrames) override {
+        const auto frameIndexRange = sampleFrames.frameIndexRange();
+        if (frameIndexRange.start() != m_nextFrameIndex) {
+            m_decodedFrames += math_min(kSeekPrerollFrames, frameIndexRange.start());
+        }
+        m_decodedFrames += frameIndexRange.length();
+        m_nextFrameIndex = frameIndexRange.end();
+        const SINT sampleCount = getSignalInfo().frames2samples(frameIndexRange.length());
+        SampleUtil::clear(sampleFrames.writableData(), sampleCount);
+        return mixxx::ReadableSampleFrames(
+                frameIndexRange,
+                mixxx::SampleBuffer::ReadableSlice(
+                        sampleFrames.writableData(), sampleCount));
+    }
+
+  private:
+    OpenResult tryOpen(
+            OpenMode /*mode*/,
+            const OpenParams& /*params*/) override {
+        if (!initChannelCountOnce(mixxx::audio::ChannelCount::stereo()) ||
+                !initSampleRateOnce(mixxx::audio::SampleRate(44100))) {
+            return OpenResult::Failed;
+        }
+        initFrameIndexRangeOnce(mixxx::IndexRange::forward(
+                0, kChunkCount * CachingReaderChunk::kFrames));
+        return OpenResult::Succeeded;
+    }
+
+    SINT m_nextFrameIndex;
+    SINT m_decodedFrames;
+};
+
+} // namespace
+
+/// Drives CachingReader::hintAndMaybeWake() like the engine. The
+/// requested chunks are read from the audio source by the test instead
+/// of the worker thread.
+class CachingReaderTest : public MixxxTest {
+  protected:
+    CachingReaderTest()
+            : m_pAudioSource(std::make_shared<CompressedAudioSource>()),
+              m_growthCheckCount(0),
+              m_tempBuffer(CachingReaderChunk::kSamples) {
+    }
+
+    void SetUp() override {
+        ASSERT_EQ(mixxx::AudioSource::OpenResult::Succeeded,
+                m_pAudioSource->open(mixxx::AudioSource::OpenMode::Strict));
+        m_pReader = std::make_unique<CachingReader>(kGroup, config());
+        // The test takes the role of the worker thread
+        m_pReader->m_worker.quitWait();
+        m_pReader->setScheduler(&m_scheduler);
+        // Pretend that the worker has loaded the track
+        m_pReader->m_readableFrameIndexRange = m_pAudioSource->frameIndexRange();
+        m_pReader->m_state.storeRelease(CachingReader::STATE_TRACK_LOADED);
+    }
+
+    void TearDown() override {
+        m_pReader.reset();
+    }
+
+    /// Hints the play position like ReadAheadManager::hintReader() and
+    /// returns the indices of the requested chunks in the order of the
+    /// requests.
+    QList<SINT> hintPosition(SINT position, bool reverse) {
+        Hint hint;
+        hint.frame = reverse ? position - kHintFrames : position;
+        hint.frameCount = kHintFrames;
+        hint.type = Hint::Type::CurrentPosition;
+        HintVector hints;
+        hints.append(hint);
+        m_pReader->hintAndMaybeWake(hints);
+        return readRequestedChunks();
+    }
+
+    /// Returns all chunks to the free list
+    void clearCache() {
+        m_pReader->freeAllChunks();
+    }
+
+    /// Responds to a growth check like the worker
+    void reportGrowth(const ReaderStatusUpdate& update) {
+        m_pReader->m_readerStatusUpdateFIFO.writeBlocking(&update, 1);
+        m_pReader->process();
+    }
+
+    void expireGrowthCheckInterval() {
+        m_pReader->m_growthCheckTimer = PerformanceTimer();
+    }
+
+    mixxx::IndexRange growingFrameIndexRange() const {
+        return m_pReader->growingFrameIndexRange();
+    }
+
+    SINT decodedFrames() const {
+        return m_pAudioSource->decodedFrames();
+    }
+
+    std::shared_ptr<CompressedAudioSource> m_pAudioSource;
+    int m_growthCheckCount;
+
+  private:
+    QList<SINT> readRequestedChunks() {
+        QList<SINT> chunkIndices;
+        CachingReaderChunkReadRequest request;
+        while (m_pReader->m_chunkReadRequestFIFO.read(&request, 1) == 1) {
+            if (!request.chunk) {
+                ++m_growthCheckCount;
+                continue;
+            }
+            chunkIndices.append(request.chunk->getIndex());
+            EXPECT_EQ(request.chunk->frameIndexRange(m_pAudioSource),
+                    request.chunk->bufferSampleFrames(m_pAudioSource,
+                            mixxx::SampleBuffer::WritableSlice(m_tempBuffer)));
+            ReaderStatusUpdate update;
+            update.init(CHUNK_READ_SUCCESS,
+                    request.chunk,
+                    m_pAudioSource->frameIndexRange());
+            m_pReader->m_readerStatusUpdateFIFO.writeBlocking(&update, 1);
+        }
+        m_pReader->process();
+        return chunkIndices;
+    }
+
+    // Destroyed after the reader that has registered its worker
+    EngineWorkerScheduler m_scheduler;
+    std::unique_ptr<CachingReader> m_pReader;
+    mixxx::SampleBuffer m_tempBuffer;
+};
+
+namespace {
+
+TEST(CachingReaderChunkTest, reverseReadWindow) {
+    constexpr SINT kWindow = CachingReaderChunk::kReverseReadWindowChunks;
+    EXPECT_EQ(mixxx::IndexRange::between(kWindow, 2 * kWindow),
+            CachingReaderChunk::reverseReadWindow(2 * kWindow - 1, 0));
+    EXPECT_EQ(mixxx::IndexRange::between(kWindow, kWindow + 1),
+            CachingReaderChunk::reverseReadWindow(kWindow, 0));
+    EXPECT_EQ(mixxx::IndexRange::between(kWindow + 1, 2 * kWindow),
+            CachingReaderChunk::reverseReadWindow(2 * kWindow - 1, kWindow + 1));
+}
+
+TEST_F(CachingReaderTest, PlayingBackwardsRequestsCurrentChunkFirst) {
+    SINT position = 50 * CachingReaderChunk::kFrames + 5000;
+    for (int i = 0; i < 8; ++i) {
+        hintPosition(position, true);
+        position -= kFramesPerCallback;
+    }
+
+    clearCache();
+    const QList<SINT> chunkIndices = hintPosition(position, true);
+
+    // The chunk under the position followed by the preceding chunks of
+    // the window in ascending order
+    const SINT currentChunkIndex = CachingReaderChunk::indexForFrame(position - 1);
+    const auto window = CachingReaderChunk::reverseReadWindow(
+            CachingReaderChunk::indexForFrame(position - kHintFrames), 0);
+    QList<SINT> expectedChunkIndices = {currentChunkIndex};
+    for (SINT chunkIndex = window.start(); chunkIndex < currentChunkIndex; ++chunkIndex) {
+        expectedChunkIndices.append(chunkIndex);
+    }
+    EXPECT_EQ(expectedChunkIndices, chunkIndices);
+}
+
+TEST_F(CachingReaderTest, BackwardJumpsDoNotRequestPrecedingChunks) {
+    SINT position = 60 * CachingReaderChunk::kFrames;
+    for (int i = 0; i < 8; ++i) {
+        hintPosition(position, false);
+        position += kFramesPerCallback;
+    }
+
+    // Seeking backwards and playing a short loop only requests the chunks
+    // of the hinted ranges
+    position = 20 * CachingReaderChunk::kFrames + 3000;
+    for (int i = 0; i < 8; ++i) {
+        const SINT loopPosition = position + (i % 2) * kFramesPerCallback;
+        const QList<SINT> chunkIndices = hintPosition(loopPosition, false);
+        for (const auto chunkIndex : chunkIndices) {
+            EXPECT_LE(CachingReaderChunk::indexForFrame(loopPosition), chunkIndex);
+        }
+    }
+}
+
+TEST_F(CachingReaderTest, PlayingBackwardsDecodesPrerollOncePerWindow) {
+    SINT position = m_pAudioSource->frameIndexMax();
+    while (position > 0) {
+        hintPosition(position, true);
+        position -= kFramesPerCallback;
+    }
+
+    // At most a single seek with preroll is needed for each window, a
+    // second one for the chunk under the position after starting or
+    // jumping
+    const double decodedFramesPerOutputFrame =
+            static_cast<double>(decodedFrames()) / m_pAudioSource->frameLength();
+    EXPECT_LE(decodedFramesPerOutputFrame,
+            1.0 + 2.0 * kSeekPrerollFrames /
+                            (CachingReaderChunk::kReverseReadWindowChunks *
+                                    CachingReaderChunk::kFrames));
+}
+
+TEST_F(CachingReaderTest, GrowthChecksAreRateLimited) {
+    const auto frameIndexRange = m_pAudioSource->frameIndexRange();
+    reportGrowth(ReaderStatusUpdate::trackGrown(frameIndexRange));
+    EXPECT_EQ(frameIndexRange, growingFrameIndexRange());
+
+    hintPosition(0, false);
+    EXPECT_EQ(1, m_growthCheckCount);
+    reportGrowth(ReaderStatusUpdate::trackGrown(frameIndexRange));
+
+    // The next check is only requested after the interval has expired
+    hintPosition(kFramesPerCallback, false);
+    EXPECT_EQ(1, m_growthCheckCount);
+    expireGrowthCheckInterval();
+    hintPosition(2 * kFramesPerCallback, false);
+    EXPECT_EQ(2, m_growthCheckCount);
+}
+
+TEST_F(CachingReaderTest, GrowthChecksStopWhenFileIsFinished) {
+    const auto frameIndexRange = m_pAudioSource->frameIndexRange();
+    reportGrowth(ReaderStatusUpdate::trackGrown(frameIndexRange));
+    hintPosition(0, false);
+    EXPECT_EQ(1, m_growthCheckCount);
+
+    // The final range is kept after the file has been finished
+    reportGrowth(ReaderStatusUpdate::trackStoppedGrowing(frameIndexRange));
+    EXPECT_EQ(frameIndexRange, growingFrameIndexRange());
+
+    expireGrowthCheckInterval();
+    hintPosition(kFramesPerCallback, false);
+    EXPECT_EQ(1, m_growthCheckCount);
+}
+
+} // namespace
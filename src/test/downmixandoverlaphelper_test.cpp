@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "analyzer/plugins/buffering_utils.h"
+#include "util/sample.h"
+
+namespace {
+
+constexpr size_t kWindowSize = 8;
+constexpr size_t kStepSize = 4;
+
+class DownmixAndOverlapHelperTest : public testing::Test {
+  protected:
+    static std::vector<CSAMPLE> stereoSamples(size_t frames) {
+        std::vector<CSAMPLE> samples(frames * 2);
+        for (size_t i = 0; i < samples.size(); ++i) {
+            samples[i] = static_cast<CSAMPLE>(i % 7) * 0.1f - 0.3f;
+        }
+        return samples;
+    }
+
+    static std::vector<std::vector<double>> process(
+            const std::vector<CSAMPLE>& samples, bool downmixed) {
+        std::vector<std::vector<double>> windows;
+        mixxx::DownmixAndOverlapHelper helper;
+        EXPECT_TRUE(helper.initialize(
+                kWindowSize, kStepSize, [&windows](double* pWindow, size_t frames) {
+                    windows.emplace_back(pWindow, pWindow + frames);
+                    return true;
+                }));
+        if (downmixed) {
+            std::vector<CSAMPLE> monoSamples(samples.size() / 2);
+            SampleUtil::mixMultichannelToMono(
+                    monoSamples.data(), samples.data(), samples.size());
+            EXPECT_TRUE(helper.processMonoSamples(
+                    monoSamples.data(), monoSamples.size()));
+        } else {
+            EXPECT_TRUE(helper.processStereoSamples(samples.data(), samples.size()));
+        }
+        EXPECT_TRUE(helper.finalize());
+        return windows;
+    }
+};
+
+TEST_F(DownmixAndOverlapHelperTest, SharedDownmixProducesSameWindows) {
+    const auto samples = stereoSamples(37);
+    const auto windows = process(samples, false);
+    ASSERT_FALSE(windows.empty());
+    EXPECT_EQ(windows, process(samples, true));
+}
+
+} // namespace
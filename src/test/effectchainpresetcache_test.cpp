@@ -0,0 +1,125 @@
+#include "effects/presets/effectchainpresetcache.h"
+
+#include <gtest/gtest.h>
+
+#include <QDomDocument>
+#include <QFile>
+#include <QFileInfo>
+
+#include "effects/presets/effectchainpreset.h"
+#include "effects/presets/effectpreset.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+const QByteArray kChainPresetXml = QByteArrayLiteral(
+        "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+        "<EffectChain>\n"
+        " <Name>Test Chain</Name>\n"
+        " <MixMode>DRY+WET</MixMode>\n"
+        " <SuperParameterValue>0.25</SuperParameterValue>\n"
+        " <Effects>\n"
+        "  <Effect>\n"
+        "   <MetaParameterValue>0.5</MetaParameterValue>\n"
+        "   <Id>org.mixxx.effects.echo</Id>\n"
+        "   <BackendType>Built-In</BackendType>\n"
+        "   <Parameters>\n"
+        "    <Parameter>\n"
+        "     <Id>send_amount</Id>\n"
+        "     <Value>0.75</Value>\n"
+        "     <LinkType>LINKED</LinkType>\n"
+        "     <LinkInversion>1</LinkInversion>\n"
+        "     <Hidden>1</Hidden>\n"
+        "    </Parameter>\n"
+        "   </Parameters>\n"
+        "  </Effect>\n"
+        "  <Effect/>\n"
+        " </Effects>\n"
+        "</EffectChain>\n");
+
+class EffectChainPresetCacheTest : public MixxxTest {
+  protected:
+    QString cacheFilePath() const {
+        return getTestDataDir().filePath(QStringLiteral("chains.cache"));
+    }
+
+    QString writePresetFile(const QByteArray& content) const {
+        const QString filePath = getTestDataDir().filePath(QStringLiteral("Test Chain.xml"));
+        QFile file(filePath);
+        EXPECT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        file.write(content);
+        file.close();
+        return filePath;
+    }
+
+    static EffectChainPresetPointer parsePreset(const QByteArray& content) {
+        QDomDocument doc;
+        EXPECT_TRUE(doc.setContent(content));
+        return EffectChainPresetPointer::create(doc.documentElement());
+    }
+};
+
+TEST_F(EffectChainPresetCacheTest, RestorePresetAfterSave) {
+    const QString presetFilePath = writePresetFile(kChainPresetXml);
+    const auto pParsedPreset = parsePreset(kChainPresetXml);
+    {
+        EffectChainPresetCache cache(cacheFilePath());
+        EXPECT_TRUE(cache.getPreset(QFileInfo(presetFilePath)).isNull());
+        cache.insertPreset(QFileInfo(presetFilePath), pParsedPreset);
+        cache.save();
+    }
+
+    EffectChainPresetCache cache(cacheFilePath());
+    const auto pCachedPreset = cache.getPreset(QFileInfo(presetFilePath));
+    ASSERT_FALSE(pCachedPreset.isNull());
+    EXPECT_QSTRING_EQ(pParsedPreset->name(), pCachedPreset->name());
+    EXPECT_EQ(pParsedPreset->mixMode(), pCachedPreset->mixMode());
+    EXPECT_DOUBLE_EQ(pParsedPreset->superKnob(), pCachedPreset->superKnob());
+    ASSERT_EQ(pParsedPreset->effectPresets().size(), pCachedPreset->effectPresets().size());
+    for (int i = 0; i < pParsedPreset->effectPresets().size(); ++i) {
+        const auto& parsedEffect = *pParsedPreset->effectPresets().at(i);
+        const auto& cachedEffect = *pCachedPreset->effectPresets().at(i);
+        EXPECT_QSTRING_EQ(parsedEffect.id(), cachedEffect.id());
+        EXPECT_EQ(parsedEffect.backendType(), cachedEffect.backendType());
+        EXPECT_DOUBLE_EQ(parsedEffect.metaParameter(), cachedEffect.metaParameter());
+        ASSERT_EQ(parsedEffect.getParameterPresets().size(),
+                cachedEffect.getParameterPresets().size());
+        for (int j = 0; j < parsedEffect.getParameterPresets().size(); ++j) {
+            const auto& parsedParameter = parsedEffect.getParameterPresets().at(j);
+            const auto& cachedParameter = cachedEffect.getParameterPresets().at(j);
+            EXPECT_QSTRING_EQ(parsedParameter.id(), cachedParameter.id());
+            EXPECT_DOUBLE_EQ(parsedParameter.value(), cachedParameter.value());
+            EXPECT_EQ(parsedParameter.linkType(), cachedParameter.linkType());
+            EXPECT_EQ(parsedParameter.linkInverted(), cachedParameter.linkInverted());
+            EXPECT_EQ(parsedParameter.hidden(), cachedParameter.hidden());
+        }
+    }
+}
+
+TEST_F(EffectChainPresetCacheTest, IgnoreModifiedFile) {
+    const QString presetFilePath = writePresetFile(kChainPresetXml);
+    {
+        EffectChainPresetCache cache(cacheFilePath());
+        cache.insertPreset(QFileInfo(presetFilePath), parsePreset(kChainPresetXml));
+        cache.save();
+    }
+
+    // The XML file is the source of truth
+    writePresetFile(kChainPresetXml + QByteArrayLiteral("\n"));
+
+    EffectChainPresetCache cache(cacheFilePath());
+    EXPECT_TRUE(cache.getPreset(QFileInfo(presetFilePath)).isNull());
+}
+
+TEST_F(EffectChainPresetCacheTest, IgnoreCorruptCache) {
+    const QString presetFilePath = writePresetFile(kChainPresetXml);
+    QFile cacheFile(cacheFilePath());
+    ASSERT_TRUE(cacheFile.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    cacheFile.write(QByteArrayLiteral("garbage"));
+    cacheFile.close();
+
+    EffectChainPresetCache cache(cacheFilePath());
+    EXPECT_TRUE(cache.getPreset(QFileInfo(presetFilePath)).isNull());
+}
+
+} // namespace
@@ -0,0 +1,143 @@
+#include "library/dao/fulltextsearchdao.h"
+
+#include <gtest/gtest.h>
+
+#include <QSet>
+#include <QSqlError>
+#include <QSqlQuery>
+
+#include "library/queryutil.h"
+#include "library/searchquery.h"
+#include "test/librarytest.h"
+
+namespace {
+
+class FullTextSearchDaoTest : public LibraryTest {
+  protected:
+    FullTextSearchDaoTest() {
+        m_fullTextSearchDao.initialize(dbConnection());
+    }
+
+    void SetUp() override {
+        if (!m_fullTextSearchDao.isAvailable()) {
+            GTEST_SKIP() << "FTS5 or the trigram tokenizer are not supported by SQLite";
+        }
+    }
+
+    int insertTrack(const QString& location, const QString& artist, const QString& title) {
+        QSqlQuery query(dbConnection());
+        query.prepare(QStringLiteral(
+                "INSERT INTO track_locations (location) VALUES (:location)"));
+        query.bindValue(QStringLiteral(":location"), location);
+        EXPECT_TRUE(query.exec()) << query.lastError().text().toStdString();
+        const QVariant locationId = query.lastInsertId();
+        query.prepare(QStringLiteral(
+                "INSERT INTO library (location, artist, title) "
+                "VALUES (:location, :artist, :title)"));
+        query.bindValue(QStringLiteral(":location"), locationId);
+        query.bindValue(QStringLiteral(":artist"), artist);
+        query.bindValue(QStringLiteral(":title"), title);
+        EXPECT_TRUE(query.exec()) << query.lastError().text().toStdString();
+        return query.lastInsertId().toInt();
+    }
+
+    void execute(const QString& statement) {
+        QSqlQuery query(dbConnection());
+        EXPECT_TRUE(query.exec(statement)) << query.lastError().text().toStdString();
+    }
+
+    QSet<int> selectTrackIds(const QueryNode& node) {
+        QSqlQuery query(dbConnection());
+        EXPECT_TRUE(query.exec(QStringLiteral("SELECT id FROM library WHERE ") +
+                node.toSql()))
+                << query.lastError().text().toStdString();
+        QSet<int> trackIds;
+        while (query.next()) {
+            trackIds.insert(query.value(0).toInt());
+        }
+        return trackIds;
+    }
+
+    /// Checks that the full-text index returns the same tracks as LIKE
+    void expectSameTrackIds(const QString& argument, const QSet<int>& expectedTrackIds) {
+        const QStringList columns = {QStringLiteral("artist"), QStringLiteral("title")};
+        const TextFilterNode likeNode(
+                dbConnection(), columns, argument, StringMatch::Contains, false);
+        const TextFilterNode ftsNode(
+                dbConnection(), columns, argument, StringMatch::Contains, true);
+        EXPECT_FALSE(likeNode.toSql().contains(QStringLiteral("MATCH")));
+        EXPECT_TRUE(ftsNode.toSql().contains(QStringLiteral("MATCH")));
+        EXPECT_EQ(expectedTrackIds, selectTrackIds(likeNode));
+        EXPECT_EQ(expectedTrackIds, selectTrackIds(ftsNode));
+
+        // A negated query must not match NULL values
+        const NotNode notLikeNode(std::make_unique<TextFilterNode>(
+                dbConnection(), columns, argument, StringMatch::Contains, false));
+        const NotNode notFtsNode(std::make_unique<TextFilterNode>(
+                dbConnection(), columns, argument, StringMatch::Contains, true));
+        EXPECT_EQ(selectTrackIds(notLikeNode), selectTrackIds(notFtsNode));
+    }
+
+    FullTextSearchDao m_fullTextSearchDao;
+};
+
+TEST_F(FullTextSearchDaoTest, MatchLikeTheLikeOperator) {
+    const int trackA = insertTrack(
+            QStringLiteral("/music/a.mp3"), QStringLiteral("Beyoncé"), QStringLiteral("Halo"));
+    const int trackB = insertTrack(
+            QStringLiteral("/music/b.mp3"), QStringLiteral("Other"), QStringLiteral("Beyond"));
+    const int trackC = insertTrack(
+            QStringLiteral("/music/c.mp3"), QString(), QStringLiteral("Untitled \"1\""));
+    EXPECT_EQ(3, m_fullTextSearchDao.updateDirtyTracks(100));
+    EXPECT_EQ(0, m_fullTextSearchDao.updateDirtyTracks(100));
+
+    expectSameTrackIds(QStringLiteral("beyonce"), {trackA});
+    expectSameTrackIds(QStringLiteral("BEYO"), {trackA, trackB});
+    expectSameTrackIds(QStringLiteral("yon"), {trackA, trackB});
+    expectSameTrackIds(QStringLiteral("titled \"1"), {trackC});
+    expectSameTrackIds(QStringLiteral("it's"), {});
+
+    // Too short for the trigram tokenizer
+    EXPECT_FALSE(TextFilterNode(dbConnection(),
+            {QStringLiteral("title")},
+            QStringLiteral("ha"),
+            StringMatch::Contains,
+            true)
+                         .toSql()
+                         .contains(QStringLiteral("MATCH")));
+}
+
+TEST_F(FullTextSearchDaoTest, UpdateDirtyTracks) {
+    const int trackA = insertTrack(
+            QStringLiteral("/music/a.mp3"), QStringLiteral("Artist"), QStringLiteral("Before"));
+    const int trackB = insertTrack(
+            QStringLiteral("/music/b.mp3"), QStringLiteral("Artist"), QStringLiteral("Other"));
+    // Tracks are indexed in batches
+    EXPECT_EQ(1, m_fullTextSearchDao.updateDirtyTracks(1));
+    EXPECT_EQ(1, m_fullTextSearchDao.updateDirtyTracks(1));
+    EXPECT_EQ(0, m_fullTextSearchDao.updateDirtyTracks(1));
+    expectSameTrackIds(QStringLiteral("before"), {trackA});
+
+    execute(QStringLiteral("UPDATE library SET title='After' WHERE id=%1").arg(trackA));
+    EXPECT_EQ(1, m_fullTextSearchDao.updateDirtyTracks(100));
+    expectSameTrackIds(QStringLiteral("before"), {});
+    expectSameTrackIds(QStringLiteral("after"), {trackA});
+
+    execute(QStringLiteral("DELETE FROM library WHERE id=%1").arg(trackA));
+    EXPECT_EQ(1, m_fullTextSearchDao.updateDirtyTracks(100));
+    expectSameTrackIds(QStringLiteral("artist"), {trackB});
+
+    // Relocated files
+    execute(QStringLiteral(
+            "UPDATE track_locations SET location='/other/b.mp3' "
+            "WHERE location='/music/b.mp3'"));
+    EXPECT_EQ(1, m_fullTextSearchDao.updateDirtyTracks(100));
+    QSqlQuery query(dbConnection());
+    ASSERT_TRUE(query.exec(QStringLiteral(
+            "SELECT rowid FROM library_fts WHERE library_fts MATCH "
+            "'location : \"other/b\"'")));
+    ASSERT_TRUE(query.next());
+    EXPECT_EQ(trackB, query.value(0).toInt());
+}
+
+} // namespace
@@ -0,0 +1,38 @@
+#include "util/loadhistogram.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+TEST(LoadHistogramTest, Empty) {
+    mixxx::LoadHistogram histogram;
+    EXPECT_EQ(0, histogram.count());
+    EXPECT_EQ(0.0, histogram.percentile(0.99));
+}
+
+TEST(LoadHistogramTest, Percentile) {
+    mixxx::LoadHistogram histogram;
+    for (int i = 0; i < 98; ++i) {
+        histogram.add(0.205);
+    }
+    histogram.add(0.505);
+    histogram.add(0.905);
+    EXPECT_EQ(100, histogram.count());
+    EXPECT_DOUBLE_EQ(0.21, histogram.percentile(0.5));
+    EXPECT_DOUBLE_EQ(0.21, histogram.percentile(0.98));
+    EXPECT_DOUBLE_EQ(0.51, histogram.percentile(0.99));
+    EXPECT_DOUBLE_EQ(0.91, histogram.percentile(1.0));
+
+    histogram.reset();
+    EXPECT_EQ(0, histogram.count());
+}
+
+TEST(LoadHistogramTest, OutOfRange) {
+    mixxx::LoadHistogram histogram;
+    histogram.add(-1.0);
+    EXPECT_DOUBLE_EQ(0.01, histogram.percentile(1.0));
+    histogram.add(100.0);
+    EXPECT_DOUBLE_EQ(mixxx::LoadHistogram::kMaxLoad, histogram.percentile(1.0));
+}
+
+} // namespace
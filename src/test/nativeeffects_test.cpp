@@ -1,96 +1,402 @@
-#if 0
-// TODO: make this work again
 #include <benchmark/benchmark.h>
 #include <gtest/gtest.h>
 
+#include <QMap>
+#include <QSet>
+#include <QThread>
+#include <cmath>
+
 #include "control/controlpotmeter.h"
-#include "effects/builtin/autopaneffect.h"
-#include "effects/builtin/bessel4lvmixeqeffect.h"
-#include "effects/builtin/bessel8lvmixeqeffect.h"
-#include "effects/builtin/bitcrushereffect.h"
-#include "effects/builtin/echoeffect.h"
-#include "effects/builtin/filtereffect.h"
-#include "effects/builtin/flangereffect.h"
-#include "effects/builtin/graphiceqeffect.h"
-#include "effects/builtin/linkwitzriley8eqeffect.h"
-#include "effects/builtin/moogladder4filtereffect.h"
-#include "effects/builtin/phasereffect.h"
-#include "effects/builtin/reverbeffect.h"
+#include "effects/backends/builtin/autopaneffect.h"
+#include "effects/backends/builtin/balanceeffect.h"
+#include "effects/backends/builtin/bessel4lvmixeqeffect.h"
+#include "effects/backends/builtin/bessel8lvmixeqeffect.h"
+#include "effects/backends/builtin/biquadfullkilleqeffect.h"
+#include "effects/backends/builtin/bitcrushereffect.h"
+#include "effects/backends/builtin/distortioneffect.h"
+#include "effects/backends/builtin/echoeffect.h"
+#include "effects/backends/builtin/filtereffect.h"
+#include "effects/backends/builtin/flangereffect.h"
+#include "effects/backends/builtin/glitcheffect.h"
+#include "effects/backends/builtin/graphiceqeffect.h"
+#include "effects/backends/builtin/linkwitzriley8eqeffect.h"
+#include "effects/backends/builtin/loudnesscontoureffect.h"
+#include "effects/backends/builtin/metronomeeffect.h"
+#include "effects/backends/builtin/moogladder4filtereffect.h"
+#include "effects/backends/builtin/parametriceqeffect.h"
+#include "effects/backends/builtin/phasereffect.h"
+#include "effects/backends/builtin/threebandbiquadeqeffect.h"
+#include "effects/backends/builtin/tremoloeffect.h"
+#include "effects/backends/builtin/whitenoiseeffect.h"
+#ifndef __MACAPPSTORE__
+#include "effects/backends/builtin/reverbeffect.h"
+#endif
+#ifdef __RUBBERBAND__
+#include "effects/backends/builtin/pitchshifteffect.h"
+#endif
+#include "effects/backends/effectmanifest.h"
+#include "effects/defs.h"
 #include "engine/channelhandle.h"
+#include "engine/effects/engineeffectparameter.h"
 #include "engine/effects/groupfeaturestate.h"
-#include "test/baseeffecttest.h"
+#include "engine/engine.h"
+#include "test/mixxxtest.h"
+#include "util/math.h"
 #include "util/samplebuffer.h"
 
+// Benchmarks for all built-in effects and tests of the pitch shift worker
+// thread. Run the benchmarks with
+//
+//   mixxx-test --benchmark --benchmark_filter=BM_BuiltInEffect
+//
+// or build the mixxx-benchmark-json target to store the results as JSON
+// for tracking performance over time.
+//
+// Every effect is processed for buffer sizes from 32 to 4096 frames at
+// the common sample rates. The "mode" argument selects the exercised path:
+//  - kDefaultParameters: steady state with the default parameter values
+//  - kParameterSweep: all parameters change on every buffer, which
+//    exercises the parameter ramping code paths
+//  - kEnableToggle: the effect is cycled through Enabling, Enabled and
+//    Disabling, which exercises the ramping from and to the dry signal
+//
+// The "realtime" counter reports how many seconds of audio are processed
+// per second of CPU time, i.e. values below 1 can't keep up with the
+// audio callback.
+
 namespace {
 
-class EffectsBenchmarkTest : public BaseEffectTest {
-  protected:
-    void SetUp() override {
-        registerTestBackend();
+enum BenchmarkMode : int64_t {
+    kDefaultParameters = 0,
+    kParameterSweep = 1,
+    kEnableToggle = 2,
+};
+
+// Number of distinct values each continuous parameter walks through
+// during a sweep.
+constexpr int kSweepPositions = 16;
+
+constexpr double kTestToneHz = 441.0;
+
+// The mixing EQs fetch their shelf frequencies from these controls, which
+// are owned by EngineMixer in Mixxx.
+class EqFrequencyControls {
+  public:
+    EqFrequencyControls()
+            : m_loEqFrequency(ConfigKey(kMixerProfile, kLowEqFrequency), 0., 22040),
+              m_hiEqFrequency(ConfigKey(kMixerProfile, kHighEqFrequency), 0., 22040) {
+        m_loEqFrequency.setDefaultValue(250.0);
+        m_loEqFrequency.set(250.0);
+        m_hiEqFrequency.setDefaultValue(2500.0);
+        m_hiEqFrequency.set(2500.0);
     }
+
+  private:
+    ControlPotmeter m_loEqFrequency;
+    ControlPotmeter m_hiEqFrequency;
 };
 
-template <class EffectType>
-void benchmarkBuiltInEffectDefaultParameters(const mixxx::EngineParameters& engineParameters,
-                                            benchmark::State* pState, EffectsManager* pEffectsManager) {
-    EffectManifestPointer pManifest = EffectType::getManifest();
+double sweepValue(const EffectManifestParameterPointer& pManifestParameter,
+        int parameterIndex,
+        int64_t iteration) {
+    // Offset each parameter so they don't all hit their extremes at once
+    const int64_t position = iteration + parameterIndex;
+    const auto& steps = pManifestParameter->getSteps();
+    if (!steps.isEmpty()) {
+        return steps.at(static_cast<int>(position % steps.size())).second;
+    }
+    const double minimum = pManifestParameter->getMinimum();
+    const double maximum = pManifestParameter->getMaximum();
+    if (pManifestParameter->valueScaler() ==
+            EffectManifestParameter::ValueScaler::Toggle) {
+        return (position % 2 == 0) ? minimum : maximum;
+    }
+    // Triangle wave across the full range
+    const int64_t period = 2 * (kSweepPositions - 1);
+    int64_t step = position % period;
+    if (step >= kSweepPositions) {
+        step = period - step;
+    }
+    const double value = minimum +
+            (maximum - minimum) * step / static_cast<double>(kSweepPositions - 1);
+    return math_clamp(value, minimum, maximum);
+}
+
+template<class EffectType>
+void BM_BuiltInEffect(benchmark::State& state) {
+    const SINT framesPerBuffer = static_cast<SINT>(state.range(0));
+    const auto sampleRate = mixxx::audio::SampleRate(
+            static_cast<mixxx::audio::SampleRate::value_t>(state.range(1)));
+    const auto mode = static_cast<BenchmarkMode>(state.range(2));
+    const mixxx::EngineParameters engineParameters(sampleRate, framesPerBuffer);
+
+    EqFrequencyControls eqFrequencyControls;
+
+    const EffectManifestPointer pManifest = EffectType::getManifest();
+    const QList<EffectManifestParameterPointer>& manifestParameters =
+            pManifest->parameters();
+    QList<EngineEffectParameterPointer> parameters;
+    QMap<QString, EngineEffectParameterPointer> parametersById;
+    for (const auto& pManifestParameter : manifestParameters) {
+        EngineEffectParameterPointer pParameter(
+                new EngineEffectParameter(pManifestParameter));
+        parameters.append(pParameter);
+        parametersById.insert(pManifestParameter->id(), pParameter);
+    }
 
     ChannelHandleFactory factory;
-    QSet<ChannelHandleAndGroup> activeInputChannels;
-
-    QString channel1_group = QString("[Channel1]");
-    ChannelHandle channel1 = factory.getOrCreateHandle(channel1_group);
-    ChannelHandleAndGroup handle_and_group(channel1, channel1_group);
-    pEffectsManager->registerInputChannel(handle_and_group);
-    pEffectsManager->registerOutputChannel(handle_and_group);
-    activeInputChannels.insert(handle_and_group);
-    EffectInstantiatorPointer pInstantiator = EffectInstantiatorPointer(
-        new EffectProcessorInstantiator<EffectType>());
-    EngineEffect effect(pManifest, activeInputChannels, pEffectsManager, pInstantiator);
-
-    GroupFeatureState featureState;
-    EffectEnableState enableState = EffectEnableState::Enabled;
-
-    mixxx::SampleBuffer input(engineParameters.samplesPerBuffer());
-    mixxx::SampleBuffer output(engineParameters.samplesPerBuffer());
-
-    while (pState->KeepRunning()) {
-        effect.process(channel1, channel1, input.data(), output.data(),
-                       engineParameters.samplesPerBuffer(),
-                       engineParameters.sampleRate(),
-                       enableState, featureState);
+    const QString inputGroup = QStringLiteral("[Channel1]");
+    const QString outputGroup = QStringLiteral("[Master]");
+    const ChannelHandleAndGroup input(factory.getOrCreateHandle(inputGroup), inputGroup);
+    const ChannelHandleAndGroup output(factory.getOrCreateHandle(outputGroup), outputGroup);
+    QSet<ChannelHandleAndGroup> inputChannels;
+    inputChannels.insert(input);
+    QSet<ChannelHandleAndGroup> outputChannels;
+    outputChannels.insert(output);
+
+    EffectType effect;
+    effect.loadEngineEffectParameters(parametersById);
+    effect.initialize(inputChannels, outputChannels, engineParameters);
+
+    // Pretend the deck is playing at 120 BPM for tempo synced effects
+    GroupFeatureState groupFeatures;
+    groupFeatures.has_beat_length_sec = true;
+    groupFeatures.beat_length_sec = 0.5;
+    groupFeatures.has_beat_fraction = true;
+    groupFeatures.beat_fraction = 0.0;
+    const double beatFractionPerBuffer = framesPerBuffer /
+            (groupFeatures.beat_length_sec * sampleRate.toDouble());
+
+    mixxx::SampleBuffer inputBuffer(engineParameters.samplesPerBuffer());
+    mixxx::SampleBuffer outputBuffer(engineParameters.samplesPerBuffer());
+    for (SINT frame = 0; frame < framesPerBuffer; ++frame) {
+        const auto sample = static_cast<CSAMPLE>(0.5 *
+                std::sin(2 * M_PI * kTestToneHz * frame / sampleRate.toDouble()));
+        inputBuffer[frame * 2] = sample;
+        inputBuffer[frame * 2 + 1] = sample;
+    }
+
+    int64_t iteration = 0;
+    for (auto _ : state) {
+        EffectEnableState enableState = EffectEnableState::Enabled;
+        if (mode == kParameterSweep) {
+            for (int i = 0; i < parameters.size(); ++i) {
+                parameters[i]->setValue(sweepValue(manifestParameters[i], i, iteration));
+            }
+        } else if (mode == kEnableToggle) {
+            switch (iteration % 3) {
+            case 0:
+                enableState = EffectEnableState::Enabling;
+                break;
+            case 1:
+                enableState = EffectEnableState::Enabled;
+                break;
+            default:
+                enableState = EffectEnableState::Disabling;
+                break;
+            }
+        }
+        effect.process(input.handle(),
+                output.handle(),
+                inputBuffer.data(),
+                outputBuffer.data(),
+                engineParameters,
+                enableState,
+                groupFeatures);
+        benchmark::DoNotOptimize(outputBuffer.data());
+        benchmark::ClobberMemory();
+
+        groupFeatures.beat_fraction += beatFractionPerBuffer;
+        groupFeatures.beat_fraction -= std::floor(groupFeatures.beat_fraction);
+        ++iteration;
+    }
+
+    state.SetItemsProcessed(state.iterations() * framesPerBuffer);
+    state.counters["realtime"] = benchmark::Counter(
+            static_cast<double>(state.iterations()) * framesPerBuffer /
+                    sampleRate.toDouble(),
+            benchmark::Counter::kIsRate);
+}
+
+void builtInEffectArguments(benchmark::internal::Benchmark* pBenchmark) {
+    pBenchmark->ArgNames({"frames", "rate", "mode"});
+    pBenchmark->ArgsProduct({
+            benchmark::CreateRange(32, 4096, 2),
+            {44100, 48000, 96000},
+            {kDefaultParameters, kParameterSweep, kEnableToggle},
+    });
+}
+
+#define DECLARE_EFFECT_BENCHMARK(EffectName) \
+    BENCHMARK_TEMPLATE(BM_BuiltInEffect, EffectName)->Apply(builtInEffectArguments)
+
+// Mixing EQs
+DECLARE_EFFECT_BENCHMARK(Bessel4LVMixEQEffect);
+DECLARE_EFFECT_BENCHMARK(Bessel8LVMixEQEffect);
+DECLARE_EFFECT_BENCHMARK(LinkwitzRiley8EQEffect);
+DECLARE_EFFECT_BENCHMARK(ThreeBandBiquadEQEffect);
+DECLARE_EFFECT_BENCHMARK(BiquadFullKillEQEffect);
+// Compensations EQs
+DECLARE_EFFECT_BENCHMARK(GraphicEQEffect);
+DECLARE_EFFECT_BENCHMARK(ParametricEQEffect);
+DECLARE_EFFECT_BENCHMARK(LoudnessContourEffect);
+// Fading Effects
+DECLARE_EFFECT_BENCHMARK(FilterEffect);
+DECLARE_EFFECT_BENCHMARK(MoogLadder4FilterEffect);
+DECLARE_EFFECT_BENCHMARK(BitCrusherEffect);
+DECLARE_EFFECT_BENCHMARK(WhiteNoiseEffect);
+DECLARE_EFFECT_BENCHMARK(BalanceEffect);
+// Fancy effects
+DECLARE_EFFECT_BENCHMARK(FlangerEffect);
+DECLARE_EFFECT_BENCHMARK(EchoEffect);
+DECLARE_EFFECT_BENCHMARK(AutoPanEffect);
+#ifndef __MACAPPSTORE__
+DECLARE_EFFECT_BENCHMARK(ReverbEffect);
+#endif
+DECLARE_EFFECT_BENCHMARK(PhaserEffect);
+DECLARE_EFFECT_BENCHMARK(MetronomeEffect);
+DECLARE_EFFECT_BENCHMARK(TremoloEffect);
+#ifdef __RUBBERBAND__
+DECLARE_EFFECT_BENCHMARK(PitchShiftEffect);
+#endif
+DECLARE_EFFECT_BENCHMARK(DistortionEffect);
+DECLARE_EFFECT_BENCHMARK(GlitchEffect);
+
+#ifdef __RUBBERBAND__
+constexpr SINT kPitchShiftFramesPerBuffer = 512;
+
+// Enough for the stretcher to fill up and for the worker thread to start
+constexpr int kMaxPitchShiftBuffers = 200;
+
+// Leaves the worker thread enough time for processing a buffer like
+// the period of the audio callback
+constexpr unsigned long kPitchShiftCallbackMillis = 5;
+
+class PitchShiftEffectTest : public MixxxTest {
+  protected:
+    PitchShiftEffectTest()
+            : m_engineParameters(mixxx::audio::SampleRate(44100),
+                      kPitchShiftFramesPerBuffer),
+              m_state(m_engineParameters),
+              m_inputBuffer(m_engineParameters.samplesPerBuffer()),
+              m_outputBuffer(m_engineParameters.samplesPerBuffer()) {
+        QMap<QString, EngineEffectParameterPointer> parametersById;
+        for (const auto& pManifestParameter : PitchShiftEffect::getManifest()->parameters()) {
+            parametersById.insert(pManifestParameter->id(),
+                    EngineEffectParameterPointer(
+                            new EngineEffectParameter(pManifestParameter)));
+        }
+        m_effect.loadEngineEffectParameters(parametersById);
+        m_pWorkerThreadParameter = parametersById.value(QStringLiteral("workerThread"));
+        m_pWorkerThreadParameter->setValue(1.0);
+
+        for (SINT frame = 0; frame < kPitchShiftFramesPerBuffer; ++frame) {
+            const auto sample = static_cast<CSAMPLE>(0.5 *
+                    std::sin(2 * M_PI * kTestToneHz * frame /
+                            m_engineParameters.sampleRate().toDouble()));
+            m_inputBuffer[frame * 2] = sample;
+            m_inputBuffer[frame * 2 + 1] = sample;
+        }
+    }
+
+    void process(EffectEnableState enableState = EffectEnableState::Enabled) {
+        m_effect.processChannel(&m_state,
+                m_inputBuffer.data(),
+                m_outputBuffer.data(),
+                m_engineParameters,
+                enableState,
+                GroupFeatureState());
+    }
+
+    SINT groupDelayFrames() const {
+        return m_effect.getChannelGroupDelayFrames(m_state);
+    }
+
+    bool isOutputSilent() const {
+        for (SINT i = 0; i < m_outputBuffer.size(); ++i) {
+            if (std::abs(m_outputBuffer[i]) > 1e-6f) {
+                return false;
+            }
+        }
+        return true;
     }
+
+    /// Processes buffers until the stretcher runs on the worker thread
+    bool waitForOffload() {
+        for (int i = 0; i < kMaxPitchShiftBuffers; ++i) {
+            process();
+            if (m_state.m_offloaded) {
+                return true;
+            }
+            QThread::msleep(kPitchShiftCallbackMillis);
+        }
+        return false;
+    }
+
+    /// Processes buffers until the output is not silent
+    bool waitForOutput() {
+        for (int i = 0; i < kMaxPitchShiftBuffers; ++i) {
+            QThread::msleep(kPitchShiftCallbackMillis);
+            process();
+            if (!isOutputSilent()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const mixxx::EngineParameters m_engineParameters;
+    PitchShiftEffect m_effect;
+    PitchShiftGroupState m_state;
+    EngineEffectParameterPointer m_pWorkerThreadParameter;
+    mixxx::SampleBuffer m_inputBuffer;
+    mixxx::SampleBuffer m_outputBuffer;
+};
+
+TEST_F(PitchShiftEffectTest, WorkerThreadDelaysOneBuffer) {
+    EXPECT_EQ(0, groupDelayFrames());
+    ASSERT_TRUE(waitForOffload());
+    EXPECT_EQ(kPitchShiftFramesPerBuffer, groupDelayFrames());
+    ASSERT_TRUE(waitForOutput());
+    EXPECT_EQ(kPitchShiftFramesPerBuffer, groupDelayFrames());
+
+    // Processed in the audio thread again without additional latency
+    m_pWorkerThreadParameter->setValue(0.0);
+    process();
+    EXPECT_EQ(0, groupDelayFrames());
 }
 
-#define FOR_COMMON_BUFFER_SIZES(bm) bm->Arg(32)->Arg(64)->Arg(128)->Arg(256)->Arg(512)->Arg(1024)->Arg(2048)->Arg(4096);
-
-#define DECLARE_EFFECT_BENCHMARK(EffectName)                                         \
-    TEST_F(EffectsBenchmarkTest, BM_BuiltInEffects_DefaultParameters_##EffectName) { \
-        ControlPotmeter loEqFrequency(                                               \
-                ConfigKey(kMixerProfile, kHighEqFrequency), 0., 22040);              \
-        loEqFrequency.setDefaultValue(250.0);                                        \
-        ControlPotmeter hiEqFrequency(                                               \
-                ConfigKey(kMixerProfile, kLowEqFrequency), 0., 22040);               \
-        hiEqFrequency.setDefaultValue(2500.0);                                       \
-        mixxx::EngineParameters engineParameters(                                    \
-                mixxx::audio::SampleRate(44100),                                     \
-                state.range_x());                                                    \
-        benchmarkBuiltInEffectDefaultParameters<EffectName>(                         \
-                engineParameters, &state, m_pEffectsManager);                        \
-    }                                                                                \
-    FOR_COMMON_BUFFER_SIZES(BENCHMARK(BM_BuiltInEffects_DefaultParameters_##EffectName));
-
-DECLARE_EFFECT_BENCHMARK(Bessel4LVMixEQEffect)
-DECLARE_EFFECT_BENCHMARK(Bessel8LVMixEQEffect)
-DECLARE_EFFECT_BENCHMARK(BitCrusherEffect)
-DECLARE_EFFECT_BENCHMARK(EchoEffect)
-DECLARE_EFFECT_BENCHMARK(FilterEffect)
-DECLARE_EFFECT_BENCHMARK(FlangerEffect)
-DECLARE_EFFECT_BENCHMARK(GraphicEQEffect)
-DECLARE_EFFECT_BENCHMARK(LinkwitzRiley8EQEffect)
-DECLARE_EFFECT_BENCHMARK(MoogLadder4FilterEffect)
-DECLARE_EFFECT_BENCHMARK(PhaserEffect)
-DECLARE_EFFECT_BENCHMARK(ReverbEffect)
-
-}  // namespace
+TEST_F(PitchShiftEffectTest, StaleWorkerResultsAreDiscarded) {
+    ASSERT_TRUE(waitForOffload());
+    ASSERT_TRUE(waitForOutput());
+
+    // Give the worker time to return the result of the last buffer,
+    // which has been submitted before the effect is re-enabled.
+    QThread::msleep(kPitchShiftCallbackMillis);
+    m_inputBuffer.clear();
+    process(EffectEnableState::Enabling);
+    EXPECT_TRUE(isOutputSilent());
+    // The audio that has been buffered by the stretcher is discarded, too
+    for (int i = 0; i < 10; ++i) {
+        QThread::msleep(kPitchShiftCallbackMillis);
+        process();
+        EXPECT_TRUE(isOutputSilent());
+    }
+    EXPECT_EQ(kPitchShiftFramesPerBuffer, groupDelayFrames());
+}
+
+TEST_F(PitchShiftEffectTest, LargeBuffersAreProcessedInAudioThread) {
+    // The worker buffers of the state are too small for the current
+    // buffer size
+    for (auto& workerBuffer : m_state.m_workerBuffers) {
+        workerBuffer = mixxx::SampleBuffer(m_engineParameters.samplesPerBuffer() / 2);
+    }
+    ASSERT_FALSE(waitForOffload());
+    EXPECT_EQ(0, groupDelayFrames());
+    ASSERT_TRUE(waitForOutput());
+    EXPECT_FALSE(m_state.m_offloaded);
+    EXPECT_EQ(0, groupDelayFrames());
+}
 #endif
+
+} // namespace
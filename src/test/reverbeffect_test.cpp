@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QMap>
+#include <QSet>
+#include <QTextStream>
+#include <QtDebug>
+#include <cmath>
+#include <memory>
+
+#include "effects/backends/builtin/reverbeffect.h"
+#include "engine/channelhandle.h"
+#include "engine/effects/engineeffectparameter.h"
+#include "engine/effects/groupfeaturestate.h"
+#include "engine/engine.h"
+#include "test/mixxxtest.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr SINT kFramesPerBuffer = 128;
+constexpr int kBufferCount = 8;
+const QString kReferenceBuffersPath = QStringLiteral("reference_buffers/");
+
+class ReverbEffectTest : public MixxxTest {
+  protected:
+    ReverbEffectTest()
+            : m_engineParameters(mixxx::audio::SampleRate(44100), kFramesPerBuffer),
+              m_input(m_factory.getOrCreateHandle(QStringLiteral("[Channel1]")),
+                      QStringLiteral("[Channel1]")),
+              m_output(m_factory.getOrCreateHandle(QStringLiteral("[Master]")),
+                      QStringLiteral("[Master]")) {
+    }
+
+    void SetUp() override {
+        const EffectManifestPointer pManifest = ReverbEffect::getManifest();
+        QMap<QString, EngineEffectParameterPointer> parameters;
+        for (const auto& pManifestParameter : pManifest->parameters()) {
+            parameters.insert(pManifestParameter->id(),
+                    EngineEffectParameterPointer(
+                            new EngineEffectParameter(pManifestParameter)));
+        }
+        parameters.value(QStringLiteral("decay"))->setValue(0.8);
+        parameters.value(QStringLiteral("bandwidth"))->setValue(0.9);
+        parameters.value(QStringLiteral("damping"))->setValue(0.2);
+        parameters.value(QStringLiteral("send_amount"))->setValue(1.0);
+        m_parameters = parameters;
+    }
+
+    std::unique_ptr<ReverbEffect> createEffect() const {
+        auto pEffect = std::make_unique<ReverbEffect>();
+        pEffect->loadEngineEffectParameters(m_parameters);
+        QSet<ChannelHandleAndGroup> inputChannels;
+        inputChannels.insert(m_input);
+        QSet<ChannelHandleAndGroup> outputChannels;
+        outputChannels.insert(m_output);
+        pEffect->initialize(inputChannels, outputChannels, m_engineParameters);
+        return pEffect;
+    }
+
+    /// Processes kBufferCount buffers of a sine tone, starting with the
+    /// effect being enabled, and returns the concatenated output.
+    mixxx::SampleBuffer processTone(ReverbEffect* pEffect) const {
+        const SINT samplesPerBuffer = m_engineParameters.samplesPerBuffer();
+        mixxx::SampleBuffer output(samplesPerBuffer * kBufferCount);
+        mixxx::SampleBuffer input(samplesPerBuffer);
+        SINT frame = 0;
+        for (int buffer = 0; buffer < kBufferCount; ++buffer) {
+            for (SINT i = 0; i < kFramesPerBuffer; ++i, ++frame) {
+                input[i * 2] = static_cast<CSAMPLE>(
+                        0.5 * std::sin(2 * M_PI * 441.0 * frame / 44100.0));
+                input[i * 2 + 1] = static_cast<CSAMPLE>(
+                        0.5 * std::sin(2 * M_PI * 882.0 * frame / 44100.0));
+            }
+            pEffect->process(m_input.handle(),
+                    m_output.handle(),
+                    input.data(),
+                    output.data(buffer * samplesPerBuffer),
+                    m_engineParameters,
+                    buffer == 0 ? EffectEnableState::Enabling
+                                : EffectEnableState::Enabled,
+                    m_groupFeatures);
+        }
+        return output;
+    }
+
+    void assertBufferMatchesReference(const mixxx::SampleBuffer& buffer,
+            const QString& referenceTitle) {
+        QFile f(getTestDir().filePath(kReferenceBuffersPath + referenceTitle));
+        bool pass = true;
+        SINT i = 0;
+        // If the file is not there, we will fail and write out the .actual
+        // reference file.
+        if (f.open(QFile::ReadOnly | QFile::Text)) {
+            QTextStream in(&f);
+            for (; i < buffer.size() && !in.atEnd(); i += 2) {
+                const QStringList line = in.readLine().split(',');
+                ASSERT_EQ(2, line.length());
+                const double gold0 = line[0].toDouble();
+                const double gold1 = line[1].toDouble();
+                if (std::fabs(gold0 - buffer[i]) > .0001 ||
+                        std::fabs(gold1 - buffer[i + 1]) > .0001) {
+                    qWarning() << "Golden check failed at index" << i << ", "
+                               << gold0 << gold1 << "vs" << buffer[i]
+                               << buffer[i + 1];
+                    pass = false;
+                }
+            }
+        }
+        if (!pass || i != buffer.size()) {
+            const QString fileNameActual = referenceTitle + ".actual";
+            qWarning() << "Buffer does not match" << referenceTitle
+                       << ", actual buffer written to "
+                       << kReferenceBuffersPath + fileNameActual;
+            QFile actual(getTestDir().filePath(kReferenceBuffersPath + fileNameActual));
+            ASSERT_TRUE(actual.open(QFile::WriteOnly | QFile::Text));
+            QTextStream out(&actual);
+            for (SINT j = 0; j < buffer.size(); j += 2) {
+                out << QString("%1,%2\n").arg(buffer[j]).arg(buffer[j + 1]);
+            }
+            EXPECT_TRUE(false);
+        }
+    }
+
+    const mixxx::EngineParameters m_engineParameters;
+    ChannelHandleFactory m_factory;
+    const ChannelHandleAndGroup m_input;
+    const ChannelHandleAndGroup m_output;
+    GroupFeatureState m_groupFeatures;
+    QMap<QString, EngineEffectParameterPointer> m_parameters;
+};
+
+// The reference has been rendered with the original sample by sample
+// implementation of the plate reverb.
+TEST_F(ReverbEffectTest, MatchesReference) {
+    auto pEffect = createEffect();
+    assertBufferMatchesReference(processTone(pEffect.get()), "ReverbEffectTest");
+}
+
+TEST_F(ReverbEffectTest, EnablingClearsTail) {
+    auto pEffect = createEffect();
+    const mixxx::SampleBuffer first = processTone(pEffect.get());
+    const mixxx::SampleBuffer second = processTone(pEffect.get());
+    ASSERT_EQ(first.size(), second.size());
+    for (SINT i = 0; i < first.size(); ++i) {
+        EXPECT_FLOAT_EQ(first[i], second[i]);
+    }
+}
+
+TEST_F(ReverbEffectTest, SampleRateChangeClearsTail) {
+    auto pEffect = createEffect();
+    // Fill the delay lines at a different sample rate
+    const mixxx::EngineParameters otherEngineParameters(
+            mixxx::audio::SampleRate(96000), kFramesPerBuffer);
+    mixxx::SampleBuffer input(otherEngineParameters.samplesPerBuffer());
+    input.fill(0.5);
+    mixxx::SampleBuffer output(otherEngineParameters.samplesPerBuffer());
+    for (int buffer = 0; buffer < kBufferCount; ++buffer) {
+        pEffect->process(m_input.handle(),
+                m_output.handle(),
+                input.data(),
+                output.data(),
+                otherEngineParameters,
+                EffectEnableState::Enabled,
+                m_groupFeatures);
+    }
+    assertBufferMatchesReference(processTone(pEffect.get()), "ReverbEffectTest");
+}
+
+} // namespace
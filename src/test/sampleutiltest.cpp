@@ -4,6 +4,8 @@
 #include <QList>
 #include <QPair>
 #include <QtDebug>
+#include <cstring>
+#include <limits>
 #include <vector>
 
 #include "util/sample.h"
@@ -289,6 +291,153 @@ TEST_F(SampleUtilTest, convertS16ToFloat32) {
     }
 }
 
+TEST_F(SampleUtilTest, convertS24LEToFloat32) {
+    const quint8 s24[] = {
+            0xFF, 0xFF, 0x7F, // maximum
+            0x00, 0x00, 0x00, // zero
+            0x00, 0x00, 0x80, // minimum
+            0x00, 0x00, 0x40, // 0.5
+            0x00, 0x00, 0xC0, // -0.5
+            0x01, 0x00, 0x00, // smallest positive value
+    };
+    CSAMPLE buffer[6];
+    SampleUtil::convertS24LEToFloat32(buffer, s24, 6);
+    EXPECT_FLOAT_EQ(8388607.0f / 8388608.0f, buffer[0]);
+    EXPECT_FLOAT_EQ(0.0f, buffer[1]);
+    EXPECT_FLOAT_EQ(-1.0f, buffer[2]);
+    EXPECT_FLOAT_EQ(0.5f, buffer[3]);
+    EXPECT_FLOAT_EQ(-0.5f, buffer[4]);
+    EXPECT_FLOAT_EQ(1.0f / 8388608.0f, buffer[5]);
+}
+
+TEST_F(SampleUtilTest, convertS32ToFloat32) {
+    for (int i = 0; i < buffers.size(); ++i) {
+        CSAMPLE* buffer = buffers[i];
+        int size = sizes[i];
+        auto s32 = std::vector<qint32>(size);
+        for (int j = 0; j < size; ++j) {
+            s32[j] = j % 2 ? std::numeric_limits<qint32>::min() : 1 << 30;
+        }
+        SampleUtil::convertS32ToFloat32(buffer, s32.data(), size);
+        for (int j = 0; j < size; ++j) {
+            EXPECT_FLOAT_EQ(j % 2 ? -1.0f : 0.5f, buffer[j]);
+        }
+    }
+}
+
+TEST_F(SampleUtilTest, convertScaledS32ToFloat32InPlace) {
+    CSAMPLE buffer[3];
+    const qint32 s32[] = {1 << 27, -(1 << 28), 0};
+    std::memcpy(buffer, s32, sizeof(s32));
+    // Fixed-point samples with 28 fractional bits
+    SampleUtil::convertScaledS32ToFloat32InPlace(buffer, 3, 1.0f / (1 << 28));
+    EXPECT_FLOAT_EQ(0.5f, buffer[0]);
+    EXPECT_FLOAT_EQ(-1.0f, buffer[1]);
+    EXPECT_FLOAT_EQ(0.0f, buffer[2]);
+}
+
+TEST_F(SampleUtilTest, convertPlanarS32ToFloat32) {
+    const qint32 left[] = {1 << 14, -(1 << 15)};
+    const qint32 right[] = {-(1 << 14), 0};
+    const qint32 center[] = {1, 1};
+    const qint32* const planar[] = {left, right, center};
+    constexpr CSAMPLE kScale = 1.0f / (1 << 15);
+    CSAMPLE buffer[6];
+
+    SampleUtil::convertPlanarS32ToFloat32(buffer,
+            mixxx::audio::ChannelCount::stereo(),
+            planar,
+            mixxx::audio::ChannelCount::stereo(),
+            2,
+            kScale);
+    EXPECT_FLOAT_EQ(0.5f, buffer[0]);
+    EXPECT_FLOAT_EQ(-0.5f, buffer[1]);
+    EXPECT_FLOAT_EQ(-1.0f, buffer[2]);
+    EXPECT_FLOAT_EQ(0.0f, buffer[3]);
+
+    // Mono -> Stereo
+    SampleUtil::convertPlanarS32ToFloat32(buffer,
+            mixxx::audio::ChannelCount::stereo(),
+            planar,
+            mixxx::audio::ChannelCount::mono(),
+            2,
+            kScale);
+    EXPECT_FLOAT_EQ(0.5f, buffer[0]);
+    EXPECT_FLOAT_EQ(0.5f, buffer[1]);
+    EXPECT_FLOAT_EQ(-1.0f, buffer[2]);
+    EXPECT_FLOAT_EQ(-1.0f, buffer[3]);
+
+    // Multi -> Stereo: Only the first two channels are kept
+    SampleUtil::convertPlanarS32ToFloat32(buffer,
+            mixxx::audio::ChannelCount::stereo(),
+            planar,
+            mixxx::audio::ChannelCount(3),
+            2,
+            kScale);
+    EXPECT_FLOAT_EQ(0.5f, buffer[0]);
+    EXPECT_FLOAT_EQ(-0.5f, buffer[1]);
+    EXPECT_FLOAT_EQ(-1.0f, buffer[2]);
+    EXPECT_FLOAT_EQ(0.0f, buffer[3]);
+
+    SampleUtil::convertPlanarS32ToFloat32(buffer,
+            mixxx::audio::ChannelCount(3),
+            planar,
+            mixxx::audio::ChannelCount(3),
+            2,
+            kScale);
+    EXPECT_FLOAT_EQ(0.5f, buffer[0]);
+    EXPECT_FLOAT_EQ(-0.5f, buffer[1]);
+    EXPECT_FLOAT_EQ(kScale, buffer[2]);
+    EXPECT_FLOAT_EQ(-1.0f, buffer[3]);
+    EXPECT_FLOAT_EQ(0.0f, buffer[4]);
+    EXPECT_FLOAT_EQ(kScale, buffer[5]);
+}
+
+TEST_F(SampleUtilTest, convertPlanarSNToFloat32) {
+    // 16-bit samples with garbage in the unused upper bits
+    const qint32 mono[] = {
+            static_cast<qint32>(0x7FFF0000 | 0x4000),
+            -(1 << 15),
+            static_cast<qint32>(0x00010000 | 0xC000),
+    };
+    const qint32* const planar[] = {mono};
+    CSAMPLE buffer[3];
+    SampleUtil::convertPlanarSNToFloat32(buffer,
+            mixxx::audio::ChannelCount::mono(),
+            planar,
+            mixxx::audio::ChannelCount::mono(),
+            3,
+            16);
+    EXPECT_FLOAT_EQ(0.5f, buffer[0]);
+    EXPECT_FLOAT_EQ(-1.0f, buffer[1]);
+    EXPECT_FLOAT_EQ(-0.5f, buffer[2]);
+}
+
+TEST_F(SampleUtilTest, interleavePlanarBuffer) {
+    const CSAMPLE left[] = {0.1f, 0.2f};
+    const CSAMPLE right[] = {-0.1f, -0.2f};
+    const CSAMPLE* const planar[] = {left, right};
+    CSAMPLE buffer[4];
+    SampleUtil::interleavePlanarBuffer(buffer,
+            mixxx::audio::ChannelCount::stereo(),
+            planar,
+            mixxx::audio::ChannelCount::stereo(),
+            2);
+    EXPECT_FLOAT_EQ(0.1f, buffer[0]);
+    EXPECT_FLOAT_EQ(-0.1f, buffer[1]);
+    EXPECT_FLOAT_EQ(0.2f, buffer[2]);
+    EXPECT_FLOAT_EQ(-0.2f, buffer[3]);
+
+    // Stereo -> Mono: Only the first channel is kept
+    SampleUtil::interleavePlanarBuffer(buffer,
+            mixxx::audio::ChannelCount::mono(),
+            planar,
+            mixxx::audio::ChannelCount::stereo(),
+            2);
+    EXPECT_FLOAT_EQ(0.1f, buffer[0]);
+    EXPECT_FLOAT_EQ(0.2f, buffer[1]);
+}
+
 TEST_F(SampleUtilTest, sumAbsPerChannel) {
     for (int i = 0; i < evenBuffers.size(); ++i) {
         int j = evenBuffers[i];
@@ -445,6 +594,26 @@ static void BM_SampleUtilCopy(benchmark::State& state) {
 }
 BENCHMARK(BM_SampleUtilCopy)->Range(64, 4096);
 
+static void BM_ConvertPlanarS32ToFloat32(benchmark::State& state) {
+    SINT numFrames = static_cast<SINT>(state.range(0));
+    std::vector<qint32> left(numFrames, 1 << 20);
+    std::vector<qint32> right(numFrames, -(1 << 20));
+    const qint32* const planar[] = {left.data(), right.data()};
+    CSAMPLE* buffer = SampleUtil::alloc(numFrames * 2);
+
+    while (state.KeepRunning()) {
+        SampleUtil::convertPlanarS32ToFloat32(buffer,
+                mixxx::audio::ChannelCount::stereo(),
+                planar,
+                mixxx::audio::ChannelCount::stereo(),
+                numFrames,
+                1.0f / (1 << 28));
+    }
+
+    SampleUtil::free(buffer);
+}
+BENCHMARK(BM_ConvertPlanarS32ToFloat32)->Range(64, 4096);
+
 
 /*
 TEST_F(SampleUtilTest, copy3WithGainSpeed) {
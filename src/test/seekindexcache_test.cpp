@@ -0,0 +1,152 @@
+#include "sources/seekindexcache.h"
+
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <limits>
+
+#include "sources/soundsourceproxy.h"
+#ifdef __MAD__
+#include "sources/soundsourcemp3.h"
+#endif
+#include "test/mixxxtest.h"
+#include "test/soundsourceproviderregistration.h"
+#include "track/track.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+const QString kDecoderId = QStringLiteral("Test/1");
+
+class SeekIndexCacheTest : public MixxxTest, SoundSourceProviderRegistration {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_cacheDir.isValid());
+        ASSERT_TRUE(m_audioDir.isValid());
+        mixxx::SeekIndexCache::setDirectory(m_cacheDir.path());
+    }
+
+    void TearDown() override {
+        mixxx::SeekIndexCache::setDirectory(QString());
+    }
+
+    QString createAudioFile(const QByteArray& content,
+            const QString& fileName = QStringLiteral("audio.bin")) {
+        const QString filePath = m_audioDir.filePath(fileName);
+        QFile file(filePath);
+        EXPECT_TRUE(file.open(QIODevice::WriteOnly));
+        EXPECT_EQ(content.size(), file.write(content));
+        return filePath;
+    }
+
+    QTemporaryDir m_cacheDir;
+    QTemporaryDir m_audioDir;
+};
+
+TEST_F(SeekIndexCacheTest, StoreAndLoad) {
+    const QString filePath = createAudioFile(QByteArray(100, 'a'));
+    const QByteArray index("index");
+    EXPECT_TRUE(mixxx::SeekIndexCache::load(filePath, kDecoderId).isEmpty());
+    ASSERT_TRUE(mixxx::SeekIndexCache::store(filePath, kDecoderId, index));
+    EXPECT_EQ(index, mixxx::SeekIndexCache::load(filePath, kDecoderId));
+    // The index is only valid for the same decoder
+    EXPECT_TRUE(mixxx::SeekIndexCache::load(filePath, QStringLiteral("Test/2")).isEmpty());
+}
+
+TEST_F(SeekIndexCacheTest, DiscardStaleIndex) {
+    const QString filePath = createAudioFile(QByteArray(100, 'a'));
+    ASSERT_TRUE(mixxx::SeekIndexCache::store(filePath, kDecoderId, QByteArray("index")));
+    createAudioFile(QByteArray(200, 'b'));
+    EXPECT_TRUE(mixxx::SeekIndexCache::load(filePath, kDecoderId).isEmpty());
+}
+
+TEST_F(SeekIndexCacheTest, Disabled) {
+    const QString filePath = createAudioFile(QByteArray(100, 'a'));
+    mixxx::SeekIndexCache::setDirectory(QString());
+    EXPECT_FALSE(mixxx::SeekIndexCache::store(filePath, kDecoderId, QByteArray("index")));
+    EXPECT_TRUE(mixxx::SeekIndexCache::load(filePath, kDecoderId).isEmpty());
+}
+
+TEST_F(SeekIndexCacheTest, Remove) {
+    const QString filePath = createAudioFile(QByteArray(100, 'a'));
+    ASSERT_TRUE(mixxx::SeekIndexCache::store(filePath, kDecoderId, QByteArray("index")));
+    mixxx::SeekIndexCache::remove(filePath);
+    EXPECT_TRUE(mixxx::SeekIndexCache::load(filePath, kDecoderId).isEmpty());
+    EXPECT_TRUE(QDir(m_cacheDir.path()).entryList(QDir::Files).isEmpty());
+}
+
+TEST_F(SeekIndexCacheTest, PruneLeastRecentlyUsed) {
+    QStringList filePaths;
+    for (int i = 0; i < 3; ++i) {
+        filePaths.append(createAudioFile(
+                QByteArray(100, 'a'), QStringLiteral("audio%1.bin").arg(i)));
+        ASSERT_TRUE(mixxx::SeekIndexCache::store(
+                filePaths.last(), kDecoderId, QByteArray("index")));
+    }
+    // All indices have last been used in the past
+    const QFileInfoList indexFiles =
+            QDir(m_cacheDir.path()).entryInfoList(QDir::Files);
+    ASSERT_EQ(3, indexFiles.size());
+    const QDateTime past = QDateTime::currentDateTimeUtc().addDays(-1);
+    for (const auto& indexFile : indexFiles) {
+        QFile file(indexFile.absoluteFilePath());
+        ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+        ASSERT_TRUE(file.setFileTime(past, QFileDevice::FileModificationTime));
+    }
+    // Loading the first index makes it the most recently used
+    ASSERT_FALSE(mixxx::SeekIndexCache::load(filePaths[0], kDecoderId).isEmpty());
+
+    mixxx::SeekIndexCache::prune(1, std::numeric_limits<qint64>::max());
+    EXPECT_EQ(1, QDir(m_cacheDir.path()).entryList(QDir::Files).size());
+    EXPECT_FALSE(mixxx::SeekIndexCache::load(filePaths[0], kDecoderId).isEmpty());
+
+    // The total size limit applies as well
+    mixxx::SeekIndexCache::prune(1, 0);
+    EXPECT_TRUE(QDir(m_cacheDir.path()).entryList(QDir::Files).isEmpty());
+}
+
+#ifdef __MAD__
+TEST_F(SeekIndexCacheTest, RestoreMp3SeekIndex) {
+    const QString filePath = getTestDir().filePath(
+            QStringLiteral("id3-test-data/cover-test-vbr.mp3"));
+    const auto pProvider = std::make_shared<mixxx::SoundSourceProviderMp3>();
+    const auto pTrack = Track::newTemporary(filePath);
+
+    // The first source scans the file and stores the index
+    const auto pScannedSource = SoundSourceProxy(pTrack, pProvider).openAudioSource();
+    ASSERT_TRUE(pScannedSource != nullptr);
+    ASSERT_EQ(1, QDir(m_cacheDir.path()).entryList(QDir::Files).size());
+
+    const auto pRestoredSource = SoundSourceProxy(pTrack, pProvider).openAudioSource();
+    ASSERT_TRUE(pRestoredSource != nullptr);
+    EXPECT_EQ(pScannedSource->getSignalInfo(), pRestoredSource->getSignalInfo());
+    EXPECT_EQ(pScannedSource->frameIndexRange(), pRestoredSource->frameIndexRange());
+
+    // Seeking backwards from the end of the stream reads the same samples
+    const SINT frameCount = 4096;
+    mixxx::SampleBuffer scannedSamples(
+            pScannedSource->getSignalInfo().frames2samples(frameCount));
+    mixxx::SampleBuffer restoredSamples(scannedSamples.size());
+    const auto lastFrames = mixxx::IndexRange::forward(
+            pScannedSource->frameIndexRange().end() - frameCount, frameCount);
+    const auto middleFrames = mixxx::IndexRange::forward(
+            pScannedSource->frameIndexRange().length() / 2, frameCount);
+    for (const auto& frameRange : {lastFrames, middleFrames}) {
+        const auto scanned = pScannedSource->readSampleFrames(
+                mixxx::WritableSampleFrames(frameRange,
+                        mixxx::SampleBuffer::WritableSlice(scannedSamples)));
+        const auto restored = pRestoredSource->readSampleFrames(
+                mixxx::WritableSampleFrames(frameRange,
+                        mixxx::SampleBuffer::WritableSlice(restoredSamples)));
+        ASSERT_EQ(scanned.frameIndexRange(), restored.frameIndexRange());
+        for (SINT i = 0; i < scanned.readableLength(); ++i) {
+            ASSERT_EQ(scanned.readableData()[i], restored.readableData()[i]) << i;
+        }
+    }
+}
+#endif
+
+} // namespace
@@ -1,10 +1,25 @@
+#include <benchmark/benchmark.h>
+
 #include <QTemporaryDir>
 #include <QTemporaryFile>
+#include <QtEndian>
 #include <QtDebug>
 
 #include "analyzer/analyzersilence.h"
+#include "library/coverartutils.h"
+#include "sources/importedtracksource.h"
 #include "sources/audiosourcestereoproxy.h"
+#include "sources/soundsourcepcm.h"
 #include "sources/soundsourceproxy.h"
+#ifdef __MAD__
+#include "sources/soundsourcemp3.h"
+#endif
+#ifdef __SNDFILE__
+#include "sources/soundsourcesndfile.h"
+#endif
+#ifdef __STEM__
+#include "sources/soundsourcestem.h"
+#endif
 #include "test/mixxxtest.h"
 #include "test/soundsourceproviderregistration.h"
 #include "track/track.h"
@@ -972,6 +987,72 @@ TEST_F(SoundSourceProxyTest, updateTrackFromSourceFileMissing) {
             SoundSourceProxy::UpdateTrackFromSourceResult::MetadataImportFailed);
 }
 
+TEST_F(SoundSourceProxyTest, updateTrackFromImportedSource) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString filePath = tempDir.filePath(QStringLiteral("cover-test-jpg.mp3"));
+    mixxxtest::copyFile(
+            getTestDir().filePath(QStringLiteral("id3-test-data/cover-test-jpg.mp3")),
+            filePath);
+
+    auto pTrack = Track::newTemporary(filePath);
+    ASSERT_EQ(SoundSourceProxy::UpdateTrackFromSourceResult::MetadataImportedAndUpdated,
+            SoundSourceProxy(pTrack).updateTrackFromSource(
+                    SoundSourceProxy::UpdateTrackFromSourceMode::Once,
+                    SyncTrackMetadataParams{}));
+
+    // Importing in advance has the same effect as reading the file
+    CoverInfoGuesser coverInfoGuesser;
+    auto importedTrackSource = SoundSourceProxy::importTrackSourceFromFile(
+            mixxx::FileAccess(mixxx::FileInfo(filePath)),
+            SyncTrackMetadataParams{},
+            &coverInfoGuesser);
+    ASSERT_EQ(mixxx::MetadataSource::ImportResult::Succeeded,
+            importedTrackSource.importResult);
+    auto pImportedTrack = Track::newTemporary(filePath);
+    EXPECT_EQ(SoundSourceProxy::UpdateTrackFromSourceResult::MetadataImportedAndUpdated,
+            SoundSourceProxy(pImportedTrack)
+                    .updateTrackFromImportedSource(
+                            std::move(importedTrackSource),
+                            SyncTrackMetadataParams{}));
+    EXPECT_EQ(pTrack->getMetadata(), pImportedTrack->getMetadata());
+    EXPECT_EQ(pTrack->getCoverInfo(), pImportedTrack->getCoverInfo());
+
+    // The imported metadata is used instead of reading the file again
+    importedTrackSource = SoundSourceProxy::importTrackSourceFromFile(
+            mixxx::FileAccess(mixxx::FileInfo(filePath)),
+            SyncTrackMetadataParams{},
+            &coverInfoGuesser);
+    importedTrackSource.trackMetadata.refTrackInfo().setTitle(QStringLiteral("imported"));
+    auto pPreImportedTrack = Track::newTemporary(filePath);
+    EXPECT_EQ(SoundSourceProxy::UpdateTrackFromSourceResult::MetadataImportedAndUpdated,
+            SoundSourceProxy(pPreImportedTrack)
+                    .updateTrackFromImportedSource(
+                            std::move(importedTrackSource),
+                            SyncTrackMetadataParams{}));
+    EXPECT_EQ(QStringLiteral("imported"), pPreImportedTrack->getTitle());
+
+    // Imported metadata is discarded after the file has been modified
+    importedTrackSource = SoundSourceProxy::importTrackSourceFromFile(
+            mixxx::FileAccess(mixxx::FileInfo(filePath)),
+            SyncTrackMetadataParams{},
+            &coverInfoGuesser);
+    importedTrackSource.trackMetadata.refTrackInfo().setTitle(QStringLiteral("outdated"));
+    QFile file(filePath);
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    ASSERT_TRUE(file.setFileTime(
+            QDateTime::currentDateTimeUtc().addSecs(60),
+            QFileDevice::FileModificationTime));
+    file.close();
+    auto pModifiedTrack = Track::newTemporary(filePath);
+    EXPECT_EQ(SoundSourceProxy::UpdateTrackFromSourceResult::MetadataImportedAndUpdated,
+            SoundSourceProxy(pModifiedTrack)
+                    .updateTrackFromImportedSource(
+                            std::move(importedTrackSource),
+                            SyncTrackMetadataParams{}));
+    EXPECT_EQ(pTrack->getTitle(), pModifiedTrack->getTitle());
+}
+
 TEST_F(SoundSourceProxyTest, handleWrongFileSuffix) {
     QTemporaryDir tempDir;
     ASSERT_TRUE(tempDir.isValid());
@@ -1086,3 +1167,262 @@ TEST_F(SoundSourceProxyTest, freeModeGarbage) {
         break;
     }
 }
+
+#ifdef __MAD__
+TEST_F(SoundSourceProxyTest, openMp3AtReducedSampleRate) {
+    const QString filePath = getTestDir().filePath(
+            QStringLiteral("id3-test-data/cover-test-vbr.mp3"));
+    const auto pProvider = std::make_shared<mixxx::SoundSourceProviderMp3>();
+    const auto pTrack = Track::newTemporary(filePath);
+
+    const auto pFullRateSource =
+            SoundSourceProxy(pTrack, pProvider).openAudioSource();
+    ASSERT_TRUE(pFullRateSource != nullptr);
+    const auto sampleRate = pFullRateSource->getSignalInfo().getSampleRate();
+    ASSERT_EQ(sampleRate, pTrack->getSampleRate());
+
+    mixxx::AudioSource::OpenParams openParams;
+    openParams.setSampleRate(mixxx::audio::SampleRate(sampleRate / 2));
+    const auto pReducedSource =
+            SoundSourceProxy(pTrack, pProvider).openAudioSource(openParams);
+    ASSERT_TRUE(pReducedSource != nullptr);
+    EXPECT_EQ(sampleRate / 2, pReducedSource->getSignalInfo().getSampleRate());
+    EXPECT_EQ(pFullRateSource->frameLength() / 2, pReducedSource->frameLength());
+    // The stream info of the track must not be overwritten
+    EXPECT_EQ(sampleRate, pTrack->getSampleRate());
+
+    // Decode the whole file
+    mixxx::SampleBuffer sampleBuffer(
+            pReducedSource->getSignalInfo().frames2samples(kMaxReadFrameCount));
+    mixxx::IndexRange remainingRange = pReducedSource->frameIndexRange();
+    while (!remainingRange.empty()) {
+        const auto readRange = pReducedSource->readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        remainingRange.splitAndShrinkFront(
+                                math_min(kMaxReadFrameCount, remainingRange.length())),
+                        mixxx::SampleBuffer::WritableSlice(sampleBuffer)));
+        ASSERT_FALSE(readRange.frameIndexRange().empty());
+    }
+}
+#endif
+
+#ifdef __SNDFILE__
+TEST_F(SoundSourceProxyTest, readPcmLikeSndFile) {
+    const auto pPcmProvider = std::make_shared<mixxx::SoundSourceProviderPcm>();
+    const auto pSndFileProvider = std::make_shared<mixxx::SoundSourceProviderSndFile>();
+    for (const auto& fileName : {
+                 QStringLiteral("id3-test-data/cover-test.aiff"),
+                 QStringLiteral("id3-test-data/cover-test.wav"),
+         }) {
+        const QString filePath = getTestDir().filePath(fileName);
+        const auto pPcmSource = openAudioSource(filePath, pPcmProvider);
+        ASSERT_TRUE(pPcmSource != nullptr) << filePath.toStdString();
+        const auto pSndFileSource = openAudioSource(filePath, pSndFileProvider);
+        ASSERT_TRUE(pSndFileSource != nullptr) << filePath.toStdString();
+        ASSERT_EQ(pSndFileSource->frameIndexRange(), pPcmSource->frameIndexRange());
+        ASSERT_EQ(pSndFileSource->getSignalInfo(), pPcmSource->getSignalInfo());
+
+        const auto sampleCount =
+                pPcmSource->getSignalInfo().frames2samples(kMaxReadFrameCount);
+        mixxx::SampleBuffer pcmBuffer(sampleCount);
+        mixxx::SampleBuffer sndFileBuffer(sampleCount);
+        mixxx::IndexRange remainingRange = pPcmSource->frameIndexRange();
+        while (!remainingRange.empty()) {
+            const auto nextRange = remainingRange.splitAndShrinkFront(
+                    math_min(kMaxReadFrameCount, remainingRange.length()));
+            const auto pcmFrames = pPcmSource->readSampleFrames(
+                    mixxx::WritableSampleFrames(
+                            nextRange,
+                            mixxx::SampleBuffer::WritableSlice(pcmBuffer)));
+            const auto sndFileFrames = pSndFileSource->readSampleFrames(
+                    mixxx::WritableSampleFrames(
+                            nextRange,
+                            mixxx::SampleBuffer::WritableSlice(sndFileBuffer)));
+            ASSERT_EQ(nextRange, pcmFrames.frameIndexRange());
+            ASSERT_EQ(nextRange, sndFileFrames.frameIndexRange());
+            ASSERT_EQ(sndFileFrames.readableLength(), pcmFrames.readableLength());
+            expectDecodedSamplesEqual(
+                    pcmFrames.readableLength(),
+                    sndFileFrames.readableData(),
+                    pcmFrames.readableData(),
+                    "Decoded samples differ from SndFile");
+        }
+    }
+}
+#endif
+
+#ifdef __STEM__
+TEST_F(SoundSourceProxyTest, readStemsConcurrently) {
+    const QUrl url = QUrl::fromLocalFile(
+            getTestDir().filePath(QStringLiteral("stems/test.stem.mp4")));
+    constexpr int kStemCount = 4;
+
+    mixxx::SoundSourceSTEM stemSource(url);
+    ASSERT_EQ(mixxx::AudioSource::OpenResult::Succeeded,
+            stemSource.open(mixxx::AudioSource::OpenMode::Strict,
+                    mixxx::AudioSource::OpenParams(
+                            mixxx::audio::ChannelCount::stem(),
+                            mixxx::audio::SampleRate())));
+    ASSERT_EQ(mixxx::audio::ChannelCount::stem(),
+            stemSource.getSignalInfo().getChannelCount());
+
+    // The main mix is the first stream followed by the stems
+    std::vector<std::unique_ptr<mixxx::SoundSourceSingleSTEM>> singleStems;
+    for (int stemIdx = 0; stemIdx < kStemCount; ++stemIdx) {
+        singleStems.push_back(std::make_unique<mixxx::SoundSourceSingleSTEM>(
+                url, stemIdx + 1));
+        ASSERT_EQ(mixxx::AudioSource::OpenResult::Succeeded,
+                singleStems.back()->open(mixxx::AudioSource::OpenMode::Strict,
+                        mixxx::AudioSource::OpenParams(
+                                mixxx::audio::ChannelCount::stereo(),
+                                mixxx::audio::SampleRate())));
+        ASSERT_EQ(stemSource.frameIndexRange(), singleStems.back()->frameIndexRange());
+    }
+
+    mixxx::SampleBuffer stemBuffer(
+            stemSource.getSignalInfo().frames2samples(kMaxReadFrameCount));
+    mixxx::SampleBuffer singleStemBuffer(
+            mixxx::audio::ChannelCount::stereo() * kMaxReadFrameCount);
+    mixxx::IndexRange remainingRange = stemSource.frameIndexRange();
+    while (!remainingRange.empty()) {
+        const auto nextRange = remainingRange.splitAndShrinkFront(
+                math_min(kMaxReadFrameCount, remainingRange.length()));
+        const auto stemFrames = stemSource.readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        nextRange,
+                        mixxx::SampleBuffer::WritableSlice(stemBuffer)));
+        ASSERT_EQ(nextRange, stemFrames.frameIndexRange());
+        for (int stemIdx = 0; stemIdx < kStemCount; ++stemIdx) {
+            const auto singleStemFrames = singleStems[stemIdx]->readSampleFrames(
+                    mixxx::WritableSampleFrames(
+                            nextRange,
+                            mixxx::SampleBuffer::WritableSlice(singleStemBuffer)));
+            ASSERT_EQ(nextRange, singleStemFrames.frameIndexRange());
+            for (SINT i = 0; i < nextRange.length(); ++i) {
+                const CSAMPLE* pStemFrame = stemFrames.readableData(
+                        mixxx::audio::ChannelCount::stem() * i + 2 * stemIdx);
+                const CSAMPLE* pSingleStemFrame = singleStemFrames.readableData(2 * i);
+                ASSERT_EQ(pSingleStemFrame[0], pStemFrame[0]) << "stem " << stemIdx;
+                ASSERT_EQ(pSingleStemFrame[1], pStemFrame[1]) << "stem " << stemIdx;
+            }
+        }
+    }
+}
+#endif
+
+TEST_F(SoundSourceProxyTest, growPcmWhileWriting) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString filePath = tempDir.filePath(QStringLiteral("recording.wav"));
+    QFile file(filePath);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+
+    // Mono 16-bit PCM written as a stream: The sizes in the header
+    // are not updated until the recording has been stopped
+    const auto appendLE = [&file](quint32 value, int size) {
+        char bytes[4];
+        qToLittleEndian(value, bytes);
+        ASSERT_EQ(size, file.write(bytes, size));
+    };
+    ASSERT_EQ(4, file.write("RIFF"));
+    appendLE(0, 4);
+    ASSERT_EQ(8, file.write("WAVEfmt "));
+    appendLE(16, 4);
+    appendLE(1, 2);     // PCM
+    appendLE(1, 2);     // channels
+    appendLE(44100, 4); // sample rate
+    appendLE(2 * 44100, 4);
+    appendLE(2, 2); // block align
+    appendLE(16, 2);
+    ASSERT_EQ(4, file.write("data"));
+    appendLE(0, 4);
+    constexpr SINT kFramesPerWrite = 1000;
+    const auto appendFrames = [&file, &appendLE] {
+        for (SINT i = 0; i < kFramesPerWrite; ++i) {
+            appendLE(0x4000, 2);
+        }
+        ASSERT_TRUE(file.flush());
+    };
+    appendFrames();
+
+    const auto pAudioSource = openAudioSource(
+            filePath, std::make_shared<mixxx::SoundSourceProviderPcm>());
+    ASSERT_TRUE(pAudioSource != nullptr);
+    EXPECT_EQ(mixxx::IndexRange::forward(0, kFramesPerWrite),
+            pAudioSource->frameIndexRange());
+    EXPECT_FALSE(pAudioSource->tryGrowFrameIndexRange());
+
+    appendFrames();
+    ASSERT_TRUE(pAudioSource->tryGrowFrameIndexRange());
+    const auto grownRange = mixxx::IndexRange::forward(0, 2 * kFramesPerWrite);
+    EXPECT_EQ(grownRange, pAudioSource->frameIndexRange());
+    EXPECT_FALSE(pAudioSource->tryGrowFrameIndexRange());
+
+    // The appended frames are readable
+    mixxx::SampleBuffer buffer(
+            pAudioSource->getSignalInfo().frames2samples(kFramesPerWrite));
+    const auto appendedRange = mixxx::IndexRange::forward(kFramesPerWrite, kFramesPerWrite);
+    const auto readableFrames = pAudioSource->readSampleFrames(
+            mixxx::WritableSampleFrames(
+                    appendedRange,
+                    mixxx::SampleBuffer::WritableSlice(buffer)));
+    ASSERT_EQ(appendedRange, readableFrames.frameIndexRange());
+    for (SINT i = 0; i < readableFrames.readableLength(); ++i) {
+        EXPECT_EQ(0.5f, readableFrames.readableData()[i]);
+    }
+}
+
+namespace {
+
+void BM_DecodeTestFile(benchmark::State& state, const QString& fileNameSuffix) {
+    if (!SoundSourceProxy::isFileSuffixSupported(QStringLiteral("wav"))) {
+        SoundSourceProxy::registerProviders();
+    }
+    const QString filePath = MixxxTest::getOrInitTestDir().filePath(
+            QStringLiteral("id3-test-data/cover-test") + fileNameSuffix);
+    if (!SoundSourceProxy::isFileNameSupported(filePath)) {
+        state.SkipWithError("Unsupported file type");
+        return;
+    }
+    mixxx::AudioSource::OpenParams openParams;
+    openParams.setChannelCount(mixxx::audio::ChannelCount::stereo());
+    SINT decodedFrames = 0;
+    while (state.KeepRunning()) {
+        auto pAudioSource = SoundSourceProxy(Track::newTemporary(filePath))
+                                    .openAudioSource(openParams);
+        if (!pAudioSource) {
+            state.SkipWithError("Failed to open file");
+            return;
+        }
+        mixxx::SampleBuffer readBuffer(
+                pAudioSource->getSignalInfo().frames2samples(kMaxReadFrameCount));
+        auto remainingRange = pAudioSource->frameIndexRange();
+        while (!remainingRange.empty()) {
+            const auto readRange = mixxx::IndexRange::forward(
+                    remainingRange.start(),
+                    math_min(kMaxReadFrameCount, remainingRange.length()));
+            const auto readableFrames = pAudioSource->readSampleFrames(
+                    mixxx::WritableSampleFrames(
+                            readRange,
+                            mixxx::SampleBuffer::WritableSlice(readBuffer)));
+            const auto readableRange = readableFrames.frameIndexRange();
+            if (readableRange.empty()) {
+                break;
+            }
+            decodedFrames += readableRange.length();
+            remainingRange.shrinkFront(readableRange.length());
+        }
+    }
+    state.counters["frames/s"] = benchmark::Counter(
+            static_cast<double>(decodedFrames), benchmark::Counter::kIsRate);
+}
+BENCHMARK_CAPTURE(BM_DecodeTestFile, AIFF, QStringLiteral(".aiff"));
+BENCHMARK_CAPTURE(BM_DecodeTestFile, FLAC, QStringLiteral(".flac"));
+BENCHMARK_CAPTURE(BM_DecodeTestFile, M4A, QStringLiteral("-itunes-12.7.0-aac.m4a"));
+BENCHMARK_CAPTURE(BM_DecodeTestFile, MP3, QStringLiteral("-png.mp3"));
+BENCHMARK_CAPTURE(BM_DecodeTestFile, OggVorbis, QStringLiteral(".ogg"));
+BENCHMARK_CAPTURE(BM_DecodeTestFile, Opus, QStringLiteral(".opus"));
+BENCHMARK_CAPTURE(BM_DecodeTestFile, WAV, QStringLiteral(".wav"));
+BENCHMARK_CAPTURE(BM_DecodeTestFile, WavPack, QStringLiteral(".wv"));
+
+} // anonymous namespace
@@ -0,0 +1,98 @@
+#include "sources/soundsourcepool.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "sources/soundsourceproxy.h"
+#include "test/mixxxtest.h"
+#include "test/soundsourceproviderregistration.h"
+#include "track/track.h"
+
+namespace {
+
+class SoundSourcePoolTest : public MixxxTest, SoundSourceProviderRegistration {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_tempDir.isValid());
+        m_filePath = m_tempDir.filePath(QStringLiteral("cover-test.wav"));
+        ASSERT_TRUE(QFile::copy(
+                getTestDir().filePath(QStringLiteral("id3-test-data/cover-test.wav")),
+                m_filePath));
+    }
+
+    void TearDown() override {
+        mixxx::SoundSourcePool::releaseAll();
+    }
+
+    std::pair<mixxx::SoundSourceProviderPointer, mixxx::SoundSourcePointer>
+    openSoundSource(const mixxx::AudioSource::OpenParams& params) {
+        const auto pProvider = SoundSourceProxy::getPrimaryProviderForFileType(
+                QStringLiteral("wav"));
+        EXPECT_TRUE(pProvider);
+        auto pSoundSource = pProvider->newSoundSource(QUrl::fromLocalFile(m_filePath));
+        EXPECT_EQ(mixxx::AudioSource::OpenResult::Succeeded,
+                pSoundSource->open(mixxx::AudioSource::OpenMode::Strict, params));
+        return std::make_pair(pProvider, pSoundSource);
+    }
+
+    QTemporaryDir m_tempDir;
+    QString m_filePath;
+};
+
+TEST_F(SoundSourcePoolTest, CheckOutExclusively) {
+    const mixxx::AudioSource::OpenParams params;
+    const auto [pProvider, pSoundSource] = openSoundSource(params);
+    mixxx::SoundSourcePool::checkIn(m_filePath, params, pProvider, pSoundSource);
+
+    // Only sources that have been opened with the same parameters are reused
+    mixxx::AudioSource::OpenParams stereoParams;
+    stereoParams.setChannelCount(mixxx::audio::ChannelCount::stereo());
+    EXPECT_FALSE(mixxx::SoundSourcePool::checkOut(m_filePath, stereoParams).second);
+
+    const auto checkedOut = mixxx::SoundSourcePool::checkOut(m_filePath, params);
+    EXPECT_EQ(pProvider, checkedOut.first);
+    EXPECT_EQ(pSoundSource, checkedOut.second);
+    EXPECT_FALSE(mixxx::SoundSourcePool::checkOut(m_filePath, params).second);
+}
+
+TEST_F(SoundSourcePoolTest, DiscardModifiedFile) {
+    const mixxx::AudioSource::OpenParams params;
+    const auto [pProvider, pSoundSource] = openSoundSource(params);
+    mixxx::SoundSourcePool::checkIn(m_filePath, params, pProvider, pSoundSource);
+
+    QFile file(m_filePath);
+    ASSERT_TRUE(file.open(QIODevice::Append));
+    ASSERT_EQ(4, file.write("junk"));
+    file.close();
+
+    EXPECT_FALSE(mixxx::SoundSourcePool::checkOut(m_filePath, params).second);
+}
+
+TEST_F(SoundSourcePoolTest, ReuseAfterClose) {
+    const auto pTrack = Track::newTemporary(m_filePath);
+    auto pAudioSource = SoundSourceProxy(pTrack).openAudioSource();
+    ASSERT_TRUE(pAudioSource);
+    const auto frameIndexRange = pAudioSource->frameIndexRange();
+    pAudioSource->close();
+    pAudioSource.reset();
+
+    // The closed audio source has been returned into the pool
+    const auto checkedOut = mixxx::SoundSourcePool::checkOut(
+            m_filePath, mixxx::AudioSource::OpenParams());
+    ASSERT_TRUE(checkedOut.second);
+    EXPECT_EQ(frameIndexRange, checkedOut.second->frameIndexRange());
+    mixxx::SoundSourcePool::checkIn(m_filePath,
+            mixxx::AudioSource::OpenParams(),
+            checkedOut.first,
+            checkedOut.second);
+
+    // Writing into the file closes all idle audio sources
+    mixxx::SoundSourcePool::release(m_filePath);
+    const auto released = mixxx::SoundSourcePool::checkOut(
+            m_filePath, mixxx::AudioSource::OpenParams());
+    EXPECT_FALSE(released.second);
+}
+
+} // namespace
@@ -0,0 +1,132 @@
+#include "library/sqltableloader.h"
+
+#include <gtest/gtest.h>
+
+#include <QSemaphore>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QTest>
+#include <map>
+
+#include "test/librarytest.h"
+
+namespace {
+
+const QString kViewName = QStringLiteral("sqltableloader_test");
+
+class SqlTableLoaderTest : public LibraryTest {
+  protected:
+    SqlTableLoaderTest()
+            : m_sqlTableLoader(dbConnectionPooler()) {
+        m_sqlTableLoader.start();
+    }
+
+    void execute(const QString& statement) {
+        QSqlQuery query(dbConnection());
+        EXPECT_TRUE(query.exec(statement)) << query.lastError().text().toStdString();
+    }
+
+    void insertTracks(int count) {
+        for (int i = 0; i < count; ++i) {
+            execute(QStringLiteral("INSERT INTO library (title) VALUES ('Track %1')")
+                            .arg(i));
+        }
+    }
+
+    SqlTableLoader::Request createRequest(const QString& filter) const {
+        // Temporary views only exist within the connection that has
+        // created them
+        QSqlQuery query(dbConnection());
+        EXPECT_TRUE(query.exec(QStringLiteral(
+                "CREATE TEMPORARY VIEW IF NOT EXISTS %1 AS "
+                "SELECT id, title FROM library WHERE %2")
+                                       .arg(kViewName, filter)));
+        SqlTableLoader::Request request;
+        request.createViewStatement = SqlTableLoader::createTemporaryViewStatement(
+                dbConnection(), kViewName);
+        request.tableName = kViewName;
+        request.queryString = QStringLiteral("SELECT id, title FROM %1 ORDER BY id")
+                                      .arg(kViewName);
+        return request;
+    }
+
+    /// Starts loading and records all batches of the reply
+    SqlTableReplyPointer load(const QString& filter) {
+        SqlTableReplyPointer pReply = m_sqlTableLoader.load(createRequest(filter));
+        QVector<SqlTableReply::Batch>* pBatches = &m_batches[pReply.data()];
+        QObject::connect(pReply.data(),
+                &SqlTableReply::rowsLoaded,
+                [pBatches](const SqlTableReply::Batch& batch) {
+                    pBatches->push_back(batch);
+                });
+        return pReply;
+    }
+
+    int waitForReply(const SqlTableReplyPointer& pReply) {
+        const QVector<SqlTableReply::Batch>& batches = m_batches[pReply.data()];
+        EXPECT_TRUE(QTest::qWaitFor([&batches] {
+            return !batches.isEmpty() && batches.last().finished;
+        }));
+        int rowCount = 0;
+        for (const auto& batch : batches) {
+            EXPECT_FALSE(batch.failed);
+            rowCount += batch.rows.size();
+        }
+        return rowCount;
+    }
+
+    SqlTableLoader m_sqlTableLoader;
+    // The references to the values remain valid after inserting keys
+    std::map<const SqlTableReply*, QVector<SqlTableReply::Batch>> m_batches;
+};
+
+TEST_F(SqlTableLoaderTest, CreateTemporaryViewStatement) {
+    createRequest(QStringLiteral("1"));
+    const QString statement = SqlTableLoader::createTemporaryViewStatement(
+            dbConnection(), kViewName);
+    EXPECT_TRUE(statement.startsWith(QStringLiteral("CREATE TEMPORARY VIEW ")));
+    EXPECT_TRUE(SqlTableLoader::createTemporaryViewStatement(
+            dbConnection(), QStringLiteral("library"))
+                        .isEmpty());
+}
+
+TEST_F(SqlTableLoaderTest, LoadRowsInBatches) {
+    insertTracks(250);
+    const SqlTableReplyPointer pReply = load(QStringLiteral("1"));
+    EXPECT_EQ(250, waitForReply(pReply));
+    // The first batch is small
+    const auto& batches = m_batches[pReply.data()];
+    EXPECT_GT(250, batches.first().rows.size());
+    EXPECT_EQ(2, batches.first().rows.first().size());
+}
+
+TEST_F(SqlTableLoaderTest, RecreateChangedViews) {
+    insertTracks(10);
+    const SqlTableReplyPointer pReply = load(QStringLiteral("id <= 5"));
+    EXPECT_EQ(5, waitForReply(pReply));
+
+    execute(QStringLiteral("DROP VIEW %1").arg(kViewName));
+    const SqlTableReplyPointer pChangedReply = load(QStringLiteral("id > 8"));
+    EXPECT_EQ(2, waitForReply(pChangedReply));
+}
+
+TEST_F(SqlTableLoaderTest, CancelledRepliesAreNotLoaded) {
+    insertTracks(10);
+    // Block the loader thread until the request has been cancelled
+    QSemaphore semaphore;
+    QMetaObject::invokeMethod(
+            &m_sqlTableLoader,
+            [&semaphore] {
+                semaphore.acquire();
+            },
+            Qt::QueuedConnection);
+    const SqlTableReplyPointer pCancelledReply = load(QStringLiteral("1"));
+    const SqlTableReplyPointer pReply = load(QStringLiteral("1"));
+    pCancelledReply->cancel();
+    semaphore.release();
+    EXPECT_EQ(10, waitForReply(pReply));
+    // The requests are executed in order
+    EXPECT_TRUE(m_batches[pCancelledReply.data()].isEmpty());
+}
+
+} // namespace
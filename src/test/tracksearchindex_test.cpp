@@ -0,0 +1,167 @@
+#include "library/tracksearchindex.h"
+
+#include <gtest/gtest.h>
+
+#include <QSet>
+#include <optional>
+
+#include "library/columncache.h"
+#include "library/dao/trackschema.h"
+#include "library/searchquery.h"
+#include "library/searchqueryparser.h"
+#include "test/librarytest.h"
+
+namespace {
+
+const QStringList kColumns = {
+        LIBRARYTABLE_ID,
+        LIBRARYTABLE_ARTIST,
+        LIBRARYTABLE_TITLE,
+        LIBRARYTABLE_ALBUM,
+        LIBRARYTABLE_YEAR,
+        LIBRARYTABLE_BPM,
+        LIBRARYTABLE_KEY_ID,
+        TRACKLOCATIONSTABLE_LOCATION,
+};
+
+class TrackSearchIndexTest : public LibraryTest {
+  protected:
+    TrackSearchIndexTest()
+            : m_columnCache(kColumns),
+              m_index(m_columnCache),
+              m_parser(internalCollection(),
+                      {LIBRARYTABLE_ARTIST, LIBRARYTABLE_TITLE}) {
+    }
+
+    void updateTrack(int id,
+            const QString& artist,
+            const QString& title,
+            const QVariant& bpm = QVariant(),
+            const QVariant& year = QVariant()) {
+        QVector<QVariant> record(kColumns.size());
+        record[m_columnCache.fieldIndex(LIBRARYTABLE_ID)] = id;
+        record[m_columnCache.fieldIndex(LIBRARYTABLE_ARTIST)] = artist;
+        record[m_columnCache.fieldIndex(LIBRARYTABLE_TITLE)] = title;
+        record[m_columnCache.fieldIndex(LIBRARYTABLE_BPM)] = bpm;
+        record[m_columnCache.fieldIndex(LIBRARYTABLE_YEAR)] = year;
+        m_index.updateTrack(TrackId(id), record);
+    }
+
+    /// Returns std::nullopt if the query is not supported by the index
+    std::optional<QSet<TrackId>> search(
+            const QString& query, const QString& extraFilter = QString()) {
+        const auto pQuery = m_parser.parseQuery(query, extraFilter);
+        std::vector<uint8_t> matches;
+        if (!m_index.match(*pQuery, &matches)) {
+            return std::nullopt;
+        }
+        EXPECT_EQ(static_cast<size_t>(m_index.rowCount()), matches.size());
+        QSet<TrackId> trackIds;
+        for (int row = 0; row < m_index.rowCount(); ++row) {
+            if (matches[row]) {
+                trackIds.insert(m_index.trackIdAt(row));
+            }
+        }
+        return trackIds;
+    }
+
+    static QSet<TrackId> trackIds(std::initializer_list<int> ids) {
+        QSet<TrackId> result;
+        for (int id : ids) {
+            result.insert(TrackId(id));
+        }
+        return result;
+    }
+
+    const ColumnCache m_columnCache;
+    TrackSearchIndex m_index;
+    SearchQueryParser m_parser;
+};
+
+TEST_F(TrackSearchIndexTest, MatchText) {
+    updateTrack(1, QStringLiteral("Beyoncé"), QStringLiteral("Halo"));
+    updateTrack(2, QStringLiteral("Other Artist"), QStringLiteral("Beyond"));
+    updateTrack(3, QString(), QStringLiteral("Untitled"));
+
+    EXPECT_EQ(trackIds({1, 2, 3}), search(QString()));
+    // Case- and accent-insensitive like the LIKE operator
+    EXPECT_EQ(trackIds({1}), search(QStringLiteral("BEYONCE")));
+    EXPECT_EQ(trackIds({1, 2}), search(QStringLiteral("beyo")));
+    EXPECT_EQ(trackIds({1}), search(QStringLiteral("beyo halo")));
+    EXPECT_EQ(trackIds({1, 3}), search(QStringLiteral("halo | untitled")));
+    // NOT (NULL OR FALSE) is NULL in SQL, i.e. the track without an
+    // artist does not match
+    EXPECT_EQ(trackIds({2}), search(QStringLiteral("-halo")));
+    EXPECT_EQ(trackIds({2}), search(QStringLiteral("title:=beyond")));
+    EXPECT_EQ(trackIds(), search(QStringLiteral("title:=beyon")));
+    EXPECT_EQ(trackIds({3}), search(QStringLiteral("artist:\"\"")));
+}
+
+TEST_F(TrackSearchIndexTest, MatchNumeric) {
+    updateTrack(1, QStringLiteral("A"), QStringLiteral("A"), 120.0, QStringLiteral("2005-03-01"));
+    updateTrack(2, QStringLiteral("B"), QStringLiteral("B"), 128.5, QStringLiteral("1999"));
+    updateTrack(3, QStringLiteral("C"), QStringLiteral("C"));
+
+    EXPECT_EQ(trackIds({2}), search(QStringLiteral("bpm:>120")));
+    EXPECT_EQ(trackIds({1, 2}), search(QStringLiteral("bpm:>=120")));
+    EXPECT_EQ(trackIds({2}), search(QStringLiteral("bpm:128.5")));
+    EXPECT_EQ(trackIds({1, 2}), search(QStringLiteral("bpm:100-130")));
+    EXPECT_EQ(trackIds({3}), search(QStringLiteral("bpm:\"\"")));
+    // Tracks without a value never match a negated comparison in SQL
+    EXPECT_EQ(trackIds({1}), search(QStringLiteral("-bpm:>120")));
+    EXPECT_EQ(trackIds({1}), search(QStringLiteral("year:2000-2010")));
+    EXPECT_EQ(trackIds({2}), search(QStringLiteral("year:<2000")));
+    EXPECT_EQ(trackIds({3}), search(QStringLiteral("year:\"\"")));
+}
+
+TEST_F(TrackSearchIndexTest, FallbackToSql) {
+    updateTrack(1, QStringLiteral("A"), QStringLiteral("A"));
+
+    // LIKE wildcards
+    EXPECT_FALSE(search(QStringLiteral("a%b")));
+    EXPECT_FALSE(search(QStringLiteral("a_b")));
+    // Columns that are not indexed
+    EXPECT_FALSE(search(QStringLiteral("genre:house")));
+    EXPECT_FALSE(search(QStringLiteral("track:1")));
+    // SQL expressions
+    EXPECT_FALSE(search(QStringLiteral("a"), QStringLiteral("mixxx_deleted=0")));
+}
+
+TEST_F(TrackSearchIndexTest, UpdateAndRemoveTracks) {
+    updateTrack(1, QStringLiteral("Artist"), QStringLiteral("Before"));
+    updateTrack(2, QStringLiteral("Artist"), QStringLiteral("Other"));
+    EXPECT_EQ(trackIds({1}), search(QStringLiteral("before")));
+
+    updateTrack(1, QStringLiteral("Artist"), QStringLiteral("After"));
+    EXPECT_EQ(trackIds(), search(QStringLiteral("before")));
+    EXPECT_EQ(trackIds({1}), search(QStringLiteral("after")));
+    EXPECT_EQ(trackIds({1, 2}), search(QStringLiteral("artist")));
+
+    m_index.removeTrack(TrackId(1));
+    EXPECT_EQ(-1, m_index.rowOf(TrackId(1)));
+    EXPECT_EQ(trackIds({2}), search(QStringLiteral("artist")));
+
+    // Removed rows are dropped eventually
+    for (int i = 0; i < 10000; ++i) {
+        updateTrack(2, QStringLiteral("Artist"), QString::number(i));
+    }
+    EXPECT_GT(5000, m_index.rowCount());
+    EXPECT_EQ(trackIds({2}), search(QStringLiteral("9999")));
+    EXPECT_EQ(trackIds(), search(QStringLiteral("9998")));
+}
+
+TEST_F(TrackSearchIndexTest, MatchPartitions) {
+    constexpr int kTrackCount = 100000;
+    QSet<TrackId> expectedTrackIds;
+    for (int id = 1; id <= kTrackCount; ++id) {
+        const QString title = QString::number(id);
+        updateTrack(id, QStringLiteral("Artist"), title);
+        if (title.contains(QStringLiteral("77"))) {
+            expectedTrackIds.insert(TrackId(id));
+        }
+    }
+    EXPECT_EQ(expectedTrackIds, search(QStringLiteral("77")));
+    EXPECT_EQ(trackIds(), search(QStringLiteral("-artist")));
+}
+
+} // namespace
@@ -0,0 +1,124 @@
+#include "waveform/waveformpyramid.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "util/math.h"
+
+namespace {
+
+constexpr int kSampleRate = 44100;
+constexpr int kVisualSampleRate = 441;
+
+class WaveformPyramidTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        // 10 minutes of audio results in multiple levels and blocks
+        m_pWaveform = std::make_unique<Waveform>(
+                kSampleRate, 10 * 60 * kSampleRate, kVisualSampleRate, -1);
+        WaveformData* pData = m_pWaveform->data();
+        for (int i = 0; i < m_pWaveform->getDataSize(); ++i) {
+            pData[i].filtered.low = static_cast<unsigned char>(i % 251);
+            pData[i].filtered.mid = static_cast<unsigned char>((i / 7) % 256);
+            pData[i].filtered.high = static_cast<unsigned char>((i * 13) % 256);
+            pData[i].filtered.all = static_cast<unsigned char>(i % 2 ? 255 - i % 100 : i % 100);
+        }
+        m_pWaveform->setCompletion(m_pWaveform->getDataSize());
+    }
+
+    std::unique_ptr<Waveform> m_pWaveform;
+};
+
+TEST_F(WaveformPyramidTest, Level0MatchesWaveform) {
+    const auto pPyramid = WaveformPyramid::fromByteArray(
+            WaveformPyramid::encode(*m_pWaveform));
+    ASSERT_TRUE(pPyramid);
+    EXPECT_GT(pPyramid->levelCount(), 1);
+    EXPECT_EQ(m_pWaveform->getVisualSampleRate(), pPyramid->getVisualSampleRate());
+    EXPECT_EQ(m_pWaveform->getAudioVisualRatio(), pPyramid->getAudioVisualRatio());
+
+    const Waveform loaded(pPyramid);
+    ASSERT_EQ(m_pWaveform->getDataSize(), loaded.getDataSize());
+    EXPECT_EQ(loaded.getDataSize(), loaded.getCompletion());
+    for (int i = 0; i < loaded.getDataSize(); ++i) {
+        ASSERT_EQ(m_pWaveform->get(i).m_i, loaded.get(i).m_i) << i;
+    }
+}
+
+TEST_F(WaveformPyramidTest, ReducedLevelsContainMaxima) {
+    const auto pPyramid = WaveformPyramid::fromByteArray(
+            WaveformPyramid::encode(*m_pWaveform));
+    ASSERT_TRUE(pPyramid);
+    const int level = 2;
+    ASSERT_LT(level, pPyramid->levelCount());
+    const int frameCount = pPyramid->levelFrameCount(level);
+    EXPECT_EQ((pPyramid->levelFrameCount(0) + 3) / 4, frameCount);
+
+    // Read a range that crosses a block boundary
+    const int firstFrame = 4000;
+    const int readFrames = 200;
+    ASSERT_LE(firstFrame + readFrames, frameCount);
+    std::vector<WaveformData> levelData(readFrames * WaveformPyramid::kDataPerFrame);
+    ASSERT_TRUE(pPyramid->readFrames(level, firstFrame, readFrames, levelData.data()));
+    for (int frame = 0; frame < readFrames; ++frame) {
+        for (int chn = 0; chn < WaveformPyramid::kDataPerFrame; ++chn) {
+            unsigned char maxAll = 0;
+            unsigned char maxLow = 0;
+            for (int i = 0; i < 4; ++i) {
+                const int index = ((firstFrame + frame) * 4 + i) *
+                                WaveformPyramid::kDataPerFrame +
+                        chn;
+                maxAll = math_max(maxAll, m_pWaveform->getAll(index));
+                maxLow = math_max(maxLow, m_pWaveform->getLow(index));
+            }
+            const WaveformData& datum =
+                    levelData[frame * WaveformPyramid::kDataPerFrame + chn];
+            EXPECT_EQ(maxAll, datum.filtered.all);
+            EXPECT_EQ(maxLow, datum.filtered.low);
+        }
+    }
+}
+
+TEST_F(WaveformPyramidTest, LevelForFramesPerPixel) {
+    const auto pPyramid = WaveformPyramid::fromByteArray(
+            WaveformPyramid::encode(*m_pWaveform));
+    ASSERT_TRUE(pPyramid);
+    EXPECT_EQ(0, pPyramid->levelForFramesPerPixel(1.0));
+    EXPECT_EQ(0, pPyramid->levelForFramesPerPixel(3.9));
+    EXPECT_EQ(1, pPyramid->levelForFramesPerPixel(4.0));
+    EXPECT_EQ(2, pPyramid->levelForFramesPerPixel(8.0));
+    EXPECT_EQ(pPyramid->levelCount() - 1, pPyramid->levelForFramesPerPixel(1e9));
+}
+
+TEST_F(WaveformPyramidTest, OpenMappedFile) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString filePath = tempDir.filePath(QStringLiteral("1.pyramid"));
+    QFile file(filePath);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    const QByteArray data = WaveformPyramid::encode(*m_pWaveform);
+    ASSERT_EQ(data.size(), file.write(data));
+    file.close();
+
+    const auto pPyramid = WaveformPyramid::open(filePath);
+    ASSERT_TRUE(pPyramid);
+    const Waveform loaded(pPyramid);
+    ASSERT_EQ(m_pWaveform->getDataSize(), loaded.getDataSize());
+    EXPECT_EQ(m_pWaveform->get(12345).m_i, loaded.get(12345).m_i);
+    // Level 0 is indexed in the mapped file instead of being copied
+    ASSERT_TRUE(pPyramid->levelData(0));
+    EXPECT_EQ(pPyramid->levelData(0), loaded.data());
+}
+
+TEST_F(WaveformPyramidTest, RejectInvalidData) {
+    EXPECT_FALSE(WaveformPyramid::fromByteArray(QByteArray()));
+    EXPECT_FALSE(WaveformPyramid::fromByteArray(QByteArray(100, 'x')));
+
+    QByteArray truncated = WaveformPyramid::encode(*m_pWaveform);
+    truncated.truncate(truncated.size() / 2);
+    EXPECT_FALSE(WaveformPyramid::fromByteArray(truncated));
+}
+
+} // namespace
@@ -0,0 +1,84 @@
+#include "util/backgroundthread.h"
+
+#include <QThread>
+#include <atomic>
+
+#include "util/logger.h"
+
+#ifdef __LINUX__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const mixxx::Logger kLogger("BackgroundThread");
+
+// -1 while no audio callback has been running yet
+std::atomic<int> s_audioCallbackCpu(-1);
+
+#ifdef __LINUX__
+constexpr int kBackgroundNiceValue = 19;
+#endif
+
+} // anonymous namespace
+
+namespace mixxx {
+
+void setAudioCallbackCpu() {
+#ifdef __LINUX__
+    // sched_getcpu() is implemented in the vDSO and does not
+    // enter the kernel
+    s_audioCallbackCpu.store(sched_getcpu(), std::memory_order_relaxed);
+#endif
+}
+
+void setCurrentThreadBackgroundScheduling() {
+#ifdef __LINUX__
+    sched_param param{};
+    param.sched_priority = 0;
+    // SCHED_BATCH might be blocked, e.g. by a seccomp filter of a sandbox.
+    // The nice value is sufficient in this case.
+    pthread_setschedparam(pthread_self(), SCHED_BATCH, &param);
+    // The nice value is a per thread attribute on Linux
+    const auto tid = static_cast<id_t>(syscall(SYS_gettid));
+    if (setpriority(PRIO_PROCESS, tid, kBackgroundNiceValue) != 0) {
+        kLogger.warning()
+                << "Failed to lower the scheduling priority of thread"
+                << QThread::currentThread()->objectName();
+    }
+#else
+    QThread::currentThread()->setPriority(QThread::LowestPriority);
+#endif
+}
+
+void avoidAudioCallbackCpu() {
+#ifdef __LINUX__
+    const int audioCallbackCpu = s_audioCallbackCpu.load(std::memory_order_relaxed);
+    if (audioCallbackCpu < 0 || audioCallbackCpu >= CPU_SETSIZE) {
+        return;
+    }
+    // The affinity of the main thread, whose id equals the process id,
+    // contains all cores of the cpuset and has not been restricted by
+    // previous invocations.
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (sched_getaffinity(getpid(), sizeof(cpuSet), &cpuSet) != 0) {
+        return;
+    }
+    if (CPU_COUNT(&cpuSet) > 1) {
+        CPU_CLR(audioCallbackCpu, &cpuSet);
+    }
+    // A pid of 0 refers to the calling thread
+    if (sched_setaffinity(0, sizeof(cpuSet), &cpuSet) != 0) {
+        kLogger.debug()
+                << "Failed to set the CPU affinity of thread"
+                << QThread::currentThread()->objectName();
+    }
+#endif
+}
+
+} // namespace mixxx
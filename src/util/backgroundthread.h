@@ -0,0 +1,30 @@
+#pragma once
+
+/// Helpers for keeping CPU intensive background threads like the
+/// analyzer and the library scanner out of the way of the audio engine.
+namespace mixxx {
+
+/// Remembers the CPU core that is currently running the audio callback.
+/// Only invoked from the audio callback. Wait-free and cheap enough to be
+/// called on every callback.
+void setAudioCallbackCpu();
+
+/// Lowers the scheduling priority of the calling thread as far as possible
+/// without starving it. On Linux this is SCHED_BATCH with the highest nice
+/// value. Other platforms use QThread::LowestPriority.
+///
+/// SCHED_IDLE is not used on purpose. The analyzer and scanner threads hold
+/// locks, e.g. of the GlobalTrackCache, and database transactions. Threads
+/// with SCHED_IDLE would not get any CPU time while all cores are busy and
+/// then block the threads that are waiting for these locks.
+void setCurrentThreadBackgroundScheduling();
+
+/// Restricts the calling thread to all CPU cores that are available to
+/// the process except the one that has run the audio callback most
+/// recently. The available cores are taken from the affinity of the
+/// process, so restrictions from cgroups/cpusets are respected. Only
+/// supported on Linux and should be invoked again from time to time,
+/// because the audio thread may migrate between cores.
+void avoidAudioCallbackCpu();
+
+} // namespace mixxx
@@ -19,7 +19,9 @@
 #include "util/assert.h"
 
 CmdlineArgs::CmdlineArgs()
-        : m_startInFullscreen(false), // Initialize vars
+        : m_analyzeThreads(0),
+          m_reanalyze(false),
+          m_startInFullscreen(false), // Initialize vars
           m_startAutoDJ(false),
           m_controllerDebug(false),
           m_controllerAbortOnWarning(false),
@@ -306,6 +308,42 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
     parser.addOption(debugAssertBreak);
     parser.addOption(debugAssertBreakDeprecated);
 
+    const QCommandLineOption analyze(QStringLiteral("analyze"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "Analyzes tracks of the library without starting the "
+                                      "GUI or any audio devices and exits afterwards. <target> "
+                                      "is either 'all', 'crate:<name>' or the path of a file "
+                                      "or directory that is added to the library if needed. "
+                                      "Can be specified multiple times.")
+                            : QString(),
+            QStringLiteral("target"));
+    parser.addOption(analyze);
+
+    const QCommandLineOption analyzeThreads(QStringLiteral("analyze-threads"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "Number of tracks that are analyzed concurrently with "
+                                      "--analyze. Default is the number of CPU cores.")
+                            : QString(),
+            QStringLiteral("count"));
+    parser.addOption(analyzeThreads);
+
+    const QCommandLineOption analyzers(QStringLiteral("analyzers"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "Comma-separated list of the analyzers that are run with "
+                                      "--analyze: beats, key, replaygain, waveform. Default "
+                                      "are the analyzers that are enabled in the preferences.")
+                            : QString(),
+            QStringLiteral("list"));
+    parser.addOption(analyzers);
+
+    const QCommandLineOption reanalyze(QStringLiteral("reanalyze"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "Analyzes the tracks with --analyze again, even if they "
+                                      "have already been analyzed. The existing results are "
+                                      "replaced.")
+                            : QString());
+    parser.addOption(reanalyze);
+
     const QCommandLineOption helpOption = parser.addHelpOption();
     const QCommandLineOption versionOption = parser.addVersionOption();
 
@@ -393,6 +431,28 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
 
     m_musicFiles = parser.positionalArguments();
 
+    m_analyzeTargets = parser.values(analyze);
+    if (parser.isSet(analyzeThreads)) {
+        bool ok = false;
+        m_analyzeThreads = parser.value(analyzeThreads).toInt(&ok);
+        if (!ok || m_analyzeThreads < 1) {
+            fputs("\nanalyze-threads must be a positive number!\n"
+                  "Mixxx will use the number of CPU cores instead.\n",
+                    stdout);
+            // The default
+            m_analyzeThreads = 0;
+        }
+    }
+    if (parser.isSet(analyzers)) {
+        m_analyzers = parser.value(analyzers).split(QChar(','),
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+                Qt::SkipEmptyParts);
+#else
+                QString::SkipEmptyParts);
+#endif
+    }
+    m_reanalyze = parser.isSet(reanalyze);
+
     if (parser.isSet(logLevel)) {
         if (!parseLogLevel(parser.value(logLevel), &m_logLevel)) {
             fputs("\nlog-level wasn't 'trace', 'debug', 'info', 'warning', or 'critical'!\n"
@@ -4,6 +4,7 @@
 #include <QDir>
 #include <QList>
 #include <QString>
+#include <QStringList>
 
 #include "util/logging.h"
 
@@ -68,6 +69,30 @@ class CmdlineArgs final {
     const QString& getResourcePath() const { return m_resourcePath; }
     const QString& getTimelinePath() const { return m_timelinePath; }
 
+    /// Analyze the given tracks without starting the GUI and exit, see
+    /// BatchAnalysis. Each target is either "all", "crate:<name>" or the
+    /// path of a file or directory.
+    bool isBatchAnalysis() const {
+        return !m_analyzeTargets.isEmpty();
+    }
+    const QStringList& getAnalyzeTargets() const {
+        return m_analyzeTargets;
+    }
+    /// The number of analyzer threads or 0 for the default
+    int getAnalyzeThreads() const {
+        return m_analyzeThreads;
+    }
+    /// The analyzers to run or empty for the analyzers that are enabled
+    /// in the preferences
+    const QStringList& getAnalyzers() const {
+        return m_analyzers;
+    }
+    /// Replace the results of tracks that have already been analyzed,
+    /// e.g. for benchmarking the analysis repeatedly
+    bool getReanalyze() const {
+        return m_reanalyze;
+    }
+
     void setScaleFactor(double scaleFactor) {
         m_scaleFactor = scaleFactor;
     }
@@ -84,6 +109,10 @@ class CmdlineArgs final {
     bool parse(const QStringList& arguments, ParseMode mode);
 
     QList<QString> m_musicFiles;    // List of files to load into players at startup
+    QStringList m_analyzeTargets;
+    int m_analyzeThreads;
+    QStringList m_analyzers;
+    bool m_reanalyze;
     bool m_startInFullscreen;       // Start in fullscreen mode
     bool m_startAutoDJ;
     bool m_controllerDebug;
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace mixxx {
+
+/// Collects the load of a periodic task, i.e. the fraction of its period
+/// that has been used for processing, for estimating high percentiles.
+///
+/// The values are counted in bins with a fixed resolution. Adding a value
+/// takes constant time and never allocates, so it is safe to use in the
+/// audio callback.
+class LoadHistogram {
+  public:
+    /// The resolution of the estimated percentiles
+    static constexpr int kBinsPerUnit = 100;
+    /// Larger values are counted in the last bin
+    static constexpr int kMaxLoad = 2;
+
+    LoadHistogram() {
+        reset();
+    }
+
+    void add(double load) {
+        const int bin = std::clamp(
+                static_cast<int>(load * kBinsPerUnit), 0, kBinCount - 1);
+        ++m_bins[bin];
+        ++m_count;
+    }
+
+    int count() const {
+        return m_count;
+    }
+
+    /// Returns the upper bound of the bin that contains the given
+    /// percentile, e.g. 0.99 for the 99th percentile, or 0 if no
+    /// values have been added.
+    double percentile(double fraction) const {
+        if (m_count == 0) {
+            return 0.0;
+        }
+        const int rank = std::max(1,
+                static_cast<int>(std::ceil(fraction * m_count)));
+        int accumulatedCount = 0;
+        for (int bin = 0; bin < kBinCount; ++bin) {
+            accumulatedCount += m_bins[bin];
+            if (accumulatedCount >= rank) {
+                return static_cast<double>(bin + 1) / kBinsPerUnit;
+            }
+        }
+        return kMaxLoad;
+    }
+
+    void reset() {
+        m_bins.fill(0);
+        m_count = 0;
+    }
+
+  private:
+    static constexpr int kBinCount = kBinsPerUnit * kMaxLoad;
+
+    std::array<int, kBinCount> m_bins;
+    int m_count;
+};
+
+} // namespace mixxx
@@ -29,6 +29,77 @@ constexpr size_t kAlignment = 32;
 constexpr size_t kAlignment = 16;
 #endif
 
+struct ConvertScaledS32 {
+    CSAMPLE operator()(qint32 sample) const {
+        return CSAMPLE(sample) * scale;
+    }
+    const CSAMPLE scale;
+};
+
+struct ConvertSN {
+    CSAMPLE operator()(qint32 sample) const {
+        // Shifting the significant bits into the upper bits discards
+        // the unused bits and extends the sign
+        const auto upscaledSample = static_cast<qint32>(
+                static_cast<quint32>(sample) << upscaleShift);
+        return CSAMPLE(upscaledSample) / 2147483648.0f; // 2^31
+    }
+    const int upscaleShift;
+};
+
+struct CopyFloat32 {
+    CSAMPLE operator()(CSAMPLE sample) const {
+        return sample;
+    }
+};
+
+// Converts planar samples into interleaved CSAMPLEs and remaps the
+// channels in a single pass. Decoders would otherwise need one pass for
+// converting and interleaving and AudioSourceStereoProxy another one
+// for remapping the channels.
+template<typename T, typename Convert>
+void convertPlanarToInterleaved(CSAMPLE* M_RESTRICT pDest,
+        mixxx::audio::ChannelCount destChannelCount,
+        const T* const* pSrc,
+        mixxx::audio::ChannelCount srcChannelCount,
+        SINT numFrames,
+        Convert convert) {
+    if (srcChannelCount == mixxx::audio::ChannelCount::mono() &&
+            destChannelCount == mixxx::audio::ChannelCount::stereo()) {
+        const T* M_RESTRICT pSrc0 = pSrc[0];
+        for (SINT i = 0; i < numFrames; ++i) {
+            const CSAMPLE sample = convert(pSrc0[i]);
+            pDest[i * 2] = sample;
+            pDest[i * 2 + 1] = sample;
+        }
+        return;
+    }
+    DEBUG_ASSERT(destChannelCount <= srcChannelCount);
+    if (destChannelCount == mixxx::audio::ChannelCount::mono()) {
+        const T* M_RESTRICT pSrc0 = pSrc[0];
+        for (SINT i = 0; i < numFrames; ++i) {
+            pDest[i] = convert(pSrc0[i]);
+        }
+    } else if (destChannelCount == mixxx::audio::ChannelCount::stereo()) {
+        const T* M_RESTRICT pSrc0 = pSrc[0];
+        const T* M_RESTRICT pSrc1 = pSrc[1];
+        for (SINT i = 0; i < numFrames; ++i) {
+            pDest[i * 2] = convert(pSrc0[i]);
+            pDest[i * 2 + 1] = convert(pSrc1[i]);
+        }
+    } else {
+        // Generic version for multi-channel signals, one channel after
+        // the other
+        const SINT numChannels = destChannelCount;
+        for (SINT j = 0; j < numChannels; ++j) {
+            const T* M_RESTRICT pSrcChannel = pSrc[j];
+            for (SINT i = 0; i < numFrames; ++i) {
+                pDest[i * numChannels + j] = convert(pSrcChannel[i]);
+            }
+        }
+    }
+}
+
 // TODO() Check if uintptr_t is available on all our build targets and use that
 // instead of size_t, we can remove the sizeof(size_t) check than
 constexpr bool useAlignedAlloc() {
@@ -398,6 +469,89 @@ void SampleUtil::convertS16ToFloat32(CSAMPLE* M_RESTRICT pDest,
     }
 }
 
+// static
+void SampleUtil::convertS24LEToFloat32(CSAMPLE* M_RESTRICT pDest,
+        const quint8* M_RESTRICT pSrc, SINT numSamples) {
+    // The samples are shifted into the upper 24 bits of a 32-bit integer
+    // to extend the sign. All 24-bit values are exactly representable.
+    const CSAMPLE kConversionFactor = 2147483648.0f; // 2^31
+    for (SINT i = 0; i < numSamples; ++i) {
+        const quint32 sample =
+                (static_cast<quint32>(pSrc[3 * i]) << 8) |
+                (static_cast<quint32>(pSrc[3 * i + 1]) << 16) |
+                (static_cast<quint32>(pSrc[3 * i + 2]) << 24);
+        pDest[i] = CSAMPLE(static_cast<qint32>(sample)) / kConversionFactor;
+    }
+}
+
+// static
+void SampleUtil::convertS32ToFloat32(CSAMPLE* M_RESTRICT pDest,
+        const qint32* M_RESTRICT pSrc, SINT numSamples) {
+    const CSAMPLE kConversionFactor = 2147483648.0f; // 2^31
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples; ++i) {
+        pDest[i] = CSAMPLE(pSrc[i]) / kConversionFactor;
+    }
+}
+
+// static
+void SampleUtil::convertScaledS32ToFloat32InPlace(CSAMPLE* pBuffer,
+        SINT numSamples, CSAMPLE scale) {
+    static_assert(sizeof(CSAMPLE) == sizeof(qint32));
+    // The integers are accessed with memcpy to avoid breaking the strict
+    // aliasing rules.
+    for (SINT i = 0; i < numSamples; ++i) {
+        qint32 sample;
+        std::memcpy(&sample, &pBuffer[i], sizeof(sample));
+        pBuffer[i] = CSAMPLE(sample) * scale;
+    }
+}
+
+// static
+void SampleUtil::convertPlanarS32ToFloat32(CSAMPLE* pDest,
+        mixxx::audio::ChannelCount destChannelCount,
+        const qint32* const* pSrc,
+        mixxx::audio::ChannelCount srcChannelCount,
+        SINT numFrames,
+        CSAMPLE scale) {
+    convertPlanarToInterleaved(pDest,
+            destChannelCount,
+            pSrc,
+            srcChannelCount,
+            numFrames,
+            ConvertScaledS32{scale});
+}
+
+// static
+void SampleUtil::convertPlanarSNToFloat32(CSAMPLE* pDest,
+        mixxx::audio::ChannelCount destChannelCount,
+        const qint32* const* pSrc,
+        mixxx::audio::ChannelCount srcChannelCount,
+        SINT numFrames,
+        int bitsPerSample) {
+    DEBUG_ASSERT(bitsPerSample > 0 && bitsPerSample <= 32);
+    convertPlanarToInterleaved(pDest,
+            destChannelCount,
+            pSrc,
+            srcChannelCount,
+            numFrames,
+            ConvertSN{32 - bitsPerSample});
+}
+
+// static
+void SampleUtil::interleavePlanarBuffer(CSAMPLE* pDest,
+        mixxx::audio::ChannelCount destChannelCount,
+        const CSAMPLE* const* pSrc,
+        mixxx::audio::ChannelCount srcChannelCount,
+        SINT numFrames) {
+    convertPlanarToInterleaved(pDest,
+            destChannelCount,
+            pSrc,
+            srcChannelCount,
+            numFrames,
+            CopyFloat32{});
+}
+
 //static
 void SampleUtil::convertFloat32ToS16(SAMPLE* pDest, const CSAMPLE* pSrc,
         SINT numSamples) {
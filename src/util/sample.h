@@ -210,6 +210,49 @@ class SampleUtil {
     static void convertS16ToFloat32(CSAMPLE* pDest, const SAMPLE* pSrc,
             SINT numSamples);
 
+    // Convert and normalize a buffer of packed little-endian signed 24-bit
+    // integers, i.e. 3 bytes per sample, to a buffer of CSAMPLEs in the
+    // range [-1.0, 1.0].
+    static void convertS24LEToFloat32(CSAMPLE* pDest, const quint8* pSrc,
+            SINT numSamples);
+
+    // Convert and normalize a buffer of signed 32-bit integers to a buffer
+    // of CSAMPLEs in the range [-1.0, 1.0].
+    static void convertS32ToFloat32(CSAMPLE* pDest, const qint32* pSrc,
+            SINT numSamples);
+
+    // Convert a buffer that has been filled with signed 32-bit integers by
+    // a decoder into CSAMPLEs by multiplying each sample with the scale
+    // factor, e.g. 1 / 2^(bitsPerSample - 1) for samples that only use the
+    // lower bits or 1 / 2^fractionBits for fixed-point samples.
+    static void convertScaledS32ToFloat32InPlace(CSAMPLE* pBuffer,
+            SINT numSamples, CSAMPLE scale);
+
+    // Convert and interleave the planar signed 32-bit integers in pSrc with
+    // a separate buffer per channel into pDest, e.g. the output of decoders.
+    // Each sample is multiplied by the scale factor, see
+    // convertScaledS32ToFloat32InPlace(). The channels are remapped in the same
+    // pass: Either the channel counts match, or a mono signal is copied into
+    // both channels (mono -> stereo), or only the first destChannelCount
+    // channels are kept (e.g. multi -> stereo like AudioSourceStereoProxy).
+    static void convertPlanarS32ToFloat32(CSAMPLE* pDest,
+            mixxx::audio::ChannelCount destChannelCount,
+            const qint32* const* pSrc,
+            mixxx::audio::ChannelCount srcChannelCount,
+            SINT numFrames,
+            CSAMPLE scale);
+
+    // Same as convertPlanarS32ToFloat32() for signed integers that only
+    // occupy the lower bitsPerSample bits of each 32-bit word. Any garbage
+    // in the unused upper bits is discarded. The samples are normalized to
+    // the range [-1.0, 1.0).
+    static void convertPlanarSNToFloat32(CSAMPLE* pDest,
+            mixxx::audio::ChannelCount destChannelCount,
+            const qint32* const* pSrc,
+            mixxx::audio::ChannelCount srcChannelCount,
+            SINT numFrames,
+            int bitsPerSample);
+
     // Convert and normalize a buffer of CSAMPLEs in the range [-1.0, 1.0]
     // to a buffer of SAMPLEs in the range [-SAMPLE_MAX, SAMPLE_MAX].
     static void convertFloat32ToS16(SAMPLE* pDest, const CSAMPLE* pSrc,
@@ -256,6 +299,15 @@ class SampleUtil {
             const CSAMPLE* pSrc8,
             SINT numFrames);
 
+    // Interleave the planar samples in pSrc with a separate buffer per
+    // channel into pDest. The channels are remapped like by
+    // convertPlanarS32ToFloat32().
+    static void interleavePlanarBuffer(CSAMPLE* pDest,
+            mixxx::audio::ChannelCount destChannelCount,
+            const CSAMPLE* const* pSrc,
+            mixxx::audio::ChannelCount srcChannelCount,
+            SINT numFrames);
+
     // Deinterleave the samples in pSrc alternately into pDest1 and
     // pDest2 (stereo). numFrames must be the number of samples in pDest1 and pDest2,
     // and pSrc must have at least numFrames*2 samples. Neither pDest1 or
@@ -1,10 +1,14 @@
 #include "waveform/renderers/allshader/waveformrendererrgb.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "track/track.h"
 #include "util/math.h"
 #include "waveform/renderers/allshader/matrixforwidgetgeometry.h"
 #include "waveform/renderers/waveformwidgetrenderer.h"
 #include "waveform/waveform.h"
+#include "waveform/waveformpyramid.h"
 
 namespace allshader {
 
@@ -39,7 +43,7 @@ void WaveformRendererRGB::paintGL() {
         return;
     }
 
-    const int dataSize = waveform->getDataSize();
+    int dataSize = waveform->getDataSize();
     if (dataSize <= 1) {
         return;
     }
@@ -54,15 +58,52 @@ void WaveformRendererRGB::paintGL() {
 
     // See waveformrenderersimple.cpp for a detailed explanation of the frame and index calculation
     const int visualFramesSize = dataSize / 2;
-    const double firstVisualFrame =
+    double firstVisualFrame =
             m_waveformRenderer->getFirstDisplayedPosition() * visualFramesSize;
-    const double lastVisualFrame =
+    double lastVisualFrame =
             m_waveformRenderer->getLastDisplayedPosition() * visualFramesSize;
 
     // Represents the # of visual frames per horizontal pixel.
-    const double visualIncrementPerPixel =
+    double visualIncrementPerPixel =
             (lastVisualFrame - firstVisualFrame) / static_cast<double>(length);
 
+    // When zoomed out, many visual frames are reduced to each pixel. Read
+    // only the visible frames from a coarser level of the pyramid instead,
+    // which already contains the maxima.
+    int visualFrameOffset = 0;
+    if (const auto pPyramid = waveform->getPyramid()) {
+        const int level = pPyramid->levelForFramesPerPixel(visualIncrementPerPixel);
+        if (level > 0) {
+            const double scale = 1.0 / (1 << level);
+            const double levelIncrementPerPixel = visualIncrementPerPixel * scale;
+            const int levelFrameCount = pPyramid->levelFrameCount(level);
+            // Include the sampling range around the first and last pixel
+            const int windowStart = std::clamp(
+                    static_cast<int>(std::floor(
+                            firstVisualFrame * scale - 2 * levelIncrementPerPixel)),
+                    0,
+                    levelFrameCount);
+            const int windowEnd = std::clamp(
+                    static_cast<int>(std::ceil(
+                            lastVisualFrame * scale + 2 * levelIncrementPerPixel)),
+                    windowStart,
+                    levelFrameCount);
+            m_levelData.resize((windowEnd - windowStart) * WaveformPyramid::kDataPerFrame);
+            if (windowEnd - windowStart > 1 &&
+                    pPyramid->readFrames(level,
+                            windowStart,
+                            windowEnd - windowStart,
+                            m_levelData.data())) {
+                data = m_levelData.data();
+                dataSize = static_cast<int>(m_levelData.size());
+                visualFrameOffset = windowStart;
+                firstVisualFrame *= scale;
+                lastVisualFrame *= scale;
+                visualIncrementPerPixel = levelIncrementPerPixel;
+            }
+        }
+    }
+
     // Per-band gain from the EQ knobs.
     float allGain(1.0), lowGain(1.0), midGain(1.0), highGain(1.0);
     // applyCompensation = false, as we scale to match filtered.all
@@ -108,8 +149,10 @@ void WaveformRendererRGB::paintGL() {
     const double maxSamplingRange = visualIncrementPerPixel / 2.0;
 
     for (int pos = 0; pos < length; ++pos) {
-        const int visualFrameStart = std::lround(xVisualFrame - maxSamplingRange);
-        const int visualFrameStop = std::lround(xVisualFrame + maxSamplingRange);
+        const int visualFrameStart =
+                std::lround(xVisualFrame - maxSamplingRange) - visualFrameOffset;
+        const int visualFrameStop =
+                std::lround(xVisualFrame + maxSamplingRange) - visualFrameOffset;
 
         const int visualIndexStart = std::max(visualFrameStart * 2, 0);
         const int visualIndexStop =
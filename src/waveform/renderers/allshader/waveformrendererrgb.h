@@ -1,10 +1,13 @@
 #pragma once
 
+#include <vector>
+
 #include "shaders/rgbshader.h"
 #include "util/class.h"
 #include "waveform/renderers/allshader/rgbdata.h"
 #include "waveform/renderers/allshader/vertexdata.h"
 #include "waveform/renderers/allshader/waveformrenderersignalbase.h"
+#include "waveform/waveform.h"
 
 namespace allshader {
 class WaveformRendererRGB;
@@ -24,6 +27,8 @@ class allshader::WaveformRendererRGB final : public allshader::WaveformRendererS
     mixxx::RGBShader m_shader;
     VertexData m_vertices;
     RGBData m_colors;
+    // Visible part of a reduced level of the waveform pyramid
+    std::vector<WaveformData> m_levelData;
 
     DISALLOW_COPY_AND_ASSIGN(WaveformRendererRGB);
 };
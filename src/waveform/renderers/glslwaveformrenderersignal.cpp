@@ -122,8 +122,21 @@ bool GLSLWaveformRendererSignal::loadTexture() {
         int textureWidth = pWaveform->getTextureStride();
         int textureHeight = pWaveform->getTextureSize() / pWaveform->getTextureStride();
 
+        // Only the data is uploaded, the texture is not padded with data
+        // if the waveform is mapped from a pyramid. The shader doesn't
+        // access the remaining texels.
         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, textureWidth, textureHeight, 0,
-                     GL_RGBA, GL_UNSIGNED_BYTE, data);
+                     GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        const int fullRows = dataSize / textureWidth;
+        if (fullRows > 0) {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, textureWidth, fullRows,
+                    GL_RGBA, GL_UNSIGNED_BYTE, data);
+        }
+        const int lastRowWidth = dataSize % textureWidth;
+        if (lastRowWidth > 0) {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, fullRows, lastRowWidth, 1,
+                    GL_RGBA, GL_UNSIGNED_BYTE, data + fullRows * textureWidth);
+        }
         int error = glGetError();
         if (error) {
             qDebug() << "GLSLWaveformRendererSignal::loadTexture - glTexImage2D error" << error;
@@ -5,6 +5,8 @@
 #include "analyzer/constants.h"
 #include "engine/engine.h"
 #include "proto/waveform.pb.h"
+#include "util/assert.h"
+#include "waveform/waveformpyramid.h"
 
 using namespace mixxx::track;
 
@@ -22,6 +24,7 @@ Waveform::Waveform(const QByteArray& data)
         : m_id(-1),
           m_saveState(SaveState::NotSaved),
           m_dataSize(0),
+          m_pData(nullptr),
           m_visualSampleRate(0),
           m_audioVisualRatio(0),
           m_textureStride(computeTextureStride(0)),
@@ -29,6 +32,39 @@ Waveform::Waveform(const QByteArray& data)
     readByteArray(data);
 }
 
+Waveform::Waveform(std::shared_ptr<const WaveformPyramid> pPyramid)
+        : m_id(-1),
+          m_saveState(SaveState::NotSaved),
+          m_dataSize(0),
+          m_pData(nullptr),
+          m_visualSampleRate(0),
+          m_audioVisualRatio(0),
+          m_textureStride(computeTextureStride(0)),
+          m_completion(-1) {
+    VERIFY_OR_DEBUG_ASSERT(pPyramid && pPyramid->levelCount() > 0) {
+        return;
+    }
+    const int frameCount = pPyramid->levelFrameCount(0);
+    m_pData = pPyramid->levelData(0);
+    if (m_pData) {
+        m_dataSize = frameCount * WaveformPyramid::kDataPerFrame;
+        m_textureStride = computeTextureStride(m_dataSize);
+    } else {
+        // Only if the data is not aligned in memory
+        resize(frameCount * WaveformPyramid::kDataPerFrame);
+        if (!pPyramid->readFrames(0, 0, frameCount, &m_data[0])) {
+            qDebug() << "ERROR: Could not read Waveform from pyramid";
+            resize(0);
+            return;
+        }
+    }
+    m_visualSampleRate = pPyramid->getVisualSampleRate();
+    m_audioVisualRatio = pPyramid->getAudioVisualRatio();
+    m_completion = m_dataSize;
+    m_saveState = SaveState::Saved;
+    m_pPyramid = std::move(pPyramid);
+}
+
 Waveform::Waveform(
         int audioSampleRate,
         SINT frameLength,
@@ -37,6 +73,7 @@ Waveform::Waveform(
         : m_id(-1),
           m_saveState(SaveState::NotSaved),
           m_dataSize(0),
+          m_pData(nullptr),
           m_visualSampleRate(0),
           m_audioVisualRatio(0),
           m_textureStride(1024),
@@ -114,7 +151,7 @@ QByteArray Waveform::toByteArray() const {
 
     int dataSize = getDataSize();
     for (int i = 0; i < dataSize; ++i) {
-        const WaveformData& datum = m_data.at(i);
+        const WaveformData& datum = get(i);
         all->add_value(datum.filtered.all);
         low->add_value(datum.filtered.low);
         mid->add_value(datum.filtered.mid);
@@ -207,12 +244,14 @@ void Waveform::resize(int size) {
     m_dataSize = size;
     m_textureStride = computeTextureStride(size);
     m_data.resize(m_textureStride * m_textureStride);
+    m_pData = m_data.data();
 }
 
 void Waveform::assign(int size, int value) {
     m_dataSize = size;
     m_textureStride = computeTextureStride(size);
     m_data.assign(m_textureStride * m_textureStride, value);
+    m_pData = m_data.data();
     m_saveState = SaveState::SavePending;
 }
 
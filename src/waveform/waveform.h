@@ -5,15 +5,19 @@
 #include <QMutex>
 #include <QSharedPointer>
 #include <QString>
+#include <memory>
 #include <vector>
 
 #include "audio/signalinfo.h"
+#include "util/assert.h"
 #include "util/class.h"
 #include "util/compatibility/qmutex.h"
 
 enum FilterIndex { Low = 0, Mid = 1, High = 2, FilterCount = 3};
 enum ChannelIndex { Left = 0, Right = 1, ChannelCount = 2};
 
+class WaveformPyramid;
+
 union WaveformData {
     struct {
         unsigned char low;
@@ -36,6 +40,11 @@ class Waveform {
     };
 
     explicit Waveform(const QByteArray& pData = QByteArray());
+    /// Indexes level 0 of a stored pyramid in place, which avoids parsing
+    /// the protobuf and keeping a copy of the data on the heap. The
+    /// pyramid is kept for the data and for rendering zoomed out, see
+    /// getPyramid().
+    explicit Waveform(std::shared_ptr<const WaveformPyramid> pPyramid);
     Waveform(
             int audioSampleRate,
             SINT frameLength,
@@ -76,6 +85,23 @@ class Waveform {
 
     QByteArray toByteArray() const;
 
+    /// The stored multi-resolution representation of this waveform or
+    /// nullptr if it has not been stored yet.
+    std::shared_ptr<const WaveformPyramid> getPyramid() const {
+        const auto locker = lockMutex(&m_mutex);
+        return m_pPyramid;
+    }
+
+    // AnalysisDAO sets the pyramid when saving, like the save state. The
+    // pyramid of a waveform that is mapped from it must not be replaced.
+    void setPyramid(std::shared_ptr<const WaveformPyramid> pPyramid) const {
+        const auto locker = lockMutex(&m_mutex);
+        VERIFY_OR_DEBUG_ASSERT(m_pData == m_data.data()) {
+            return;
+        }
+        m_pPyramid = std::move(pPyramid);
+    }
+
     SaveState saveState() const {
         return m_saveState;
     }
@@ -105,28 +131,39 @@ class Waveform {
     // the constructor runs.
     inline int getTextureStride() const { return m_textureStride; }
 
-    // We do not lock the mutex since m_data is not resized after the
-    // constructor runs.
-    inline int getTextureSize() const { return static_cast<int>(m_data.size()); }
+    // We do not lock the mutex since m_textureStride is not changed after
+    // the constructor runs. Only the first getDataSize() elements are
+    // backed by data().
+    inline int getTextureSize() const { return m_textureStride * m_textureStride; }
 
     // Atomically get the number of data elements in this Waveform. We do not
     // lock the mutex since m_dataSize is not changed after the constructor
     // runs.
     inline int getDataSize() const { return m_dataSize; }
 
-    inline const WaveformData& get(int i) const { return m_data[i];}
-    inline unsigned char getLow(int i) const { return m_data[i].filtered.low;}
-    inline unsigned char getMid(int i) const { return m_data[i].filtered.mid;}
-    inline unsigned char getHigh(int i) const { return m_data[i].filtered.high;}
-    inline unsigned char getAll(int i) const { return m_data[i].filtered.all;}
+    // We do not lock the mutex since m_visualSampleRate is not changed
+    // after the constructor runs.
+    double getVisualSampleRate() const {
+        return m_visualSampleRate;
+    }
 
-    // We do not lock the mutex since m_data is not resized after the
-    // constructor runs.
-    WaveformData* data() { return &m_data[0];}
+    inline const WaveformData& get(int i) const { return m_pData[i];}
+    inline unsigned char getLow(int i) const { return m_pData[i].filtered.low;}
+    inline unsigned char getMid(int i) const { return m_pData[i].filtered.mid;}
+    inline unsigned char getHigh(int i) const { return m_pData[i].filtered.high;}
+    inline unsigned char getAll(int i) const { return m_pData[i].filtered.all;}
 
     // We do not lock the mutex since m_data is not resized after the
+    // constructor runs. Waveforms that are mapped from a pyramid are
+    // read-only.
+    WaveformData* data() {
+        DEBUG_ASSERT(m_data.empty() || m_pData == m_data.data());
+        return &m_data[0];
+    }
+
+    // We do not lock the mutex since m_pData is not changed after the
     // constructor runs.
-    const WaveformData* data() const { return &m_data[0];}
+    const WaveformData* data() const { return m_pData;}
 
     void dump() const;
 
@@ -140,7 +177,6 @@ class Waveform {
     inline unsigned char& mid(int i) { return m_data[i].filtered.mid;}
     inline unsigned char& high(int i) { return m_data[i].filtered.high;}
     inline unsigned char& all(int i) { return m_data[i].filtered.all;}
-    double getVisualSampleRate() const { return m_visualSampleRate; }
 
     // If stored in the database, the ID of the waveform.
     int m_id;
@@ -160,6 +196,9 @@ class Waveform {
     // TODO(XXX): In the future we should switch to QVector and use the raw data
     // pointer when performance matters.
     std::vector<WaveformData> m_data;
+    // Points either to m_data or to level 0 of m_pPyramid. Not allowed to
+    // change after the constructor runs.
+    const WaveformData* m_pData;
     // Not allowed to change after the constructor runs.
     double m_visualSampleRate;
     // Not allowed to change after the constructor runs.
@@ -173,6 +212,9 @@ class Waveform {
     // the mutex. The completion of the waveform calculation.
     QAtomicInt m_completion;
 
+    // mutable since AnalysisDAO attaches the pyramid when saving.
+    mutable std::shared_ptr<const WaveformPyramid> m_pPyramid;
+
     mutable QMutex m_mutex;
 
     DISALLOW_COPY_AND_ASSIGN(Waveform);
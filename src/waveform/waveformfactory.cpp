@@ -1,10 +1,13 @@
 #include "waveform/waveformfactory.h"
 #include "waveform/waveform.h"
+#include "waveform/waveformpyramid.h"
 
 // static
 Waveform* WaveformFactory::loadWaveformFromAnalysis(
         const AnalysisDao::AnalysisInfo& analysis) {
-    Waveform* pWaveform = new Waveform(analysis.data);
+    Waveform* pWaveform = analysis.pWaveformPyramid
+            ? new Waveform(analysis.pWaveformPyramid)
+            : new Waveform(analysis.data);
     pWaveform->setId(analysis.analysisId);
     pWaveform->setVersion(analysis.version);
     pWaveform->setDescription(analysis.description);
@@ -0,0 +1,376 @@
+#include "waveform/waveformpyramid.h"
+
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+#include "util/assert.h"
+#include "util/logger.h"
+#include "util/math.h"
+
+namespace {
+
+const mixxx::Logger kLogger("WaveformPyramid");
+
+constexpr char kMagic[4] = {'M', 'X', 'W', 'P'};
+constexpr quint32 kFormatVersion = 2;
+
+// 32 KiB of raw data per block. Large enough for a good compression
+// ratio and small enough to decompress only what is visible.
+constexpr int kFramesPerBlock = 4096;
+constexpr int kFrameBytes = WaveformPyramid::kDataPerFrame * sizeof(WaveformData);
+
+// Levels are added until a level fits into a single block
+constexpr int kMinFramesPerLevel = kFramesPerBlock;
+
+// Decompressing is cheap compared to reading zlib data from disk, but
+// renderers repeatedly draw the same blocks while playing
+constexpr std::size_t kDecodedBlockCacheSize = 8;
+
+// Fastest zlib compression, the blocks are read much more often than
+// they are written
+constexpr int kCompressionLevel = 1;
+
+constexpr int kHeaderSize = 4 + 4 + 8 + 8 + 4 + 4 + 4 + 4;
+constexpr int kLevelEntrySize = 4 + 4;
+constexpr int kBlockEntrySize = 8 + 4 + 4;
+
+void appendUInt32(QByteArray* pData, quint32 value) {
+    uchar bytes[sizeof(value)];
+    qToLittleEndian(value, bytes);
+    pData->append(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+}
+
+void appendUInt64(QByteArray* pData, quint64 value) {
+    uchar bytes[sizeof(value)];
+    qToLittleEndian(value, bytes);
+    pData->append(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+}
+
+void appendDouble(QByteArray* pData, double value) {
+    quint64 bits;
+    static_assert(sizeof(bits) == sizeof(value));
+    std::memcpy(&bits, &value, sizeof(bits));
+    appendUInt64(pData, bits);
+}
+
+double readDouble(const uchar* pData) {
+    const quint64 bits = qFromLittleEndian<quint64>(pData);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/// Reduces a level by keeping the maximum of each pair of visual
+/// frames for both channels and all bands.
+std::vector<WaveformData> reduceLevel(const std::vector<WaveformData>& level) {
+    const int frameCount = static_cast<int>(level.size()) / WaveformPyramid::kDataPerFrame;
+    const int reducedFrameCount = (frameCount + 1) / 2;
+    std::vector<WaveformData> reduced(reducedFrameCount * WaveformPyramid::kDataPerFrame);
+    for (int frame = 0; frame < reducedFrameCount; ++frame) {
+        for (int chn = 0; chn < WaveformPyramid::kDataPerFrame; ++chn) {
+            const WaveformData& first =
+                    level[2 * frame * WaveformPyramid::kDataPerFrame + chn];
+            WaveformData& target = reduced[frame * WaveformPyramid::kDataPerFrame + chn];
+            target = first;
+            if (2 * frame + 1 >= frameCount) {
+                continue;
+            }
+            const WaveformData& second =
+                    level[(2 * frame + 1) * WaveformPyramid::kDataPerFrame + chn];
+            target.filtered.low = math_max(first.filtered.low, second.filtered.low);
+            target.filtered.mid = math_max(first.filtered.mid, second.filtered.mid);
+            target.filtered.high = math_max(first.filtered.high, second.filtered.high);
+            target.filtered.all = math_max(first.filtered.all, second.filtered.all);
+        }
+    }
+    return reduced;
+}
+
+} // anonymous namespace
+
+WaveformPyramid::WaveformPyramid()
+        : m_pData(nullptr),
+          m_size(0),
+          m_visualSampleRate(0),
+          m_audioVisualRatio(0),
+          m_framesPerBlock(0) {
+}
+
+WaveformPyramid::~WaveformPyramid() {
+    if (m_file.isOpen()) {
+        m_file.unmap(const_cast<uchar*>(m_pData));
+        m_file.close();
+    }
+}
+
+// static
+QByteArray WaveformPyramid::encode(const Waveform& waveform) {
+    const int frameCount = waveform.getDataSize() / kDataPerFrame;
+    if (frameCount <= 0) {
+        return QByteArray();
+    }
+
+    std::vector<std::vector<WaveformData>> levels;
+    levels.emplace_back(waveform.data(), waveform.data() + frameCount * kDataPerFrame);
+    while (static_cast<int>(levels.back().size()) / kDataPerFrame > kMinFramesPerLevel) {
+        levels.push_back(reduceLevel(levels.back()));
+    }
+
+    QByteArray blockData;
+    std::vector<Level> levelEntries;
+    std::vector<Block> blockEntries;
+    for (const auto& level : levels) {
+        const int levelFrameCount = static_cast<int>(level.size()) / kDataPerFrame;
+        levelEntries.push_back(Level{levelFrameCount,
+                static_cast<int>(blockEntries.size()),
+                nullptr});
+        for (int firstFrame = 0; firstFrame < levelFrameCount; firstFrame += kFramesPerBlock) {
+            const int blockFrames = math_min(kFramesPerBlock, levelFrameCount - firstFrame);
+            const QByteArray raw = QByteArray::fromRawData(
+                    reinterpret_cast<const char*>(&level[firstFrame * kDataPerFrame]),
+                    blockFrames * kFrameBytes);
+            if (levelEntries.size() == 1) {
+                // Level 0 is indexed in place
+                blockEntries.push_back(Block{blockData.size(), raw.size(), raw.size()});
+                blockData.append(raw);
+                continue;
+            }
+            const QByteArray compressed = qCompress(raw, kCompressionLevel);
+            // Blocks of silence compress well, noisy blocks might not
+            const QByteArray& stored = compressed.size() < raw.size() ? compressed : raw;
+            blockEntries.push_back(Block{blockData.size(), stored.size(), raw.size()});
+            blockData.append(stored);
+        }
+    }
+
+    const qint64 dataOffset = kHeaderSize +
+            kLevelEntrySize * static_cast<qint64>(levelEntries.size()) +
+            kBlockEntrySize * static_cast<qint64>(blockEntries.size());
+    QByteArray data;
+    data.reserve(static_cast<int>(dataOffset) + blockData.size());
+    data.append(kMagic, sizeof(kMagic));
+    appendUInt32(&data, kFormatVersion);
+    appendDouble(&data, waveform.getVisualSampleRate());
+    appendDouble(&data, waveform.getAudioVisualRatio());
+    appendUInt32(&data, static_cast<quint32>(levelEntries.size()));
+    appendUInt32(&data, kFramesPerBlock);
+    appendUInt32(&data, static_cast<quint32>(blockEntries.size()));
+    appendUInt32(&data, 0); // reserved
+    for (const auto& level : levelEntries) {
+        appendUInt32(&data, static_cast<quint32>(level.frameCount));
+        appendUInt32(&data, static_cast<quint32>(level.firstBlock));
+    }
+    for (const auto& block : blockEntries) {
+        appendUInt64(&data, static_cast<quint64>(dataOffset + block.offset));
+        appendUInt32(&data, static_cast<quint32>(block.storedSize));
+        appendUInt32(&data, static_cast<quint32>(block.rawSize));
+    }
+    DEBUG_ASSERT(data.size() == dataOffset);
+    data.append(blockData);
+    return data;
+}
+
+// static
+std::shared_ptr<const WaveformPyramid> WaveformPyramid::open(const QString& filePath) {
+    // The constructor is private
+    auto pPyramid = std::shared_ptr<WaveformPyramid>(new WaveformPyramid());
+    pPyramid->m_file.setFileName(filePath);
+    if (!pPyramid->m_file.open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+    const qint64 size = pPyramid->m_file.size();
+    const uchar* pData = pPyramid->m_file.map(0, size);
+    if (!pData) {
+        kLogger.warning() << "Failed to map" << filePath;
+        pPyramid->m_file.close();
+        return nullptr;
+    }
+    if (!pPyramid->parse(pData, size)) {
+        kLogger.warning() << "Invalid waveform pyramid" << filePath;
+        return nullptr;
+    }
+    return pPyramid;
+}
+
+// static
+std::shared_ptr<const WaveformPyramid> WaveformPyramid::fromByteArray(QByteArray data) {
+    auto pPyramid = std::shared_ptr<WaveformPyramid>(new WaveformPyramid());
+    pPyramid->m_ownedData = std::move(data);
+    if (!pPyramid->parse(
+                reinterpret_cast<const uchar*>(pPyramid->m_ownedData.constData()),
+                pPyramid->m_ownedData.size())) {
+        return nullptr;
+    }
+    return pPyramid;
+}
+
+bool WaveformPyramid::parse(const uchar* pData, qint64 size) {
+    m_pData = pData;
+    m_size = size;
+    if (size < kHeaderSize || std::memcmp(pData, kMagic, sizeof(kMagic)) != 0) {
+        return false;
+    }
+    if (qFromLittleEndian<quint32>(pData + 4) != kFormatVersion) {
+        return false;
+    }
+    m_visualSampleRate = readDouble(pData + 8);
+    m_audioVisualRatio = readDouble(pData + 16);
+    const quint32 levelCount = qFromLittleEndian<quint32>(pData + 24);
+    m_framesPerBlock = static_cast<int>(qFromLittleEndian<quint32>(pData + 28));
+    const quint32 blockCount = qFromLittleEndian<quint32>(pData + 32);
+    if (levelCount == 0 || m_framesPerBlock <= 0 ||
+            size < kHeaderSize + kLevelEntrySize * static_cast<qint64>(levelCount) +
+                            kBlockEntrySize * static_cast<qint64>(blockCount)) {
+        return false;
+    }
+
+    const uchar* pLevelEntry = pData + kHeaderSize;
+    m_levels.reserve(levelCount);
+    for (quint32 i = 0; i < levelCount; ++i) {
+        const auto frameCount = static_cast<int>(qFromLittleEndian<quint32>(pLevelEntry));
+        const auto firstBlock = static_cast<int>(qFromLittleEndian<quint32>(pLevelEntry + 4));
+        const int levelBlockCount = (frameCount + m_framesPerBlock - 1) / m_framesPerBlock;
+        if (frameCount < 0 || firstBlock < 0 ||
+                static_cast<qint64>(firstBlock) + levelBlockCount > blockCount) {
+            return false;
+        }
+        m_levels.push_back(Level{frameCount, firstBlock, nullptr});
+        pLevelEntry += kLevelEntrySize;
+    }
+
+    const uchar* pBlockEntry = pLevelEntry;
+    m_blocks.reserve(blockCount);
+    for (quint32 i = 0; i < blockCount; ++i) {
+        const auto offset = static_cast<qint64>(qFromLittleEndian<quint64>(pBlockEntry));
+        const auto storedSize = static_cast<int>(qFromLittleEndian<quint32>(pBlockEntry + 8));
+        const auto rawSize = static_cast<int>(qFromLittleEndian<quint32>(pBlockEntry + 12));
+        if (offset < 0 || storedSize < 0 || rawSize < 0 ||
+                rawSize > m_framesPerBlock * kFrameBytes ||
+                offset + storedSize > size) {
+            return false;
+        }
+        m_blocks.push_back(Block{offset, storedSize, rawSize});
+        pBlockEntry += kBlockEntrySize;
+    }
+
+    for (auto& level : m_levels) {
+        level.pData = mapLevel(level);
+    }
+    return true;
+}
+
+const WaveformData* WaveformPyramid::mapLevel(const Level& level) const {
+    if (level.frameCount == 0) {
+        return nullptr;
+    }
+    const qint64 offset = m_blocks[level.firstBlock].offset;
+    if ((reinterpret_cast<quintptr>(m_pData) + offset) % alignof(WaveformData) != 0) {
+        return nullptr;
+    }
+    // The blocks must be uncompressed and follow each other
+    qint64 nextOffset = offset;
+    const int blockCount = (level.frameCount + m_framesPerBlock - 1) / m_framesPerBlock;
+    for (int i = level.firstBlock; i < level.firstBlock + blockCount; ++i) {
+        const Block& block = m_blocks[i];
+        if (block.offset != nextOffset || block.storedSize != block.rawSize) {
+            return nullptr;
+        }
+        nextOffset += block.storedSize;
+    }
+    if (nextOffset - offset != static_cast<qint64>(level.frameCount) * kFrameBytes) {
+        return nullptr;
+    }
+    return reinterpret_cast<const WaveformData*>(m_pData + offset);
+}
+
+int WaveformPyramid::levelFrameCount(int level) const {
+    VERIFY_OR_DEBUG_ASSERT(level >= 0 && level < levelCount()) {
+        return 0;
+    }
+    return m_levels[level].frameCount;
+}
+
+const WaveformData* WaveformPyramid::levelData(int level) const {
+    VERIFY_OR_DEBUG_ASSERT(level >= 0 && level < levelCount()) {
+        return nullptr;
+    }
+    return m_levels[level].pData;
+}
+
+int WaveformPyramid::levelForFramesPerPixel(
+        double framesPerPixel, int minFramesPerPixel) const {
+    int level = 0;
+    while (level + 1 < levelCount() &&
+            framesPerPixel / (2 << level) >= minFramesPerPixel) {
+        ++level;
+    }
+    return level;
+}
+
+const QByteArray& WaveformPyramid::decodeBlock(int blockIndex) const {
+    for (auto it = m_decodedBlocks.begin(); it != m_decodedBlocks.end(); ++it) {
+        if (it->first == blockIndex) {
+            std::rotate(m_decodedBlocks.begin(), it, it + 1);
+            return m_decodedBlocks.front().second;
+        }
+    }
+
+    const Block& block = m_blocks[blockIndex];
+    const QByteArray stored = QByteArray::fromRawData(
+            reinterpret_cast<const char*>(m_pData + block.offset), block.storedSize);
+    QByteArray raw;
+    if (block.storedSize == block.rawSize) {
+        // Deep copy, the stored data might be unmapped
+        raw = QByteArray(stored.constData(), stored.size());
+    } else {
+        raw = qUncompress(stored);
+        if (raw.size() != block.rawSize) {
+            kLogger.warning() << "Corrupt block" << blockIndex;
+            raw = QByteArray(block.rawSize, '\0');
+        }
+    }
+
+    if (m_decodedBlocks.size() >= kDecodedBlockCacheSize) {
+        m_decodedBlocks.pop_back();
+    }
+    m_decodedBlocks.emplace(m_decodedBlocks.begin(), blockIndex, std::move(raw));
+    return m_decodedBlocks.front().second;
+}
+
+bool WaveformPyramid::readFrames(
+        int level, int firstFrame, int frameCount, WaveformData* pData) const {
+    VERIFY_OR_DEBUG_ASSERT(level >= 0 && level < levelCount()) {
+        return false;
+    }
+    const Level& levelEntry = m_levels[level];
+    VERIFY_OR_DEBUG_ASSERT(firstFrame >= 0 && frameCount >= 0 &&
+            firstFrame + frameCount <= levelEntry.frameCount) {
+        return false;
+    }
+
+    if (levelEntry.pData) {
+        std::memcpy(pData,
+                levelEntry.pData + firstFrame * kDataPerFrame,
+                frameCount * kFrameBytes);
+        return true;
+    }
+
+    const auto locker = lockMutex(&m_mutex);
+    int frame = firstFrame;
+    const int endFrame = firstFrame + frameCount;
+    while (frame < endFrame) {
+        const int blockInLevel = frame / m_framesPerBlock;
+        const int frameInBlock = frame % m_framesPerBlock;
+        const int framesToCopy = math_min(m_framesPerBlock - frameInBlock, endFrame - frame);
+        const QByteArray& raw = decodeBlock(levelEntry.firstBlock + blockInLevel);
+        if ((frameInBlock + framesToCopy) * kFrameBytes > raw.size()) {
+            return false;
+        }
+        std::memcpy(pData + (frame - firstFrame) * kDataPerFrame,
+                raw.constData() + frameInBlock * kFrameBytes,
+                framesToCopy * kFrameBytes);
+        frame += framesToCopy;
+    }
+    return true;
+}
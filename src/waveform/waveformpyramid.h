@@ -0,0 +1,125 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <memory>
+#include <vector>
+
+#include "waveform/waveform.h"
+
+/// Multi-resolution representation of a waveform with power-of-two
+/// reduction levels, i.e. a mipmap. Level 0 contains the data of the
+/// waveform and each following level contains half the visual frames
+/// of the previous level, keeping the maximum of each pair.
+///
+/// The pyramid is stored in a binary file that is memory-mapped for
+/// reading. The levels are split into blocks of a fixed number of
+/// visual frames. Level 0 is stored uncompressed and contiguously, so
+/// a Waveform can index it in place without a copy on the heap. The
+/// blocks of the reduced levels are compressed individually, so
+/// renderers only need to decompress the blocks of the level that fits
+/// the current zoom factor and that are visible.
+///
+/// File layout, all integers are little endian:
+///   Header:       "MXWP", version, visual sample rate, audio/visual
+///                 ratio, level count, frames per block, block count
+///   Level table:  frame count and first block index of each level
+///   Block table:  offset, stored size and raw size of each block
+///   Blocks:       zlib compressed (or uncompressed if stored size
+///                 equals raw size) visual frames, each consisting of
+///                 the interleaved WaveformData of both channels. The
+///                 blocks of level 0 are always uncompressed.
+///
+/// Reading is thread-safe.
+class WaveformPyramid final {
+  public:
+    /// The number of WaveformData per visual frame, i.e. one per channel.
+    static constexpr int kDataPerFrame = ChannelCount;
+
+    /// Encodes the completed waveform into the binary format. Returns
+    /// an empty byte array if the waveform is empty.
+    static QByteArray encode(const Waveform& waveform);
+
+    /// Memory-maps and validates a file. Returns nullptr on failure.
+    static std::shared_ptr<const WaveformPyramid> open(const QString& filePath);
+
+    /// Validates encoded data that is kept in memory.
+    static std::shared_ptr<const WaveformPyramid> fromByteArray(QByteArray data);
+
+    WaveformPyramid(const WaveformPyramid&) = delete;
+    WaveformPyramid& operator=(const WaveformPyramid&) = delete;
+    ~WaveformPyramid();
+
+    double getVisualSampleRate() const {
+        return m_visualSampleRate;
+    }
+    double getAudioVisualRatio() const {
+        return m_audioVisualRatio;
+    }
+
+    int levelCount() const {
+        return static_cast<int>(m_levels.size());
+    }
+    /// The number of visual frames of a level. Level n covers the
+    /// same duration as level 0 with 2^n visual frames per frame.
+    int levelFrameCount(int level) const;
+
+    /// Returns the coarsest level that still has at least minFramesPerPixel
+    /// visual frames per pixel, given the number of level 0 frames per pixel.
+    int levelForFramesPerPixel(double framesPerPixel, int minFramesPerPixel = 2) const;
+
+    /// The visual frames of a level that is stored uncompressed, directly
+    /// from the mapped file, or nullptr. The pointer is valid as long as
+    /// the pyramid exists. Available for level 0 unless the data is not
+    /// aligned in memory.
+    const WaveformData* levelData(int level) const;
+
+    /// Copies frameCount visual frames of a level starting at firstFrame
+    /// into pData, which must provide space for frameCount * kDataPerFrame
+    /// elements. Only the affected blocks are decompressed.
+    bool readFrames(int level, int firstFrame, int frameCount, WaveformData* pData) const;
+
+    /// The encoded data, e.g. for copying the file.
+    QByteArray toByteArray() const {
+        return QByteArray(reinterpret_cast<const char*>(m_pData), static_cast<int>(m_size));
+    }
+
+  private:
+    struct Level {
+        int frameCount;
+        int firstBlock;
+        // Only set if the level is stored uncompressed
+        const WaveformData* pData;
+    };
+    struct Block {
+        qint64 offset;
+        int storedSize;
+        int rawSize;
+    };
+
+    WaveformPyramid();
+
+    bool parse(const uchar* pData, qint64 size);
+    const WaveformData* mapLevel(const Level& level) const;
+    const QByteArray& decodeBlock(int blockIndex) const;
+
+    // Either the file is mapped or the data is owned
+    QFile m_file;
+    QByteArray m_ownedData;
+    const uchar* m_pData;
+    qint64 m_size;
+
+    double m_visualSampleRate;
+    double m_audioVisualRatio;
+    int m_framesPerBlock;
+    std::vector<Level> m_levels;
+    std::vector<Block> m_blocks;
+
+    // Most recently decoded blocks, the front is the newest
+    mutable QMutex m_mutex;
+    mutable std::vector<std::pair<int, QByteArray>> m_decodedBlocks;
+};
+
+typedef std::shared_ptr<const WaveformPyramid> ConstWaveformPyramidPointer;
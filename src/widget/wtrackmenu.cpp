@@ -32,6 +32,7 @@
 #include "preferences/colorpalettesettings.h"
 #include "preferences/configobject.h"
 #include "preferences/dialog/dlgprefdeck.h"
+#include "sources/soundsourcepool.h"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
 #include "util/defs.h"
@@ -1529,13 +1530,16 @@ void WTrackMenu::slotAnalyze() {
 
 void WTrackMenu::slotReanalyze() {
     clearBeats();
-    addToAnalysis();
+    AnalyzerTrack::Options options;
+    options.reuseCachedResults = false;
+    addToAnalysis(options);
 }
 
 void WTrackMenu::slotReanalyzeWithFixedTempo() {
     clearBeats();
     AnalyzerTrack::Options options;
     options.useFixedTempo = true;
+    options.reuseCachedResults = false;
     addToAnalysis(options);
 }
 
@@ -1543,6 +1547,7 @@ void WTrackMenu::slotReanalyzeWithVariableTempo() {
     clearBeats();
     AnalyzerTrack::Options options;
     options.useFixedTempo = false;
+    options.reuseCachedResults = false;
     addToAnalysis(options);
 }
 
@@ -2066,6 +2071,8 @@ class RemoveTrackFilesFromDiskTrackPointerOperation : public mixxx::TrackPointer
             return;
         }
         QString location = pTrack->getLocation();
+        // Idle audio sources must not keep the file open
+        mixxx::SoundSourcePool::release(location);
         QFile file(location);
 #if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
         if (file.exists() && !file.moveToTrash()) {
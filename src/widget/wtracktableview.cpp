@@ -7,6 +7,7 @@
 #include <QUrl>
 
 #include "control/controlobject.h"
+#include "library/basesqltablemodel.h"
 #include "library/dao/trackschema.h"
 #include "library/library.h"
 #include "library/library_prefs.h"
@@ -166,11 +167,16 @@ void WTrackTableView::loadTrackModel(QAbstractItemModel* model, bool restoreStat
                 horizontalHeader()->sortIndicatorOrder());
 
         if (restoreState) {
-            restoreCurrentViewState();
+            invokeAfterSelect([this] {
+                restoreCurrentViewState();
+            });
         }
         return;
     }
 
+    // Discard the deferred restoring of the previous model's state
+    disconnect(m_selectFinishedConnection);
+
     setVisible(false);
 
     // Save the previous track model's header state
@@ -321,7 +327,9 @@ void WTrackTableView::loadTrackModel(QAbstractItemModel* model, bool restoreStat
 
     // trigger restoring scrollBar position, selection etc.
     if (restoreState) {
-        restoreCurrentViewState();
+        invokeAfterSelect([this] {
+            restoreCurrentViewState();
+        });
     }
     initTrackMenu();
 }
@@ -529,26 +537,44 @@ void WTrackTableView::onSearch(const QString& text) {
         TrackId prevTrack = getCurrentTrackId();
         saveCurrentIndex();
         trackModel->search(text);
-        if (queryIsLessSpecific) {
-            // If the user removed query terms, we try to select the same
-            // tracks as before
-            setCurrentTrackId(prevTrack, m_prevColumn);
-            setSelectedTracks(selectedTracks);
-        } else {
-            // The user created a more specific search query, try to restore a
-            // previous state
-            if (!restoreCurrentViewState()) {
-                // We found no saved state for this query, try to select the
-                // tracks last active, if they are part of the result set
-                if (!setCurrentTrackId(prevTrack, m_prevColumn)) {
-                    // if the last focused track is not present try to focus the
-                    // respective index and scroll there
-                    restoreCurrentIndex();
-                }
+        invokeAfterSelect([this, queryIsLessSpecific, selectedTracks, prevTrack] {
+            if (queryIsLessSpecific) {
+                // If the user removed query terms, we try to select the same
+                // tracks as before
+                setCurrentTrackId(prevTrack, m_prevColumn);
                 setSelectedTracks(selectedTracks);
+            } else {
+                // The user created a more specific search query, try to restore a
+                // previous state
+                if (!restoreCurrentViewState()) {
+                    // We found no saved state for this query, try to select the
+                    // tracks last active, if they are part of the result set
+                    if (!setCurrentTrackId(prevTrack, m_prevColumn)) {
+                        // if the last focused track is not present try to focus the
+                        // respective index and scroll there
+                        restoreCurrentIndex();
+                    }
+                    setSelectedTracks(selectedTracks);
+                }
             }
-        }
+        });
+    }
+}
+
+void WTrackTableView::invokeAfterSelect(std::function<void()> function) {
+    disconnect(m_selectFinishedConnection);
+    auto* pSqlTableModel = qobject_cast<BaseSqlTableModel*>(model());
+    if (!pSqlTableModel || !pSqlTableModel->isSelectPending()) {
+        function();
+        return;
     }
+    m_selectFinishedConnection = connect(pSqlTableModel,
+            &BaseSqlTableModel::selectFinished,
+            this,
+            [this, function = std::move(function)] {
+                disconnect(m_selectFinishedConnection);
+                function();
+            });
 }
 
 void WTrackTableView::onShow() {
@@ -1319,11 +1345,13 @@ void WTrackTableView::doSortByColumn(int headerSection, Qt::SortOrder sortOrder)
 
     sortByColumn(headerSection, sortOrder);
 
-    selectTracksById(selectedTrackIds, prevColum);
+    invokeAfterSelect([this, selectedTrackIds, prevColum, savedHScrollBarPos] {
+        selectTracksById(selectedTrackIds, prevColum);
 
-    // This seems to be broken since at least Qt 5.12: no scrolling is issued
-    // scrollTo(first, QAbstractItemView::EnsureVisible);
-    horizontalScrollBar()->setValue(savedHScrollBarPos);
+        // This seems to be broken since at least Qt 5.12: no scrolling is issued
+        // scrollTo(first, QAbstractItemView::EnsureVisible);
+        horizontalScrollBar()->setValue(savedHScrollBarPos);
+    });
 }
 
 void WTrackTableView::selectTracksById(const QList<TrackId>& trackIds, int prevColum) {
@@ -2,6 +2,7 @@
 
 #include <QAbstractItemModel>
 #include <QSortFilterProxyModel>
+#include <functional>
 
 #include "control/controlproxy.h"
 #include "control/pollingcontrolproxy.h"
@@ -140,6 +141,11 @@ class WTrackTableView : public WLibraryTableView {
     // Returns the current TrackModel, or returns NULL if none is set.
     TrackModel* getTrackModel() const;
 
+    /// Invokes the function after the pending asynchronous select of the
+    /// model has finished or immediately if no select is pending. Replaces
+    /// a previously deferred function.
+    void invokeAfterSelect(std::function<void()> function);
+
     void initTrackMenu();
 
     void hideOrRemoveSelectedTracks();
@@ -164,4 +170,6 @@ class WTrackTableView : public WLibraryTableView {
     ControlProxy* m_pKeyNotation;
     ControlProxy* m_pSortColumn;
     ControlProxy* m_pSortOrder;
+
+    QMetaObject::Connection m_selectFinishedConnection;
 };